@@ -57,6 +57,21 @@ struct BlockDataTransfer3D {
     virtual void send(Box3D domain, T* buffer) const =0;
     virtual void receive(Box3D domain, T const* buffer) =0;
     virtual void attribute(Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ, AtomicBlock3D<T> const& from) =0;
+    /// Size of the data which is streamed into the cells of domain from the cells of source.
+    /** The following methods transfer only the part of the cells which has
+     *  been streamed from another domain. They are used to send populations
+     *  which were streamed into an envelope back to the block which owns the
+     *  cells. By default, a block has no streamed data.
+     */
+    virtual plint sizeOfStreamedData(Box3D domain, Box3D source) const { return 0; }
+    /// Pack the data streamed into domain from source (both in local coordinates).
+    virtual void sendStreamed(Box3D domain, Box3D source, T* buffer) const { }
+    /// Unpack the data streamed into domain from source (both in local coordinates).
+    virtual void receiveStreamed(Box3D domain, Box3D source, T const* buffer) { }
+    /// Copy the data streamed from source into toDomain (both in local coordinates)
+    ///   from the cells of another block, shifted by delta.
+    virtual void attributeStreamed(Box3D toDomain, Box3D source, plint deltaX, plint deltaY, plint deltaZ,
+                                   AtomicBlock3D<T> const& from) { }
 };
 
 template<typename T>
@@ -96,6 +111,8 @@ public:
     Dot3D getLocation() const;
     /// Add a dataProcessor, which is executed after each iteration
     void integrateDataProcessor(DataProcessor3D<T>* processor, plint level);
+    /// Remove all internal dataProcessors, explicit and automatic ones
+    void clearInternalProcessors();
 private:
     typedef std::vector<std::vector<DataProcessor3D<T>*> > DataProcessorVector;
 private:
@@ -148,6 +148,11 @@ void AtomicBlock3D<T>::copyDataProcessors(DataProcessorVector const& from, DataP
     }
 }
 
+template<typename T>
+void AtomicBlock3D<T>::clearInternalProcessors() {
+    clearDataProcessors();
+}
+
 template<typename T>
 void AtomicBlock3D<T>::clearDataProcessors() {
     clearDataProcessors(explicitInternalProcessors);
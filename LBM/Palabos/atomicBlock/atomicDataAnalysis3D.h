@@ -154,6 +154,13 @@ std::auto_ptr<ScalarField3D<T> > evaluate(Function f, ScalarField3D<T>& field) {
 }
 
 
+/* *************** Extract Sub-ScalarField *************************** */
+
+/// Copy the content of a sub-domain of a field into a new field of the size of the sub-domain.
+template<typename T>
+std::auto_ptr<ScalarField3D<T> > extractSubDomain(ScalarField3D<T>& field, Box3D domain);
+
+
 /* *************** ScalarField - Scalar operations *************** */
 
 template<typename T>
@@ -279,6 +286,12 @@ void divideInPlace(ScalarField3D<T>& A, ScalarField3D<T>& B);
 /* *************** Analysis of the tensor-field ********************** */
 /* ******************************************************************* */
 
+/* *************** Extract Sub-TensorField *************************** */
+
+/// Copy the content of a sub-domain of a field into a new field of the size of the sub-domain.
+template<typename T, int nDim>
+std::auto_ptr<TensorField3D<T,nDim> > extractSubDomain(TensorField3D<T,nDim>& field, Box3D domain);
+
 /* *************** Component (scalar-field) out of a tensor-field ****** */
 
 template<typename T, int nDim>
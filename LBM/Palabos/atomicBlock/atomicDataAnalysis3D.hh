@@ -25,6 +25,7 @@
 #include "atomicBlock/blockLattice3D.h"
 #include "atomicBlock/dataCouplingWrapper3D.h"
 #include "core/dataAnalysisFunctionals3D.h"
+#include "core/serializer.h"
 
 
 #ifndef ATOMIC_DATA_ANALYSIS_3D_HH
@@ -219,6 +220,21 @@ std::auto_ptr<ScalarField3D<T> > computePopulation(BlockLattice3D<T,Descriptor>&
 /* *************** Analysis of the scalar-field ********************** */
 /* ******************************************************************* */
 
+/* *************** Extract Sub-ScalarField *************************** */
+
+template<typename T>
+std::auto_ptr<ScalarField3D<T> > extractSubDomain(ScalarField3D<T>& field, Box3D domain)
+{
+    PLB_PRECONDITION( contained(domain, field.getBoundingBox()) );
+    ScalarField3D<T>* extractedField =
+        new ScalarField3D<T>(domain.getNx(), domain.getNy(), domain.getNz());
+    serializerToUnSerializer (
+            field.getBlockSerializer(domain, IndexOrdering::forward),
+            extractedField->getBlockUnSerializer(extractedField->getBoundingBox(), IndexOrdering::forward) );
+    return std::auto_ptr<ScalarField3D<T> >(extractedField);
+}
+
+
 /* *************** ScalarField - Scalar operations *************** */
 
 template<typename T>
@@ -488,6 +504,21 @@ void divideInPlace(ScalarField3D<T>& A, ScalarField3D<T>& B) {
 /* *************** Analysis of the tensor-field ********************** */
 /* ******************************************************************* */
 
+/* *************** Extract Sub-TensorField *************************** */
+
+template<typename T, int nDim>
+std::auto_ptr<TensorField3D<T,nDim> > extractSubDomain(TensorField3D<T,nDim>& field, Box3D domain)
+{
+    PLB_PRECONDITION( contained(domain, field.getBoundingBox()) );
+    TensorField3D<T,nDim>* extractedField =
+        new TensorField3D<T,nDim>(domain.getNx(), domain.getNy(), domain.getNz());
+    serializerToUnSerializer (
+            field.getBlockSerializer(domain, IndexOrdering::forward),
+            extractedField->getBlockUnSerializer(extractedField->getBoundingBox(), IndexOrdering::forward) );
+    return std::auto_ptr<TensorField3D<T,nDim> >(extractedField);
+}
+
+
 /* *************** Component (scalar-field) out of a tensor-field ****** */
 
 template<typename T, int nDim>
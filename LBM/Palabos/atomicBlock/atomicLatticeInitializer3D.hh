@@ -64,6 +64,39 @@ void defineDynamics( BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& in
     defineDynamics(lattice, intMask, lattice.getBoundingBox(), dynamics, whichFlag);
 }
 
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& boolMask,
+                           Box3D domain, Dynamics<T,Descriptor>* dynamics, bool whichFlag )
+{
+    applyProcessingFunctional (
+            new DynamicsFromMaskFunctional3D<T,Descriptor>(dynamics, whichFlag, true),
+            domain, lattice, boolMask );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& boolMask,
+                           Dynamics<T,Descriptor>* dynamics, bool whichFlag )
+{
+    defineSharedDynamics(lattice, boolMask, lattice.getBoundingBox(), dynamics, whichFlag);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& intMask,
+                           Box3D domain, Dynamics<T,Descriptor>* dynamics, int whichFlag )
+{
+    applyProcessingFunctional (
+            new DynamicsFromIntMaskFunctional3D<T,Descriptor>(dynamics, whichFlag, true),
+            domain, lattice, intMask );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& intMask,
+                           Dynamics<T,Descriptor>* dynamics, int whichFlag )
+{
+    defineSharedDynamics(lattice, intMask, lattice.getBoundingBox(), dynamics, whichFlag);
+}
+
 }  // namespace plb
 
 #endif  // ATOMIC_LATTICE_INITIALIZER_3D_HH
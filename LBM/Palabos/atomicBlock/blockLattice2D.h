@@ -31,6 +31,7 @@
 #include "core/blockLatticeBase2D.h"
 #include "atomicBlock/atomicBlock2D.h"
 #include "core/identifiers.h"
+#include "parallelism/smpManager.h"
 #include <vector>
 
 
@@ -38,6 +39,7 @@
 namespace plb {
 
 template<typename T, template<typename U> class Descriptor> struct Dynamics;
+template<typename T, template<typename U> class Descriptor> class LatticeSlabTask2D;
 template<typename T, template<typename U> class Descriptor> class BlockLattice2D;
 
 
@@ -58,6 +60,12 @@ private:
 /** A block lattice contains a regular array of Cell objects and
  * some useful methods to execute the LB dynamics on the lattice.
  *
+ * With the aaPattern streaming scheme (see StreamingScheme), the full time
+ * step collideAndStream() alternates even and odd steps. The streaming of
+ * an even step is pending until the next odd step, or until the populations
+ * are accessed otherwise, as described for BlockLattice3D. The scheme is
+ * not available for the components of a multi-block lattice.
+ *
  * This class is not intended to be derived from.
  */
 template<typename T, template<typename U> class Descriptor>
@@ -80,12 +88,19 @@ public:
     virtual Cell<T,Descriptor>& get(plint iX, plint iY) {
         PLB_PRECONDITION(iX<nx);
         PLB_PRECONDITION(iY<ny);
+        if (streamPending) {
+            completePendingStream();
+        }
         return grid[iX][iY];
     }
     /// Read only access to lattice cells
     virtual Cell<T,Descriptor> const& get(plint iX, plint iY) const {
         PLB_PRECONDITION(iX<nx);
         PLB_PRECONDITION(iY<ny);
+        // Concluding the streaming changes the storage, but not the content, of the cells.
+        if (streamPending) {
+            const_cast<BlockLattice2D<T,Descriptor>*>(this)->completePendingStream();
+        }
         return grid[iX][iY];
     }
     /// Initialize the lattice cells to get ready for simulation
@@ -125,6 +140,14 @@ public:
     void boundaryStream(Box2D bound, Box2D domain);
     /// Apply collision and streaming step to bulk (non-boundary) cells
     void bulkCollideAndStream(Box2D domain);
+    /// Select the streaming scheme of the full time step collideAndStream().
+    void setStreamingScheme(StreamingScheme::SchemeT scheme);
+    /// Get the streaming scheme of the full time step collideAndStream().
+    StreamingScheme::SchemeT getStreamingScheme() const;
+    /// Tells whether the streaming of an even step of the AA-pattern is pending.
+    bool isStreamPending() const { return streamPending; }
+    /// Conclude the pending streaming of an even step of the AA-pattern, if any.
+    void completePendingStream();
 private:
     /// Helper method for memory allocation
     void allocateMemory();
@@ -133,14 +156,60 @@ private:
     void implementPeriodicity();
 private:
     void periodicDomain(Box2D domain);
+private:
+    /// Collision step followed by revert, with statistics gathered into a given object
+    void collideAndRevert(Box2D domain, BlockStatistics<T>& statistics);
+    /// Sequential, cache-blocked implementation of bulkCollideAndStream()
+    void blockwiseCollideAndStream(Box2D domain, BlockStatistics<T>& statistics);
+private:
+    /// Full time step with the AA-pattern, executing an even or an odd step
+    void aaCollideAndStream();
+    /// Even step of the AA-pattern: collision followed by revert, row by row
+    void aaEvenStep(Box2D domain, BlockStatistics<T>& statistics);
+    /// Odd step of the AA-pattern: gathering, collision and scattering of the populations
+    void aaOddStep(Box2D domain, BlockStatistics<T>& statistics);
+    /// Location of population iPop of a cell during the odd step of the AA-pattern
+    T& aaLocation(plint iX, plint iY, plint iPop, Array<bool,2> const& periodic);
 private:
     plint                    nx, ny;
     Dynamics<T,Descriptor>* backgroundDynamics;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>    **grid;
+    StreamingScheme::SchemeT streamingScheme;
+    bool streamPending;
     BlockLatticeDataTransfer2D<T,Descriptor> dataTransfer;
 public:
     static CachePolicy2D& cachePolicy();
+    template<typename T_, template<typename U_> class Descriptor_> friend class LatticeSlabTask2D;
+};
+
+/// Execution of bulkCollideAndStream() on a BlockLattice2D by a team of threads.
+/** The domain is cut along the x-axis into slabs, one per thread. The
+ *  first planes of each slab (except for the first slab) are treated like
+ *  a boundary envelope, to keep the in-place swap algorithm correct: they
+ *  are collided in a first stage, the bulk of all slabs is collided and
+ *  streamed in a second stage, and the envelopes are streamed in a third.
+ *  The even and odd steps of the AA-pattern are executed in a single stage.
+ *  See LatticeSlabTask3D for details.
+ */
+template<typename T, template<typename U> class Descriptor>
+class LatticeSlabTask2D : public BlockTask {
+public:
+    enum Stage { collideEnvelope, collideAndStreamBulk, streamEnvelope, aaEvenStep, aaOddStep };
+public:
+    LatticeSlabTask2D(BlockLattice2D<T,Descriptor>& lattice_, Box2D domain, Box2D bound_, plint minWidth);
+    plint getNumSlabs() const { return (plint)slabs.size(); }
+    /// Execute a stage on all slabs concurrently.
+    void executeStage(Stage stage_);
+    /// Add the statistics gathered on all slabs to the internal statistics of the lattice.
+    void combineStatistics();
+    virtual void execute(plint iSlab);
+private:
+    BlockLattice2D<T,Descriptor>& lattice;
+    Box2D bound;
+    std::vector<Box2D> slabs;
+    std::vector<BlockStatistics<T> > statistics;
+    Stage stage;
 };
 
 }  // namespace plb
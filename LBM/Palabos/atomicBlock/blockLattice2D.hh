@@ -25,6 +25,7 @@
 #define BLOCK_LATTICE_2D_HH
 
 #include "atomicBlock/blockLattice2D.h"
+#include "core/collisionKernels.hh"
 #include "core/dynamics.h"
 #include "core/cell.h"
 #include "latticeBoltzmann/latticeTemplates.h"
@@ -47,6 +48,8 @@ BlockLattice2D<T,Descriptor>::BlockLattice2D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : nx(nx_), ny(ny_),
       backgroundDynamics(backgroundDynamics_),
+      streamingScheme(StreamingScheme::inPlaceSwap),
+      streamPending(false),
       dataTransfer(*this)
 {
     // Allocate memory and attribute dynamics.
@@ -92,6 +95,8 @@ BlockLattice2D<T,Descriptor>::BlockLattice2D(BlockLattice2D<T,Descriptor> const&
       nx(rhs.nx),
       ny(rhs.ny),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
+      streamingScheme(rhs.streamingScheme),
+      streamPending(rhs.streamPending),
       dataTransfer(*this)
 {
     allocateMemory();
@@ -139,6 +144,8 @@ void BlockLattice2D<T,Descriptor>::swap(BlockLattice2D& rhs) {
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
+    std::swap(streamingScheme, rhs.streamingScheme);
+    std::swap(streamPending, rhs.streamPending);
 }
 
 /// For an AtomicBlock, the lower left corner is always at the origin
@@ -170,10 +177,18 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::collide(Box2D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
 
+    collideAndRevert(domain, this->getInternalStatistics());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::collideAndRevert (
+        Box2D domain, BlockStatistics<T>& statistics )
+{
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            grid[iX][iY].collide(this->getInternalStatistics());
+            grid[iX][iY].collide(statistics);
             grid[iX][iY].revert();
         }
     }
@@ -198,6 +213,7 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::stream(Box2D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -244,6 +260,7 @@ void BlockLattice2D<T,Descriptor>::collideAndStream(Box2D domain)
 {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -278,9 +295,13 @@ void BlockLattice2D<T,Descriptor>::collideAndStream(Box2D domain)
  * \sa collideAndStream(int,int,int,int) */
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::collideAndStream() {
-    collideAndStream(this->getBoundingBox());
-    
-    implementPeriodicity();
+    if (streamingScheme==StreamingScheme::aaPattern) {
+        aaCollideAndStream();
+    }
+    else {
+        collideAndStream(this->getBoundingBox());
+        implementPeriodicity();
+    }
 
     this->executeInternalProcessors();
     this->evaluateStatistics();
@@ -347,6 +368,7 @@ void BlockLattice2D<T,Descriptor>::boundaryStream(Box2D bound, Box2D domain) {
     PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
     // Make sure domain is contained within bound
     PLB_PRECONDITION( contained(domain, bound) );
+    completePendingStream();
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -371,6 +393,7 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::bulkStream(Box2D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -413,7 +436,29 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::bulkCollideAndStream(Box2D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
+
+    static const plint vicinity = Descriptor<T>::vicinity;
+    // Cells streamed by the bulk algorithm have their neighbors within this bound.
+    Box2D bound;
+    intersect(domain.enlarge(vicinity), this->getBoundingBox(), bound);
+    // Slabs must be thick enough for their envelopes not to interact.
+    LatticeSlabTask2D<T,Descriptor> slabTask(*this, domain, bound, 2*vicinity);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage(LatticeSlabTask2D<T,Descriptor>::collideEnvelope);
+        slabTask.executeStage(LatticeSlabTask2D<T,Descriptor>::collideAndStreamBulk);
+        slabTask.executeStage(LatticeSlabTask2D<T,Descriptor>::streamEnvelope);
+        slabTask.combineStatistics();
+    }
+    else {
+        blockwiseCollideAndStream(domain, this->getInternalStatistics());
+    }
+}
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::blockwiseCollideAndStream (
+        Box2D domain, BlockStatistics<T>& statistics )
+{
     // For cache efficiency, memory is traversed block-wise. The two outer loops enumerate
     //   the blocks, whereas the two inner loops enumerate the cells inside each block.
     const plint blockSize = cachePolicy().getBlockSize();
@@ -431,13 +476,15 @@ void BlockLattice2D<T,Descriptor>::bulkCollideAndStream(Box2D domain) {
                 //   of the streaming.
                 plint minY = outerY-dx;
                 plint maxY = minY+blockSize-1;
-                for (plint innerY=max(minY,domain.y0);
-                     innerY <= min(maxY, domain.y1);
-                     ++innerY)
-                {
-                    // Collide the cell.
-                    grid[innerX][innerY].collide (
-                            this->getInternalStatistics() );
+                plint startY = max(minY,domain.y0);
+                plint endY = min(maxY, domain.y1);
+                // Collide the whole y-row at once. Runs of cells which share their
+                //   dynamics are dispatched to a statically typed collision kernel.
+                //   Streaming a cell only involves the previous cell of this row,
+                //   so this is equivalent to a cell-by-cell collision.
+                collideCellRange( &grid[innerX][startY], endY-startY+1,
+                                  statistics );
+                for (plint innerY=startY; innerY<=endY; ++innerY) {
                     // Swap the populations on the cell, and then with post-collision
                     //   neighboring cell, to perform the streaming step.
                     latticeTemplates<T,Descriptor>::swapAndStream2D (
@@ -448,6 +495,131 @@ void BlockLattice2D<T,Descriptor>::bulkCollideAndStream(Box2D domain) {
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::setStreamingScheme(StreamingScheme::SchemeT scheme) {
+    completePendingStream();
+    streamingScheme = scheme;
+}
+
+template<typename T, template<typename U> class Descriptor>
+StreamingScheme::SchemeT BlockLattice2D<T,Descriptor>::getStreamingScheme() const {
+    return streamingScheme;
+}
+
+/** After an even step of the AA-pattern, the populations are in the same
+ *  state as after a collision with the inPlaceSwap scheme. The streaming
+ *  step and the periodicity are therefore concluded as in stream().
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::completePendingStream() {
+    if (!streamPending) {
+        return;
+    }
+    streamPending = false;
+    stream(this->getBoundingBox());
+    implementPeriodicity();
+}
+
+/** Even and odd steps alternate. The streaming of an even step is left
+ *  pending, and is concluded by the next odd step, unless the populations
+ *  are accessed in the meantime (see completePendingStream()).
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::aaCollideAndStream() {
+    Box2D domain(this->getBoundingBox());
+    LatticeSlabTask2D<T,Descriptor> slabTask(*this, domain, domain, 1);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage( streamPending ? LatticeSlabTask2D<T,Descriptor>::aaOddStep
+                                             : LatticeSlabTask2D<T,Descriptor>::aaEvenStep );
+        slabTask.combineStatistics();
+    }
+    else if (streamPending) {
+        aaOddStep(domain, this->getInternalStatistics());
+    }
+    else {
+        aaEvenStep(domain, this->getInternalStatistics());
+    }
+    streamPending = !streamPending;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::aaEvenStep (
+        Box2D domain, BlockStatistics<T>& statistics )
+{
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        collideCellRange(&grid[iX][domain.y0], domain.getNy(), statistics);
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            grid[iX][iY].revert();
+        }
+    }
+}
+
+/** Each population is read from the location where the even step has left
+ *  it (see aaLocation()), and after the collision, the opposite population
+ *  is written into the same location, which streams it to its destination.
+ *  The populations of a y-row are gathered into a row of scratch cells,
+ *  which is collided at once.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice2D<T,Descriptor>::aaOddStep (
+        Box2D domain, BlockStatistics<T>& statistics )
+{
+    static const plint q = Descriptor<T>::q;
+    plint rowLength = domain.getNy();
+    if (rowLength <= 0) return;
+    Array<bool,2> periodic;
+    for (plint iDim=0; iDim<2; ++iDim) {
+        periodic[iDim] = this->periodicity().get(iDim);
+    }
+    std::vector<Cell<T,Descriptor> > row(rowLength);
+    std::vector<T*> locations(rowLength*q);
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=0; iY<rowLength; ++iY) {
+            row[iY] = grid[iX][domain.y0+iY];
+            for (plint iPop=0; iPop<q; ++iPop) {
+                T* location = &aaLocation(iX,domain.y0+iY, iPop, periodic);
+                locations[iY*q+iPop] = location;
+                row[iY][iPop] = *location;
+            }
+        }
+        collideCellRange(&row[0], rowLength, statistics);
+        for (plint iY=0; iY<rowLength; ++iY) {
+            for (plint iPop=0; iPop<q; ++iPop) {
+                *locations[iY*q+iPop] = row[iY][indexTemplates::opposite<Descriptor<T> >(iPop)];
+            }
+            Cell<T,Descriptor>& cell = grid[iX][domain.y0+iY];
+            for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                *cell.getExternal(iExt) = *row[iY].getExternal(iExt);
+            }
+        }
+    }
+}
+
+/** After an even step, population iPop streamed into a cell is located in
+ *  slot opposite(iPop) of its upstream neighbor, which is wrapped around
+ *  periodic boundaries. If the upstream neighbor is outside the lattice, the
+ *  slot iPop of the cell itself is used instead: it contains the opposite
+ *  post-collision population, as in boundaryStream(). The location of
+ *  population iPop of a cell is accessed by no other cell.
+ */
+template<typename T, template<typename U> class Descriptor>
+T& BlockLattice2D<T,Descriptor>::aaLocation (
+        plint iX, plint iY, plint iPop, Array<bool,2> const& periodic )
+{
+    plint prev[2] = { iX - Descriptor<T>::c[iPop][0],
+                      iY - Descriptor<T>::c[iPop][1] };
+    plint size[2] = { nx, ny };
+    for (plint iDim=0; iDim<2; ++iDim) {
+        if (prev[iDim]<0 || prev[iDim]>=size[iDim]) {
+            if (!periodic[iDim]) {
+                return grid[iX][iY][iPop];
+            }
+            prev[iDim] = (prev[iDim]+size[iDim]) % size[iDim];
+        }
+    }
+    return grid[prev[0]][prev[1]][indexTemplates::opposite<Descriptor<T> >(iPop)];
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice2D<T,Descriptor>::periodicDomain(Box2D domain) {
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
@@ -564,6 +736,80 @@ CachePolicy2D& BlockLattice2D<T,Descriptor>::cachePolicy() {
     return cachePolicySingleton;
 }
 
+
+////////////////////// Class LatticeSlabTask2D /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+LatticeSlabTask2D<T,Descriptor>::LatticeSlabTask2D (
+        BlockLattice2D<T,Descriptor>& lattice_, Box2D domain, Box2D bound_, plint minWidth )
+    : lattice(lattice_),
+      bound(bound_),
+      stage(collideAndStreamBulk)
+{
+    plint numSlabs = 1;
+    if (!global::smp().inParallelRegion()) {
+        numSlabs = std::min(global::smp().getNumThreads(), domain.getNx()/minWidth);
+    }
+    if (numSlabs <= 1) {
+        return;
+    }
+    for (plint iSlab=0; iSlab<numSlabs; ++iSlab) {
+        plint x0 = domain.x0 + iSlab*domain.getNx()/numSlabs;
+        plint x1 = domain.x0 + (iSlab+1)*domain.getNx()/numSlabs - 1;
+        slabs.push_back(Box2D(x0,x1, domain.y0,domain.y1));
+    }
+    statistics.resize(numSlabs, lattice.getInternalStatistics());
+    for (plint iSlab=0; iSlab<numSlabs; ++iSlab) {
+        statistics[iSlab].resetRunning();
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask2D<T,Descriptor>::executeStage(Stage stage_) {
+    stage = stage_;
+    std::vector<plint> slabIds(slabs.size()), costs(slabs.size());
+    for (pluint iSlab=0; iSlab<slabs.size(); ++iSlab) {
+        slabIds[iSlab] = iSlab;
+        costs[iSlab] = slabs[iSlab].nCells();
+    }
+    executeBlockTasks(slabIds, costs, *this);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask2D<T,Descriptor>::combineStatistics() {
+    for (pluint iSlab=0; iSlab<statistics.size(); ++iSlab) {
+        lattice.getInternalStatistics().combineRunning(statistics[iSlab]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask2D<T,Descriptor>::execute(plint iSlab) {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box2D const& slab = slabs[iSlab];
+    // The first slab has no upstream neighbor inside the domain, and is
+    //   therefore executed entirely with the sequential algorithm.
+    plint envelopeWidth = iSlab==0 ? 0 : vicinity;
+    Box2D envelope(slab.x0, slab.x0+envelopeWidth-1, slab.y0, slab.y1);
+    Box2D bulk(slab.x0+envelopeWidth, slab.x1, slab.y0, slab.y1);
+    switch(stage) {
+        case collideEnvelope:
+            if (envelopeWidth>0) lattice.collideAndRevert(envelope, statistics[iSlab]);
+            break;
+        case collideAndStreamBulk:
+            lattice.blockwiseCollideAndStream(bulk, statistics[iSlab]);
+            break;
+        case streamEnvelope:
+            if (envelopeWidth>0) lattice.boundaryStream(bound, envelope);
+            break;
+        case aaEvenStep:
+            lattice.aaEvenStep(slab, statistics[iSlab]);
+            break;
+        case aaOddStep:
+            lattice.aaOddStep(slab, statistics[iSlab]);
+            break;
+    }
+}
+
 }  // namespace plb
 
 #endif
@@ -31,6 +31,10 @@
 #include "core/blockLatticeBase3D.h"
 #include "atomicBlock/atomicBlock3D.h"
 #include "core/identifiers.h"
+#include "atomicBlock/populationArrays3D.h"
+#include "core/dynamicsRegistry.h"
+#include "core/collisionKernels.h"
+#include "parallelism/smpManager.h"
 #include <vector>
 
 /// All OpenLB code is contained in this namespace.
@@ -38,6 +42,7 @@ namespace plb {
 
 template<typename T, template<typename U> class Descriptor> struct Dynamics;
 template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+template<typename T, template<typename U> class Descriptor> class LatticeSlabTask3D;
 
 
 template<typename T, template<typename U> class Descriptor>
@@ -48,6 +53,20 @@ public:
     virtual void send(Box3D domain, T* buffer) const;
     virtual void receive(Box3D domain, T const* buffer);
     virtual void attribute(Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ, AtomicBlock3D<T> const& from);
+    virtual plint sizeOfStreamedData(Box3D domain, Box3D source) const;
+    virtual void sendStreamed(Box3D domain, Box3D source, T* buffer) const;
+    virtual void receiveStreamed(Box3D domain, Box3D source, T const* buffer);
+    virtual void attributeStreamed(Box3D toDomain, Box3D source, plint deltaX, plint deltaY, plint deltaZ,
+                                   AtomicBlock3D<T> const& from);
+private:
+    /// Tells whether population iPop of cell (iX,iY,iZ) is streamed from a cell of source.
+    static bool isStreamedFrom(plint iX, plint iY, plint iZ, plint iPop, Box3D const& source) {
+        return contained(iX-Descriptor<T>::c[iPop][0], iY-Descriptor<T>::c[iPop][1],
+                         iZ-Descriptor<T>::c[iPop][2], source);
+    }
+    /// Tells whether the upstream neighbor of cell (iX,iY,iZ) in direction iPop is
+    ///   inactive in the sparse layout, in which case nothing is streamed from it.
+    bool isStreamedFromInactive(plint iX, plint iY, plint iZ, plint iPop) const;
 private:
     BlockLattice3D<T,Descriptor>& lattice;
 };
@@ -57,13 +76,56 @@ private:
 /** A block lattice contains a regular array of Cell objects and
  * some useful methods to execute the LB dynamics on the lattice.
  *
+ * In the structureOfArrays layout (see PopulationLayout), the cells are
+ * not stored as Cell objects, but in a PopulationArrays3D. Cell-wise
+ * access through get() remains possible, but a reference to a cell is
+ * only guaranteed to remain valid as long as less than
+ * PopulationArrays3D::numStagedCells other cells are accessed after the
+ * last access to its cell through get(), and until the next collision,
+ * streaming or data transfer. As even the const version
+ * of get() modifies the staging area, a lattice in this layout must not be
+ * accessed by several threads at a time. Data processors which visit many
+ * cells can avoid the staging altogether through getPopulationArrays().
+ *
+ * The sparse layout is a variant of the structureOfArrays layout in which
+ * the cells with NoDynamics are not stored. They can still be accessed
+ * through get(), but they all share the same storage, the content of which
+ * is meaningless. The streaming step does not exchange any populations with
+ * such cells, which leaves the result unchanged only if all their neighbors
+ * are NoDynamics or BounceBack cells. Other blocks are kept in a dense
+ * storage, with a warning. Attributing another dynamics to a NoDynamics
+ * cell temporarily switches to a dense storage, which is compacted at the
+ * next collision.
+ *
+ * A dynamics object which is registered through shareDynamics() can be
+ * attributed to any number of cells, and is deleted when none of them
+ * refers to it any more (see DynamicsRegistry). Cells which share a
+ * dynamics object are collided by a statically dispatched kernel, if one
+ * is registered for its type. Sharing is requested explicitly, for example
+ * through defineSharedDynamics(); a parameter change through the dynamics
+ * of one such cell applies to all cells which share it.
+ *
+ * With the aaPattern streaming scheme (see StreamingScheme), the full time
+ * step collideAndStream() alternates even and odd steps in the
+ * arrayOfStructures layout. After an even step, the populations are in
+ * post-collision state and reverted order, and the streaming is pending.
+ * It is concluded before any other access to the populations, be it through
+ * get(), a data transfer or a partial collision or streaming step, so that
+ * the cells and their moments always appear as in the inPlaceSwap scheme.
+ * Such an access costs an additional streaming sweep, after which the next
+ * step is an even one again. The scheme is not available in the other
+ * layouts, nor for the components of a multi-block lattice, which are
+ * collided and streamed over partial domains: an XflLogicException is
+ * thrown when it is combined with them.
+ *
  * This class is not intended to be derived from.
  */
 template<typename T, template<typename U> class Descriptor>
 class BlockLattice3D : public BlockLatticeBase3D<T,Descriptor>, public AtomicBlock3D<T> {
 public:
     /// Construction of an nx_ by ny_ by nz_ lattice
-    BlockLattice3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics_);
+    BlockLattice3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics_,
+                   PopulationLayout::LayoutT layout_ = PopulationLayout::arrayOfStructures);
     /// Destruction of the lattice
     ~BlockLattice3D();
     /// Copy construction
@@ -80,6 +142,12 @@ public:
         PLB_PRECONDITION(iX<nx);
         PLB_PRECONDITION(iY<ny);
         PLB_PRECONDITION(iZ<nz);
+        if (populationArrays) {
+            return populationArrays->stage(populationArrays->index(iX,iY,iZ));
+        }
+        if (streamPending) {
+            completePendingStream();
+        }
         return grid[iX][iY][iZ];
     }
     /// Read only access to lattice cells
@@ -87,6 +155,13 @@ public:
         PLB_PRECONDITION(iX<nx);
         PLB_PRECONDITION(iY<ny);
         PLB_PRECONDITION(iZ<nz);
+        if (populationArrays) {
+            return populationArrays->stage(populationArrays->index(iX,iY,iZ));
+        }
+        // Concluding the streaming changes the storage, but not the content, of the cells.
+        if (streamPending) {
+            const_cast<BlockLattice3D<T,Descriptor>*>(this)->completePendingStream();
+        }
         return grid[iX][iY][iZ];
     }
     /// Initialize the lattice cells to get ready for simulation
@@ -116,7 +191,19 @@ public:
     virtual BlockLatticeDataTransfer3D<T,Descriptor> const& getDataTransfer() const;
 public:
     /// Attribute dynamics to a cell.
+    /** The lattice takes ownership of the dynamics, unless it is shared. The
+     *  previous dynamics of the cell is deleted, unless it is the background
+     *  dynamics or it is still shared by other cells.
+     */
     void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
+    /// Register a shareable dynamics, which can then be attributed to several cells.
+    /** The lattice takes ownership of the dynamics. It is deleted when it has
+     *  been attributed to cells which all have received another dynamics, or
+     *  else with the lattice.
+     */
+    Dynamics<T,Descriptor>* shareDynamics(Dynamics<T,Descriptor>* dynamics);
+    /// Get the registry of the shared dynamics of this lattice.
+    DynamicsRegistry<T,Descriptor> const& getDynamicsRegistry() const;
     /// Get a reference to the background dynamics
     Dynamics<T,Descriptor>& getBackgroundDynamics();
     /// Get a const reference to the background dynamics
@@ -127,22 +214,139 @@ public:
     void boundaryStream(Box3D bound, Box3D domain);
     /// Apply collision and streaming step to bulk (non-boundary) cells
     void bulkCollideAndStream(Box3D domain);
+    /// Apply collision step to domain, and streaming step to the enclosing envelope.
+    void collideAndStreamIntoEnvelope(Box3D domain, Box3D envelope);
+    /// Tells whether collideAndStream(domain) can be split into a shell and a core phase.
+    bool isSplittable(Box3D domain, plint shellWidth) const;
+    /// First phase of a split collideAndStream(domain): complete the cells
+    ///   at a distance smaller than shellWidth from the boundary of domain.
+    void collideAndStreamShell(Box3D domain, plint shellWidth);
+    /// First phase of a split collideAndStreamIntoEnvelope(domain, envelope),
+    ///   which is concluded by collideAndStreamCore(domain, shellWidth).
+    void collideAndStreamShell(Box3D domain, Box3D envelope, plint shellWidth);
+    /// Second phase of a split collideAndStream(domain): complete all other cells.
+    void collideAndStreamCore(Box3D domain, plint shellWidth);
+    /// Convert the memory layout of the populations; the content of the lattice is preserved.
+    void setPopulationLayout(PopulationLayout::LayoutT layout_);
+    /// Get the current memory layout of the populations.
+    PopulationLayout::LayoutT getPopulationLayout() const;
+    /// Direct access to the arrays of the structureOfArrays and sparse layouts, or 0 in the arrayOfStructures layout.
+    /** The staged cells are written back first, which invalidates all
+     *  references obtained through get().
+     */
+    PopulationArrays3D<T,Descriptor>* getPopulationArrays();
+    /// Direct read-only access to the arrays of the structureOfArrays and sparse layouts.
+    PopulationArrays3D<T,Descriptor> const* getPopulationArrays() const;
+    /// Select the streaming scheme of the full time step collideAndStream().
+    /** The aaPattern requires the arrayOfStructures layout. */
+    void setStreamingScheme(StreamingScheme::SchemeT scheme);
+    /// Get the streaming scheme of the full time step collideAndStream().
+    StreamingScheme::SchemeT getStreamingScheme() const;
+    /// Tells whether the streaming of an even step of the AA-pattern is pending.
+    bool isStreamPending() const { return streamPending; }
+    /// Conclude the pending streaming of an even step of the AA-pattern, if any.
+    void completePendingStream();
 private:
     /// Helper method for memory allocation
     void allocateMemory();
     /// Helper method for memory de-allocation
     void releaseMemory();
+    /// Helper method for de-allocation of the Cell objects, without their dynamics
+    void releaseCells();
     void implementPeriodicity();
 private:
     void periodicDomain(Box3D domain);
+    /// Read a population, independently of the memory layout
+    T getPopulation(plint iX, plint iY, plint iZ, plint iPop) const;
+    /// Write a population, independently of the memory layout
+    void setPopulation(plint iX, plint iY, plint iZ, plint iPop, T value);
+    /// Stream between the cells of domain and their upstream neighbors inside bound
+    void exchangePopulations(Box3D bound, Box3D domain);
+private:
+    /// Collision step (followed by revert) in the structureOfArrays layout
+    void collideArrays(Box3D domain);
+    /// Streaming step in the structureOfArrays layout
+    void streamArrays(Box3D bound, Box3D domain);
+private:
+    /// Collision step followed by revert, with statistics gathered into a given object
+    void collideAndRevert(Box3D domain, BlockStatistics<T>& statistics);
+    /// Sequential, cache-blocked implementation of bulkCollideAndStream()
+    void blockwiseCollideAndStream(Box3D domain, BlockStatistics<T>& statistics);
+    /// Sequential implementation of collideArrays()
+    void collideArrayRows(Box3D domain, BlockStatistics<T>& statistics);
+    /// Collision (followed by revert) of contiguous stored cells through a batched kernel,
+    ///   using q*numCells scratch values in batch, and numCells in rhoBar and uSqr
+    void collideArrayBatch( plint firstCell, plint numCells, Dynamics<T,Descriptor>& dynamics,
+                            CollisionKernel<T,Descriptor> const& kernel,
+                            T* batch, T* rhoBar, T* uSqr, BlockStatistics<T>& statistics );
+    /// Sequential implementation of streamArrays()
+    void streamArrayRows(Box3D bound, Box3D domain);
+private:
+    /// Full time step with the AA-pattern, executing an even or an odd step
+    void aaCollideAndStream();
+    /// Even step of the AA-pattern: collision followed by revert, row by row
+    void aaEvenStep(Box3D domain, BlockStatistics<T>& statistics);
+    /// Odd step of the AA-pattern: gathering, collision and scattering of the populations
+    void aaOddStep(Box3D domain, BlockStatistics<T>& statistics);
+    /// Location of population iPop of a cell during the odd step of the AA-pattern
+    T& aaLocation(plint iX, plint iY, plint iZ, plint iPop, Array<bool,3> const& periodic);
 private:
     plint                    nx, ny, nz;
     Dynamics<T,Descriptor>* backgroundDynamics;
+    DynamicsRegistry<T,Descriptor>* sharedDynamics;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>   ***grid;
+    PopulationArrays3D<T,Descriptor>* populationArrays;
+    StreamingScheme::SchemeT streamingScheme;
+    bool streamPending;
     BlockLatticeDataTransfer3D<T,Descriptor> dataTransfer;
 public:
     static CachePolicy3D& cachePolicy();
+    template<typename T_, template<typename U_> class Descriptor_> friend class BlockLatticeDataTransfer3D;
+    template<typename T_, template<typename U_> class Descriptor_> friend class LatticeSlabTask3D;
+};
+
+/// Execution of a sweep over a BlockLattice3D by a team of threads.
+/** The domain is cut along the x-axis into slabs, one per thread, which
+ *  are at least minWidth cells thick. Each stage of the sweep is executed
+ *  concurrently on all slabs, and all slabs have completed a stage before
+ *  the next one begins. Statistics are gathered separately on each slab.
+ *
+ *  In the in-place swap algorithm, the streaming step of a cell accesses
+ *  upstream neighbors, which must already be in post-collision state. In
+ *  bulkCollideAndStream(), the first planes of each slab (except for the
+ *  first slab) are therefore treated like a boundary envelope: they are
+ *  collided in a first stage, the bulk of all slabs is collided and
+ *  streamed in a second stage, and the envelopes are streamed in a third.
+ *  The result is identical to the one of the sequential algorithm.
+ *
+ *  The even and odd steps of the AA-pattern need no such precaution: the
+ *  locations accessed by a cell are accessed by no other cell, and each of
+ *  them is executed in a single stage.
+ *
+ *  Without threads, or when it is invoked from within a threaded region,
+ *  the task has a single slab; the caller then uses the sequential
+ *  algorithm instead.
+ */
+template<typename T, template<typename U> class Descriptor>
+class LatticeSlabTask3D : public BlockTask {
+public:
+    enum Stage { collideEnvelope, collideAndStreamBulk, streamEnvelope, collideRows, streamRows,
+                 aaEvenStep, aaOddStep };
+public:
+    LatticeSlabTask3D(BlockLattice3D<T,Descriptor>& lattice_, Box3D domain, Box3D bound_, plint minWidth);
+    plint getNumSlabs() const { return (plint)slabs.size(); }
+    /// Execute a stage on all slabs concurrently.
+    void executeStage(Stage stage_);
+    /// Add the statistics gathered on all slabs to the internal statistics of the lattice.
+    void combineStatistics();
+    virtual void execute(plint iSlab);
+private:
+    BlockLattice3D<T,Descriptor>& lattice;
+    Box3D bound;
+    std::vector<Box3D> slabs;
+    std::vector<BlockStatistics<T> > statistics;
+    Stage stage;
 };
 
 }  // namespace plb
@@ -25,11 +25,16 @@
 #define BLOCK_LATTICE_3D_HH
 
 #include "atomicBlock/blockLattice3D.h"
+#include "atomicBlock/populationArrays3D.hh"
+#include "core/dynamicsRegistry.hh"
+#include "core/collisionKernels.hh"
 #include "core/dynamics.h"
 #include "core/cell.h"
 #include "latticeBoltzmann/latticeTemplates.h"
 #include "latticeBoltzmann/indexTemplates.h"
+#include "core/latticeStatistics.h"
 #include "core/util.h"
+#include "core/runTimeDiagnostics.h"
 #include <algorithm>
 #include <typeinfo>
 using namespace std;
@@ -40,21 +45,34 @@ namespace plb {
 /** \param nx_ lattice width (first index)
  *  \param ny_ lattice height (second index)
  *  \param nz_ lattice depth (third index)
+ *  \param layout_ memory layout of the populations
  */
 template<typename T, template<typename U> class Descriptor>
 BlockLattice3D<T,Descriptor>::BlockLattice3D (
         plint nx_, plint ny_, plint nz_,
-        Dynamics<T,Descriptor>* backgroundDynamics_ )
+        Dynamics<T,Descriptor>* backgroundDynamics_,
+        PopulationLayout::LayoutT layout_ )
     : nx(nx_), ny(ny_), nz(nz_),
       backgroundDynamics(backgroundDynamics_),
+      sharedDynamics(new DynamicsRegistry<T,Descriptor>),
+      rawData(0), grid(0),
+      populationArrays(0),
+      streamingScheme(StreamingScheme::inPlaceSwap),
+      streamPending(false),
       dataTransfer(*this)
 {
     // Allocate memory, and initialize dynamics.
-    allocateMemory();
-    for (plint iX=0; iX<nx; ++iX) {
-        for (plint iY=0; iY<ny; ++iY) {
-            for (plint iZ=0; iZ<nz; ++iZ) {
-                grid[iX][iY][iZ].attributeDynamics(backgroundDynamics);
+    if (layout_!=PopulationLayout::arrayOfStructures) {
+        populationArrays = new PopulationArrays3D<T,Descriptor>(nx,ny,nz, backgroundDynamics, *sharedDynamics);
+        populationArrays->setSparse(layout_==PopulationLayout::sparse);
+    }
+    else {
+        allocateMemory();
+        for (plint iX=0; iX<nx; ++iX) {
+            for (plint iY=0; iY<ny; ++iY) {
+                for (plint iZ=0; iZ<nz; ++iZ) {
+                    grid[iX][iY][iZ].attributeDynamics(backgroundDynamics);
+                }
             }
         }
     }
@@ -80,11 +98,14 @@ template<typename T, template<typename U> class Descriptor>
 BlockLattice3D<T,Descriptor>::~BlockLattice3D()
 {
     releaseMemory();
+    delete sharedDynamics;
 }
 
 /** The whole data of the lattice is duplicated. This includes
  * both particle distribution function and external fields.
  * \warning The dynamics objects and internalProcessors are not copied
+ * Each shared dynamics of rhs is cloned once, and the clone is shared
+ * by the same cells in the new lattice.
  * \param rhs the lattice to be duplicated
  */
 template<typename T, template<typename U> class Descriptor>
@@ -95,8 +116,19 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
       ny(rhs.ny),
       nz(rhs.nz),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
+      sharedDynamics(new DynamicsRegistry<T,Descriptor>),
+      rawData(0), grid(0),
+      populationArrays(0),
+      streamingScheme(rhs.streamingScheme),
+      streamPending(rhs.streamPending),
       dataTransfer(*this)
 {
+    if (rhs.populationArrays) {
+        populationArrays = new PopulationArrays3D<T,Descriptor> (
+                *rhs.populationArrays, backgroundDynamics, *sharedDynamics );
+        return;
+    }
+    typename DynamicsRegistry<T,Descriptor>::CloneMap clones;
     allocateMemory();
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
@@ -110,7 +142,8 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
                     cell.attributeDynamics(backgroundDynamics);
                 }
                 else {
-                    cell.attributeDynamics(cell.getDynamics().clone());
+                    cell.attributeDynamics ( sharedDynamics->duplicate (
+                            cell.getDynamics(), *rhs.sharedDynamics, clones ) );
                 }
             }
         }
@@ -143,8 +176,12 @@ void BlockLattice3D<T,Descriptor>::swap(BlockLattice3D& rhs) {
     std::swap(ny, rhs.ny);
     std::swap(nz, rhs.nz);
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
+    std::swap(sharedDynamics, rhs.sharedDynamics);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
+    std::swap(populationArrays, rhs.populationArrays);
+    std::swap(streamingScheme, rhs.streamingScheme);
+    std::swap(streamPending, rhs.streamPending);
 }
 
 /// For an AtomicBlock, the lower left corner is always at the origin
@@ -163,6 +200,19 @@ void BlockLattice3D<T,Descriptor>::specifyStatisticsStatus(Box3D domain, bool st
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
+    if (populationArrays) {
+        populationArrays->flush();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    populationArrays->specifyStatisticsStatus (
+                            populationArrays->index(iX,iY,iZ), status );
+                }
+            }
+        }
+        return;
+    }
+
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -176,11 +226,24 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collide(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
 
+    if (populationArrays) {
+        collideArrays(domain);
+        return;
+    }
+
+    collideAndRevert(domain, this->getInternalStatistics());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndRevert (
+        Box3D domain, BlockStatistics<T>& statistics )
+{
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                grid[iX][iY][iZ].collide(this->getInternalStatistics());
+                grid[iX][iY][iZ].collide(statistics);
                 grid[iX][iY][iZ].revert();
             }
         }
@@ -201,6 +264,12 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::stream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
+
+    if (populationArrays) {
+        streamArrays(domain, domain);
+        return;
+    }
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -251,6 +320,15 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
+
+    // In the structureOfArrays layout, collision and streaming are executed
+    // in two separate sweeps, each of which traverses the arrays linearly.
+    if (populationArrays) {
+        collideArrays(domain);
+        streamArrays(domain, domain);
+        return;
+    }
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -305,14 +383,60 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
                                  domain.z1-vicinity+1,domain.z1) );
 }
 
+/** The cells of envelope which are outside domain are not collided. The
+ *  streaming step is nevertheless applied to them, so that they receive
+ *  the populations streamed out of domain, and send their own, invalid
+ *  populations into domain. These are expected to be overwritten with the
+ *  content of the envelopes of neighboring blocks.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamIntoEnvelope(Box3D domain, Box3D envelope) {
+    PLB_PRECONDITION( contained(domain, envelope) );
+    PLB_PRECONDITION( contained(envelope, this->getBoundingBox()) );
+    completePendingStream();
+
+    if (populationArrays) {
+        collideArrays(domain);
+        streamArrays(envelope, envelope);
+        return;
+    }
+
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D bulk(domain.enlarge(-vicinity));
+    std::vector<Box3D> shell;
+    if (bulk.x0<=bulk.x1 && bulk.y0<=bulk.y1 && bulk.z0<=bulk.z1) {
+        except(domain, bulk, shell);
+        for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+            collide(shell[iShell]);
+        }
+        bulkCollideAndStream(bulk);
+    }
+    else {
+        collide(domain);
+        shell.push_back(domain);
+    }
+    for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+        boundaryStream(envelope, shell[iShell]);
+    }
+    std::vector<Box3D> outside;
+    except(envelope, domain, outside);
+    for (pluint iOutside=0; iOutside<outside.size(); ++iOutside) {
+        boundaryStream(envelope, outside[iOutside]);
+    }
+}
+
 /** At the end of this method, finalizeIteration() and
  * executeInternalProcessors() are automatically invoked.
  * \sa collideAndStream(int,int,int,int,int,int) */
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collideAndStream() {
-    collideAndStream(this->getBoundingBox());
-
-    implementPeriodicity();
+    if (streamingScheme==StreamingScheme::aaPattern) {
+        aaCollideAndStream();
+    }
+    else {
+        collideAndStream(this->getBoundingBox());
+        implementPeriodicity();
+    }
 
     this->executeInternalProcessors();
     this->evaluateStatistics();
@@ -322,6 +446,7 @@ void BlockLattice3D<T,Descriptor>::collideAndStream() {
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::incrementTime() {
     this->getTimeCounter().incrementTime();
+    this->toggleStatisticsGathering(this->isStatisticsStep());
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -338,33 +463,178 @@ void BlockLattice3D<T,Descriptor>::allocateMemory() {
 
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::releaseMemory() {
+    if (populationArrays) {
+        populationArrays->releaseDynamics();
+        delete populationArrays;
+        delete backgroundDynamics;
+        return;
+    }
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
             for (plint iZ=0; iZ<nz; ++iZ) {
                 Dynamics<T,Descriptor>* dynamics = &grid[iX][iY][iZ].getDynamics();
                 if (dynamics != backgroundDynamics) {
-                    delete dynamics;
+                    sharedDynamics->release(dynamics);
                 }
             }
         }
     }
     delete backgroundDynamics;
+    releaseCells();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::releaseCells() {
     delete [] rawData;
     for (plint iX=0; iX<nx; ++iX) {
         delete [] grid[iX];
     }
     delete [] grid;
+    rawData = 0;
+    grid = 0;
+}
+
+/** The cells are transferred one by one into the new layout. Ownership of
+ *  the dynamics objects is handed over; they are neither cloned nor deleted,
+ *  except for those of inactive cells when switching to the sparse layout.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setPopulationLayout(PopulationLayout::LayoutT layout_) {
+    if (layout_==getPopulationLayout()) {
+        return;
+    }
+    if (layout_!=PopulationLayout::arrayOfStructures && streamingScheme==StreamingScheme::aaPattern) {
+        throw XflLogicException (
+                "the aaPattern streaming scheme is only implemented for the arrayOfStructures layout" );
+    }
+    completePendingStream();
+    if (populationArrays && layout_!=PopulationLayout::arrayOfStructures) {
+        populationArrays->setSparse(layout_==PopulationLayout::sparse);
+    }
+    else if (layout_!=PopulationLayout::arrayOfStructures) {
+        PopulationArrays3D<T,Descriptor>* arrays =
+            new PopulationArrays3D<T,Descriptor>(nx,ny,nz, backgroundDynamics, *sharedDynamics);
+        for (plint iX=0; iX<nx; ++iX) {
+            for (plint iY=0; iY<ny; ++iY) {
+                for (plint iZ=0; iZ<nz; ++iZ) {
+                    plint iCell = arrays->index(iX,iY,iZ);
+                    arrays->storeFullCell(iCell, grid[iX][iY][iZ]);
+                    arrays->adoptDynamics(iCell, &grid[iX][iY][iZ].getDynamics());
+                }
+            }
+        }
+        releaseCells();
+        populationArrays = arrays;
+        populationArrays->setSparse(layout_==PopulationLayout::sparse);
+    }
+    else {
+        populationArrays->setSparse(false);
+        populationArrays->flush();
+        allocateMemory();
+        for (plint iX=0; iX<nx; ++iX) {
+            for (plint iY=0; iY<ny; ++iY) {
+                for (plint iZ=0; iZ<nz; ++iZ) {
+                    populationArrays->loadCell (
+                            populationArrays->index(iX,iY,iZ), grid[iX][iY][iZ] );
+                }
+            }
+        }
+        delete populationArrays;
+        populationArrays = 0;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationLayout::LayoutT BlockLattice3D<T,Descriptor>::getPopulationLayout() const {
+    if (!populationArrays) {
+        return PopulationLayout::arrayOfStructures;
+    }
+    return populationArrays->isSparse() ? PopulationLayout::sparse
+                                        : PopulationLayout::structureOfArrays;
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>* BlockLattice3D<T,Descriptor>::getPopulationArrays() {
+    if (populationArrays) {
+        populationArrays->flush();
+    }
+    return populationArrays;
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor> const* BlockLattice3D<T,Descriptor>::getPopulationArrays() const {
+    if (populationArrays) {
+        populationArrays->flush();
+    }
+    return populationArrays;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setStreamingScheme(StreamingScheme::SchemeT scheme) {
+    if (scheme==StreamingScheme::aaPattern && populationArrays) {
+        throw XflLogicException (
+                "the aaPattern streaming scheme is only implemented for the arrayOfStructures layout" );
+    }
+    completePendingStream();
+    streamingScheme = scheme;
+}
+
+template<typename T, template<typename U> class Descriptor>
+StreamingScheme::SchemeT BlockLattice3D<T,Descriptor>::getStreamingScheme() const {
+    return streamingScheme;
+}
+
+/** After an even step of the AA-pattern, the populations are in the same
+ *  state as after a collision with the inPlaceSwap scheme. The streaming
+ *  step and the periodicity are therefore concluded as in stream().
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::completePendingStream() {
+    if (!streamPending) {
+        return;
+    }
+    streamPending = false;
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D domain(this->getBoundingBox());
+    Box3D bulk(domain.enlarge(-vicinity));
+    std::vector<Box3D> shell;
+    if (bulk.x0<=bulk.x1 && bulk.y0<=bulk.y1 && bulk.z0<=bulk.z1) {
+        except(domain, bulk, shell);
+        bulkStream(bulk);
+    }
+    else {
+        shell.push_back(domain);
+    }
+    for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+        exchangePopulations(domain, shell[iShell]);
+    }
+    implementPeriodicity();
 }
 
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::attributeDynamics (
         plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics )
 {
+    if (populationArrays) {
+        populationArrays->attributeDynamics(iX,iY,iZ, dynamics);
+        return;
+    }
     Dynamics<T,Descriptor>* previousDynamics = &grid[iX][iY][iZ].getDynamics();
+    sharedDynamics->acquire(dynamics);
+    grid[iX][iY][iZ].attributeDynamics(dynamics);
     if (previousDynamics != backgroundDynamics) {
-        delete previousDynamics;
+        sharedDynamics->release(previousDynamics);
     }
-    grid[iX][iY][iZ].attributeDynamics(dynamics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* BlockLattice3D<T,Descriptor>::shareDynamics(Dynamics<T,Descriptor>* dynamics) {
+    return sharedDynamics->share(dynamics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsRegistry<T,Descriptor> const& BlockLattice3D<T,Descriptor>::getDynamicsRegistry() const {
+    return *sharedDynamics;
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -389,7 +659,23 @@ void BlockLattice3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
     PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
     // Make sure domain is contained within bound
     PLB_PRECONDITION( contained(domain, bound) );
+    completePendingStream();
+
+    if (populationArrays) {
+        streamArrays(bound, domain);
+        return;
+    }
+
+    exchangePopulations(bound, domain);
+}
 
+/** Each population is exchanged with the opposite population of the neighbor
+ *  in the direction of the corresponding lattice vector, if this neighbor is
+ *  inside bound. Contrarily to boundaryStream(), domain is not required to be
+ *  contained in bound.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::exchangePopulations(Box3D bound, Box3D domain) {
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -419,6 +705,12 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::bulkStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
+
+    if (populationArrays) {
+        streamArrays(this->getBoundingBox(), domain);
+        return;
+    }
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -444,7 +736,35 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::bulkCollideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    completePendingStream();
+
+    if (populationArrays) {
+        collideArrays(domain);
+        streamArrays(this->getBoundingBox(), domain);
+        return;
+    }
 
+    static const plint vicinity = Descriptor<T>::vicinity;
+    // Cells streamed by the bulk algorithm have their neighbors within this bound.
+    Box3D bound;
+    intersect(domain.enlarge(vicinity), this->getBoundingBox(), bound);
+    // Slabs must be thick enough for their envelopes not to interact.
+    LatticeSlabTask3D<T,Descriptor> slabTask(*this, domain, bound, 2*vicinity);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage(LatticeSlabTask3D<T,Descriptor>::collideEnvelope);
+        slabTask.executeStage(LatticeSlabTask3D<T,Descriptor>::collideAndStreamBulk);
+        slabTask.executeStage(LatticeSlabTask3D<T,Descriptor>::streamEnvelope);
+        slabTask.combineStatistics();
+    }
+    else {
+        blockwiseCollideAndStream(domain, this->getInternalStatistics());
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::blockwiseCollideAndStream (
+        Box3D domain, BlockStatistics<T>& statistics )
+{
     // For cache efficiency, memory is traversed block-wise. The three outer loops enumerate
     //   the blocks, whereas the three inner loops enumerate the cells inside each block.
     const plint blockSize = cachePolicy().getBlockSize();
@@ -473,13 +793,15 @@ void BlockLattice3D<T,Descriptor>::bulkCollideAndStream(Box3D domain) {
                         //    the swap-operation of the streaming.
                         plint minZ = outerZ-dx-dy;
                         plint maxZ = minZ+blockSize-1;
-                        for (plint innerZ=max(minZ,domain.z0);
-                             innerZ <= min(maxZ, domain.z1);
-                             ++innerZ)
-                        {
-                            // Collide the cell.
-                            grid[innerX][innerY][innerZ].collide (
-                                    this->getInternalStatistics() );
+                        plint startZ = max(minZ,domain.z0);
+                        plint endZ = min(maxZ, domain.z1);
+                        // Collide the whole z-row at once. Runs of cells which share their
+                        //   dynamics are dispatched to a statically typed collision kernel.
+                        //   Streaming a cell only involves the previous cell of this row,
+                        //   so this is equivalent to a cell-by-cell collision.
+                        collideCellRange( &grid[innerX][innerY][startZ], endZ-startZ+1,
+                                          statistics );
+                        for (plint innerZ=startZ; innerZ<=endZ; ++innerZ) {
                             // Swap the populations on the cell, and then with post-collision
                             //   neighboring cell, to perform the streaming step.
                             latticeTemplates<T,Descriptor>::swapAndStream3D (
@@ -492,9 +814,413 @@ void BlockLattice3D<T,Descriptor>::bulkCollideAndStream(Box3D domain) {
     }
 }
 
+/** The split is possible in the arrayOfStructures layout, if the domain is
+ *  wide enough to contain a core beneath the shell and the layer of cells
+ *  which stream into the shell.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool BlockLattice3D<T,Descriptor>::isSplittable(Box3D domain, plint shellWidth) const {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    plint minWidth = 2*(shellWidth+vicinity)+1;
+    return !populationArrays &&
+           domain.getNx()>=minWidth && domain.getNy()>=minWidth && domain.getNz()>=minWidth;
+}
+
+/** The two phases collideAndStreamShell() and collideAndStreamCore() are
+ *  equivalent to collideAndStream(domain). The shell is completed first, so
+ *  that its content can be communicated while the core is being computed.
+ *
+ *  Three regions are distinguished: the shell, a layer of cells of width
+ *  vicinity beneath the shell, and the core. In the first phase, the shell
+ *  and the layer are collided, and the populations which enter the shell
+ *  are streamed. In the second phase, the core is collided and streamed
+ *  with the efficient bulk algorithm, after which the streaming between
+ *  the layer and the core is concluded. Each pair of populations is
+ *  exchanged once, after both cells have been collided.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamShell(Box3D domain, plint shellWidth) {
+    collideAndStreamShell(domain, domain, shellWidth);
+}
+
+/** The cells of envelope which are outside domain are streamed in this
+ *  phase, as in collideAndStreamIntoEnvelope(). With a shell at least as
+ *  wide as the vicinity, the populations streamed out of domain into the
+ *  envelope are final at the end of this phase.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamShell(Box3D domain, Box3D envelope, plint shellWidth) {
+    PLB_PRECONDITION( contained(domain, envelope) );
+    PLB_PRECONDITION( contained(envelope, this->getBoundingBox()) );
+    PLB_PRECONDITION( isSplittable(domain, shellWidth) );
+    completePendingStream();
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D inner(domain.enlarge(-shellWidth));
+    Box3D core(inner.enlarge(-vicinity));
+    std::vector<Box3D> shell, layer;
+    except(domain, inner, shell);
+    except(inner, core, layer);
+
+    for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+        collide(shell[iShell]);
+    }
+    for (pluint iLayer=0; iLayer<layer.size(); ++iLayer) {
+        collide(layer[iLayer]);
+    }
+    // Streaming from the shell, with upstream neighbors anywhere in the envelope.
+    for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+        exchangePopulations(envelope, shell[iShell]);
+    }
+    std::vector<Box3D> outside;
+    except(envelope, domain, outside);
+    for (pluint iOutside=0; iOutside<outside.size(); ++iOutside) {
+        exchangePopulations(envelope, outside[iOutside]);
+    }
+    // Streaming from the layer, with upstream neighbors in the shell.
+    for (pluint iLayer=0; iLayer<layer.size(); ++iLayer) {
+        Box3D reach(layer[iLayer].enlarge(vicinity)), inters;
+        for (pluint iShell=0; iShell<shell.size(); ++iShell) {
+            if (intersect(reach, shell[iShell], inters)) {
+                exchangePopulations(shell[iShell], layer[iLayer]);
+            }
+        }
+    }
+}
+
+/** \sa collideAndStreamShell() */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamCore(Box3D domain, plint shellWidth) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    PLB_PRECONDITION( isSplittable(domain, shellWidth) );
+    completePendingStream();
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D inner(domain.enlarge(-shellWidth));
+    Box3D core(inner.enlarge(-vicinity));
+    std::vector<Box3D> layer;
+    except(inner, core, layer);
+
+    // The upstream neighbors of the core which are located in the layer
+    //   are already in post-collision state.
+    bulkCollideAndStream(core);
+    // Streaming from the layer, with upstream neighbors in the layer or the core.
+    for (pluint iLayer=0; iLayer<layer.size(); ++iLayer) {
+        exchangePopulations(inner, layer[iLayer]);
+    }
+}
+
+/** Even and odd steps alternate. The streaming of an even step is left
+ *  pending, and is concluded by the next odd step, unless the populations
+ *  are accessed in the meantime (see completePendingStream()).
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaCollideAndStream() {
+    Box3D domain(this->getBoundingBox());
+    LatticeSlabTask3D<T,Descriptor> slabTask(*this, domain, domain, 1);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage( streamPending ? LatticeSlabTask3D<T,Descriptor>::aaOddStep
+                                             : LatticeSlabTask3D<T,Descriptor>::aaEvenStep );
+        slabTask.combineStatistics();
+    }
+    else if (streamPending) {
+        aaOddStep(domain, this->getInternalStatistics());
+    }
+    else {
+        aaEvenStep(domain, this->getInternalStatistics());
+    }
+    streamPending = !streamPending;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaEvenStep (
+        Box3D domain, BlockStatistics<T>& statistics )
+{
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            collideCellRange(&grid[iX][iY][domain.z0], domain.getNz(), statistics);
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                grid[iX][iY][iZ].revert();
+            }
+        }
+    }
+}
+
+/** Each population is read from the location where the even step has left
+ *  it (see aaLocation()), and after the collision, the opposite population
+ *  is written into the same location, which streams it to its destination.
+ *  The populations of a z-row are gathered into a row of scratch cells,
+ *  which is collided at once, as in collideArrayRows().
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaOddStep (
+        Box3D domain, BlockStatistics<T>& statistics )
+{
+    static const plint q = Descriptor<T>::q;
+    plint rowLength = domain.getNz();
+    if (rowLength <= 0) return;
+    Array<bool,3> periodic;
+    for (plint iDim=0; iDim<3; ++iDim) {
+        periodic[iDim] = this->periodicity().get(iDim);
+    }
+    std::vector<Cell<T,Descriptor> > row(rowLength);
+    std::vector<T*> locations(rowLength*q);
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=0; iZ<rowLength; ++iZ) {
+                row[iZ] = grid[iX][iY][domain.z0+iZ];
+                for (plint iPop=0; iPop<q; ++iPop) {
+                    T* location = &aaLocation(iX,iY,domain.z0+iZ, iPop, periodic);
+                    locations[iZ*q+iPop] = location;
+                    row[iZ][iPop] = *location;
+                }
+            }
+            collideCellRange(&row[0], rowLength, statistics);
+            for (plint iZ=0; iZ<rowLength; ++iZ) {
+                for (plint iPop=0; iPop<q; ++iPop) {
+                    *locations[iZ*q+iPop] = row[iZ][indexTemplates::opposite<Descriptor<T> >(iPop)];
+                }
+                Cell<T,Descriptor>& cell = grid[iX][iY][domain.z0+iZ];
+                for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                    *cell.getExternal(iExt) = *row[iZ].getExternal(iExt);
+                }
+            }
+        }
+    }
+}
+
+/** After an even step, population iPop streamed into a cell is located in
+ *  slot opposite(iPop) of its upstream neighbor, which is wrapped around
+ *  periodic boundaries. If the upstream neighbor is outside the lattice, the
+ *  slot iPop of the cell itself is used instead: it contains the opposite
+ *  post-collision population, as in boundaryStream(). The location of
+ *  population iPop of a cell is accessed by no other cell.
+ */
+template<typename T, template<typename U> class Descriptor>
+T& BlockLattice3D<T,Descriptor>::aaLocation (
+        plint iX, plint iY, plint iZ, plint iPop, Array<bool,3> const& periodic )
+{
+    plint prev[3] = { iX - Descriptor<T>::c[iPop][0],
+                      iY - Descriptor<T>::c[iPop][1],
+                      iZ - Descriptor<T>::c[iPop][2] };
+    plint size[3] = { nx, ny, nz };
+    for (plint iDim=0; iDim<3; ++iDim) {
+        if (prev[iDim]<0 || prev[iDim]>=size[iDim]) {
+            if (!periodic[iDim]) {
+                return grid[iX][iY][iZ][iPop];
+            }
+            prev[iDim] = (prev[iDim]+size[iDim]) % size[iDim];
+        }
+    }
+    return grid[prev[0]][prev[1]][prev[2]][indexTemplates::opposite<Descriptor<T> >(iPop)];
+}
+
+/** In the structureOfArrays layout, the collision is executed on a row of
+ * scratch cells, into which the content of each z-row is loaded in turn. The
+ * populations are stored back in reverted order, as expected by the
+ * streaming step. Runs of cells whose shared dynamics has a batched collision
+ * kernel (see BatchedCollisionKernel) are instead loaded into scratch arrays,
+ * and collided a SIMD pack at a time.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideArrays(Box3D domain) {
+    PLB_PRECONDITION( populationArrays );
+    populationArrays->flush();
+    populationArrays->updateStorage( this->periodicity().get(0),
+                                     this->periodicity().get(1),
+                                     this->periodicity().get(2) );
+    LatticeSlabTask3D<T,Descriptor> slabTask(*this, domain, domain, 1);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage(LatticeSlabTask3D<T,Descriptor>::collideRows);
+        slabTask.combineStatistics();
+    }
+    else {
+        collideArrayRows(domain, this->getInternalStatistics());
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideArrayRows (
+        Box3D domain, BlockStatistics<T>& statistics )
+{
+    if (domain.getNz() <= 0) return;
+    CollisionKernelRegistry<T,Descriptor> const& registry = collisionKernelRegistry<T,Descriptor>();
+    std::vector<Cell<T,Descriptor> > row(domain.getNz());
+    std::vector<T> batch(Descriptor<T>::q*domain.getNz()), rhoBar(domain.getNz()), uSqr(domain.getNz());
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            plint firstCell, lastCell;
+            populationArrays->getRowRange(iX,iY, domain.z0,domain.z1, firstCell,lastCell);
+            plint runStart = firstCell;
+            while (runStart<lastCell) {
+                plint dynamicsId = populationArrays->getDynamicsId(runStart);
+                plint runEnd = runStart+1;
+                while (runEnd<lastCell && populationArrays->getDynamicsId(runEnd)==dynamicsId) {
+                    ++runEnd;
+                }
+                plint runLength = runEnd-runStart;
+                Dynamics<T,Descriptor>& dynamics = populationArrays->getDynamicsFromId(dynamicsId);
+                CollisionKernel<T,Descriptor> const* kernel = runLength>1 ? registry.find(dynamics) : 0;
+                if (kernel && kernel->collidesArrays()) {
+                    collideArrayBatch( runStart, runLength, dynamics, *kernel,
+                                       &batch[0], &rhoBar[0], &uSqr[0], statistics );
+                }
+                else {
+                    for (plint iCell=0; iCell<runLength; ++iCell) {
+                        populationArrays->loadCell(runStart+iCell, row[iCell]);
+                    }
+                    collideCellRange(&row[0], runLength, statistics);
+                    for (plint iCell=0; iCell<runLength; ++iCell) {
+                        row[iCell].revert();
+                        populationArrays->storeCell(runStart+iCell, row[iCell]);
+                    }
+                }
+                runStart = runEnd;
+            }
+        }
+    }
+}
+
+/** The populations are converted to T in the scratch arrays, so that the
+ *  batched kernels are also used with PLB_MIXED_PRECISION. They are stored
+ *  back in reverted order.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideArrayBatch (
+        plint firstCell, plint numCells, Dynamics<T,Descriptor>& dynamics,
+        CollisionKernel<T,Descriptor> const& kernel,
+        T* batch, T* rhoBar, T* uSqr, BlockStatistics<T>& statistics )
+{
+    typedef typename PopulationArrays3D<T,Descriptor>::Storage Storage;
+    static const plint q = Descriptor<T>::q;
+    T* f[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        f[iPop] = batch + iPop*numCells;
+        Storage const* population = populationArrays->population(iPop) + firstCell;
+        for (plint iCell=0; iCell<numCells; ++iCell) {
+            f[iPop][iCell] = (T) population[iCell];
+        }
+    }
+    bool gatheringOn = statistics.isGatheringOn();
+    kernel.collideArrays(dynamics, f, numCells, gatheringOn ? rhoBar : 0, gatheringOn ? uSqr : 0);
+    for (plint iPop=0; iPop<q; ++iPop) {
+        Storage* population = populationArrays->population (
+                indexTemplates::opposite<Descriptor<T> >(iPop) ) + firstCell;
+        for (plint iCell=0; iCell<numCells; ++iCell) {
+            population[iCell] = (Storage) f[iPop][iCell];
+        }
+    }
+    if (gatheringOn) {
+        for (plint iCell=0; iCell<numCells; ++iCell) {
+            if (populationArrays->takesStatistics(firstCell+iCell)) {
+                gatherStatistics(statistics, rhoBar[iCell], uSqr[iCell]);
+            }
+        }
+    }
+}
+
+/** The streaming step is executed one direction at a time. For a given
+ * direction, the cells for which both the source and the destination are
+ * inside the domain are exchanged between two contiguous arrays at a
+ * constant offset, which is a simple, vectorizable loop along the z-axis.
+ * The populations which would leave the domain are left untouched, as
+ * in boundaryStream().
+ * \param bound Destination cells must be contained in this domain.
+ * \param domain Source cells are taken from this domain.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::streamArrays(Box3D bound, Box3D domain) {
+    PLB_PRECONDITION( populationArrays );
+    populationArrays->flush();
+    LatticeSlabTask3D<T,Descriptor> slabTask(*this, domain, bound, 1);
+    if (slabTask.getNumSlabs() > 1) {
+        slabTask.executeStage(LatticeSlabTask3D<T,Descriptor>::streamRows);
+    }
+    else {
+        streamArrayRows(bound, domain);
+    }
+}
+
+/** Each population of each cell is involved in exactly one exchange, which is
+ *  attributed to its source cell. Disjoint ranges of source cells can therefore
+ *  be streamed concurrently.
+ *
+ *  With a compact storage, the neighbors are taken from the precomputed table
+ *  of the arrays, and exchanges with inactive cells are skipped.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::streamArrayRows(Box3D bound, Box3D domain) {
+    const plint half = Descriptor<T>::q/2;
+    typedef typename PopulationArrays3D<T,Descriptor>::Storage Storage;
+    if (populationArrays->isCompact()) {
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                plint firstCell, lastCell;
+                populationArrays->getRowRange(iX,iY, domain.z0,domain.z1, firstCell,lastCell);
+                for (plint iCell=firstCell; iCell<lastCell; ++iCell) {
+                    plint iZ = populationArrays->getZ(iCell);
+                    for (plint iPop=1; iPop<=half; ++iPop) {
+                        plint next = populationArrays->getNeighbor(iCell, iPop);
+                        if (next!=0 && contained(iX+Descriptor<T>::c[iPop][0],
+                                                 iY+Descriptor<T>::c[iPop][1],
+                                                 iZ+Descriptor<T>::c[iPop][2], bound))
+                        {
+                            std::swap(populationArrays->population(iPop+half)[iCell],
+                                      populationArrays->population(iPop)[next]);
+                        }
+                    }
+                }
+            }
+        }
+        return;
+    }
+    for (plint iPop=1; iPop<=half; ++iPop) {
+        const plint cX = Descriptor<T>::c[iPop][0];
+        const plint cY = Descriptor<T>::c[iPop][1];
+        const plint cZ = Descriptor<T>::c[iPop][2];
+        const plint offset = cZ + nz*(cY + ny*cX);
+        const plint x0 = std::max(domain.x0, bound.x0-cX), x1 = std::min(domain.x1, bound.x1-cX);
+        const plint y0 = std::max(domain.y0, bound.y0-cY), y1 = std::min(domain.y1, bound.y1-cY);
+        const plint z0 = std::max(domain.z0, bound.z0-cZ), z1 = std::min(domain.z1, bound.z1-cZ);
+        Storage* fOut = populationArrays->population(iPop+half);
+        Storage* fIn  = populationArrays->population(iPop);
+        for (plint iX=x0; iX<=x1; ++iX) {
+            for (plint iY=y0; iY<=y1; ++iY) {
+                plint iCell = populationArrays->index(iX,iY,0);
+                Storage* out = fOut + iCell;
+                Storage* in  = fIn  + iCell + offset;
+                for (plint iZ=z0; iZ<=z1; ++iZ) {
+                    Storage fTmp = out[iZ];
+                    out[iZ] = in[iZ];
+                    in[iZ]  = fTmp;
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+T BlockLattice3D<T,Descriptor>::getPopulation(plint iX, plint iY, plint iZ, plint iPop) const {
+    if (populationArrays) {
+        return populationArrays->population(iPop)[populationArrays->index(iX,iY,iZ)];
+    }
+    return grid[iX][iY][iZ][iPop];
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setPopulation(plint iX, plint iY, plint iZ, plint iPop, T value) {
+    if (populationArrays) {
+        populationArrays->population(iPop)[populationArrays->index(iX,iY,iZ)] =
+            (typename PopulationArrays3D<T,Descriptor>::Storage) value;
+        return;
+    }
+    grid[iX][iY][iZ][iPop] = value;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
     static const plint vicinity = Descriptor<T>::vicinity;
+    if (populationArrays) {
+        populationArrays->flush();
+    }
     plint maxX = nx-1;
     plint maxY = ny-1;
     plint maxZ = nz-1;
@@ -567,9 +1293,16 @@ void BlockLattice3D<T,Descriptor>::periodicDomain(Box3D domain) {
                         plint nextX = (iX+nx)%nx;
                         plint nextY = (iY+ny)%ny;
                         plint nextZ = (iZ+nz)%nz;
-                        std::swap (
-                            grid[prevX][prevY][prevZ][indexTemplates::opposite<Descriptor<T> >(iPop)],
-                            grid[nextX][nextY][nextZ][iPop] );
+                        if ( populationArrays &&
+                             !( populationArrays->isActive(populationArrays->index(prevX,prevY,prevZ)) &&
+                                populationArrays->isActive(populationArrays->index(nextX,nextY,nextZ)) ) )
+                        {
+                            continue;
+                        }
+                        plint oppPop = indexTemplates::opposite<Descriptor<T> >(iPop);
+                        T fTmp = getPopulation(prevX,prevY,prevZ, oppPop);
+                        setPopulation(prevX,prevY,prevZ, oppPop, getPopulation(nextX,nextY,nextZ, iPop));
+                        setPopulation(nextX,nextY,nextZ, iPop, fTmp);
                     }
                 }
             }
@@ -610,6 +1343,25 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::send(Box3D domain, T* buffer) con
     PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
     plint cellSize = sizeOfCell();
     plint iData=0;
+    PopulationArrays3D<T,Descriptor> const* arrays = lattice.populationArrays;
+    if (arrays) {
+        arrays->flush();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    plint iCell = arrays->index(iX,iY,iZ);
+                    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+                        buffer[iData+iPop] = arrays->population(iPop)[iCell];
+                    }
+                    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                        buffer[iData+Descriptor<T>::q+iExt] = arrays->external(iExt)[iCell];
+                    }
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -623,8 +1375,28 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::send(Box3D domain, T* buffer) con
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive(Box3D domain, T const* buffer) {
     PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    typedef typename PopulationArrays3D<T,Descriptor>::Storage Storage;
     plint cellSize = sizeOfCell();
     plint iData=0;
+    PopulationArrays3D<T,Descriptor>* arrays = lattice.populationArrays;
+    if (arrays) {
+        arrays->flush();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    plint iCell = arrays->index(iX,iY,iZ);
+                    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+                        arrays->population(iPop)[iCell] = (Storage) buffer[iData+iPop];
+                    }
+                    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                        arrays->external(iExt)[iCell] = buffer[iData+Descriptor<T>::q+iExt];
+                    }
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -642,6 +1414,27 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute (
     PLB_PRECONDITION (typeid(from) == typeid(BlockLattice3D<T,Descriptor> const&));
     PLB_PRECONDITION(contained(toDomain, lattice.getBoundingBox()));
     BlockLattice3D<T,Descriptor> const& fromLattice = (BlockLattice3D<T,Descriptor> const&) from;
+    PopulationArrays3D<T,Descriptor>* toArrays = lattice.populationArrays;
+    PopulationArrays3D<T,Descriptor> const* fromArrays = fromLattice.populationArrays;
+    if (toArrays && fromArrays) {
+        toArrays->flush();
+        fromArrays->flush();
+        for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
+            for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
+                for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
+                    plint toCell = toArrays->index(iX,iY,iZ);
+                    plint fromCell = fromArrays->index(iX+deltaX,iY+deltaY,iZ+deltaZ);
+                    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+                        toArrays->population(iPop)[toCell] = fromArrays->population(iPop)[fromCell];
+                    }
+                    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                        toArrays->external(iExt)[toCell] = fromArrays->external(iExt)[fromCell];
+                    }
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
         for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
             for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
@@ -652,12 +1445,210 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute (
     }
 }
 
+/** In the sparse layout, the local streaming step leaves populations which
+ *  come from an inactive cell untouched. The values which are returned for
+ *  them from the envelope of another block are therefore discarded.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool BlockLatticeDataTransfer3D<T,Descriptor>::isStreamedFromInactive (
+        plint iX, plint iY, plint iZ, plint iPop ) const
+{
+    PopulationArrays3D<T,Descriptor> const* arrays = lattice.populationArrays;
+    if (!arrays || !arrays->isCompact()) {
+        return false;
+    }
+    return !arrays->isActive( arrays->index(iX-Descriptor<T>::c[iPop][0],
+                                            iY-Descriptor<T>::c[iPop][1],
+                                            iZ-Descriptor<T>::c[iPop][2]) );
+}
+
+/** Population iPop of a cell at position r is streamed from the cell at
+ *  position r-c[iPop]. The size of the data therefore depends on the
+ *  relative position of domain and source only: on a face adjacent to
+ *  source, it is equal to the number of lattice vectors which cross the
+ *  face (5 out of 19 for D3Q19), and it is smaller on edges and corners.
+ */
+template<typename T, template<typename U> class Descriptor>
+plint BlockLatticeDataTransfer3D<T,Descriptor>::sizeOfStreamedData(Box3D domain, Box3D source) const {
+    plint size = 0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    if (isStreamedFrom(iX,iY,iZ,iPop, source)) {
+                        ++size;
+                    }
+                }
+            }
+        }
+    }
+    return size;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendStreamed(Box3D domain, Box3D source, T* buffer) const {
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    if (lattice.populationArrays) {
+        lattice.populationArrays->flush();
+    }
+    lattice.completePendingStream();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    if (isStreamedFrom(iX,iY,iZ,iPop, source)) {
+                        buffer[iData++] = lattice.getPopulation(iX,iY,iZ,iPop);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveStreamed(Box3D domain, Box3D source, T const* buffer) {
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    if (lattice.populationArrays) {
+        lattice.populationArrays->flush();
+    }
+    lattice.completePendingStream();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    if (isStreamedFrom(iX,iY,iZ,iPop, source)) {
+                        if (isStreamedFromInactive(iX,iY,iZ,iPop)) {
+                            ++iData;
+                        }
+                        else {
+                            lattice.setPopulation(iX,iY,iZ,iPop, buffer[iData++]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::attributeStreamed (
+        Box3D toDomain, Box3D source, plint deltaX, plint deltaY, plint deltaZ, AtomicBlock3D<T> const& from)
+{
+    PLB_PRECONDITION (typeid(from) == typeid(BlockLattice3D<T,Descriptor> const&));
+    PLB_PRECONDITION(contained(toDomain, lattice.getBoundingBox()));
+    BlockLattice3D<T,Descriptor> const& fromLattice = (BlockLattice3D<T,Descriptor> const&) from;
+    if (lattice.populationArrays) {
+        lattice.populationArrays->flush();
+    }
+    if (fromLattice.populationArrays) {
+        fromLattice.populationArrays->flush();
+    }
+    lattice.completePendingStream();
+    const_cast<BlockLattice3D<T,Descriptor>&>(fromLattice).completePendingStream();
+    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
+        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
+            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    if (isStreamedFrom(iX,iY,iZ,iPop, source) &&
+                        !isStreamedFromInactive(iX,iY,iZ,iPop))
+                    {
+                        lattice.setPopulation(iX,iY,iZ,iPop,
+                            fromLattice.getPopulation(iX+deltaX,iY+deltaY,iZ+deltaZ,iPop) );
+                    }
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 CachePolicy3D& BlockLattice3D<T,Descriptor>::cachePolicy() {
     static CachePolicy3D cachePolicySingleton(30);
     return cachePolicySingleton;
 }
 
+
+////////////////////// Class LatticeSlabTask3D /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+LatticeSlabTask3D<T,Descriptor>::LatticeSlabTask3D (
+        BlockLattice3D<T,Descriptor>& lattice_, Box3D domain, Box3D bound_, plint minWidth )
+    : lattice(lattice_),
+      bound(bound_),
+      stage(collideRows)
+{
+    plint numSlabs = 1;
+    if (!global::smp().inParallelRegion()) {
+        numSlabs = std::min(global::smp().getNumThreads(), domain.getNx()/minWidth);
+    }
+    if (numSlabs <= 1) {
+        return;
+    }
+    for (plint iSlab=0; iSlab<numSlabs; ++iSlab) {
+        plint x0 = domain.x0 + iSlab*domain.getNx()/numSlabs;
+        plint x1 = domain.x0 + (iSlab+1)*domain.getNx()/numSlabs - 1;
+        slabs.push_back(Box3D(x0,x1, domain.y0,domain.y1, domain.z0,domain.z1));
+    }
+    statistics.resize(numSlabs, lattice.getInternalStatistics());
+    for (plint iSlab=0; iSlab<numSlabs; ++iSlab) {
+        statistics[iSlab].resetRunning();
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask3D<T,Descriptor>::executeStage(Stage stage_) {
+    stage = stage_;
+    std::vector<plint> slabIds(slabs.size()), costs(slabs.size());
+    for (pluint iSlab=0; iSlab<slabs.size(); ++iSlab) {
+        slabIds[iSlab] = iSlab;
+        costs[iSlab] = slabs[iSlab].nCells();
+    }
+    executeBlockTasks(slabIds, costs, *this);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask3D<T,Descriptor>::combineStatistics() {
+    for (pluint iSlab=0; iSlab<statistics.size(); ++iSlab) {
+        lattice.getInternalStatistics().combineRunning(statistics[iSlab]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void LatticeSlabTask3D<T,Descriptor>::execute(plint iSlab) {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D const& slab = slabs[iSlab];
+    // The first slab has no upstream neighbor inside the domain, and is
+    //   therefore executed entirely with the sequential algorithm.
+    plint envelopeWidth = iSlab==0 ? 0 : vicinity;
+    Box3D envelope(slab.x0, slab.x0+envelopeWidth-1, slab.y0, slab.y1, slab.z0, slab.z1);
+    Box3D bulk(slab.x0+envelopeWidth, slab.x1, slab.y0, slab.y1, slab.z0, slab.z1);
+    switch(stage) {
+        case collideEnvelope:
+            if (envelopeWidth>0) lattice.collideAndRevert(envelope, statistics[iSlab]);
+            break;
+        case collideAndStreamBulk:
+            lattice.blockwiseCollideAndStream(bulk, statistics[iSlab]);
+            break;
+        case streamEnvelope:
+            if (envelopeWidth>0) lattice.boundaryStream(bound, envelope);
+            break;
+        case collideRows:
+            lattice.collideArrayRows(slab, statistics[iSlab]);
+            break;
+        case streamRows:
+            lattice.streamArrayRows(bound, slab);
+            break;
+        case aaEvenStep:
+            lattice.aaEvenStep(slab, statistics[iSlab]);
+            break;
+        case aaOddStep:
+            lattice.aaOddStep(slab, statistics[iSlab]);
+            break;
+    }
+}
+
 }  // namespace plb
 
 #endif
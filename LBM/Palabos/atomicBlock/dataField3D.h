@@ -90,6 +90,11 @@ public:
     virtual ScalarFieldDataTransfer3D<T>& getDataTransfer();
     /// Get access to data transfer between blocks (const version)
     virtual ScalarFieldDataTransfer3D<T> const& getDataTransfer() const;
+protected:
+    /// Construction on top of memory which is not owned by the field, and
+    ///   which must remain valid during the lifetime of the field.
+    /** The data is ordered as in the field: z runs fastest, then y and x. */
+    ScalarField3D(plint nx_, plint ny_, plint nz_, T* externalData);
 private:
     void allocateMemory();
     void releaseMemory();
@@ -99,6 +104,7 @@ private:
     plint nz;
     T   *rawData;
     T   ***field;
+    bool ownsData;
     ScalarFieldDataTransfer3D<T> dataTransfer;
 };
 
@@ -156,6 +162,11 @@ public:
     virtual TensorFieldDataTransfer3D<T,nDim>& getDataTransfer();
     /// Get access to data transfer between blocks (const version)
     virtual TensorFieldDataTransfer3D<T,nDim> const& getDataTransfer() const;
+protected:
+    /// Construction on top of memory which is not owned by the field, and
+    ///   which must remain valid during the lifetime of the field.
+    /** The data is ordered as in the field: z runs fastest, then y and x. */
+    TensorField3D(plint nx_, plint ny_, plint nz_, Array<T,nDim>* externalData);
 private:
     void allocateMemory();
     void releaseMemory();
@@ -165,6 +176,7 @@ private:
     plint nz;
     Array<T,nDim> *rawData;
     Array<T,nDim> ***field;
+    bool ownsData;
     TensorFieldDataTransfer3D<T,nDim> dataTransfer;
 };
 
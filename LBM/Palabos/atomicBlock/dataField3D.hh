@@ -37,6 +37,17 @@ namespace plb {
 template<typename T>
 ScalarField3D<T>::ScalarField3D(plint nx_, plint ny_, plint nz_)
     : nx(nx_), ny(ny_), nz(nz_),
+      ownsData(true),
+      dataTransfer(*this)
+{
+    allocateMemory();
+}
+
+template<typename T>
+ScalarField3D<T>::ScalarField3D(plint nx_, plint ny_, plint nz_, T* externalData)
+    : nx(nx_), ny(ny_), nz(nz_),
+      rawData(externalData),
+      ownsData(false),
       dataTransfer(*this)
 {
     allocateMemory();
@@ -51,6 +62,7 @@ template<typename T>
 ScalarField3D<T>::ScalarField3D(ScalarField3D<T> const& rhs)
     : AtomicBlock3D<T>(rhs),
       nx(rhs.nx), ny(rhs.ny), nz(rhs.nz),
+      ownsData(true),
       dataTransfer(*this)
 {
     allocateMemory();
@@ -74,6 +86,7 @@ void ScalarField3D<T>::swap(ScalarField3D<T>& rhs) {
     std::swap(nz, rhs.nz);
     std::swap(rawData, rhs.rawData);
     std::swap(field, rhs.field);
+    std::swap(ownsData, rhs.ownsData);
 }
 
 template<typename T>
@@ -105,7 +118,9 @@ ScalarFieldDataTransfer3D<T> const& ScalarField3D<T>::getDataTransfer() const {
 
 template<typename T>
 void ScalarField3D<T>::allocateMemory() {
-    rawData = new T [(pluint)nx*(pluint)ny*(pluint)nz];
+    if (ownsData) {
+        rawData = new T [(pluint)nx*(pluint)ny*(pluint)nz];
+    }
     field   = new T** [(pluint)nx];
     for (plint iX=0; iX<nx; ++iX) {
         field[iX] = new T* [(pluint)ny];
@@ -117,7 +132,10 @@ void ScalarField3D<T>::allocateMemory() {
 
 template<typename T>
 void ScalarField3D<T>::releaseMemory() {
-    delete [] rawData; rawData = 0;
+    if (ownsData) {
+        delete [] rawData;
+    }
+    rawData = 0;
     for (plint iX=0; iX<nx; ++iX) {
       delete [] field[iX];
     }
@@ -187,6 +205,17 @@ void ScalarFieldDataTransfer3D<T>::attribute (
 template<typename T, int nDim>
 TensorField3D<T,nDim>::TensorField3D(plint nx_, plint ny_, plint nz_)
     : nx(nx_), ny(ny_), nz(nz_),
+      ownsData(true),
+      dataTransfer(*this)
+{
+    allocateMemory();
+}
+
+template<typename T, int nDim>
+TensorField3D<T,nDim>::TensorField3D(plint nx_, plint ny_, plint nz_, Array<T,nDim>* externalData)
+    : nx(nx_), ny(ny_), nz(nz_),
+      rawData(externalData),
+      ownsData(false),
       dataTransfer(*this)
 {
     allocateMemory();
@@ -201,6 +230,7 @@ template<typename T, int nDim>
 TensorField3D<T,nDim>::TensorField3D(TensorField3D<T,nDim> const& rhs)
     : AtomicBlock3D<T>(rhs),
       nx(rhs.nx), ny(rhs.ny), nz(rhs.nz),
+      ownsData(true),
       dataTransfer(*this)
 {
     allocateMemory();
@@ -226,6 +256,7 @@ void TensorField3D<T,nDim>::swap(TensorField3D<T,nDim>& rhs) {
     std::swap(nz, rhs.nz);
     std::swap(rawData, rhs.rawData);
     std::swap(field, rhs.field);
+    std::swap(ownsData, rhs.ownsData);
 }
 
 template<typename T, int nDim>
@@ -259,7 +290,9 @@ TensorFieldDataTransfer3D<T,nDim> const& TensorField3D<T,nDim>::getDataTransfer(
 
 template<typename T, int nDim>
 void TensorField3D<T,nDim>::allocateMemory() {
-    rawData = new Array<T,nDim>   [(pluint)nx*(pluint)ny*(pluint)nz];
+    if (ownsData) {
+        rawData = new Array<T,nDim> [(pluint)nx*(pluint)ny*(pluint)nz];
+    }
     field   = new Array<T,nDim>** [(pluint)nx];
     for (plint iX=0; iX<nx; ++iX) {
         field[iX] = new Array<T,nDim>* [(pluint)ny];
@@ -271,7 +304,10 @@ void TensorField3D<T,nDim>::allocateMemory() {
 
 template<typename T, int nDim>
 void TensorField3D<T,nDim>::releaseMemory() {
-    delete [] rawData; rawData = 0;
+    if (ownsData) {
+        delete [] rawData;
+    }
+    rawData = 0;
     for (plint iX=0; iX<nx; ++iX) {
         delete [] field[iX];
     }
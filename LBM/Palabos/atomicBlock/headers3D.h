@@ -31,5 +31,6 @@
 #include "atomicBlock/dataField3D.h"
 #include "atomicBlock/dataProcessor3D.h"
 #include "atomicBlock/dataProcessorWrapper3D.h"
+#include "atomicBlock/populationArrays3D.h"
 #include "atomicBlock/reductiveDataCouplingWrapper3D.h"
 #include "atomicBlock/reductiveDataProcessorWrapper3D.h"
@@ -31,5 +31,6 @@
 #include "atomicBlock/dataField3D.hh"
 #include "atomicBlock/dataProcessor3D.hh"
 #include "atomicBlock/dataProcessorWrapper3D.hh"
+#include "atomicBlock/populationArrays3D.hh"
 #include "atomicBlock/reductiveDataCouplingWrapper3D.hh"
 #include "atomicBlock/reductiveDataProcessorWrapper3D.hh"
@@ -0,0 +1,321 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Structure-of-arrays storage for the populations of a 3D block lattice -- header file.
+ */
+#ifndef POPULATION_ARRAYS_3D_H
+#define POPULATION_ARRAYS_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include "core/cell.h"
+#include "core/dynamicsRegistry.h"
+#include <vector>
+#include <map>
+#include <utility>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+
+/// Type in which the populations are stored by a PopulationArrays3D.
+/** By default, this is the type T of the arithmetic. If Palabos is compiled
+ *  with PLB_MIXED_PRECISION, populations of type double are stored in single
+ *  precision, which halves the memory footprint and the memory traffic of the
+ *  structureOfArrays and sparse layouts. The populations are converted to T
+ *  whenever they are loaded into a Cell, so that collisions and all other
+ *  computations are executed in T.
+ *
+ *  The populations are stored with an offset -t[iPop], equal to their
+ *  value in a fluid at rest and unit density (see Descriptor::rhoBar()).
+ *  The rounding error of the single-precision storage is therefore relative
+ *  to the deviation from this state, and not to the populations themselves.
+ */
+template<typename T>
+struct PopulationStorage {
+    typedef T StorageT;
+};
+
+#ifdef PLB_MIXED_PRECISION
+template<>
+struct PopulationStorage<double> {
+    typedef float StorageT;
+};
+#endif
+
+/// Structure-of-arrays storage for the cells of a BlockLattice3D.
+/** Each population direction and each external scalar is stored in its own
+ *  contiguous array, aligned on a cache-line boundary. Cells are enumerated
+ *  in the same order as in the array-of-structures layout (z contiguous, then
+ *  y, then x). Instead of a pointer, each cell holds the integer id of its
+ *  dynamics, which refers to an entry of a dynamics table; id 0 is reserved
+ *  for the background dynamics.
+ *
+ *  Ownership of the dynamics objects follows the rules of BlockLattice3D:
+ *  each non-background dynamics is owned by exactly one cell, unless it is
+ *  shared through the DynamicsRegistry of the lattice, in which case all its
+ *  cells have the same id. The objects are however not deleted by the
+ *  destructor of this class, but explicitly through releaseDynamics(). This
+ *  makes it possible to hand them over to another storage when the layout of
+ *  a lattice is changed.
+ *
+ *  Cell-wise access through a Cell reference (required by the BlockLatticeBase3D
+ *  interface) is provided by "staging" the cell: its content is copied into one
+ *  of a small set of Cell objects, and written back as soon as the slot is
+ *  reused, or when flush() is called. The least recently accessed slot is
+ *  reused first, so that a reference obtained in this way remains valid as
+ *  long as less than numStagedCells other cells are accessed after the last
+ *  access to its cell. In debug builds, a recycled Cell object is kept aside
+ *  until the next flush(), which asserts that it has not been written to
+ *  through a reference which has outlived its slot. Even read-only access
+ *  changes the age of the slots, so that the
+ *  arrays must not be accessed by several threads at a time. Code which
+ *  visits many cells should rather work on the arrays directly (see
+ *  population() and external()), after a call to flush().
+ *
+ *  In sparse mode, only the active cells are stored, in the same order as
+ *  above. All cells with NoDynamics are inactive, and share a single storage
+ *  cell, with index 0, whose content is meaningless. Populations which would
+ *  be streamed from or into an inactive cell are left untouched, as on the
+ *  boundary of the lattice. The storage index of the neighbors of each active
+ *  cell is precomputed for the streaming step. This yields the same result as
+ *  a dense storage only if the neighbors of the inactive cells are inactive
+ *  or BounceBack cells: a BounceBack cell sends the populations it receives
+ *  from a cell back to the same cell, so that only the populations it exchanges
+ *  with the inactive cells differ, and they affect neither the other cells nor
+ *  its macroscopic variables. A storage with inactive cells next to other
+ *  cells is kept dense, and a warning is printed once per process. Attributing
+ *  dynamics can change this, and the compaction is attempted again at the
+ *  next call to updateStorage(), as it is when an inactive cell is activated
+ *  (which switches to a dense storage) or when active cells are made inactive.
+ *
+ *  The populations are stored in the type PopulationStorage<T>::StorageT,
+ *  which can be of lower precision than T. The external scalars are stored
+ *  in T.
+ *
+ *  This class is not intended to be used directly; it is the back-end of a
+ *  BlockLattice3D in the structureOfArrays and sparse layouts.
+ */
+template<typename T, template<typename U> class Descriptor>
+class PopulationArrays3D {
+public:
+    /// Type in which the populations are stored.
+    typedef typename PopulationStorage<T>::StorageT Storage;
+public:
+    /// Number of cells which can be staged simultaneously.
+    static const plint numStagedCells = 64;
+    /// Alignment of each array, in bytes.
+    static const plint alignment = 64;
+public:
+    PopulationArrays3D(plint nx_, plint ny_, plint nz_,
+                       Dynamics<T,Descriptor>* backgroundDynamics_,
+                       DynamicsRegistry<T,Descriptor>& registry_);
+    /// Copy the data of rhs, and attribute clones of its dynamics.
+    /** Each shared dynamics of rhs is cloned once, and the clone is shared in registry_. */
+    PopulationArrays3D(PopulationArrays3D<T,Descriptor> const& rhs,
+                       Dynamics<T,Descriptor>* backgroundDynamics_,
+                       DynamicsRegistry<T,Descriptor>& registry_);
+    ~PopulationArrays3D();
+    void swap(PopulationArrays3D<T,Descriptor>& rhs);
+public:
+    /// Storage index of a cell; with a dense storage, this is identical to its
+    ///   position in the array-of-structures layout.
+    plint index(plint iX, plint iY, plint iZ) const {
+        PLB_PRECONDITION(iX>=0 && iX<nx);
+        PLB_PRECONDITION(iY>=0 && iY<ny);
+        PLB_PRECONDITION(iZ>=0 && iZ<nz);
+        plint position = iZ + nz*(iY + ny*iX);
+        return storageIndex.empty() ? position : storageIndex[position];
+    }
+    /// Number of cells in the arrays.
+    plint getNumCells() const {
+        return numStoredCells;
+    }
+    /// Tells whether only active cells are stored.
+    bool isCompact() const {
+        return !storageIndex.empty();
+    }
+    /// Tells whether a stored cell represents the active cell of a position.
+    bool isActive(plint iCell) const {
+        return storageIndex.empty() || iCell != 0;
+    }
+    /// Range [begin,end) of the stored cells of row (iX,iY) with a z-coordinate between z0 and z1.
+    void getRowRange(plint iX, plint iY, plint z0, plint z1, plint& begin, plint& end) const;
+    /// z-coordinate of a stored cell.
+    plint getZ(plint iCell) const {
+        return storageIndex.empty() ? iCell%nz : positions[iCell]%nz;
+    }
+    /// Storage index of the neighbor of a compactly stored cell in direction
+    ///   iPop (between 1 and q/2), or 0 if it is inactive or outside of the lattice.
+    plint getNeighbor(plint iCell, plint iPop) const {
+        PLB_PRECONDITION(isCompact());
+        PLB_PRECONDITION(iPop>=1 && iPop<=Descriptor<T>::q/2);
+        return neighbors[iCell*(Descriptor<T>::q/2) + iPop-1];
+    }
+    /// Contiguous array of one population direction.
+    Storage* population(plint iPop) {
+        PLB_PRECONDITION(iPop < Descriptor<T>::q);
+        return populations[iPop];
+    }
+    /// Contiguous array of one population direction (const version).
+    Storage const* population(plint iPop) const {
+        PLB_PRECONDITION(iPop < Descriptor<T>::q);
+        return populations[iPop];
+    }
+    /// Contiguous array of one external scalar.
+    T* external(plint iExt) {
+        PLB_PRECONDITION(iExt < Descriptor<T>::ExternalField::numScalars);
+        return externals[iExt];
+    }
+    /// Contiguous array of one external scalar (const version).
+    T const* external(plint iExt) const {
+        PLB_PRECONDITION(iExt < Descriptor<T>::ExternalField::numScalars);
+        return externals[iExt];
+    }
+    /// Id of the dynamics of a cell in the dynamics table.
+    plint getDynamicsId(plint iCell) const {
+        return dynamicsIds[iCell];
+    }
+    /// Dynamics of a cell.
+    Dynamics<T,Descriptor>& getDynamics(plint iCell) const {
+        return *dynamicsTable[dynamicsIds[iCell]];
+    }
+    /// Dynamics attached to a given id of the dynamics table.
+    Dynamics<T,Descriptor>& getDynamicsFromId(plint id) const {
+        PLB_PRECONDITION(id < (plint)dynamicsTable.size());
+        return *dynamicsTable[id];
+    }
+    /// Attribute dynamics to a cell; the previous one is released, unless it's the background dynamics.
+    void attributeDynamics(plint iCell, Dynamics<T,Descriptor>* dynamics);
+    /// Attribute dynamics to the cell at a given position, which can be inactive in sparse mode.
+    void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
+    /// Take over the dynamics pointer of a cell, without deleting the previous one.
+    void adoptDynamics(plint iCell, Dynamics<T,Descriptor>* dynamics);
+    bool takesStatistics(plint iCell) const {
+        return statisticsFlags[iCell];
+    }
+    void specifyStatisticsStatus(plint iCell, bool status) {
+        statisticsFlags[iCell] = status;
+    }
+    /// Release all non-background dynamics objects.
+    void releaseDynamics();
+    /// Switch sparse mode on or off; the storage is immediately adapted,
+    ///   for a non-periodic block.
+    void setSparse(bool sparse_);
+    /// Tells whether the arrays are in sparse mode.
+    bool isSparse() const {
+        return sparse;
+    }
+    /// In sparse mode, adapt the storage to the dynamics which have been attributed
+    ///   since the last call, and to the periodicity of the block.
+    void updateStorage(bool periodicX, bool periodicY, bool periodicZ);
+public:
+    /// Copy the content of a cell (populations, external scalars, statistics flag and dynamics),
+    ///   converting the populations to T.
+    void loadCell(plint iCell, Cell<T,Descriptor>& cell) const;
+    /// Copy back populations and external scalars of a cell, converting the
+    ///   populations to the storage type.
+    void storeCell(plint iCell, Cell<T,Descriptor> const& cell);
+    /// Copy back populations, external scalars and statistics flag of a cell.
+    void storeFullCell(plint iCell, Cell<T,Descriptor> const& cell);
+    /// Get cell-wise access to a cell, through the staged cells.
+    Cell<T,Descriptor>& stage(plint iCell);
+    /// Get cell-wise, read-only access to a cell, through the staged cells.
+    Cell<T,Descriptor> const& stage(plint iCell) const;
+    /// Write back all staged cells and invalidate the references to them.
+    void flush() const;
+private:
+    plint findStagedCell(plint iCell) const;
+    plint findOrStageCell(plint iCell) const;
+    void stageNewCell(plint slot, plint iCell) const;
+    void allocateStagedCells();
+#ifdef PLB_DEBUG
+    static bool hasSameContent(Cell<T,Descriptor> const& cell1, Cell<T,Descriptor> const& cell2);
+#endif
+    void allocateMemory();
+    /// First address at or after memory which is aligned on the alignment.
+    template<typename U> static U* alignPointer(U* memory);
+    /// Store only the active cells, unless the result would differ from a dense storage.
+    void compact();
+    /// Tells whether an inactive cell is next to a cell which is neither inactive
+    ///   nor a BounceBack cell (dense storage only).
+    bool hasExposedInactiveCells() const;
+    /// Store all cells.
+    void expand();
+    static bool isInactiveDynamics(Dynamics<T,Descriptor> const& dynamics);
+    /// Tells whether the dynamics sends back all populations to the cells they come from.
+    static bool isBounceBackDynamics(Dynamics<T,Descriptor> const& dynamics);
+    /// Tells whether the cell at a given position has an inactive neighbor (compact storage only).
+    bool hasInactiveNeighbor(plint iX, plint iY, plint iZ) const;
+    /// Position of the neighbor of a cell in direction iPop, or -1 if it is outside
+    ///   of the block and the block is not periodic in this direction.
+    plint neighborPosition(plint iX, plint iY, plint iZ, plint iPop) const;
+    plint newDynamicsId(Dynamics<T,Descriptor>* dynamics);
+    void releaseDynamicsId(plint id);
+private:
+    PopulationArrays3D(PopulationArrays3D<T,Descriptor> const& rhs);
+    PopulationArrays3D<T,Descriptor>& operator=(PopulationArrays3D<T,Descriptor> const& rhs);
+private:
+    plint nx, ny, nz;
+    plint numStoredCells;
+    plint stride;
+    Storage* rawMemory;
+    T* rawExternals;
+    Storage* populations[Descriptor<T>::q];
+    T* externals[Descriptor<T>::ExternalField::numScalars+1];
+    std::vector<plint> dynamicsIds;
+    std::vector<bool> statisticsFlags;
+    std::vector<Dynamics<T,Descriptor>*> dynamicsTable;
+    /// Number of cells which refer to each entry of the dynamics table.
+    std::vector<plint> numUses;
+    std::vector<plint> freeIds;
+    DynamicsRegistry<T,Descriptor>* registry;
+    /// Id of the shared dynamics objects.
+    std::map<Dynamics<T,Descriptor> const*, plint> sharedIds;
+    /// In sparse mode, the inactive cells are to be removed from the storage.
+    bool sparse;
+    /// In sparse mode, tells whether dynamics have been attributed since the last
+    ///   compaction (or attempt to compact) in a way which can change its outcome.
+    bool geometryChanged;
+    /// Periodicity of the block along each axis, as seen by the last compaction.
+    bool periodic[3];
+    /// Storage index of each position (compact storage only).
+    std::vector<plint> storageIndex;
+    /// Position of each stored cell (compact storage only).
+    std::vector<plint> positions;
+    /// First stored cell of each (x,y) row, and end of the last row (compact storage only).
+    std::vector<plint> rowBegin;
+    /// Storage index of the neighbors of each stored cell, in the directions 1 to q/2 (compact storage only).
+    std::vector<plint> neighbors;
+    mutable std::vector<Cell<T,Descriptor>*> stagedCells;
+    mutable std::vector<plint> stagedIndices;
+    /// Time of the last access to each slot, counted in accesses since the last flush().
+    mutable std::vector<plint> lastStagedUse;
+    mutable plint stagedUseCounter;
+#ifdef PLB_DEBUG
+    /// Recycled staging cells, each with a copy of its content at the time it was recycled.
+    mutable std::vector<std::pair<Cell<T,Descriptor>*, Cell<T,Descriptor> > > retiredCells;
+#endif
+};
+
+}  // namespace plb
+
+#endif  // POPULATION_ARRAYS_3D_H
@@ -0,0 +1,729 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Structure-of-arrays storage for the populations of a 3D block lattice -- generic implementation.
+ */
+#ifndef POPULATION_ARRAYS_3D_HH
+#define POPULATION_ARRAYS_3D_HH
+
+#include "atomicBlock/populationArrays3D.h"
+#include "core/dynamics.h"
+#include "core/cell.h"
+#include "core/dynamicsRegistry.hh"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <typeinfo>
+
+namespace plb {
+
+////////////////////// Class PopulationArrays3D /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::PopulationArrays3D (
+        plint nx_, plint ny_, plint nz_,
+        Dynamics<T,Descriptor>* backgroundDynamics_,
+        DynamicsRegistry<T,Descriptor>& registry_ )
+    : nx(nx_), ny(ny_), nz(nz_),
+      numStoredCells(nx*ny*nz),
+      dynamicsIds(nx*ny*nz, 0),
+      statisticsFlags(nx*ny*nz, true),
+      dynamicsTable(1, backgroundDynamics_),
+      numUses(1, 0),
+      registry(&registry_),
+      sparse(false),
+      geometryChanged(false),
+      stagedIndices(numStagedCells, -1),
+      lastStagedUse(numStagedCells, 0),
+      stagedUseCounter(0)
+{
+    std::fill(periodic, periodic+3, false);
+    allocateMemory();
+    allocateStagedCells();
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::PopulationArrays3D (
+        PopulationArrays3D<T,Descriptor> const& rhs,
+        Dynamics<T,Descriptor>* backgroundDynamics_,
+        DynamicsRegistry<T,Descriptor>& registry_ )
+    : nx(rhs.nx), ny(rhs.ny), nz(rhs.nz),
+      numStoredCells(rhs.numStoredCells),
+      dynamicsIds(rhs.numStoredCells, 0),
+      statisticsFlags(rhs.statisticsFlags),
+      dynamicsTable(1, backgroundDynamics_),
+      numUses(1, 0),
+      registry(&registry_),
+      sparse(rhs.sparse),
+      geometryChanged(rhs.geometryChanged),
+      storageIndex(rhs.storageIndex),
+      positions(rhs.positions),
+      rowBegin(rhs.rowBegin),
+      neighbors(rhs.neighbors),
+      stagedIndices(numStagedCells, -1),
+      lastStagedUse(numStagedCells, 0),
+      stagedUseCounter(0)
+{
+    std::copy(rhs.periodic, rhs.periodic+3, periodic);
+    rhs.flush();
+    allocateMemory();
+    allocateStagedCells();
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        std::copy(rhs.populations[iPop], rhs.populations[iPop]+getNumCells(), populations[iPop]);
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        std::copy(rhs.externals[iExt], rhs.externals[iExt]+getNumCells(), externals[iExt]);
+    }
+    typename DynamicsRegistry<T,Descriptor>::CloneMap clones;
+    for (plint iCell=0; iCell<getNumCells(); ++iCell) {
+        if (rhs.dynamicsIds[iCell] != 0) {
+            dynamicsIds[iCell] = newDynamicsId (
+                    registry->duplicate(rhs.getDynamics(iCell), *rhs.registry, clones) );
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::~PopulationArrays3D() {
+    flush();
+    for (plint iSlot=0; iSlot<numStagedCells; ++iSlot) {
+        delete stagedCells[iSlot];
+    }
+    delete [] rawMemory;
+    delete [] rawExternals;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::swap(PopulationArrays3D<T,Descriptor>& rhs) {
+    flush();
+    rhs.flush();
+    std::swap(nx, rhs.nx);
+    std::swap(ny, rhs.ny);
+    std::swap(nz, rhs.nz);
+    std::swap(numStoredCells, rhs.numStoredCells);
+    std::swap(stride, rhs.stride);
+    std::swap(rawMemory, rhs.rawMemory);
+    std::swap(rawExternals, rhs.rawExternals);
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        std::swap(populations[iPop], rhs.populations[iPop]);
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        std::swap(externals[iExt], rhs.externals[iExt]);
+    }
+    dynamicsIds.swap(rhs.dynamicsIds);
+    statisticsFlags.swap(rhs.statisticsFlags);
+    dynamicsTable.swap(rhs.dynamicsTable);
+    numUses.swap(rhs.numUses);
+    freeIds.swap(rhs.freeIds);
+    std::swap(registry, rhs.registry);
+    sharedIds.swap(rhs.sharedIds);
+    std::swap(sparse, rhs.sparse);
+    std::swap(geometryChanged, rhs.geometryChanged);
+    std::swap_ranges(periodic, periodic+3, rhs.periodic);
+    storageIndex.swap(rhs.storageIndex);
+    positions.swap(rhs.positions);
+    rowBegin.swap(rhs.rowBegin);
+    neighbors.swap(rhs.neighbors);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::allocateStagedCells() {
+    stagedCells.resize(numStagedCells);
+    for (plint iSlot=0; iSlot<numStagedCells; ++iSlot) {
+        stagedCells[iSlot] = new Cell<T,Descriptor>;
+    }
+}
+
+/** The populations are allocated in a single chunk of memory, and so are
+ *  the external scalars. The length of each array is rounded up to a multiple
+ *  of the alignment, so that each of them starts on an aligned address.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::allocateMemory() {
+    static const plint numExternals = Descriptor<T>::ExternalField::numScalars;
+    const plint minSize = (plint) std::min(sizeof(T), sizeof(Storage));
+    const plint alignedLength = alignment/minSize > 0 ? alignment/minSize : 1;
+    stride = ((numStoredCells + alignedLength-1) / alignedLength) * alignedLength;
+    rawMemory = new Storage[Descriptor<T>::q*stride + alignedLength];
+    std::fill(rawMemory, rawMemory + Descriptor<T>::q*stride + alignedLength, Storage());
+    rawExternals = new T[numExternals*stride + alignedLength];
+    std::fill(rawExternals, rawExternals + numExternals*stride + alignedLength, T());
+    Storage* alignedMemory = alignPointer(rawMemory);
+    T* alignedExternals = alignPointer(rawExternals);
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        populations[iPop] = alignedMemory + iPop*stride;
+    }
+    for (plint iExt=0; iExt<numExternals; ++iExt) {
+        externals[iExt] = alignedExternals + iExt*stride;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename U>
+U* PopulationArrays3D<T,Descriptor>::alignPointer(U* memory) {
+    pluint address = (pluint) memory;
+    pluint misalignment = address % (pluint)alignment;
+    return misalignment==0 ? memory : (U*) (address + (pluint)alignment - misalignment);
+}
+
+/** A shared dynamics has a single id, which is used by all its cells. */
+template<typename T, template<typename U> class Descriptor>
+plint PopulationArrays3D<T,Descriptor>::newDynamicsId(Dynamics<T,Descriptor>* dynamics) {
+    bool shared = registry->isShared(dynamics);
+    if (shared) {
+        typename std::map<Dynamics<T,Descriptor> const*, plint>::iterator it = sharedIds.find(dynamics);
+        if (it != sharedIds.end()) {
+            ++numUses[it->second];
+            return it->second;
+        }
+    }
+    plint id;
+    if (freeIds.empty()) {
+        dynamicsTable.push_back(dynamics);
+        numUses.push_back(1);
+        id = (plint)dynamicsTable.size()-1;
+    }
+    else {
+        id = freeIds.back();
+        freeIds.pop_back();
+        dynamicsTable[id] = dynamics;
+        numUses[id] = 1;
+    }
+    if (shared) {
+        sharedIds[dynamics] = id;
+    }
+    return id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::releaseDynamicsId(plint id) {
+    if (id != 0 && --numUses[id] == 0) {
+        sharedIds.erase(dynamicsTable[id]);
+        dynamicsTable[id] = 0;
+        freeIds.push_back(id);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::attributeDynamics (
+        plint iCell, Dynamics<T,Descriptor>* dynamics )
+{
+    plint previousId = dynamicsIds[iCell];
+    Dynamics<T,Descriptor>* previousDynamics = dynamicsTable[previousId];
+    registry->acquire(dynamics);
+    adoptDynamics(iCell, dynamics);
+    if (previousId != 0) {
+        registry->release(previousDynamics);
+    }
+}
+
+/** In sparse mode, a NoDynamics attributed to an inactive cell is deleted
+ *  (unless it is shared), as the cell already has one, and any other dynamics
+ *  makes the cell active. The storage is compacted again at the next call to
+ *  updateStorage() if the new dynamics can change the set of stored cells, or
+ *  the decision to keep the storage dense.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::attributeDynamics (
+        plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics )
+{
+    if (isCompact()) {
+        plint iCell = index(iX,iY,iZ);
+        if (iCell==0) {
+            if (isInactiveDynamics(*dynamics)) {
+                if (dynamics != dynamicsTable[0] && !registry->isShared(dynamics)) {
+                    delete dynamics;
+                }
+                return;
+            }
+            expand();
+            geometryChanged = true;
+        }
+        else if ( isInactiveDynamics(*dynamics) ||
+                  (!isBounceBackDynamics(*dynamics) && hasInactiveNeighbor(iX,iY,iZ)) )
+        {
+            geometryChanged = true;
+        }
+    }
+    else if (sparse) {
+        geometryChanged = true;
+    }
+    attributeDynamics(index(iX,iY,iZ), dynamics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::adoptDynamics (
+        plint iCell, Dynamics<T,Descriptor>* dynamics )
+{
+    releaseDynamicsId(dynamicsIds[iCell]);
+    if (dynamics == dynamicsTable[0]) {
+        dynamicsIds[iCell] = 0;
+    }
+    else {
+        dynamicsIds[iCell] = newDynamicsId(dynamics);
+    }
+    plint slot = findStagedCell(iCell);
+    if (slot >= 0) {
+        stagedCells[slot]->attributeDynamics(dynamics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::releaseDynamics() {
+    flush();
+    for (plint iCell=0; iCell<getNumCells(); ++iCell) {
+        if (dynamicsIds[iCell] != 0) {
+            registry->release(dynamicsTable[dynamicsIds[iCell]]);
+        }
+    }
+    dynamicsTable.resize(1);
+    numUses.resize(1);
+    freeIds.clear();
+    sharedIds.clear();
+    std::fill(dynamicsIds.begin(), dynamicsIds.end(), 0);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::isInactiveDynamics(Dynamics<T,Descriptor> const& dynamics) {
+    return typeid(dynamics) == typeid(NoDynamics<T,Descriptor>);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::isBounceBackDynamics(Dynamics<T,Descriptor> const& dynamics) {
+    return typeid(dynamics) == typeid(BounceBack<T,Descriptor>);
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint PopulationArrays3D<T,Descriptor>::neighborPosition (
+        plint iX, plint iY, plint iZ, plint iPop ) const
+{
+    plint next[3] = { iX + Descriptor<T>::c[iPop][0],
+                      iY + Descriptor<T>::c[iPop][1],
+                      iZ + Descriptor<T>::c[iPop][2] };
+    plint size[3] = { nx, ny, nz };
+    for (plint iDim=0; iDim<3; ++iDim) {
+        if (next[iDim]<0 || next[iDim]>=size[iDim]) {
+            if (!periodic[iDim]) return -1;
+            next[iDim] = (next[iDim]+size[iDim]) % size[iDim];
+        }
+    }
+    return next[2] + nz*(next[1] + ny*next[0]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::hasInactiveNeighbor(plint iX, plint iY, plint iZ) const {
+    PLB_PRECONDITION( isCompact() );
+    for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+        plint position = neighborPosition(iX,iY,iZ, iPop);
+        if (position>=0 && storageIndex[position]==0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** The periodicity only affects the neighbors across the boundary of the
+ *  block. The atomic-blocks of a multi-block are not periodic themselves,
+ *  as their neighbors are in the envelope.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::hasExposedInactiveCells() const {
+    PLB_PRECONDITION( !isCompact() );
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                if (!isInactiveDynamics(getDynamics(index(iX,iY,iZ)))) continue;
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    plint position = neighborPosition(iX,iY,iZ, iPop);
+                    if (position<0) continue;
+                    Dynamics<T,Descriptor> const& dynamics = getDynamics(position);
+                    if (!isInactiveDynamics(dynamics) && !isBounceBackDynamics(dynamics)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::setSparse(bool sparse_) {
+    sparse = sparse_;
+    if (sparse) {
+        compact();
+    }
+    else if (isCompact()) {
+        expand();
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::updateStorage(bool periodicX, bool periodicY, bool periodicZ) {
+    if (!sparse) return;
+    if (periodic[0]!=periodicX || periodic[1]!=periodicY || periodic[2]!=periodicZ) {
+        periodic[0] = periodicX;
+        periodic[1] = periodicY;
+        periodic[2] = periodicZ;
+        geometryChanged = true;
+    }
+    if (geometryChanged) {
+        compact();
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::getRowRange (
+        plint iX, plint iY, plint z0, plint z1, plint& begin, plint& end ) const
+{
+    if (!isCompact()) {
+        begin = index(iX,iY,z0);
+        end = begin + (z1>=z0 ? z1-z0+1 : 0);
+        return;
+    }
+    plint rowStart = nz*(iY + ny*iX);
+    std::vector<plint>::const_iterator first = positions.begin()+rowBegin[iX*ny+iY];
+    std::vector<plint>::const_iterator last  = positions.begin()+rowBegin[iX*ny+iY+1];
+    begin = std::lower_bound(first, last, rowStart+z0) - positions.begin();
+    end   = std::upper_bound(first, last, rowStart+z1) - positions.begin();
+}
+
+/** The active cells are moved to a new storage, preceded by a shared storage
+ *  cell for all inactive cells. The dynamics objects of the inactive cells are
+ *  released, and replaced by a single, shared NoDynamics object, unless the
+ *  background dynamics is a NoDynamics. If inactive cells are exposed to
+ *  other cells (see hasExposedInactiveCells()), the storage is left dense.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::compact() {
+    if (isCompact()) {
+        expand();
+    }
+    flush();
+    geometryChanged = false;
+    if (hasExposedInactiveCells()) {
+#ifdef PLB_SMP_PARALLEL
+        #pragma omp critical (plb_population_arrays_warning)
+#endif
+        {
+            static bool warningIssued = false;
+            if (!warningIssued) {
+                std::cerr << "Warning: the sparse layout keeps blocks in which cells with "
+                          << "NoDynamics are next to cells other than NoDynamics or "
+                          << "BounceBack in a dense storage" << std::endl;
+                warningIssued = true;
+            }
+        }
+        return;
+    }
+    plint numPositions = nx*ny*nz;
+    std::vector<plint> newIndex(numPositions, 0);
+    std::vector<plint> newPositions(1, -1);
+    std::vector<plint> newRowBegin(nx*ny+1);
+    plint firstInactive = -1;
+    for (plint iRow=0; iRow<nx*ny; ++iRow) {
+        newRowBegin[iRow] = (plint)newPositions.size();
+        for (plint position=iRow*nz; position<(iRow+1)*nz; ++position) {
+            if (isInactiveDynamics(getDynamics(position))) {
+                if (firstInactive<0) firstInactive = position;
+            }
+            else {
+                newIndex[position] = (plint)newPositions.size();
+                newPositions.push_back(position);
+            }
+        }
+    }
+    newRowBegin[nx*ny] = (plint)newPositions.size();
+
+    // Move the data of the active cells, and of one inactive cell, to the new storage.
+    Storage* oldMemory = rawMemory;
+    T* oldExternalMemory = rawExternals;
+    Storage* oldPopulations[Descriptor<T>::q];
+    T* oldExternals[Descriptor<T>::ExternalField::numScalars+1];
+    std::copy(populations, populations+Descriptor<T>::q, oldPopulations);
+    std::copy(externals, externals+Descriptor<T>::ExternalField::numScalars, oldExternals);
+    std::vector<plint> oldIds;
+    oldIds.swap(dynamicsIds);
+    std::vector<bool> oldFlags;
+    oldFlags.swap(statisticsFlags);
+
+    numStoredCells = (plint)newPositions.size();
+    allocateMemory();
+    dynamicsIds.resize(numStoredCells);
+    statisticsFlags.resize(numStoredCells);
+    newPositions[0] = firstInactive;
+    for (plint iCell=0; iCell<numStoredCells; ++iCell) {
+        plint position = newPositions[iCell];
+        if (position<0) continue;
+        for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+            populations[iPop][iCell] = oldPopulations[iPop][position];
+        }
+        for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+            externals[iExt][iCell] = oldExternals[iExt][position];
+        }
+        dynamicsIds[iCell] = oldIds[position];
+        statisticsFlags[iCell] = oldFlags[position];
+    }
+    delete [] oldMemory;
+    delete [] oldExternalMemory;
+    newPositions[0] = -1;
+
+    // Replace the dynamics of the inactive cells by a single one.
+    for (plint position=0; position<numPositions; ++position) {
+        if (newIndex[position]==0 && oldIds[position]!=0) {
+            Dynamics<T,Descriptor>* dynamics = dynamicsTable[oldIds[position]];
+            releaseDynamicsId(oldIds[position]);
+            registry->release(dynamics);
+        }
+    }
+    if (isInactiveDynamics(*dynamicsTable[0])) {
+        dynamicsIds[0] = 0;
+    }
+    else {
+        Dynamics<T,Descriptor>* inactiveDynamics = registry->share(new NoDynamics<T,Descriptor>);
+        registry->acquire(inactiveDynamics);
+        dynamicsIds[0] = newDynamicsId(inactiveDynamics);
+    }
+
+    // Neighbors of the active cells.
+    const plint half = Descriptor<T>::q/2;
+    neighbors.assign(numStoredCells*half, 0);
+    for (plint iCell=1; iCell<numStoredCells; ++iCell) {
+        plint position = newPositions[iCell];
+        plint iX = position / (ny*nz);
+        plint iY = (position / nz) % ny;
+        plint iZ = position % nz;
+        for (plint iPop=1; iPop<=half; ++iPop) {
+            plint nextX = iX + Descriptor<T>::c[iPop][0];
+            plint nextY = iY + Descriptor<T>::c[iPop][1];
+            plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+            if (nextX>=0 && nextX<nx && nextY>=0 && nextY<ny && nextZ>=0 && nextZ<nz) {
+                neighbors[iCell*half + iPop-1] = newIndex[nextZ + nz*(nextY + ny*nextX)];
+            }
+        }
+    }
+
+    storageIndex.swap(newIndex);
+    positions.swap(newPositions);
+    rowBegin.swap(newRowBegin);
+}
+
+/** Each inactive cell receives the content of the shared storage cell, and
+ *  its shared NoDynamics object (or the background dynamics).
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::expand() {
+    PLB_PRECONDITION( isCompact() );
+    flush();
+    plint numPositions = nx*ny*nz;
+    Storage* oldMemory = rawMemory;
+    T* oldExternalMemory = rawExternals;
+    Storage* oldPopulations[Descriptor<T>::q];
+    T* oldExternals[Descriptor<T>::ExternalField::numScalars+1];
+    std::copy(populations, populations+Descriptor<T>::q, oldPopulations);
+    std::copy(externals, externals+Descriptor<T>::ExternalField::numScalars, oldExternals);
+    std::vector<plint> oldIds;
+    oldIds.swap(dynamicsIds);
+    std::vector<bool> oldFlags;
+    oldFlags.swap(statisticsFlags);
+
+    numStoredCells = numPositions;
+    allocateMemory();
+    dynamicsIds.resize(numStoredCells);
+    statisticsFlags.resize(numStoredCells);
+    plint inactiveId = oldIds[0];
+    for (plint position=0; position<numPositions; ++position) {
+        plint oldCell = storageIndex[position];
+        for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+            populations[iPop][position] = oldPopulations[iPop][oldCell];
+        }
+        for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+            externals[iExt][position] = oldExternals[iExt][oldCell];
+        }
+        statisticsFlags[position] = oldFlags[oldCell];
+        if (oldCell!=0 || inactiveId==0) {
+            dynamicsIds[position] = oldIds[oldCell];
+        }
+        else {
+            Dynamics<T,Descriptor>* inactiveDynamics = dynamicsTable[inactiveId];
+            if (!registry->isShared(inactiveDynamics)) {
+                inactiveDynamics = inactiveDynamics->clone();
+            }
+            registry->acquire(inactiveDynamics);
+            dynamicsIds[position] = newDynamicsId(inactiveDynamics);
+        }
+    }
+    delete [] oldMemory;
+    delete [] oldExternalMemory;
+    if (inactiveId!=0) {
+        // The shared storage cell does no longer refer to its dynamics.
+        Dynamics<T,Descriptor>* inactiveDynamics = dynamicsTable[inactiveId];
+        releaseDynamicsId(inactiveId);
+        registry->release(inactiveDynamics);
+    }
+
+    storageIndex.clear();
+    positions.clear();
+    rowBegin.clear();
+    neighbors.clear();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::loadCell(plint iCell, Cell<T,Descriptor>& cell) const {
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        cell[iPop] = populations[iPop][iCell];
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        *cell.getExternal(iExt) = externals[iExt][iCell];
+    }
+    cell.specifyStatisticsStatus(statisticsFlags[iCell]);
+    cell.attributeDynamics(dynamicsTable[dynamicsIds[iCell]]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::storeCell(plint iCell, Cell<T,Descriptor> const& cell) {
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        populations[iPop][iCell] = (Storage) cell[iPop];
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        externals[iExt][iCell] = *cell.getExternal(iExt);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::storeFullCell(plint iCell, Cell<T,Descriptor> const& cell) {
+    storeCell(iCell, cell);
+    statisticsFlags[iCell] = cell.takesStatistics();
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint PopulationArrays3D<T,Descriptor>::findStagedCell(plint iCell) const {
+    for (plint iSlot=0; iSlot<numStagedCells; ++iSlot) {
+        if (stagedIndices[iSlot]==iCell) {
+            return iSlot;
+        }
+    }
+    return -1;
+}
+
+/** Each access to a slot, including a hit, renews its age, so that a
+ *  slot is only recycled after numStagedCells-1 other cells have been
+ *  accessed since its last use.
+ */
+template<typename T, template<typename U> class Descriptor>
+plint PopulationArrays3D<T,Descriptor>::findOrStageCell(plint iCell) const {
+    plint slot = 0;
+    for (plint iSlot=0; iSlot<numStagedCells; ++iSlot) {
+        if (stagedIndices[iSlot]==iCell) {
+            slot = iSlot;
+            break;
+        }
+        if (lastStagedUse[iSlot] < lastStagedUse[slot]) {
+            slot = iSlot;
+        }
+    }
+    if (stagedIndices[slot]!=iCell) {
+        stageNewCell(slot, iCell);
+    }
+    lastStagedUse[slot] = ++stagedUseCounter;
+    return slot;
+}
+
+/** The previous content of the recycled slot is written back to the arrays. */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::stageNewCell(plint slot, plint iCell) const {
+    PopulationArrays3D<T,Descriptor>& self = const_cast<PopulationArrays3D<T,Descriptor>&>(*this);
+    if (stagedIndices[slot] >= 0) {
+        self.storeFullCell(stagedIndices[slot], *stagedCells[slot]);
+#ifdef PLB_DEBUG
+        // Keep the recycled object alive, so that flush() can detect if it
+        //   is still written to through an outdated reference.
+        retiredCells.push_back(std::make_pair(stagedCells[slot], *stagedCells[slot]));
+        stagedCells[slot] = new Cell<T,Descriptor>;
+#endif
+    }
+    loadCell(iCell, *stagedCells[slot]);
+    stagedIndices[slot] = iCell;
+}
+
+template<typename T, template<typename U> class Descriptor>
+Cell<T,Descriptor>& PopulationArrays3D<T,Descriptor>::stage(plint iCell) {
+    return *stagedCells[findOrStageCell(iCell)];
+}
+
+template<typename T, template<typename U> class Descriptor>
+Cell<T,Descriptor> const& PopulationArrays3D<T,Descriptor>::stage(plint iCell) const {
+    return *stagedCells[findOrStageCell(iCell)];
+}
+
+/** When the blocks of a multi-block are executed concurrently, the arrays
+ *  of a block can be flushed at the same time by the thread which copies
+ *  data into this block and by a thread which copies data out of it.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::flush() const {
+    PopulationArrays3D<T,Descriptor>& self = const_cast<PopulationArrays3D<T,Descriptor>&>(*this);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp critical (plb_population_arrays_flush)
+#endif
+    {
+        for (plint iSlot=0; iSlot<numStagedCells; ++iSlot) {
+            if (stagedIndices[iSlot] >= 0) {
+                self.storeFullCell(stagedIndices[iSlot], *stagedCells[iSlot]);
+                stagedIndices[iSlot] = -1;
+            }
+            lastStagedUse[iSlot] = 0;
+        }
+        stagedUseCounter = 0;
+#ifdef PLB_DEBUG
+        for (pluint iRetired=0; iRetired<retiredCells.size(); ++iRetired) {
+            // A cell reference was used after its slot had been recycled
+            //   (see PopulationArrays3D::numStagedCells).
+            PLB_ASSERT( hasSameContent(*retiredCells[iRetired].first, retiredCells[iRetired].second) );
+            delete retiredCells[iRetired].first;
+        }
+        retiredCells.clear();
+#endif
+    }
+}
+
+#ifdef PLB_DEBUG
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::hasSameContent (
+        Cell<T,Descriptor> const& cell1, Cell<T,Descriptor> const& cell2 )
+{
+    static const plint numExternals = Descriptor<T>::ExternalField::numScalars;
+    if (std::memcmp(&cell1.getRawPopulations()[0], &cell2.getRawPopulations()[0],
+                    Descriptor<T>::q*sizeof(T)) != 0)
+    {
+        return false;
+    }
+    if (numExternals>0 && std::memcmp(cell1.getExternal(0), cell2.getExternal(0), numExternals*sizeof(T)) != 0) {
+        return false;
+    }
+    return &cell1.getDynamics()==&cell2.getDynamics() &&
+           cell1.takesStatistics()==cell2.takesStatistics();
+}
+#endif
+
+}  // namespace plb
+
+#endif  // POPULATION_ARRAYS_3D_HH
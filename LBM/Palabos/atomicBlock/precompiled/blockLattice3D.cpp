@@ -30,5 +30,6 @@ namespace plb {
 
     template class BlockLattice3D<double, descriptors::D3Q19Descriptor>;
     template class BlockLatticeDataTransfer3D<double, descriptors::D3Q19Descriptor>;
+    template class PopulationArrays3D<double, descriptors::D3Q19Descriptor>;
 
 }  // namespace plb
@@ -27,6 +27,7 @@
 
 #include "core/globalDefs.h"
 #include "core/dynamics.h"
+#include "core/collisionKernels.h"
 
 namespace plb {
 
@@ -117,9 +118,19 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics<T>& statistics_);
 
+    /// Implementation of the collision step, without gathering of statistics
+    virtual void collideWithoutStatistics(Cell<T,Descriptor>& cell);
+
+    /// Collision of contiguous cells in a structure-of-arrays layout, with
+    ///   the batched templates (see BatchedCollisionKernel)
+    void collideArrays(T* const* f, plint numCells, T* rhoBar, T* uSqr);
+
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
+private:
+    /// Registers the batched collision kernel of this class (see collisionKernels.h).
+    static bool staticKernelRegistered;
 };
 
 /// Implementation of O(Ma^2) BGK dynamics, density and momentum taken from external scalars
@@ -159,9 +170,19 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics<T>& statistics_);
 
+    /// Implementation of the collision step, without gathering of statistics
+    virtual void collideWithoutStatistics(Cell<T,Descriptor>& cell);
+
+    /// Collision of contiguous cells in a structure-of-arrays layout, with
+    ///   the batched templates (see BatchedCollisionKernel)
+    void collideArrays(T* const* f, plint numCells, T* rhoBar, T* uSqr);
+
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
+private:
+    /// Registers the batched collision kernel of this class (see collisionKernels.h).
+    static bool staticKernelRegistered;
 };
 
 /// Implementation of O(Ma^2) BGK dynamics with constant average density
@@ -225,9 +246,19 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics<T>& statistics_);
 
+    /// Implementation of the collision step, without gathering of statistics
+    virtual void collideWithoutStatistics(Cell<T,Descriptor>& cell);
+
+    /// Collision of contiguous cells in a structure-of-arrays layout, with
+    ///   the batched templates (see BatchedCollisionKernel)
+    void collideArrays(T* const* f, plint numCells, T* rhoBar, T* uSqr);
+
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
+private:
+    /// Registers the batched collision kernel of this class (see collisionKernels.h).
+    static bool staticKernelRegistered;
 };
 
 /// Implementation of O(Ma^2) BGK dynamics, density and momentum taken from external scalars
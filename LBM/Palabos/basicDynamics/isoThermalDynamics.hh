@@ -26,8 +26,10 @@
 #define ISO_THERMAL_DYNAMICS_HH
 
 #include "basicDynamics/isoThermalDynamics.h"
+#include "core/collisionKernels.hh"
 #include "core/cell.h"
 #include "latticeBoltzmann/dynamicsTemplates.h"
+#include "latticeBoltzmann/batchedDynamicsTemplates.h"
 #include "latticeBoltzmann/momentTemplates.h"
 #include "latticeBoltzmann/externalForceTemplates.h"
 #include "latticeBoltzmann/offEquilibriumTemplates.h"
@@ -287,12 +289,19 @@ void IsoThermalBulkDynamics<T,Descriptor>::rescaleOrder1 (
 
 /* *************** Class BGKdynamics *********************************************** */
 
+template<typename T, template<typename U> class Descriptor>
+bool BGKdynamics<T,Descriptor>::staticKernelRegistered =
+    registerBatchedCollisionKernel<T,Descriptor,BGKdynamics<T,Descriptor> >();
+
 /** \param omega_ relaxation parameter, related to the dynamic viscosity
  */
 template<typename T, template<typename U> class Descriptor>
 BGKdynamics<T,Descriptor>::BGKdynamics(T omega_ )
     : IsoThermalBulkDynamics<T,Descriptor>(omega_)
-{ }
+{
+    // Refer to the static member, so that it is instantiated along with the class.
+    (void) staticKernelRegistered;
+}
 
 template<typename T, template<typename U> class Descriptor>
 BGKdynamics<T,Descriptor>* BGKdynamics<T,Descriptor>::clone() const {
@@ -313,6 +322,22 @@ void BGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BGKdynamics<T,Descriptor>::collideWithoutStatistics(Cell<T,Descriptor>& cell)
+{
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
+    dynamicsTemplates<T,Descriptor>::bgk_ma2_collision(cell, rhoBar, j, this->getOmega());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BGKdynamics<T,Descriptor>::collideArrays (
+        T* const* f, plint numCells, T* rhoBar, T* uSqr )
+{
+    batchedDynamicsTemplates<T,Descriptor>::bgk_ma2_collision(f, numCells, this->getOmega(), rhoBar, uSqr);
+}
+
 template<typename T, template<typename U> class Descriptor>
 T BGKdynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                                 T jSqr, T thetaBar) const
@@ -363,12 +388,19 @@ T ExternalMomentBGKdynamics<T,Descriptor>::computeEquilibrium (
 
 /* *************** Class IncBGKdynamics ******************************************** */
 
+template<typename T, template<typename U> class Descriptor>
+bool IncBGKdynamics<T,Descriptor>::staticKernelRegistered =
+    registerBatchedCollisionKernel<T,Descriptor,IncBGKdynamics<T,Descriptor> >();
+
 /** \param omega_ relaxation parameter, related to the dynamic viscosity
  */
 template<typename T, template<typename U> class Descriptor>
 IncBGKdynamics<T,Descriptor>::IncBGKdynamics(T omega_)
     : IsoThermalBulkDynamics<T,Descriptor>(omega_)
-{ }
+{
+    // Refer to the static member, so that it is instantiated along with the class.
+    (void) staticKernelRegistered;
+}
 
 template<typename T, template<typename U> class Descriptor>
 IncBGKdynamics<T,Descriptor>* IncBGKdynamics<T,Descriptor>::clone() const {
@@ -389,6 +421,22 @@ void IncBGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void IncBGKdynamics<T,Descriptor>::collideWithoutStatistics(Cell<T,Descriptor>& cell)
+{
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
+    dynamicsTemplates<T,Descriptor>::bgk_inc_collision(cell, rhoBar, j, this->getOmega());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void IncBGKdynamics<T,Descriptor>::collideArrays (
+        T* const* f, plint numCells, T* rhoBar, T* uSqr )
+{
+    batchedDynamicsTemplates<T,Descriptor>::bgk_inc_collision(f, numCells, this->getOmega(), rhoBar, uSqr);
+}
+
 
 template<typename T, template<typename U> class Descriptor>
 T IncBGKdynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
@@ -481,12 +529,19 @@ void RLBdynamics<T,Descriptor>::completePopulations(Cell<T,Descriptor>& cell) co
 
 /* *************** Class RegularizedBGKdynamics ************************************ */
 
+template<typename T, template<typename U> class Descriptor>
+bool RegularizedBGKdynamics<T,Descriptor>::staticKernelRegistered =
+    registerBatchedCollisionKernel<T,Descriptor,RegularizedBGKdynamics<T,Descriptor> >();
+
 /** \param omega_ relaxation parameter, related to the dynamic viscosity
  */
 template<typename T, template<typename U> class Descriptor>
 RegularizedBGKdynamics<T,Descriptor>::RegularizedBGKdynamics(T omega_)
     : IsoThermalBulkDynamics<T,Descriptor>(omega_)
-{ }
+{
+    // Refer to the static member, so that it is instantiated along with the class.
+    (void) staticKernelRegistered;
+}
 
 template<typename T, template<typename U> class Descriptor>
 RegularizedBGKdynamics<T,Descriptor>* RegularizedBGKdynamics<T,Descriptor>::clone() const
@@ -510,6 +565,24 @@ void RegularizedBGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void RegularizedBGKdynamics<T,Descriptor>::collideWithoutStatistics(Cell<T,Descriptor>& cell)
+{
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    Array<T,SymmetricTensor<T,Descriptor>::n> PiNeq;
+    momentTemplates<T,Descriptor>::compute_rhoBar_j_PiNeq(cell, rhoBar, j, PiNeq);
+    dynamicsTemplates<T,Descriptor>::rlb_collision (
+            cell, rhoBar, j, PiNeq, this->getOmega() );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void RegularizedBGKdynamics<T,Descriptor>::collideArrays (
+        T* const* f, plint numCells, T* rhoBar, T* uSqr )
+{
+    batchedDynamicsTemplates<T,Descriptor>::rlb_collision(f, numCells, this->getOmega(), rhoBar, uSqr);
+}
+
 template<typename T, template<typename U> class Descriptor>
 T RegularizedBGKdynamics<T,Descriptor>::computeEquilibrium (
         plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j, T jSqr, T thetaBar ) const
@@ -60,6 +60,9 @@ public:
     /// Clone the object on its dynamic type.
     virtual MomentumExchangeBounceBack<T,Descriptor>* clone() const;
 
+    /// The fluid neighbors are stored per cell, which precludes sharing.
+    virtual bool isShareable() const;
+
 /* *************** Collision, Equilibrium, and Non-equilibrium ******* */
 
     /// Implementation of the collision step
@@ -104,6 +107,12 @@ public:
     /// Does nothing
     virtual void setOmega(T omega_);
 
+    /// Serialize the fictitious density, the force ids and the fluid directions.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the fictitious density, the force ids and the fluid directions.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Switch between population and moment representation ****** */
 
     /// Yields Descriptor<T>::q + Descriptor<T>::ExternalField::numScalars.
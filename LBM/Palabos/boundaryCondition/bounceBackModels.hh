@@ -50,6 +50,11 @@ template<typename T, template<typename U> class Descriptor>
 MomentumExchangeBounceBack<T,Descriptor>* MomentumExchangeBounceBack<T,Descriptor>::clone() const {
     return new MomentumExchangeBounceBack<T,Descriptor>(*this);
 }
+
+template<typename T, template<typename U> class Descriptor>
+bool MomentumExchangeBounceBack<T,Descriptor>::isShareable() const {
+    return false;
+}
  
 template<typename T, template<typename U> class Descriptor>
 void MomentumExchangeBounceBack<T,Descriptor>::collide (
@@ -154,6 +159,32 @@ template<typename T, template<typename U> class Descriptor>
 void MomentumExchangeBounceBack<T,Descriptor>::setOmega(T omega_)
 { }
 
+template<typename T, template<typename U> class Descriptor>
+void MomentumExchangeBounceBack<T,Descriptor>::serialize(std::vector<T>& data) const {
+    data.push_back(rho);
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        data.push_back((T)forceIds[iD]);
+    }
+    data.push_back((T)fluidDirections.size());
+    for (pluint iDir=0; iDir<fluidDirections.size(); ++iDir) {
+        data.push_back((T)fluidDirections[iDir]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MomentumExchangeBounceBack<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    PLB_PRECONDITION( pos+2+Descriptor<T>::d <= data.size() );
+    rho = data[pos++];
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        forceIds[iD] = util::roundToInt(data[pos++]);
+    }
+    fluidDirections.resize(util::roundToInt(data[pos++]));
+    PLB_PRECONDITION( pos+fluidDirections.size() <= data.size() );
+    for (pluint iDir=0; iDir<fluidDirections.size(); ++iDir) {
+        fluidDirections[iDir] = util::roundToInt(data[pos++]);
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 T MomentumExchangeBounceBack<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const {
     return Descriptor<T>::rhoBar(rho);
@@ -48,6 +48,9 @@ public:
     /// Clone the object, based on its dynamic type
     virtual BoundaryCompositeDynamics<T,Descriptor>* clone() const;
 
+    /// Boundary dynamics store the boundary values of their cell, and are not shared.
+    virtual bool isShareable() const;
+
 /* *************** Computation of macroscopic variables ************** */
 
     /// Compute the local particle density in lattice units
@@ -119,6 +122,14 @@ public:
     /// Define density. Stores the value inside the Dynamics object.
     virtual void defineDensity(Cell<T,Descriptor>& cell, T rho_);
 
+/* *************** Access to Dynamics variables ********************** */
+
+    /// Serialize the base dynamics and the stored density.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the base dynamics and the stored density.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Additional moments, intended for internal use ***** */
 
     /// Compute order-0 moment rho-bar
@@ -152,6 +163,14 @@ public:
     /// Define velocity. Stores value inside Dynamics object.
     virtual void defineVelocity(Cell<T,Descriptor>& cell, Array<T,Descriptor<T>::d> const& u_);
 
+/* *************** Access to Dynamics variables ********************** */
+
+    /// Serialize the base dynamics and the stored velocity.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the base dynamics and the stored velocity.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Additional moments, intended for internal use ***** */
 
     /// Compute order-0 moment rho-bar
@@ -191,6 +210,14 @@ public:
     /// Define velocity. Stores value inside Dynamics object.
     virtual void defineVelocity(Cell<T,Descriptor>& cell, Array<T,Descriptor<T>::d> const& u_);
 
+/* *************** Access to Dynamics variables ********************** */
+
+    /// Serialize the base dynamics and the stored density and velocity.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the base dynamics and the stored density and velocity.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Additional moments, intended for internal use ***** */
 
     /// Compute order-0 moment rho-bar
@@ -232,6 +259,14 @@ public:
     /// Define density. Stores the value inside the Dynamics object.
     virtual void defineTemperature(Cell<T,Descriptor>& cell, T theta_);
 
+/* *************** Access to Dynamics variables ********************** */
+
+    /// Serialize the base dynamics and the stored temperature and velocity.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the base dynamics and the stored temperature and velocity.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Additional moments, intended for internal use ***** */
 
     /// Compute order-0 moment rho-bar
@@ -44,6 +44,11 @@ BoundaryCompositeDynamics<T,Descriptor>* BoundaryCompositeDynamics<T,Descriptor>
     return new BoundaryCompositeDynamics<T,Descriptor>(*this);
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool BoundaryCompositeDynamics<T,Descriptor>::isShareable() const {
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor>
 T BoundaryCompositeDynamics<T,Descriptor>::computeDensity(Cell<T,Descriptor> const& cell) const {
     Cell<T,Descriptor> tmpCell(cell);
@@ -173,6 +178,19 @@ void StoreDensityDynamics<T,Descriptor>::defineDensity (
     rhoBar = Descriptor<T>::rhoBar(rho_);
 }
 
+template<typename T, template<typename U> class Descriptor>
+void StoreDensityDynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    CompositeDynamics<T,Descriptor>::serialize(data);
+    data.push_back(rhoBar);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void StoreDensityDynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    CompositeDynamics<T,Descriptor>::unserialize(data, pos);
+    PLB_PRECONDITION( pos < data.size() );
+    rhoBar = data[pos++];
+}
+
 template<typename T, template<typename U> class Descriptor>
 T StoreDensityDynamics<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const
 {
@@ -226,6 +244,23 @@ void StoreVelocityDynamics<T,Descriptor>::defineVelocity (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void StoreVelocityDynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    CompositeDynamics<T,Descriptor>::serialize(data);
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        data.push_back(u[iD]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void StoreVelocityDynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    CompositeDynamics<T,Descriptor>::unserialize(data, pos);
+    PLB_PRECONDITION( pos+Descriptor<T>::d <= data.size() );
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        u[iD] = data[pos++];
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 T StoreVelocityDynamics<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const {
     T rho = this->computeDensity(cell);
@@ -296,6 +331,25 @@ void StoreDensityAndVelocityDynamics<T,Descriptor>::defineVelocity (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void StoreDensityAndVelocityDynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    CompositeDynamics<T,Descriptor>::serialize(data);
+    data.push_back(rhoBar);
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        data.push_back(u[iD]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void StoreDensityAndVelocityDynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    CompositeDynamics<T,Descriptor>::unserialize(data, pos);
+    PLB_PRECONDITION( pos+1+Descriptor<T>::d <= data.size() );
+    rhoBar = data[pos++];
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        u[iD] = data[pos++];
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 T StoreDensityAndVelocityDynamics<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const {
     return rhoBar;
@@ -362,6 +416,25 @@ void StoreTemperatureAndVelocityDynamics<T,Descriptor>::defineTemperature (
     thetaBar = theta_ - (T)1;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void StoreTemperatureAndVelocityDynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    CompositeDynamics<T,Descriptor>::serialize(data);
+    data.push_back(thetaBar);
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        data.push_back(u[iD]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void StoreTemperatureAndVelocityDynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    CompositeDynamics<T,Descriptor>::unserialize(data, pos);
+    PLB_PRECONDITION( pos+1+Descriptor<T>::d <= data.size() );
+    thetaBar = data[pos++];
+    for (int iD=0; iD<Descriptor<T>::d; ++iD) {
+        u[iD] = data[pos++];
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 T StoreTemperatureAndVelocityDynamics<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const {
     T rho = this->computeDensity(cell);
@@ -57,6 +57,9 @@ public:
     /// Clone the object on its dynamic type.
     virtual BGKCarreauDynamics<T,Descriptor,N>* clone() const;
 
+    /// The relaxation parameter is modified at each cell, which precludes sharing.
+    virtual bool isShareable() const;
+
 /* *************** Collision and Equilibrium ************************* */
 
     /// Implementation of the collision step
@@ -81,6 +84,9 @@ public:
     /// Clone the object on its dynamic type.
     virtual RegularizedBGKCarreauDynamics<T,Descriptor,N>* clone() const;
 
+    /// The relaxation parameter is modified at each cell, which precludes sharing.
+    virtual bool isShareable() const;
+
 /* *************** Collision and Equilibrium ************************* */
 
     /// Implementation of the collision step
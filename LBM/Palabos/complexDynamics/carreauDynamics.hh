@@ -79,6 +79,11 @@ BGKCarreauDynamics<T,Descriptor,N>* BGKCarreauDynamics<T,Descriptor,N>::clone()
     return new BGKCarreauDynamics<T,Descriptor,N>(*this);
 }
 
+template<typename T, template<typename U> class Descriptor, int N>
+bool BGKCarreauDynamics<T,Descriptor,N>::isShareable() const {
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor, int N>
 void BGKCarreauDynamics<T,Descriptor,N>::collide (
         Cell<T,Descriptor>& cell,
@@ -150,6 +155,11 @@ RegularizedBGKCarreauDynamics<T,Descriptor,N>* RegularizedBGKCarreauDynamics<T,D
     return new RegularizedBGKCarreauDynamics<T,Descriptor,N>(*this);
 }
 
+template<typename T, template<typename U> class Descriptor, int N>
+bool RegularizedBGKCarreauDynamics<T,Descriptor,N>::isShareable() const {
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor, int N>
 void RegularizedBGKCarreauDynamics<T,Descriptor,N>::collide (
         Cell<T,Descriptor>& cell,
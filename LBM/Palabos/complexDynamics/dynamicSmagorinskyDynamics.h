@@ -33,6 +33,10 @@ public:
     ExternalOmegaDynamics(Dynamics<T,Descriptor>* baseDynamics_)
         : CompositeDynamics<T,Descriptor>(baseDynamics_)
     { }
+    /// The relaxation parameter is modified at each cell, which precludes sharing.
+    virtual bool isShareable() const {
+        return false;
+    }
     virtual void prepareCollision(Cell<T,Descriptor>& cell) {
         // Copy relaxation parameter from external scalar.
         this->setOmega(*cell.getExternal(Descriptor<T>::ExternalField::omegaBeginsAt));
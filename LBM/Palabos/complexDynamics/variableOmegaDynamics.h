@@ -34,6 +34,8 @@ template<typename T, template<typename U> class Descriptor>
 class VariableOmegaDynamics : public CompositeDynamics<T,Descriptor> {
 public:
     VariableOmegaDynamics(Dynamics<T,Descriptor>* baseDynamics_);
+    /// The relaxation parameter is modified at each cell, which precludes sharing.
+    virtual bool isShareable() const;
     virtual void prepareCollision(Cell<T,Descriptor>& cell);
     virtual T getOmegaFromCell(Cell<T,Descriptor> const& cell) const =0;
 };
@@ -34,6 +34,11 @@ VariableOmegaDynamics<T,Descriptor>::VariableOmegaDynamics(Dynamics<T,Descriptor
     : CompositeDynamics<T,Descriptor>(baseDynamics_)
 { }
 
+template<typename T, template<typename U> class Descriptor>
+bool VariableOmegaDynamics<T,Descriptor>::isShareable() const {
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void VariableOmegaDynamics<T,Descriptor>::prepareCollision(Cell<T,Descriptor>& cell) {
     this->setOmega(getOmegaFromCell(cell));
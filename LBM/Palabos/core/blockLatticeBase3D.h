@@ -57,8 +57,26 @@ public:
     virtual void incrementTime() =0;
     TimeCounter& getTimeCounter();
     TimeCounter const& getTimeCounter() const;
+    /// Gather the internal statistics only at every period-th time step.
+    /** In between, the collision skips the gathering, no reduction of the
+     *  statistics takes place, and the internal statistics keep the values
+     *  of the last iteration in which they were gathered. Bulk dynamics
+     *  with a statically dispatched collision kernel (see collisionKernels.h)
+     *  then execute a version of the collision without statistics code.
+     *  With a period of 0, statistics are never gathered; quantities like the
+     *  average energy must then be computed on request, with
+     *  computeAverageEnergy() and similar functions.
+     */
+    void setStatisticsPeriod(plint period);
+    plint getStatisticsPeriod() const;
+    /// Tells whether statistics are gathered in the current time step.
+    bool isStatisticsStep() const;
+protected:
+    /// Switch the gathering of the internal statistics on or off.
+    virtual void toggleStatisticsGathering(bool gatheringOn);
 private:
     TimeCounter timeCounter;
+    plint statisticsPeriod;
 };
 
 template<typename T, template<typename U> class Descriptor>
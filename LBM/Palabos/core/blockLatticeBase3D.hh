@@ -35,7 +35,9 @@ namespace plb {
 /////////// class BlockLatticeBase3D //////////////////////////////
 
 template<typename T, template<typename U> class Descriptor>
-BlockLatticeBase3D<T,Descriptor>::BlockLatticeBase3D() {
+BlockLatticeBase3D<T,Descriptor>::BlockLatticeBase3D()
+    : statisticsPeriod(1)
+{
     this->getInternalStatistics().subscribeAverage(); // Subscribe average rho-bar
     this->getInternalStatistics().subscribeAverage(); // Subscribe average uSqr
     this->getInternalStatistics().subscribeMax();     // Subscribe max uSqr
@@ -44,6 +46,7 @@ BlockLatticeBase3D<T,Descriptor>::BlockLatticeBase3D() {
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeBase3D<T,Descriptor>::swap(BlockLatticeBase3D<T,Descriptor>& rhs) {
     std::swap(timeCounter, rhs.timeCounter);
+    std::swap(statisticsPeriod, rhs.statisticsPeriod);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -56,6 +59,28 @@ TimeCounter const& BlockLatticeBase3D<T,Descriptor>::getTimeCounter() const {
     return timeCounter;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeBase3D<T,Descriptor>::setStatisticsPeriod(plint period) {
+    PLB_PRECONDITION( period >= 0 );
+    statisticsPeriod = period;
+    toggleStatisticsGathering(isStatisticsStep());
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLatticeBase3D<T,Descriptor>::getStatisticsPeriod() const {
+    return statisticsPeriod;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BlockLatticeBase3D<T,Descriptor>::isStatisticsStep() const {
+    return statisticsPeriod > 0 && timeCounter.getTime() % (pluint)statisticsPeriod == 0;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeBase3D<T,Descriptor>::toggleStatisticsGathering(bool gatheringOn) {
+    this->getInternalStatistics().toggleGathering(gatheringOn);
+}
+
 /////////// Free Functions //////////////////////////////
 
 template<typename T, template<typename U> class Descriptor>
@@ -87,8 +87,19 @@ public:
     void gatherIntSum(plint whichSum, plint value);
     /// Call this function once all statistics for a cell have been added
     void incrementStats();
+    /// Reset running statistics to default, without modifying the public statistics.
+    void resetRunning();
+    /// Add the running statistics of rhs, which has the same observables, to the present ones.
+    void combineRunning(BlockStatistics<T> const& rhs);
     /// Return number of cells for which statistics have been added so far
     pluint const& getNumCells() const { return numCells; }
+    /// Switch the gathering of statistics on or off.
+    /** While gathering is off, the gather functions have no effect, and
+     *  evaluate() leaves the public statistics unchanged.
+     */
+    void toggleGathering(bool gatheringOn_) { gatheringOn = gatheringOn_; }
+    /// Tells whether statistics are being gathered.
+    bool isGatheringOn() const { return gatheringOn; }
 
     /// Get the public value for any "average observable"
     T getAverage(plint whichAverage) const;
@@ -129,6 +140,8 @@ private:
     std::vector<plint> intSumVect;
     /// Public result for number of cells over which statistics has been computed
     pluint numCells;
+    /// Tells whether the gather functions contribute to the running statistics
+    bool gatheringOn;
 };
 
 }  // namespace plb
@@ -37,7 +37,8 @@ namespace plb {
 
 template<typename T>
 BlockStatistics<T>::BlockStatistics()
-  : tmpNumCells(0)
+  : tmpNumCells(0),
+    gatheringOn(true)
 { }
 
 template<typename T>
@@ -54,6 +55,7 @@ void BlockStatistics<T>::swap(BlockStatistics<T>& rhs)
     maxVect.swap    (rhs.maxVect);
     intSumVect.swap (rhs.intSumVect);
     std::swap(numCells, rhs.numCells);
+    std::swap(gatheringOn, rhs.gatheringOn);
 }
 
 /** In the reset function, running statistics are copied to public statistics,
@@ -61,6 +63,11 @@ void BlockStatistics<T>::swap(BlockStatistics<T>& rhs)
  */
 template<typename T>
 void BlockStatistics<T>::evaluate() {
+    // Nothing has been gathered: keep the public statistics of the last evaluation.
+    if (!gatheringOn) {
+        return;
+    }
+
     // First step: copy running statistics to public statistics
 
     // Avoid division by zero while evaluating average: if no cell has
@@ -88,23 +95,54 @@ void BlockStatistics<T>::evaluate() {
 
     // Second step: reset the running statistics, in order to be ready
     //   for next lattice iteration
-    for (pluint iVect=0; iVect<averageVect.size(); ++iVect) {
+    resetRunning();
+}
+
+template<typename T>
+void BlockStatistics<T>::resetRunning() {
+    for (pluint iVect=0; iVect<tmpAv.size(); ++iVect) {
         tmpAv[iVect]     = T();
     }
-    for (pluint iVect=0; iVect<sumVect.size(); ++iVect) {
+    for (pluint iVect=0; iVect<tmpSum.size(); ++iVect) {
         tmpSum[iVect]    = T();
     }
-    for (pluint iVect=0; iVect<maxVect.size(); ++iVect) {
+    for (pluint iVect=0; iVect<tmpMax.size(); ++iVect) {
         // Use -max() instead of min(), because min<float> yields a positive value close to zero.
         tmpMax[iVect]    = -std::numeric_limits<T>::max();
     }
-    for (pluint iVect=0; iVect<intSumVect.size(); ++iVect) {
+    for (pluint iVect=0; iVect<tmpIntSum.size(); ++iVect) {
         tmpIntSum[iVect] = 0;
     }
 
     tmpNumCells = 0;
 }
 
+/** This is used to merge statistics which have been gathered separately, for
+ *  example by different threads, on disjoint parts of a block.
+ */
+template<typename T>
+void BlockStatistics<T>::combineRunning(BlockStatistics<T> const& rhs) {
+    PLB_PRECONDITION( tmpAv.size()     == rhs.tmpAv.size() );
+    PLB_PRECONDITION( tmpSum.size()    == rhs.tmpSum.size() );
+    PLB_PRECONDITION( tmpMax.size()    == rhs.tmpMax.size() );
+    PLB_PRECONDITION( tmpIntSum.size() == rhs.tmpIntSum.size() );
+    for (pluint iVect=0; iVect<tmpAv.size(); ++iVect) {
+        tmpAv[iVect] += rhs.tmpAv[iVect];
+    }
+    for (pluint iVect=0; iVect<tmpSum.size(); ++iVect) {
+        tmpSum[iVect] += rhs.tmpSum[iVect];
+    }
+    for (pluint iVect=0; iVect<tmpMax.size(); ++iVect) {
+        if (rhs.tmpMax[iVect] > tmpMax[iVect]) {
+            tmpMax[iVect] = rhs.tmpMax[iVect];
+        }
+    }
+    for (pluint iVect=0; iVect<tmpIntSum.size(); ++iVect) {
+        tmpIntSum[iVect] += rhs.tmpIntSum[iVect];
+    }
+    tmpNumCells += rhs.tmpNumCells;
+}
+
 template<typename T>
 void BlockStatistics<T>::evaluate (
         std::vector<T> const& average, std::vector<T> const& sum,
@@ -191,18 +229,21 @@ plint BlockStatistics<T>::subscribeIntSum() {
 
 template<typename T>
 void BlockStatistics<T>::gatherAverage(plint whichAverage, T value) {
+    if (!gatheringOn) return;
     PLB_PRECONDITION( whichAverage < (plint) tmpAv.size() );
     tmpAv[whichAverage] += value;
 }
 
 template<typename T>
 void BlockStatistics<T>::gatherSum(plint whichSum, T value) {
+    if (!gatheringOn) return;
     PLB_PRECONDITION( whichSum < (plint) tmpSum.size() );
     tmpSum[whichSum] += value;
 }
 
 template<typename T>
 void BlockStatistics<T>::gatherMax(plint whichMax, T value) {
+    if (!gatheringOn) return;
     PLB_PRECONDITION( whichMax < (plint) tmpMax.size() );
     if (value > tmpMax[whichMax]) {
         tmpMax[whichMax] = value;
@@ -211,12 +252,14 @@ void BlockStatistics<T>::gatherMax(plint whichMax, T value) {
 
 template<typename T>
 void BlockStatistics<T>::gatherIntSum(plint whichSum, plint value) {
+    if (!gatheringOn) return;
     PLB_PRECONDITION( whichSum < (plint) tmpIntSum.size() );
     tmpIntSum[whichSum] += value;
 }
 
 template<typename T>
 void BlockStatistics<T>::incrementStats() {
+    if (!gatheringOn) return;
     ++tmpNumCells;
 }
 
@@ -0,0 +1,149 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Statically dispatched collision kernels for runs of cells which share
+ * the same dynamics object -- header file.
+ */
+#ifndef COLLISION_KERNELS_H
+#define COLLISION_KERNELS_H
+
+#include "core/globalDefs.h"
+#include "core/blockStatistics.h"
+#include <typeinfo>
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+template<typename T, template<typename U> class Descriptor> class Cell;
+
+/// Executes the collision step on a run of cells sharing the same dynamics object.
+template<typename T, template<typename U> class Descriptor>
+struct CollisionKernel {
+    virtual ~CollisionKernel() { }
+    /// Collide numCells contiguous cells, which all point to the object dynamics.
+    virtual void collide( Dynamics<T,Descriptor>& dynamics, Cell<T,Descriptor>* cells,
+                          plint numCells, BlockStatistics<T>& statistics ) const =0;
+    /// Collide numCells contiguous cells without gathering statistics.
+    /** By default, collide() is executed with statistics on which gathering is off. */
+    virtual void collideWithoutStatistics( Dynamics<T,Descriptor>& dynamics,
+                                           Cell<T,Descriptor>* cells, plint numCells ) const;
+    /// Tells whether the kernel can collide cells stored in a structure-of-arrays
+    ///   layout through collideArrays(). By default, it can't.
+    virtual bool collidesArrays() const;
+    /// Collide numCells contiguous cells stored in a structure-of-arrays layout.
+    /** f[iPop] points to population iPop of the first cell. If they are
+     *  non-null, the arrays rhoBar and uSqr receive the value of rhoBar and of
+     *  the squared velocity of each cell, for use in the statistics. This
+     *  method may only be called if collidesArrays() returns true.
+     */
+    virtual void collideArrays( Dynamics<T,Descriptor>& dynamics, T* const* f, plint numCells,
+                                T* rhoBar, T* uSqr ) const;
+};
+
+/// Collision kernel for which the dynamic type of the dynamics is known statically.
+/** Within the run, the call to DynamicsT::collide is non-virtual, and can
+ *  therefore be inlined by the compiler. DynamicsT must be the exact dynamic
+ *  type of the dynamics objects to which the kernel is applied.
+ *  Without statistics, DynamicsT::collideWithoutStatistics is inlined
+ *  instead, so that the kernel contains no statistics code at all.
+ */
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+struct StaticCollisionKernel : public CollisionKernel<T,Descriptor> {
+    virtual void collide( Dynamics<T,Descriptor>& dynamics, Cell<T,Descriptor>* cells,
+                          plint numCells, BlockStatistics<T>& statistics ) const;
+    virtual void collideWithoutStatistics( Dynamics<T,Descriptor>& dynamics,
+                                           Cell<T,Descriptor>* cells, plint numCells ) const;
+};
+
+/// Static collision kernel which, in addition, collides cells stored in a
+///   structure-of-arrays layout through DynamicsT::collideArrays.
+/** DynamicsT::collideArrays(f, numCells, rhoBar, uSqr) must have the same
+ *  signature as CollisionKernel::collideArrays(), without the dynamics, and
+ *  yield the same result as DynamicsT::collide(), up to round-off.
+ */
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+struct BatchedCollisionKernel : public StaticCollisionKernel<T,Descriptor,DynamicsT> {
+    virtual bool collidesArrays() const;
+    virtual void collideArrays( Dynamics<T,Descriptor>& dynamics, T* const* f, plint numCells,
+                                T* rhoBar, T* uSqr ) const;
+};
+
+/// Associates dynamics classes with statically dispatched collision kernels.
+/** A kernel is applied only to a dynamics object whose dynamic type is exactly
+ *  the registered type, so that classes derived from a registered dynamics
+ *  are not affected.
+ */
+template<typename T, template<typename U> class Descriptor>
+class CollisionKernelRegistry {
+public:
+    ~CollisionKernelRegistry();
+    /// Register a kernel for a dynamics class, and take ownership of it.
+    void registerKernel(std::type_info const& dynamicsType, CollisionKernel<T,Descriptor>* kernel);
+    /// Get the kernel for the dynamic type of dynamics, or 0 if there is none.
+    CollisionKernel<T,Descriptor> const* find(Dynamics<T,Descriptor> const& dynamics) const;
+    /// Switch statically dispatched collisions on or off (they are on by default).
+    void toggleStaticDispatch(bool staticDispatch_);
+    bool isStaticDispatchOn() const;
+private:
+    CollisionKernelRegistry();
+    CollisionKernelRegistry(CollisionKernelRegistry<T,Descriptor> const& rhs);
+    CollisionKernelRegistry<T,Descriptor>& operator=(CollisionKernelRegistry<T,Descriptor> const& rhs);
+private:
+    std::vector<std::type_info const*> types;
+    std::vector<CollisionKernel<T,Descriptor>*> kernels;
+    bool staticDispatch;
+template<typename T_, template<typename U_> class Descriptor_>
+    friend CollisionKernelRegistry<T_,Descriptor_>& collisionKernelRegistry();
+};
+
+/// Access to the registry of collision kernels.
+/** The standard BGK-type dynamics register their kernels as soon as they
+ *  are instantiated (see isoThermalDynamics.h).
+ */
+template<typename T, template<typename U> class Descriptor>
+CollisionKernelRegistry<T,Descriptor>& collisionKernelRegistry();
+
+/// Register a statically dispatched collision kernel for the dynamics class DynamicsT.
+/** The return value is always true; it can be used to initialize a static
+ *  data member of DynamicsT, so that the kernel is registered at program start.
+ */
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+bool registerStaticCollisionKernel();
+
+/// Register a batched collision kernel (see BatchedCollisionKernel) for the dynamics class DynamicsT.
+/** The return value is always true, as for registerStaticCollisionKernel(). */
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+bool registerBatchedCollisionKernel();
+
+/// Collide a contiguous range of cells.
+/** Runs of cells which share the same dynamics object are handed to the
+ *  collision kernel registered for the type of this dynamics, if there is
+ *  one. All other cells are collided through a virtual call to their dynamics.
+ *  If gathering is switched off on the statistics, the kernels are executed
+ *  in their version without statistics.
+ */
+template<typename T, template<typename U> class Descriptor>
+void collideCellRange(Cell<T,Descriptor>* cells, plint numCells, BlockStatistics<T>& statistics);
+
+}  // namespace plb
+
+#endif  // COLLISION_KERNELS_H
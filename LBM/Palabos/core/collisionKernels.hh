@@ -0,0 +1,211 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Statically dispatched collision kernels for runs of cells which share
+ * the same dynamics object -- generic implementation.
+ */
+#ifndef COLLISION_KERNELS_HH
+#define COLLISION_KERNELS_HH
+
+#include "core/collisionKernels.h"
+#include "core/plbDebug.h"
+#include "core/dynamics.h"
+#include "core/cell.h"
+
+namespace plb {
+
+////////////////////// Class CollisionKernel /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+void CollisionKernel<T,Descriptor>::collideWithoutStatistics (
+        Dynamics<T,Descriptor>& dynamics, Cell<T,Descriptor>* cells, plint numCells ) const
+{
+    BlockStatistics<T> statistics;
+    statistics.toggleGathering(false);
+    collide(dynamics, cells, numCells, statistics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool CollisionKernel<T,Descriptor>::collidesArrays() const {
+    return false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CollisionKernel<T,Descriptor>::collideArrays (
+        Dynamics<T,Descriptor>&, T* const*, plint, T*, T* ) const
+{
+    PLB_ASSERT( false );
+}
+
+////////////////////// Class StaticCollisionKernel /////////////////////////
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+void StaticCollisionKernel<T,Descriptor,DynamicsT>::collide (
+        Dynamics<T,Descriptor>& dynamics, Cell<T,Descriptor>* cells,
+        plint numCells, BlockStatistics<T>& statistics ) const
+{
+    DynamicsT& staticDynamics = static_cast<DynamicsT&>(dynamics);
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        // Qualified call: no virtual dispatch inside the loop.
+        staticDynamics.DynamicsT::collide(cells[iCell], statistics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+void StaticCollisionKernel<T,Descriptor,DynamicsT>::collideWithoutStatistics (
+        Dynamics<T,Descriptor>& dynamics, Cell<T,Descriptor>* cells, plint numCells ) const
+{
+    DynamicsT& staticDynamics = static_cast<DynamicsT&>(dynamics);
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        staticDynamics.DynamicsT::collideWithoutStatistics(cells[iCell]);
+    }
+}
+
+////////////////////// Class BatchedCollisionKernel /////////////////////////
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+bool BatchedCollisionKernel<T,Descriptor,DynamicsT>::collidesArrays() const {
+    return true;
+}
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+void BatchedCollisionKernel<T,Descriptor,DynamicsT>::collideArrays (
+        Dynamics<T,Descriptor>& dynamics, T* const* f, plint numCells,
+        T* rhoBar, T* uSqr ) const
+{
+    static_cast<DynamicsT&>(dynamics).DynamicsT::collideArrays(f, numCells, rhoBar, uSqr);
+}
+
+////////////////////// Class CollisionKernelRegistry /////////////////////////
+
+/** The registry is pre-filled with the kernel of NoDynamics. The bulk
+ *  dynamics of higher layers register their own kernels, through a static
+ *  data member initialized by registerStaticCollisionKernel().
+ */
+template<typename T, template<typename U> class Descriptor>
+CollisionKernelRegistry<T,Descriptor>::CollisionKernelRegistry()
+    : staticDispatch(true)
+{
+    registerKernel( typeid(NoDynamics<T,Descriptor>),
+                    new StaticCollisionKernel<T,Descriptor,NoDynamics<T,Descriptor> > );
+}
+
+template<typename T, template<typename U> class Descriptor>
+CollisionKernelRegistry<T,Descriptor>::~CollisionKernelRegistry() {
+    for (pluint iKernel=0; iKernel<kernels.size(); ++iKernel) {
+        delete kernels[iKernel];
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CollisionKernelRegistry<T,Descriptor>::registerKernel (
+        std::type_info const& dynamicsType, CollisionKernel<T,Descriptor>* kernel )
+{
+    for (pluint iKernel=0; iKernel<types.size(); ++iKernel) {
+        if (*types[iKernel] == dynamicsType) {
+            delete kernels[iKernel];
+            kernels[iKernel] = kernel;
+            return;
+        }
+    }
+    types.push_back(&dynamicsType);
+    kernels.push_back(kernel);
+}
+
+template<typename T, template<typename U> class Descriptor>
+CollisionKernel<T,Descriptor> const* CollisionKernelRegistry<T,Descriptor>::find (
+        Dynamics<T,Descriptor> const& dynamics ) const
+{
+    if (staticDispatch) {
+        std::type_info const& dynamicsType = typeid(dynamics);
+        for (pluint iKernel=0; iKernel<types.size(); ++iKernel) {
+            if (*types[iKernel] == dynamicsType) {
+                return kernels[iKernel];
+            }
+        }
+    }
+    return 0;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CollisionKernelRegistry<T,Descriptor>::toggleStaticDispatch(bool staticDispatch_) {
+    staticDispatch = staticDispatch_;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool CollisionKernelRegistry<T,Descriptor>::isStaticDispatchOn() const {
+    return staticDispatch;
+}
+
+template<typename T, template<typename U> class Descriptor>
+CollisionKernelRegistry<T,Descriptor>& collisionKernelRegistry() {
+    static CollisionKernelRegistry<T,Descriptor> registry;
+    return registry;
+}
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+bool registerStaticCollisionKernel() {
+    collisionKernelRegistry<T,Descriptor>().registerKernel (
+            typeid(DynamicsT), new StaticCollisionKernel<T,Descriptor,DynamicsT> );
+    return true;
+}
+
+template<typename T, template<typename U> class Descriptor, class DynamicsT>
+bool registerBatchedCollisionKernel() {
+    collisionKernelRegistry<T,Descriptor>().registerKernel (
+            typeid(DynamicsT), new BatchedCollisionKernel<T,Descriptor,DynamicsT> );
+    return true;
+}
+
+/** The cost of the type lookup is amortized over a run of cells, and is only
+ *  paid when the run contains more than one cell.
+ */
+template<typename T, template<typename U> class Descriptor>
+void collideCellRange(Cell<T,Descriptor>* cells, plint numCells, BlockStatistics<T>& statistics)
+{
+    CollisionKernelRegistry<T,Descriptor> const& registry = collisionKernelRegistry<T,Descriptor>();
+    bool gatheringOn = statistics.isGatheringOn();
+    plint iCell=0;
+    while (iCell<numCells) {
+        Dynamics<T,Descriptor>& dynamics = cells[iCell].getDynamics();
+        plint runEnd = iCell+1;
+        while (runEnd<numCells && &cells[runEnd].getDynamics()==&dynamics) {
+            ++runEnd;
+        }
+        CollisionKernel<T,Descriptor> const* kernel = runEnd-iCell>1 ? registry.find(dynamics) : 0;
+        if (kernel && gatheringOn) {
+            kernel->collide(dynamics, cells+iCell, runEnd-iCell, statistics);
+        }
+        else if (kernel) {
+            kernel->collideWithoutStatistics(dynamics, cells+iCell, runEnd-iCell);
+        }
+        else {
+            for (plint jCell=iCell; jCell<runEnd; ++jCell) {
+                cells[jCell].collide(statistics);
+            }
+        }
+        iCell = runEnd;
+    }
+}
+
+}  // namespace plb
+
+#endif  // COLLISION_KERNELS_HH
@@ -61,12 +61,21 @@ struct Dynamics {
     /// Clone and produce an object which can be used as base dynamics for a CompositeDynamics
     virtual Dynamics<T,Descriptor>* cloneComposeable() const;
 
+    /// Tells whether a single object can be shared by several cells (see DynamicsRegistry).
+    /** This is the case by default. Dynamics which store per-cell values, or
+     *  which modify their own parameters during collision, must return false.
+     */
+    virtual bool isShareable() const;
+
 /* *************** Collision, Equilibrium, and Non-equilibrium ************** */
 
     /// Implementation of the collision step
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics<T>& statistics_) =0;
 
+    /// Implementation of the collision step, without gathering of statistics
+    virtual void collideWithoutStatistics(Cell<T,Descriptor>& cell);
+
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const =0;
@@ -110,6 +119,15 @@ struct Dynamics {
     /// Set local value of any generic parameter
     virtual void setParameter(plint whichParameter, T value);
 
+    /// Append the state of the object to a serial stream (see DynamicsPrototypes).
+    /** By default, this is the relaxation parameter. Dynamics which store
+     *  other per-cell values, like a boundary velocity, append them as well.
+     */
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Restore the state written by serialize(), starting at position pos, which is advanced.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Switch between population and moment representation ****** */
 
     /// Number of variables required to decompose a population representation into moments.
@@ -303,6 +321,8 @@ public:
     virtual void replaceBaseDynamics(Dynamics<T,Descriptor>* newBaseDynamics);
     Dynamics<T,Descriptor>& getBaseDynamics();
     Dynamics<T,Descriptor> const& getBaseDynamics() const;
+    /// A composite dynamics is shareable if its base dynamics is.
+    virtual bool isShareable() const;
 
 /* *************** Methods to be overloaded to configure behavior  ********** */
 
@@ -396,6 +416,12 @@ public:
     /// Set local value of any generic parameter
     virtual void setParameter(plint whichParameter, T value);
 
+    /// Serialize the state of the base dynamics.
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the state of the base dynamics.
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Access Cell raw data through Dynamics ********************* */
 
     /// Access particle populations through the dynamics object.
@@ -505,6 +531,12 @@ public:
     /// Does nothing
     virtual void setOmega(T omega_);
 
+    /// Serialize the fictitious density
+    virtual void serialize(std::vector<T>& data) const;
+
+    /// Unserialize the fictitious density
+    virtual void unserialize(std::vector<T> const& data, pluint& pos);
+
 /* *************** Switch between population and moment representation ****** */
 
     /// Yields Descriptor<T>::q + Descriptor<T>::ExternalField::numScalars.
@@ -44,6 +44,22 @@ Dynamics<T,Descriptor>* Dynamics<T,Descriptor>::cloneComposeable() const {
     return clone();
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool Dynamics<T,Descriptor>::isShareable() const {
+    return true;
+}
+
+/* By default, this method executes collide() with statistics on which
+ * gathering is switched off. Bulk dynamics override it with a version
+ * which does not compute the statistics in the first place.
+ */
+template<typename T, template<typename U> class Descriptor>
+void Dynamics<T,Descriptor>::collideWithoutStatistics(Cell<T,Descriptor>& cell) {
+    BlockStatistics<T> statistics;
+    statistics.toggleGathering(false);
+    collide(cell, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 T Dynamics<T,Descriptor>::getParameter(plint whichParameter) const {
     if (whichParameter == dynamicParams::omega_shear) {
@@ -59,6 +75,17 @@ void Dynamics<T,Descriptor>::setParameter(plint whichParameter, T value) {
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void Dynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    data.push_back(getOmega());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void Dynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    PLB_PRECONDITION( pos < data.size() );
+    setOmega(data[pos++]);
+}
+
 
 template<typename T, template<typename U> class Descriptor>
 void Dynamics<T,Descriptor>::getPopulations(Cell<T,Descriptor> const& cell, Array<T,Descriptor<T>::q>& f) const {
@@ -313,6 +340,11 @@ Dynamics<T,Descriptor> const& CompositeDynamics<T,Descriptor>::getBaseDynamics()
     return *baseDynamics;
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool CompositeDynamics<T,Descriptor>::isShareable() const {
+    return baseDynamics->isShareable();
+}
+
 template<typename T, template<typename U> class Descriptor>
 void CompositeDynamics<T,Descriptor>::collide (
         Cell<T,Descriptor>& cell, BlockStatistics<T>& statistics )
@@ -451,6 +483,16 @@ void CompositeDynamics<T,Descriptor>::setParameter(plint whichParameter, T value
     baseDynamics -> setParameter(whichParameter, value);
 }
 
+template<typename T, template<typename U> class Descriptor>
+void CompositeDynamics<T,Descriptor>::serialize(std::vector<T>& data) const {
+    baseDynamics -> serialize(data);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CompositeDynamics<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    baseDynamics -> unserialize(data, pos);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void CompositeDynamics<T,Descriptor>::getPopulations(Cell<T,Descriptor> const& cell, Array<T,Descriptor<T>::q>& f) const {
     baseDynamics -> getPopulations(cell, f);
@@ -584,6 +626,17 @@ template<typename T, template<typename U> class Descriptor>
 void BounceBack<T,Descriptor>::setOmega(T omega_)
 { }
 
+template<typename T, template<typename U> class Descriptor>
+void BounceBack<T,Descriptor>::serialize(std::vector<T>& data) const {
+    data.push_back(rho);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BounceBack<T,Descriptor>::unserialize(std::vector<T> const& data, pluint& pos) {
+    PLB_PRECONDITION( pos < data.size() );
+    rho = data[pos++];
+}
+
 template<typename T, template<typename U> class Descriptor>
 T BounceBack<T,Descriptor>::computeRhoBar(Cell<T,Descriptor> const& cell) const {
     return Descriptor<T>::rhoBar(rho);
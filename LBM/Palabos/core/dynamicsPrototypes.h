@@ -0,0 +1,87 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Prototypes from which dynamics objects are re-created, e.g. on another process -- header file.
+ */
+#ifndef DYNAMICS_PROTOTYPES_H
+#define DYNAMICS_PROTOTYPES_H
+
+#include "core/globalDefs.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+
+/// Prototypes of the dynamics classes, by which a dynamics object can be re-created from its type.
+/** Dynamics objects cannot be transmitted between processes as such. A
+ *  dynamics is instead described by its type chain, the names of its dynamic
+ *  type and of the types of its base dynamics, and by its state, as written
+ *  by Dynamics::serialize(). It is re-created by cloning the prototypes of
+ *  the types in the chain, and by restoring the state with
+ *  Dynamics::unserialize(). Parameters which are not part of the state are
+ *  those of the prototype.
+ *
+ *  In a parallel program, the prototypes must be registered on all
+ *  processes. This is done automatically for the dynamics which are
+ *  attributed through defineDynamics() and setCompositeDynamics(), and for
+ *  the background dynamics of a MultiBlockLattice3D, because these are
+ *  constructed by all processes. A dynamics which is attributed to a single
+ *  cell through Cell::defineDynamics() must be registered by hand.
+ */
+template<typename T, template<typename U> class Descriptor>
+class DynamicsPrototypes {
+public:
+    ~DynamicsPrototypes();
+    /// Register a clone of a dynamics as the prototype of its dynamic type.
+    /** If the dynamics is composite, its base dynamics are registered as well.
+     *  A previously registered prototype of the same type is replaced.
+     */
+    void registerPrototype(Dynamics<T,Descriptor> const& dynamics);
+    /// Names of the dynamic type of a dynamics and of its base dynamics, from outer to inner.
+    static void getTypeChain(Dynamics<T,Descriptor> const& dynamics, std::vector<std::string>& chain);
+    /// Tells whether a prototype is registered for all types of a chain.
+    bool isKnown(std::vector<std::string> const& chain) const;
+    /// Create a dynamics object of a given type chain, with the state of the prototypes.
+    /** Returns 0 if one of the types has no prototype. */
+    Dynamics<T,Descriptor>* create(std::vector<std::string> const& chain) const;
+    /// Number of registered prototypes.
+    plint getNumPrototypes() const;
+private:
+    DynamicsPrototypes();
+    DynamicsPrototypes(DynamicsPrototypes<T,Descriptor> const& rhs);
+    DynamicsPrototypes<T,Descriptor>& operator=(DynamicsPrototypes<T,Descriptor> const& rhs);
+private:
+    typedef std::map<std::string, Dynamics<T,Descriptor>*> PrototypeMap;
+    PrototypeMap prototypes;
+template<typename T_, template<typename U_> class Descriptor_>
+    friend DynamicsPrototypes<T_,Descriptor_>& dynamicsPrototypes();
+};
+
+/// Access to the prototypes of the dynamics classes.
+template<typename T, template<typename U> class Descriptor>
+DynamicsPrototypes<T,Descriptor>& dynamicsPrototypes();
+
+}  // namespace plb
+
+#endif  // DYNAMICS_PROTOTYPES_H
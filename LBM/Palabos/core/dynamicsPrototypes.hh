@@ -0,0 +1,120 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Prototypes from which dynamics objects are re-created, e.g. on another process -- generic implementation.
+ */
+#ifndef DYNAMICS_PROTOTYPES_HH
+#define DYNAMICS_PROTOTYPES_HH
+
+#include "core/dynamicsPrototypes.h"
+#include "core/dynamics.h"
+#include "core/plbDebug.h"
+#include <typeinfo>
+
+namespace plb {
+
+////////////////////// Class DynamicsPrototypes /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsPrototypes<T,Descriptor>::DynamicsPrototypes()
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsPrototypes<T,Descriptor>::~DynamicsPrototypes() {
+    for (typename PrototypeMap::iterator it = prototypes.begin(); it != prototypes.end(); ++it) {
+        delete it->second;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsPrototypes<T,Descriptor>::registerPrototype(Dynamics<T,Descriptor> const& dynamics) {
+    Dynamics<T,Descriptor>*& prototype = prototypes[typeid(dynamics).name()];
+    delete prototype;
+    prototype = dynamics.clone();
+    CompositeDynamics<T,Descriptor> const* composite
+        = dynamic_cast<CompositeDynamics<T,Descriptor> const*>(&dynamics);
+    if (composite) {
+        registerPrototype(composite->getBaseDynamics());
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsPrototypes<T,Descriptor>::getTypeChain (
+        Dynamics<T,Descriptor> const& dynamics, std::vector<std::string>& chain )
+{
+    chain.clear();
+    Dynamics<T,Descriptor> const* current = &dynamics;
+    while (current) {
+        chain.push_back(typeid(*current).name());
+        CompositeDynamics<T,Descriptor> const* composite
+            = dynamic_cast<CompositeDynamics<T,Descriptor> const*>(current);
+        current = composite ? &composite->getBaseDynamics() : 0;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool DynamicsPrototypes<T,Descriptor>::isKnown(std::vector<std::string> const& chain) const {
+    if (chain.empty()) {
+        return false;
+    }
+    for (pluint iType=0; iType<chain.size(); ++iType) {
+        if (prototypes.find(chain[iType]) == prototypes.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** The chain is re-assembled from the inside out: the innermost type is
+ *  cloned, and each enclosing composite dynamics is cloned with the result
+ *  as its new base dynamics.
+ */
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* DynamicsPrototypes<T,Descriptor>::create (
+        std::vector<std::string> const& chain ) const
+{
+    if (!isKnown(chain)) {
+        return 0;
+    }
+    Dynamics<T,Descriptor>* dynamics = prototypes.find(chain.back())->second->clone();
+    for (plint iType=(plint)chain.size()-2; iType>=0; --iType) {
+        CompositeDynamics<T,Descriptor> const* composite
+            = dynamic_cast<CompositeDynamics<T,Descriptor> const*>(prototypes.find(chain[iType])->second);
+        PLB_ASSERT( composite );
+        dynamics = composite->cloneWithNewBase(dynamics);
+    }
+    return dynamics;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint DynamicsPrototypes<T,Descriptor>::getNumPrototypes() const {
+    return (plint)prototypes.size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsPrototypes<T,Descriptor>& dynamicsPrototypes() {
+    static DynamicsPrototypes<T,Descriptor> registry;
+    return registry;
+}
+
+}  // namespace plb
+
+#endif  // DYNAMICS_PROTOTYPES_HH
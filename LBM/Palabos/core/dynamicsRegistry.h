@@ -0,0 +1,87 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Reference-counted dynamics objects shared by several cells of a lattice -- header file.
+ */
+#ifndef DYNAMICS_REGISTRY_H
+#define DYNAMICS_REGISTRY_H
+
+#include "core/globalDefs.h"
+#include <map>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+
+/// Set of dynamics objects which are shared by several cells of a lattice.
+/** By default, each non-background dynamics object of a lattice is owned by
+ *  exactly one cell. A dynamics which is registered through share() can
+ *  instead be attributed to any number of cells of the lattice. The registry
+ *  counts these cells, and deletes the object when the last of them receives
+ *  another dynamics. All remaining objects are deleted with the registry.
+ *
+ *  Only dynamics for which Dynamics::isShareable() is true can be shared:
+ *  as all cells refer to the same object, a change of its parameters (e.g.
+ *  through setOmega()) affects all of them.
+ */
+template<typename T, template<typename U> class Descriptor>
+class DynamicsRegistry {
+public:
+    typedef std::map<Dynamics<T,Descriptor> const*, Dynamics<T,Descriptor>*> CloneMap;
+public:
+    DynamicsRegistry();
+    ~DynamicsRegistry();
+    void swap(DynamicsRegistry<T,Descriptor>& rhs);
+public:
+    /// Register a shareable dynamics, and take ownership of it.
+    /** If the object is already registered, nothing happens. */
+    Dynamics<T,Descriptor>* share(Dynamics<T,Descriptor>* dynamics);
+    /// Tells whether a dynamics object is registered as shared.
+    bool isShared(Dynamics<T,Descriptor> const* dynamics) const;
+    /// Count one more cell referring to a dynamics, if it is shared.
+    void acquire(Dynamics<T,Descriptor>* dynamics);
+    /// Count one cell less referring to a dynamics, if it is shared.
+    /** A shared dynamics is deleted when no cell refers to it any more,
+     *  a dynamics which is not shared is deleted right away.
+     */
+    void release(Dynamics<T,Descriptor>* dynamics);
+    /// Clone a dynamics of another lattice, and acquire the clone for a cell of this one.
+    /** If the dynamics is shared in origin, it is cloned only on its first
+     *  occurrence (as recorded in clones), and the clone is shared in this registry.
+     */
+    Dynamics<T,Descriptor>* duplicate( Dynamics<T,Descriptor> const& dynamics,
+                                       DynamicsRegistry<T,Descriptor> const& origin,
+                                       CloneMap& clones );
+    /// Number of cells which refer to a shared dynamics.
+    plint getNumReferences(Dynamics<T,Descriptor> const* dynamics) const;
+    /// Number of shared dynamics objects.
+    plint getNumShared() const;
+private:
+    DynamicsRegistry(DynamicsRegistry<T,Descriptor> const& rhs);
+    DynamicsRegistry<T,Descriptor>& operator=(DynamicsRegistry<T,Descriptor> const& rhs);
+private:
+    typedef std::map<Dynamics<T,Descriptor> const*, plint> CountMap;
+    CountMap numReferences;
+};
+
+}  // namespace plb
+
+#endif  // DYNAMICS_REGISTRY_H
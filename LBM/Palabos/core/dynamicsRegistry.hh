@@ -0,0 +1,119 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Reference-counted dynamics objects shared by several cells of a lattice -- generic implementation.
+ */
+#ifndef DYNAMICS_REGISTRY_HH
+#define DYNAMICS_REGISTRY_HH
+
+#include "core/dynamicsRegistry.h"
+#include "core/dynamics.h"
+#include "core/plbDebug.h"
+
+namespace plb {
+
+////////////////////// Class DynamicsRegistry /////////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsRegistry<T,Descriptor>::DynamicsRegistry()
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsRegistry<T,Descriptor>::~DynamicsRegistry() {
+    for (typename CountMap::iterator it = numReferences.begin(); it != numReferences.end(); ++it) {
+        delete it->first;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsRegistry<T,Descriptor>::swap(DynamicsRegistry<T,Descriptor>& rhs) {
+    numReferences.swap(rhs.numReferences);
+}
+
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* DynamicsRegistry<T,Descriptor>::share(Dynamics<T,Descriptor>* dynamics) {
+    PLB_PRECONDITION( dynamics->isShareable() );
+    numReferences.insert(typename CountMap::value_type(dynamics, 0));
+    return dynamics;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool DynamicsRegistry<T,Descriptor>::isShared(Dynamics<T,Descriptor> const* dynamics) const {
+    return numReferences.find(dynamics) != numReferences.end();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsRegistry<T,Descriptor>::acquire(Dynamics<T,Descriptor>* dynamics) {
+    typename CountMap::iterator it = numReferences.find(dynamics);
+    if (it != numReferences.end()) {
+        ++it->second;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsRegistry<T,Descriptor>::release(Dynamics<T,Descriptor>* dynamics) {
+    typename CountMap::iterator it = numReferences.find(dynamics);
+    if (it == numReferences.end()) {
+        delete dynamics;
+    }
+    else if (--it->second <= 0) {
+        numReferences.erase(it);
+        delete dynamics;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* DynamicsRegistry<T,Descriptor>::duplicate (
+        Dynamics<T,Descriptor> const& dynamics,
+        DynamicsRegistry<T,Descriptor> const& origin, CloneMap& clones )
+{
+    Dynamics<T,Descriptor>* clone = 0;
+    if (origin.isShared(&dynamics)) {
+        typename CloneMap::iterator it = clones.find(&dynamics);
+        if (it == clones.end()) {
+            clone = share(dynamics.clone());
+            clones[&dynamics] = clone;
+        }
+        else {
+            clone = it->second;
+        }
+    }
+    else {
+        clone = dynamics.clone();
+    }
+    acquire(clone);
+    return clone;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint DynamicsRegistry<T,Descriptor>::getNumReferences(Dynamics<T,Descriptor> const* dynamics) const {
+    typename CountMap::const_iterator it = numReferences.find(dynamics);
+    return it == numReferences.end() ? 0 : it->second;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint DynamicsRegistry<T,Descriptor>::getNumShared() const {
+    return (plint)numReferences.size();
+}
+
+}  // namespace plb
+
+#endif  // DYNAMICS_REGISTRY_HH
@@ -27,7 +27,10 @@ namespace global {
 IOpolicyClass::IOpolicyClass()
     : streamOrdering(IndexOrdering::forward),
       endianSwitchOnBase64out(false),
-      endianSwitchOnBase64in(false)
+      endianSwitchOnBase64in(false),
+      blockwiseSerialization(true),
+      vtkEncoding(VtkEncoding::base64),
+      vtkSinglePrecision(false)
 { }
 
 void IOpolicyClass::setIndexOrderingForStreams(IndexOrdering::OrderingT streamOrdering_) {
@@ -54,6 +57,30 @@ bool IOpolicyClass::getEndianSwitchOnBase64in() {
     return endianSwitchOnBase64in;
 }
 
+void IOpolicyClass::setBlockwiseSerialization(bool blockwise) {
+    blockwiseSerialization = blockwise;
+}
+
+bool IOpolicyClass::getBlockwiseSerialization() const {
+    return blockwiseSerialization;
+}
+
+void IOpolicyClass::setVtkEncoding(VtkEncoding::EncodingT vtkEncoding_) {
+    vtkEncoding = vtkEncoding_;
+}
+
+VtkEncoding::EncodingT IOpolicyClass::getVtkEncoding() const {
+    return vtkEncoding;
+}
+
+void IOpolicyClass::setVtkSinglePrecision(bool singlePrecision) {
+    vtkSinglePrecision = singlePrecision;
+}
+
+bool IOpolicyClass::getVtkSinglePrecision() const {
+    return vtkSinglePrecision;
+}
+
   
 /** Directories are default initialized to working directory.
  */
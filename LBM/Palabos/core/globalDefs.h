@@ -63,6 +63,67 @@ namespace IndexOrdering {
     enum OrderingT {forward, backward, memorySaving};
 }
 
+/// Memory layout of the particle populations in a BlockLattice.
+/** Signification of constants:
+ *    - arrayOfStructures: Each cell is stored as a Cell object, holding its
+ *                         populations, external scalars and dynamics pointer.
+ *                         This is the default.
+ *    - structureOfArrays: Each population direction and each external scalar
+ *                         is stored in a separate, contiguous and aligned array.
+ *                         Dynamics are referred to by an integer id. Streaming
+ *                         traverses memory linearly, which pays off on large,
+ *                         memory-bandwidth-bound lattices.
+ *    - sparse:            Like structureOfArrays, but only the active cells are
+ *                         stored, all cells with NoDynamics being inactive.
+ *                         Streaming uses a precomputed table of neighbors.
+ *                         This pays off on geometries with a low fluid fraction,
+ *                         in which the NoDynamics cells are separated from the
+ *                         fluid by BounceBack cells; other blocks stay dense.
+ *  In the structureOfArrays and sparse layouts, double-precision populations
+ *  are stored in single precision if Palabos is compiled with
+ *  PLB_MIXED_PRECISION (see PopulationStorage).
+ **/
+namespace PopulationLayout {
+    enum LayoutT {arrayOfStructures, structureOfArrays, sparse};
+}
+
+/// Streaming scheme used by a BlockLattice in a full time step collideAndStream().
+/** Signification of constants:
+ *    - inPlaceSwap: After collision, the populations of a cell are reverted
+ *                   and swapped with those of its neighbors. This is the
+ *                   default.
+ *    - aaPattern:   Even and odd steps alternate. In an even step, each cell
+ *                   is collided and its populations are stored back in
+ *                   reverted order, without accessing any neighbor. In an
+ *                   odd step, each cell reads its incoming populations from
+ *                   the neighbors, is collided, and writes its outgoing
+ *                   populations into the locations it has read from. Both
+ *                   steps are a single sweep in which cells can be processed
+ *                   in any order, and each population is read and written
+ *                   once. This is implemented for an atomic BlockLattice
+ *                   in the arrayOfStructures layout; a multi-block lattice
+ *                   refuses to iterate with components which use it.
+ **/
+namespace StreamingScheme {
+    enum SchemeT {inPlaceSwap, aaPattern};
+}
+
+/// Encoding of the data arrays in a VTK XML file.
+/** Signification of constants:
+ *    - base64:       The data is written inline, in base64 encoding. This is
+ *                    the default.
+ *    - rawAppended:  The data is written in raw binary format, in an appended
+ *                    section at the end of the file. This avoids the 33%
+ *                    overhead and the cost of the base64 encoding.
+ *    - zlibAppended: Like rawAppended, but the data is compressed by blocks
+ *                    with zlib (vtkZLibDataCompressor). This is available only
+ *                    if Palabos is compiled with PLB_USE_ZLIB (and linked with
+ *                    zlib); otherwise, rawAppended is used instead.
+ **/
+namespace VtkEncoding {
+    enum EncodingT {base64, rawAppended, zlibAppended};
+}
+
 /// Sub-domain of an atomic-block, on which for example a data processor is executed.
 /** Signification of constants:
  *      - bulk: Refers to bulk-nodes, without envelope.
@@ -88,12 +149,26 @@ public:
     bool getEndianSwitchOnBase64out();
     void setEndianSwitchOnBase64in(bool doSwitch);
     bool getEndianSwitchOnBase64in();
+    /// Serialize multi-blocks slab by slab, with one message per process and
+    ///   slab, instead of one message per line of cells (default: true).
+    void setBlockwiseSerialization(bool blockwise);
+    bool getBlockwiseSerialization() const;
+    /// Encoding of the data arrays in VTK files (default: base64).
+    void setVtkEncoding(VtkEncoding::EncodingT vtkEncoding_);
+    VtkEncoding::EncodingT getVtkEncoding() const;
+    /// Convert floating-point data to single precision when it is written to
+    ///   VTK files with a VtkImageOutput (default: false).
+    void setVtkSinglePrecision(bool singlePrecision);
+    bool getVtkSinglePrecision() const;
 private:
     IOpolicyClass();
 private:
     IndexOrdering::OrderingT streamOrdering;
     bool endianSwitchOnBase64out;
     bool endianSwitchOnBase64in;
+    bool blockwiseSerialization;
+    VtkEncoding::EncodingT vtkEncoding;
+    bool vtkSinglePrecision;
     friend IOpolicyClass& IOpolicy();
 };
     
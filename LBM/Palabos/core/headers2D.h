@@ -29,6 +29,7 @@
 #include "core/dynamics.h"
 #include "core/cell.h"
 #include "core/blockStatistics.h"
+#include "core/collisionKernels.h"
 #include "core/dataFieldBase2D.h"
 #include "core/serializer.h"
 #include "core/blockLatticeBase2D.h"
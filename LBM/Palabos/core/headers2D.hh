@@ -24,6 +24,7 @@
 #include "core/cell.hh"
 #include "core/dynamics.hh"
 #include "core/blockStatistics.hh"
+#include "core/collisionKernels.hh"
 #include "core/serializer.hh"
 #include "core/block2D.hh"
 #include "core/blockLatticeBase2D.hh"
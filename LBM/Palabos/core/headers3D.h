@@ -27,8 +27,11 @@
 #include "core/identifiers.h"
 #include "core/units.h"
 #include "core/dynamics.h"
+#include "core/dynamicsRegistry.h"
+#include "core/dynamicsPrototypes.h"
 #include "core/cell.h"
 #include "core/blockStatistics.h"
+#include "core/collisionKernels.h"
 #include "core/dataFieldBase3D.h"
 #include "core/serializer.h"
 #include "core/block3D.h"
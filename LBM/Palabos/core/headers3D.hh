@@ -23,7 +23,10 @@
  */
 #include "core/cell.hh"
 #include "core/dynamics.hh"
+#include "core/dynamicsRegistry.hh"
+#include "core/dynamicsPrototypes.hh"
 #include "core/blockStatistics.hh"
+#include "core/collisionKernels.hh"
 #include "core/serializer.hh"
 #include "core/block3D.hh"
 #include "core/blockLatticeBase3D.hh"
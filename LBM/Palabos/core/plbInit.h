@@ -26,12 +26,14 @@
 
 #include "core/globalDefs.h"
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "io/parallelIO.h"
 
 namespace plb {
 
 inline void plbInit(int *argc, char ***argv, bool verbous=false) {
     global::mpi().init(argc, argv, verbous);
+    global::smp().init(verbous);
 }
 
 }  // namespace plb
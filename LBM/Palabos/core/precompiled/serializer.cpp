@@ -37,7 +37,7 @@ template void serializerToUnSerializer<double>(DataSerializer<double> const* ser
                                                DataUnSerializer<double>* unSerializer);
 
 template void serializerToSink<double>(DataSerializer<double> const* serializer,
-                                       SerializedWriter<double>* sink);
+                                       SerializedWriter<double>* sink, bool mainProcOnly);
 
 template void sourceToUnSerializer<double>(SerializedReader<double> const* source,
                                            DataUnSerializer<double>* unSerializer);
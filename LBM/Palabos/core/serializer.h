@@ -99,8 +99,14 @@ private:
 template<typename T>
 void serializerToUnSerializer(DataSerializer<T> const* serializer, DataUnSerializer<T>* unSerializer);
 
+/// Stream the content of a serializer into a sink.
+/** By default, the sink is used by the main processor only, as the serializer
+ *  of a multi-block gathers its data there. With mainProcOnly=false, the sink
+ *  is used by every process, for example to write the data of a local block.
+ */
 template<typename T>
-void serializerToSink(DataSerializer<T> const* serializer, SerializedWriter<T>* sink);
+void serializerToSink(DataSerializer<T> const* serializer, SerializedWriter<T>* sink,
+                      bool mainProcOnly=true);
 
 template<typename T>
 void sourceToUnSerializer(SerializedReader<T> const* source, DataUnSerializer<T>* unSerializer);
@@ -178,15 +178,18 @@ void serializerToUnSerializer(DataSerializer<T> const* serializer, DataUnSeriali
 }
 
 template<typename T>
-void serializerToSink(DataSerializer<T> const* serializer, SerializedWriter<T>* sink) {
-    if (global::mpi().isMainProcessor()) {
+void serializerToSink(DataSerializer<T> const* serializer, SerializedWriter<T>* sink,
+                      bool mainProcOnly)
+{
+    bool writes = !mainProcOnly || global::mpi().isMainProcessor();
+    if (writes) {
         pluint dataSize = serializer->getSize();
         sink->writeHeader(dataSize);
     }
     while (!serializer->isEmpty()) {
         pluint bufferSize;
         const T* dataBuffer = serializer->getNextDataBuffer(bufferSize);
-        if (global::mpi().isMainProcessor()) {
+        if (writes) {
             sink->writeData(dataBuffer, bufferSize);
         }
     }
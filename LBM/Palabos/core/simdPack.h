@@ -0,0 +1,161 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Short-vector (SIMD) arithmetic types, used by the batched collision
+ * templates to process several cells at once.
+ *
+ * The instruction set is selected at build time, from the flags of the
+ * compiler: AVX-512 (__AVX512F__), AVX (__AVX__), or SSE2 (__SSE2__, or
+ * a 64-bit MSVC target). Define PLB_NO_SIMD to use the portable scalar
+ * fallback unconditionally. The selection is made through macros which are
+ * local to this file; other code can query it through simd::instructionSet().
+ */
+#ifndef SIMD_PACK_H
+#define SIMD_PACK_H
+
+#include "core/globalDefs.h"
+
+#ifndef PLB_NO_SIMD
+    #if defined(__AVX512F__)
+        #define PLB_SIMD_PACK_AVX512
+    #elif defined(__AVX__)
+        #define PLB_SIMD_PACK_AVX
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define PLB_SIMD_PACK_SSE2
+    #endif
+#endif
+
+#if defined(PLB_SIMD_PACK_AVX512) || defined(PLB_SIMD_PACK_AVX)
+    #include <immintrin.h>
+#elif defined(PLB_SIMD_PACK_SSE2)
+    #include <emmintrin.h>
+#endif
+
+namespace plb {
+
+namespace simd {
+
+/// Portable fallback: a pack of width 1, which is nothing but a scalar.
+template<typename T>
+struct ScalarPack {
+    typedef T value_type;
+    enum { width = 1 };
+    ScalarPack() { }
+    explicit ScalarPack(T value_) : value(value_) { }
+    static ScalarPack<T> load(T const* data) { return ScalarPack<T>(*data); }
+    void store(T* data) const { *data = value; }
+    T value;
+};
+
+template<typename T>
+inline ScalarPack<T> operator+(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.value+b.value); }
+template<typename T>
+inline ScalarPack<T> operator-(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.value-b.value); }
+template<typename T>
+inline ScalarPack<T> operator*(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.value*b.value); }
+template<typename T>
+inline ScalarPack<T> operator/(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.value/b.value); }
+template<typename T>
+inline ScalarPack<T>& operator+=(ScalarPack<T>& a, ScalarPack<T> b) { a.value += b.value; return a; }
+template<typename T>
+inline ScalarPack<T>& operator-=(ScalarPack<T>& a, ScalarPack<T> b) { a.value -= b.value; return a; }
+template<typename T>
+inline ScalarPack<T>& operator*=(ScalarPack<T>& a, ScalarPack<T> b) { a.value *= b.value; return a; }
+
+/// Defines a pack type on top of the intrinsics of a given instruction set.
+#define PLB_DEFINE_SIMD_PACK(PACK, T, REGISTER, WIDTH, SET1, LOADU, STOREU, ADD, SUB, MUL, DIV) \
+struct PACK {                                                                    \
+    typedef T value_type;                                                        \
+    enum { width = WIDTH };                                                      \
+    PACK() { }                                                                   \
+    explicit PACK(T value) : reg(SET1(value)) { }                                \
+    explicit PACK(REGISTER reg_) : reg(reg_) { }                                 \
+    static PACK load(T const* data) { return PACK(LOADU(data)); }               \
+    void store(T* data) const { STOREU(data, reg); }                             \
+    REGISTER reg;                                                                \
+};                                                                               \
+inline PACK operator+(PACK a, PACK b) { return PACK(ADD(a.reg, b.reg)); }        \
+inline PACK operator-(PACK a, PACK b) { return PACK(SUB(a.reg, b.reg)); }        \
+inline PACK operator*(PACK a, PACK b) { return PACK(MUL(a.reg, b.reg)); }        \
+inline PACK operator/(PACK a, PACK b) { return PACK(DIV(a.reg, b.reg)); }        \
+inline PACK& operator+=(PACK& a, PACK b) { a = a+b; return a; }                  \
+inline PACK& operator-=(PACK& a, PACK b) { a = a-b; return a; }                  \
+inline PACK& operator*=(PACK& a, PACK b) { a = a*b; return a; }
+
+#if defined(PLB_SIMD_PACK_AVX512)
+PLB_DEFINE_SIMD_PACK( DoublePack, double, __m512d, 8, _mm512_set1_pd, _mm512_loadu_pd,
+                      _mm512_storeu_pd, _mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_div_pd )
+PLB_DEFINE_SIMD_PACK( FloatPack, float, __m512, 16, _mm512_set1_ps, _mm512_loadu_ps,
+                      _mm512_storeu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_div_ps )
+#elif defined(PLB_SIMD_PACK_AVX)
+PLB_DEFINE_SIMD_PACK( DoublePack, double, __m256d, 4, _mm256_set1_pd, _mm256_loadu_pd,
+                      _mm256_storeu_pd, _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_div_pd )
+PLB_DEFINE_SIMD_PACK( FloatPack, float, __m256, 8, _mm256_set1_ps, _mm256_loadu_ps,
+                      _mm256_storeu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_div_ps )
+#elif defined(PLB_SIMD_PACK_SSE2)
+PLB_DEFINE_SIMD_PACK( DoublePack, double, __m128d, 2, _mm_set1_pd, _mm_loadu_pd,
+                      _mm_storeu_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd, _mm_div_pd )
+PLB_DEFINE_SIMD_PACK( FloatPack, float, __m128, 4, _mm_set1_ps, _mm_loadu_ps,
+                      _mm_storeu_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_div_ps )
+#endif
+
+#undef PLB_DEFINE_SIMD_PACK
+
+/// Widest pack type available for a given scalar type.
+template<typename T>
+struct NativePack {
+    typedef ScalarPack<T> Pack;
+};
+
+#if defined(PLB_SIMD_PACK_AVX512) || defined(PLB_SIMD_PACK_AVX) || defined(PLB_SIMD_PACK_SSE2)
+template<>
+struct NativePack<double> {
+    typedef DoublePack Pack;
+};
+
+template<>
+struct NativePack<float> {
+    typedef FloatPack Pack;
+};
+#endif
+
+/// Name of the instruction set selected at build time.
+inline char const* instructionSet() {
+#if defined(PLB_SIMD_PACK_AVX512)
+    return "AVX-512";
+#elif defined(PLB_SIMD_PACK_AVX)
+    return "AVX";
+#elif defined(PLB_SIMD_PACK_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+}  // namespace simd
+
+}  // namespace plb
+
+#undef PLB_SIMD_PACK_AVX512
+#undef PLB_SIMD_PACK_AVX
+#undef PLB_SIMD_PACK_SSE2
+
+#endif  // SIMD_PACK_H
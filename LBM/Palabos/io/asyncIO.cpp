@@ -0,0 +1,190 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Asynchronous execution of output operations in a background thread -- implementation.
+ */
+
+#include "io/asyncIO.h"
+#include "core/plbDebug.h"
+#include <deque>
+
+#ifdef PLB_ASYNC_IO
+#include <pthread.h>
+#endif
+
+namespace plb {
+
+namespace global {
+
+#ifdef PLB_ASYNC_IO
+
+/// Background thread, and the queue of jobs it executes.
+struct AsyncIOService::Worker {
+    Worker();
+    ~Worker();
+    void submit(AsyncIOJob* job, pluint maxMemory);
+    void flush();
+    void run();
+    static void* start(void* worker);
+
+    std::deque<AsyncIOJob*> queue;
+    /// Memory held by the queued jobs and by the job in execution.
+    pluint pendingMemory;
+    bool busy, shutdown;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    /// Signals a new job or the shutdown to the worker.
+    pthread_cond_t jobAvailable;
+    /// Signals the completion of a job to the submitting thread.
+    pthread_cond_t jobCompleted;
+};
+
+AsyncIOService::Worker::Worker()
+    : pendingMemory(0),
+      busy(false),
+      shutdown(false)
+{
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&jobAvailable, 0);
+    pthread_cond_init(&jobCompleted, 0);
+    int error = pthread_create(&thread, 0, &Worker::start, this);
+    PLB_ASSERT( error==0 );
+    (void) error;
+}
+
+AsyncIOService::Worker::~Worker() {
+    pthread_mutex_lock(&mutex);
+    shutdown = true;
+    pthread_cond_signal(&jobAvailable);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, 0);
+    pthread_cond_destroy(&jobCompleted);
+    pthread_cond_destroy(&jobAvailable);
+    pthread_mutex_destroy(&mutex);
+}
+
+void* AsyncIOService::Worker::start(void* worker) {
+    static_cast<Worker*>(worker)->run();
+    return 0;
+}
+
+void AsyncIOService::Worker::submit(AsyncIOJob* job, pluint maxMemory) {
+    pluint memory = job->getMemorySize();
+    pthread_mutex_lock(&mutex);
+    // Back-pressure: wait until the job fits, unless nothing else is pending.
+    while (pendingMemory>0 && pendingMemory+memory>maxMemory) {
+        pthread_cond_wait(&jobCompleted, &mutex);
+    }
+    queue.push_back(job);
+    pendingMemory += memory;
+    pthread_cond_signal(&jobAvailable);
+    pthread_mutex_unlock(&mutex);
+}
+
+void AsyncIOService::Worker::flush() {
+    pthread_mutex_lock(&mutex);
+    while (!queue.empty() || busy) {
+        pthread_cond_wait(&jobCompleted, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void AsyncIOService::Worker::run() {
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (queue.empty() && !shutdown) {
+            pthread_cond_wait(&jobAvailable, &mutex);
+        }
+        // Pending jobs are completed before the thread terminates.
+        if (queue.empty()) {
+            break;
+        }
+        AsyncIOJob* job = queue.front();
+        queue.pop_front();
+        busy = true;
+        pthread_mutex_unlock(&mutex);
+
+        pluint memory = job->getMemorySize();
+        job->execute();
+        delete job;
+
+        pthread_mutex_lock(&mutex);
+        busy = false;
+        pendingMemory -= memory;
+        pthread_cond_broadcast(&jobCompleted);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+#endif  // PLB_ASYNC_IO
+
+AsyncIOService::AsyncIOService()
+    : maxMemory((pluint)1 << 30),
+      worker(0)
+{ }
+
+AsyncIOService::~AsyncIOService() {
+#ifdef PLB_ASYNC_IO
+    // Completes all pending jobs.
+    delete worker;
+#endif
+}
+
+void AsyncIOService::submit(AsyncIOJob* job) {
+    PLB_PRECONDITION( job );
+#ifdef PLB_ASYNC_IO
+    if (!worker) {
+        worker = new Worker();
+    }
+    worker->submit(job, maxMemory);
+#else
+    job->execute();
+    delete job;
+#endif
+}
+
+void AsyncIOService::flush() {
+#ifdef PLB_ASYNC_IO
+    if (worker) {
+        worker->flush();
+    }
+#endif
+}
+
+void AsyncIOService::setMaxMemory(pluint maxMemory_) {
+    maxMemory = maxMemory_;
+}
+
+pluint AsyncIOService::getMaxMemory() const {
+    return maxMemory;
+}
+
+bool AsyncIOService::isAsynchronous() const {
+#ifdef PLB_ASYNC_IO
+    return true;
+#else
+    return false;
+#endif
+}
+
+}  // namespace global
+
+}  // namespace plb
@@ -0,0 +1,91 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Asynchronous execution of output operations in a background thread -- header file.
+ *
+ * The background thread is enabled by compiling with PLB_ASYNC_IO, which
+ * requires POSIX threads (link with -lpthread). Otherwise, the jobs are
+ * executed immediately, at the time they are submitted.
+ */
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include "core/globalDefs.h"
+
+namespace plb {
+
+/// An output operation, executed in the background by the AsyncIOService.
+/** A job must own all the data it needs: it is executed at a later time,
+ *  while the simulation keeps modifying its blocks. It is executed by a
+ *  separate thread, and must therefore neither communicate through MPI nor
+ *  access data which is modified by the simulation.
+ */
+class AsyncIOJob {
+public:
+    virtual ~AsyncIOJob() { }
+    /// Encode and write the data.
+    virtual void execute() =0;
+    /// Amount of staged data held by the job, in bytes.
+    virtual pluint getMemorySize() const =0;
+};
+
+namespace global {
+
+/// Queue of output jobs, which are executed in order by a background thread.
+/** The amount of memory held by submitted jobs which are not yet completed
+ *  is bounded by getMaxMemory(). When a job is submitted which exceeds this
+ *  bound, the caller is blocked until enough pending jobs are completed
+ *  (one job is always accepted, whatever its size). The staged data of the
+ *  job being submitted comes on top of the bound.
+ */
+class AsyncIOService {
+public:
+    ~AsyncIOService();
+    /// Hand a job over to the background thread, which takes ownership of it.
+    void submit(AsyncIOJob* job);
+    /// Wait until all submitted jobs are completed.
+    void flush();
+    /// Maximum amount of memory held by pending jobs, in bytes (default: 1 GB).
+    void setMaxMemory(pluint maxMemory_);
+    pluint getMaxMemory() const;
+    /// Tells whether jobs are executed in a background thread.
+    bool isAsynchronous() const;
+private:
+    AsyncIOService();
+    AsyncIOService(AsyncIOService const& rhs);
+    AsyncIOService& operator=(AsyncIOService const& rhs);
+private:
+    struct Worker;
+    pluint maxMemory;
+    Worker* worker;
+friend AsyncIOService& asyncIO();
+};
+
+inline AsyncIOService& asyncIO() {
+    static AsyncIOService instance;
+    return instance;
+}
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // ASYNC_IO_H
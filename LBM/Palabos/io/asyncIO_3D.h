@@ -0,0 +1,128 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Asynchronous output of 3D blocks -- header file.
+ *
+ * The functions and classes of this file take a snapshot of the data of a
+ * block, which is gathered on the main processor, and return immediately.
+ * The data is then encoded and written by the global::asyncIO() service,
+ * while the simulation continues. Before the end of the program, or before
+ * reading the files, call global::asyncIO().flush().
+ */
+#ifndef ASYNC_IO_3D_H
+#define ASYNC_IO_3D_H
+
+#include "core/globalDefs.h"
+#include "core/serializer.h"
+#include "core/block3D.h"
+#include "core/dataFieldBase3D.h"
+#include "core/array.h"
+#include "io/asyncIO.h"
+#include "io/imageWriter.h"
+#include "io/vtkDataOutput.h"
+#include <string>
+#include <vector>
+
+namespace plb {
+
+/// A sink which copies serialized data into a vector.
+template<typename T>
+class StagingWriter : public SerializedWriter<T> {
+public:
+    StagingWriter(std::vector<T>& data_);
+    virtual StagingWriter<T>* clone() const;
+    virtual void writeHeader(pluint dataSize);
+    virtual void writeData(T const* dataBuffer, pluint bufferSize);
+private:
+    std::vector<T>& data;
+};
+
+/// A serializer for data which has been copied into a vector.
+template<typename T>
+class StagedDataSerializer : public DataSerializer<T> {
+public:
+    StagedDataSerializer(std::vector<T> const& data_);
+    virtual StagedDataSerializer<T>* clone() const;
+    virtual pluint getSize() const;
+    virtual const T* getNextDataBuffer(pluint& bufferSize) const;
+    virtual bool isEmpty() const;
+private:
+    std::vector<T> const& data;
+    mutable pluint position;
+};
+
+/// Asynchronous version of saveBinaryBlock().
+template<typename T>
+void asyncSaveBinaryBlock(Block3D<T> const& block, std::string fName, bool enforceUint=false);
+
+/// Asynchronous version of ImageWriter::writePpm() for a 3D field which is one cell thick.
+template<typename T>
+void asyncWritePpm(ImageWriter<T> const& imageWriter, std::string const& fName,
+                   ScalarFieldBase3D<T>& field, T minVal, T maxVal);
+
+/// Asynchronous version of ImageWriter::writeScaledPpm() for a 3D field which is one cell thick.
+template<typename T>
+void asyncWriteScaledPpm(ImageWriter<T> const& imageWriter, std::string const& fName,
+                         ScalarFieldBase3D<T>& field);
+
+/// A data array which is staged for a VTK file.
+class StagedVtkField {
+public:
+    virtual ~StagedVtkField() { }
+    virtual void write(VtkDataWriter3D& vtkOut) const =0;
+    virtual pluint getMemorySize() const =0;
+};
+
+/// Asynchronous version of VtkImageOutput3D.
+/** The fields are staged by writeData(), and the file is written in the
+ *  background after the destruction of the object. The encoding of the
+ *  file is the one of global::IOpolicy() at construction.
+ */
+template<typename T>
+class AsyncVtkImageOutput3D {
+public:
+    AsyncVtkImageOutput3D(std::string fName, T deltaX_=(T)1);
+    AsyncVtkImageOutput3D(std::string fName, T deltaX_, Array<T,3> offset);
+    ~AsyncVtkImageOutput3D();
+    template<typename TConv>
+    void writeData(ScalarFieldBase3D<T> const& scalarField,
+                   std::string scalarFieldName, TConv scalingFactor=(T)1);
+    template<plint n, typename TConv>
+    void writeData(TensorFieldBase3D<T,n> const& tensorField,
+                   std::string tensorFieldName, TConv scalingFactor=(T)1);
+private:
+    AsyncVtkImageOutput3D(AsyncVtkImageOutput3D<T> const& rhs);
+    AsyncVtkImageOutput3D<T>& operator=(AsyncVtkImageOutput3D<T> const& rhs);
+    template<typename TConv>
+    void stageField(DataSerializer<T> const* serializer, std::string const& name,
+                    TConv scalingFactor, plint nDim, Box3D domain);
+private:
+    std::string fullName;
+    VtkEncoding::EncodingT encoding;
+    T deltaX;
+    Array<T,3> offset;
+    Box3D domain;
+    std::vector<StagedVtkField*> fields;
+};
+
+} // namespace plb
+
+#endif
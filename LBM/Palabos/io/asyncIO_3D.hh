@@ -0,0 +1,374 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Asynchronous output of 3D blocks -- generic implementation.
+ */
+#ifndef ASYNC_IO_3D_HH
+#define ASYNC_IO_3D_HH
+
+#include "io/asyncIO_3D.h"
+#include "io/serializerIO.hh"
+#include "io/vtkDataOutput.hh"
+#include "io/imageWriter.hh"
+#include "atomicBlock/dataField2D.h"
+#include "parallelism/mpiManager.h"
+#include <fstream>
+#include <algorithm>
+
+namespace plb {
+
+////////// class StagingWriter ////////////////////////////////////////
+
+template<typename T>
+StagingWriter<T>::StagingWriter(std::vector<T>& data_)
+    : data(data_)
+{ }
+
+template<typename T>
+StagingWriter<T>* StagingWriter<T>::clone() const {
+    return new StagingWriter<T>(*this);
+}
+
+template<typename T>
+void StagingWriter<T>::writeHeader(pluint dataSize) {
+    data.reserve(data.size()+dataSize);
+}
+
+template<typename T>
+void StagingWriter<T>::writeData(T const* dataBuffer, pluint bufferSize) {
+    data.insert(data.end(), dataBuffer, dataBuffer+bufferSize);
+}
+
+
+////////// class StagedDataSerializer ////////////////////////////////////////
+
+template<typename T>
+StagedDataSerializer<T>::StagedDataSerializer(std::vector<T> const& data_)
+    : data(data_),
+      position(0)
+{ }
+
+template<typename T>
+StagedDataSerializer<T>* StagedDataSerializer<T>::clone() const {
+    return new StagedDataSerializer<T>(*this);
+}
+
+template<typename T>
+pluint StagedDataSerializer<T>::getSize() const {
+    return data.size();
+}
+
+template<typename T>
+const T* StagedDataSerializer<T>::getNextDataBuffer(pluint& bufferSize) const {
+    PLB_PRECONDITION( !isEmpty() );
+    // Moderate chunks, to limit the size of the buffers of filters like the
+    //   ScalingSerializer.
+    static const pluint chunkSize = 1<<16;
+    bufferSize = std::min(chunkSize, (pluint)data.size()-position);
+    const T* buffer = &data[position];
+    position += bufferSize;
+    return buffer;
+}
+
+template<typename T>
+bool StagedDataSerializer<T>::isEmpty() const {
+    return position >= data.size();
+}
+
+
+////////// Asynchronous binary output ////////////////////////////////////////
+
+/// Writes staged data into a Base64 encoded binary file.
+template<typename T>
+class BinaryBlockJob : public AsyncIOJob {
+public:
+    BinaryBlockJob(std::string const& fName_, bool enforceUint_, bool switchEndianness_)
+        : fName(fName_),
+          enforceUint(enforceUint_),
+          switchEndianness(switchEndianness_)
+    { }
+    virtual void execute() {
+        std::ofstream ostr(fName.c_str());
+        PLB_PRECONDITION( ostr );
+        Base64Writer<T> writer(ostr, enforceUint, switchEndianness);
+        writer.writeHeader(data.size());
+        if (!data.empty()) {
+            writer.writeData(&data[0], data.size());
+        }
+    }
+    virtual pluint getMemorySize() const {
+        return data.size()*sizeof(T);
+    }
+    std::vector<T>& getData() { return data; }
+private:
+    std::string fName;
+    bool enforceUint, switchEndianness;
+    std::vector<T> data;
+};
+
+template<typename T>
+void asyncSaveBinaryBlock(Block3D<T> const& block, std::string fName, bool enforceUint)
+{
+    BinaryBlockJob<T>* job = new BinaryBlockJob<T> (
+            fName, enforceUint, global::IOpolicy().getEndianSwitchOnBase64out() );
+    serializerToSink<T> (
+            block.getBlockSerializer(block.getBoundingBox(),
+                                     global::IOpolicy().getIndexOrderingForStreams()),
+            new StagingWriter<T>(job->getData()) );
+    if (global::mpi().isMainProcessor()) {
+        global::asyncIO().submit(job);
+    }
+    else {
+        delete job;
+    }
+}
+
+
+////////// Asynchronous image output ////////////////////////////////////////
+
+/// Writes a staged 2D field into a PPM image.
+template<typename T>
+class PpmJob : public AsyncIOJob {
+public:
+    PpmJob(ImageWriter<T> const& imageWriter_, std::string const& fName_,
+           plint nx, plint ny, T minVal_, T maxVal_)
+        : imageWriter(imageWriter_),
+          fName(fName_),
+          field(nx, ny),
+          minVal(minVal_),
+          maxVal(maxVal_)
+    { }
+    virtual void execute() {
+        imageWriter.writePpm(fName, field, minVal, maxVal);
+    }
+    virtual pluint getMemorySize() const {
+        return field.getNx()*field.getNy()*sizeof(T);
+    }
+    ScalarField2D<T>& getField() { return field; }
+private:
+    ImageWriter<T> imageWriter;
+    std::string fName;
+    ScalarField2D<T> field;
+    T minVal, maxVal;
+};
+
+template<typename T>
+void asyncWritePpm(ImageWriter<T> const& imageWriter, std::string const& fName,
+                   ScalarFieldBase3D<T>& field, T minVal, T maxVal)
+{
+    plint nx=0, ny=0;
+    if (field.getNx()==1) {
+        nx = field.getNy();
+        ny = field.getNz();
+    }
+    else if (field.getNy()==1) {
+        nx = field.getNx();
+        ny = field.getNz();
+    }
+    else if (field.getNz()==1) {
+        nx = field.getNx();
+        ny = field.getNy();
+    }
+    else {
+        return;
+    }
+    PpmJob<T>* job = new PpmJob<T>(imageWriter, fName, nx, ny, minVal, maxVal);
+    serializerToUnSerializer (
+            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
+            job->getField().getBlockUnSerializer(job->getField().getBoundingBox(),
+                                                 IndexOrdering::forward) );
+    if (global::mpi().isMainProcessor()) {
+        global::asyncIO().submit(job);
+    }
+    else {
+        delete job;
+    }
+}
+
+template<typename T>
+void asyncWriteScaledPpm(ImageWriter<T> const& imageWriter, std::string const& fName,
+                         ScalarFieldBase3D<T>& field)
+{
+    asyncWritePpm(imageWriter, fName, field, T(), T());
+}
+
+
+////////// Asynchronous VTK output ////////////////////////////////////////
+
+/// A data array of type TConv, staged for a VTK file.
+template<typename TConv>
+class StagedVtkFieldT : public StagedVtkField {
+public:
+    StagedVtkFieldT(std::string const& name_, TConv scalingFactor_, plint nDim_)
+        : name(name_),
+          scalingFactor(scalingFactor_),
+          nDim(nDim_)
+    { }
+    virtual void write(VtkDataWriter3D& vtkOut) const {
+        vtkOut.writeDataField(new StagedDataSerializer<TConv>(data), name, scalingFactor, nDim);
+    }
+    virtual pluint getMemorySize() const {
+        return data.size()*sizeof(TConv);
+    }
+    std::vector<TConv>& getData() { return data; }
+private:
+    std::string name;
+    TConv scalingFactor;
+    plint nDim;
+    std::vector<TConv> data;
+};
+
+/// Writes staged fields into a VTK image file.
+class VtkImageJob : public AsyncIOJob {
+public:
+    VtkImageJob(std::string const& fullName_, VtkEncoding::EncodingT encoding_,
+                Box3D domain_, Array<double,3> offset_, double deltaX_,
+                std::vector<StagedVtkField*> const& fields_)
+        : fullName(fullName_),
+          encoding(encoding_),
+          domain(domain_),
+          offset(offset_),
+          deltaX(deltaX_),
+          fields(fields_)
+    { }
+    virtual ~VtkImageJob() {
+        for (pluint iField=0; iField<fields.size(); ++iField) {
+            delete fields[iField];
+        }
+    }
+    virtual void execute() {
+        // The job is executed on the main processor only, which writes
+        //   the file on its own.
+        VtkDataWriter3D vtkOut(fullName, encoding, false);
+        vtkOut.writeHeader(domain, offset, deltaX);
+        vtkOut.startPiece(domain);
+        for (pluint iField=0; iField<fields.size(); ++iField) {
+            fields[iField]->write(vtkOut);
+        }
+        vtkOut.endPiece();
+        vtkOut.writeFooter();
+    }
+    virtual pluint getMemorySize() const {
+        pluint memory = 0;
+        for (pluint iField=0; iField<fields.size(); ++iField) {
+            memory += fields[iField]->getMemorySize();
+        }
+        return memory;
+    }
+private:
+    std::string fullName;
+    VtkEncoding::EncodingT encoding;
+    Box3D domain;
+    Array<double,3> offset;
+    double deltaX;
+    std::vector<StagedVtkField*> fields;
+};
+
+template<typename T>
+AsyncVtkImageOutput3D<T>::AsyncVtkImageOutput3D(std::string fName, T deltaX_)
+    : fullName ( global::directories().getVtkOutDir() + fName+".vti" ),
+      encoding( global::IOpolicy().getVtkEncoding() ),
+      deltaX(deltaX_),
+      offset(T(),T(),T())
+{ }
+
+template<typename T>
+AsyncVtkImageOutput3D<T>::AsyncVtkImageOutput3D(std::string fName, T deltaX_, Array<T,3> offset_)
+    : fullName ( global::directories().getVtkOutDir() + fName+".vti" ),
+      encoding( global::IOpolicy().getVtkEncoding() ),
+      deltaX(deltaX_),
+      offset(offset_)
+{ }
+
+template<typename T>
+AsyncVtkImageOutput3D<T>::~AsyncVtkImageOutput3D() {
+    if (global::mpi().isMainProcessor() && !fields.empty()) {
+        global::asyncIO().submit (
+                new VtkImageJob( fullName, encoding, domain,
+                                 Array<double,3>(offset[0],offset[1],offset[2]),
+                                 deltaX, fields ) );
+    }
+    else {
+        for (pluint iField=0; iField<fields.size(); ++iField) {
+            delete fields[iField];
+        }
+    }
+}
+
+template<typename T>
+template<typename TConv>
+void AsyncVtkImageOutput3D<T>::stageField (
+        DataSerializer<T> const* serializer, std::string const& name,
+        TConv scalingFactor, plint nDim, Box3D domain_ )
+{
+    if (fields.empty()) {
+        domain = domain_;
+    }
+    else {
+        PLB_PRECONDITION( domain.getNx()==domain_.getNx() );
+        PLB_PRECONDITION( domain.getNy()==domain_.getNy() );
+        PLB_PRECONDITION( domain.getNz()==domain_.getNz() );
+    }
+    // The type conversion is done right away; the scaling, encoding and
+    //   writing are left to the background thread.
+    if (VtkDataWriter3D::convertsToSinglePrecision<TConv>()) {
+        StagedVtkFieldT<float>* field =
+            new StagedVtkFieldT<float>(name, (float)scalingFactor, nDim);
+        serializerToSink<float> (
+                new TypeConversionSerializer<T,float>(serializer),
+                new StagingWriter<float>(field->getData()) );
+        fields.push_back(field);
+    }
+    else {
+        StagedVtkFieldT<TConv>* field =
+            new StagedVtkFieldT<TConv>(name, scalingFactor, nDim);
+        serializerToSink<TConv> (
+                new TypeConversionSerializer<T,TConv>(serializer),
+                new StagingWriter<TConv>(field->getData()) );
+        fields.push_back(field);
+    }
+}
+
+template<typename T>
+template<typename TConv>
+void AsyncVtkImageOutput3D<T>::writeData( ScalarFieldBase3D<T> const& scalarField,
+                                          std::string scalarFieldName, TConv scalingFactor )
+{
+    Box3D fieldDomain(0, scalarField.getNx()-1, 0, scalarField.getNy()-1, 0, scalarField.getNz()-1);
+    stageField (
+            scalarField.getBlockSerializer(scalarField.getBoundingBox(), IndexOrdering::backward),
+            scalarFieldName, scalingFactor, 1, fieldDomain );
+}
+
+template<typename T>
+template<plint n, typename TConv>
+void AsyncVtkImageOutput3D<T>::writeData( TensorFieldBase3D<T,n> const& tensorField,
+                                          std::string tensorFieldName, TConv scalingFactor )
+{
+    Box3D fieldDomain(0, tensorField.getNx()-1, 0, tensorField.getNy()-1, 0, tensorField.getNz()-1);
+    stageField (
+            tensorField.getBlockSerializer(tensorField.getBoundingBox(), IndexOrdering::backward),
+            tensorFieldName, scalingFactor, n, fieldDomain );
+}
+
+}  // namespace plb
+
+#endif
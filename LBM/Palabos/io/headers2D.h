@@ -28,5 +28,6 @@
 #include "io/vtkDataOutput.h"
 #include "io/parallelIO.h"
 #include "io/colormaps.h"
+#include "io/imageEncoders.h"
 #include "io/imageWriter.h"
 #include "io/endianness.h"
@@ -25,8 +25,14 @@
 #include "io/base64.h"
 #include "io/serializerIO.h"
 #include "io/serializerIO_3D.h"
+#include "io/parallelCheckpoint3D.h"
+#include "io/mappedDataField3D.h"
 #include "io/vtkDataOutput.h"
+#include "io/parallelVtkDataOutput3D.h"
+#include "io/asyncIO.h"
+#include "io/asyncIO_3D.h"
 #include "io/parallelIO.h"
 #include "io/colormaps.h"
+#include "io/imageEncoders.h"
 #include "io/imageWriter.h"
 #include "io/endianness.h"
@@ -24,5 +24,9 @@
 #include "io/base64.hh"
 #include "io/serializerIO.hh"
 #include "io/serializerIO_3D.hh"
+#include "io/parallelCheckpoint3D.hh"
+#include "io/mappedDataField3D.hh"
 #include "io/vtkDataOutput.hh"
+#include "io/parallelVtkDataOutput3D.hh"
+#include "io/asyncIO_3D.hh"
 #include "io/imageWriter.hh"
@@ -0,0 +1,379 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * In-memory encoders for PNG and GIF images -- implementation.
+ */
+
+#include "io/imageEncoders.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+
+#ifdef PLB_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace plb {
+
+namespace {
+
+////////// PNG helpers ////////////////////////////////////////
+
+unsigned long updateCrc32(unsigned long crc, unsigned char const* data, pluint length) {
+    static unsigned long table[256];
+    static bool tableComputed = false;
+    if (!tableComputed) {
+        for (unsigned long n=0; n<256; ++n) {
+            unsigned long c = n;
+            for (int k=0; k<8; ++k) {
+                c = (c&1) ? 0xedb88320UL ^ (c>>1) : c>>1;
+            }
+            table[n] = c;
+        }
+        tableComputed = true;
+    }
+    for (pluint i=0; i<length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc>>8);
+    }
+    return crc;
+}
+
+#ifndef PLB_USE_ZLIB
+unsigned long computeAdler32(unsigned char const* data, pluint length) {
+    unsigned long a = 1, b = 0;
+    for (pluint i=0; i<length; ++i) {
+        a = (a+data[i]) % 65521;
+        b = (b+a) % 65521;
+    }
+    return (b<<16) | a;
+}
+#endif
+
+void appendBigEndian(std::vector<unsigned char>& data, unsigned long value) {
+    data.push_back((unsigned char)((value>>24) & 0xff));
+    data.push_back((unsigned char)((value>>16) & 0xff));
+    data.push_back((unsigned char)((value>> 8) & 0xff));
+    data.push_back((unsigned char)( value      & 0xff));
+}
+
+void writePngChunk(std::ofstream& ostr, char const* type, std::vector<unsigned char> const& data) {
+    std::vector<unsigned char> chunk;
+    appendBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type+4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    // The CRC covers the type and the data of the chunk.
+    unsigned long crc = updateCrc32(0xffffffffUL, &chunk[4], chunk.size()-4) ^ 0xffffffffUL;
+    appendBigEndian(chunk, crc);
+    ostr.write((char const*)&chunk[0], chunk.size());
+}
+
+/// Encode data into a zlib stream.
+void zlibEncode(std::vector<unsigned char> const& data, std::vector<unsigned char>& stream) {
+#ifdef PLB_USE_ZLIB
+    uLongf streamSize = compressBound(data.size());
+    stream.resize(streamSize);
+    int status = compress2(&stream[0], &streamSize, &data[0], data.size(), Z_BEST_SPEED);
+    PLB_ASSERT( status==Z_OK );
+    (void) status;
+    stream.resize(streamSize);
+#else
+    // Stored (uncompressed) deflate blocks of at most 65535 bytes.
+    stream.clear();
+    stream.push_back(0x78);
+    stream.push_back(0x01);
+    pluint pos = 0;
+    do {
+        pluint length = std::min((pluint)65535, (pluint)data.size()-pos);
+        bool isLast = pos+length == data.size();
+        stream.push_back(isLast ? 1 : 0);
+        stream.push_back((unsigned char)(length & 0xff));
+        stream.push_back((unsigned char)(length >> 8));
+        stream.push_back((unsigned char)(~length & 0xff));
+        stream.push_back((unsigned char)((~length >> 8) & 0xff));
+        stream.insert(stream.end(), data.begin()+pos, data.begin()+pos+length);
+        pos += length;
+    } while (pos<data.size());
+    appendBigEndian(stream, computeAdler32(&data[0], data.size()));
+#endif
+}
+
+
+////////// GIF helpers ////////////////////////////////////////
+
+/// LZW compression of GIF image data, written in sub-blocks of at most 255 bytes.
+class LzwEncoder {
+public:
+    LzwEncoder(std::ofstream& ostr_, plint minCodeSize_);
+    void encode(std::vector<unsigned char> const& indexes);
+private:
+    void resetTable();
+    void writeCode(plint code);
+    void flushBits();
+    void flushBlock();
+private:
+    static const plint maxCode = 4096;
+    static const plint tableSize = 5003;
+    std::ofstream& ostr;
+    plint minCodeSize, codeSize, clearCode, nextCode;
+    /// Open-addressing hash table which maps (prefix, index) to a code.
+    std::vector<long> keys;
+    std::vector<plint> codes;
+    unsigned long bitBuffer;
+    plint numBits;
+    std::vector<unsigned char> block;
+};
+
+LzwEncoder::LzwEncoder(std::ofstream& ostr_, plint minCodeSize_)
+    : ostr(ostr_),
+      minCodeSize(minCodeSize_),
+      clearCode((plint)1 << minCodeSize_),
+      keys(tableSize),
+      codes(tableSize),
+      bitBuffer(0),
+      numBits(0)
+{ }
+
+void LzwEncoder::resetTable() {
+    std::fill(keys.begin(), keys.end(), -1);
+    codeSize = minCodeSize+1;
+    nextCode = clearCode+2;
+}
+
+void LzwEncoder::writeCode(plint code) {
+    bitBuffer |= (unsigned long)code << numBits;
+    numBits += codeSize;
+    while (numBits>=8) {
+        block.push_back((unsigned char)(bitBuffer & 0xff));
+        bitBuffer >>= 8;
+        numBits -= 8;
+        if (block.size()==255) {
+            flushBlock();
+        }
+    }
+}
+
+void LzwEncoder::flushBits() {
+    if (numBits>0) {
+        block.push_back((unsigned char)(bitBuffer & 0xff));
+        bitBuffer = 0;
+        numBits = 0;
+    }
+    flushBlock();
+}
+
+void LzwEncoder::flushBlock() {
+    if (!block.empty()) {
+        ostr.put((char)block.size());
+        ostr.write((char const*)&block[0], block.size());
+        block.clear();
+    }
+}
+
+void LzwEncoder::encode(std::vector<unsigned char> const& indexes) {
+    ostr.put((char)minCodeSize);
+    resetTable();
+    writeCode(clearCode);
+    if (!indexes.empty()) {
+        plint prefix = indexes[0];
+        for (pluint iPixel=1; iPixel<indexes.size(); ++iPixel) {
+            plint index = indexes[iPixel];
+            long key = ((long)prefix<<8) | index;
+            plint slot = (plint)(key % tableSize);
+            while (keys[slot]!=-1 && keys[slot]!=key) {
+                slot = (slot+1) % tableSize;
+            }
+            if (keys[slot]==key) {
+                prefix = codes[slot];
+                continue;
+            }
+            writeCode(prefix);
+            if (nextCode<maxCode) {
+                keys[slot] = key;
+                codes[slot] = nextCode;
+                ++nextCode;
+                // The decoder adds its entries one code later; its code size
+                //   grows once the entry 2^codeSize exists.
+                if (nextCode > ((plint)1<<codeSize) && codeSize<12) {
+                    ++codeSize;
+                }
+            }
+            else {
+                writeCode(clearCode);
+                resetTable();
+            }
+            prefix = index;
+        }
+        writeCode(prefix);
+        // Account for the entry added by the decoder after the last code.
+        ++nextCode;
+        if (nextCode > ((plint)1<<codeSize) && codeSize<12) {
+            ++codeSize;
+        }
+    }
+    writeCode(clearCode+1);
+    flushBits();
+    ostr.put(0);
+}
+
+}  // namespace
+
+
+////////// PNG output ////////////////////////////////////////
+
+bool writePngImage(std::string const& fName, plint width, plint height,
+                   std::vector<unsigned char> const& rgb)
+{
+    PLB_PRECONDITION( (plint)rgb.size() == 3*width*height );
+    std::ofstream ostr(fName.c_str(), std::ios::out | std::ios::binary);
+    if (!ostr) {
+        return false;
+    }
+    static const unsigned char signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    ostr.write((char const*)signature, 8);
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.push_back(8);  // Bit depth.
+    header.push_back(2);  // Color type: RGB.
+    header.push_back(0);  // Compression method: deflate.
+    header.push_back(0);  // Filter method.
+    header.push_back(0);  // No interlace.
+    writePngChunk(ostr, "IHDR", header);
+
+    // Every row is preceded by its filter type, which is "none".
+    std::vector<unsigned char> rows;
+    rows.reserve((3*width+1)*height);
+    for (plint iY=0; iY<height; ++iY) {
+        rows.push_back(0);
+        rows.insert(rows.end(), rgb.begin()+3*width*iY, rgb.begin()+3*width*(iY+1));
+    }
+    std::vector<unsigned char> stream;
+    zlibEncode(rows, stream);
+    writePngChunk(ostr, "IDAT", stream);
+    writePngChunk(ostr, "IEND", std::vector<unsigned char>());
+    return (bool)ostr;
+}
+
+
+////////// class GifEncoder ////////////////////////////////////////
+
+GifEncoder::GifEncoder(std::string const& fName, plint width_, plint height_,
+                       std::vector<unsigned char> const& palette, bool animated_, plint delay_)
+    : ostr(fName.c_str(), std::ios::out | std::ios::binary),
+      width(width_),
+      height(height_),
+      animated(animated_),
+      delay(delay_)
+{
+    plint numColors = (plint)palette.size()/3;
+    PLB_PRECONDITION( numColors>=1 && numColors<=256 );
+    // The size of the color table is a power of two, of at least 4 colors.
+    minCodeSize = 2;
+    while (((plint)1<<minCodeSize) < numColors) {
+        ++minCodeSize;
+    }
+    if (!ostr) {
+        return;
+    }
+    ostr.write("GIF89a", 6);
+    writeShort(width);
+    writeShort(height);
+    // Global color table of 2^minCodeSize entries, with 8 bits per channel.
+    ostr.put((char)(0x80 | 0x70 | (minCodeSize-1)));
+    ostr.put(0);  // Background color.
+    ostr.put(0);  // Pixel aspect ratio.
+    std::vector<unsigned char> colorTable(3*((plint)1<<minCodeSize), 0);
+    std::copy(palette.begin(), palette.end(), colorTable.begin());
+    ostr.write((char const*)&colorTable[0], colorTable.size());
+    if (animated) {
+        // Application extension for an infinitely looping animation.
+        ostr.put((char)0x21);
+        ostr.put((char)0xff);
+        ostr.put(11);
+        ostr.write("NETSCAPE2.0", 11);
+        ostr.put(3);
+        ostr.put(1);
+        writeShort(0);
+        ostr.put(0);
+    }
+}
+
+GifEncoder::~GifEncoder() {
+    if (ostr) {
+        ostr.put(0x3b);
+    }
+}
+
+bool GifEncoder::isOpen() const {
+    return (bool)ostr;
+}
+
+void GifEncoder::writeShort(plint value) {
+    ostr.put((char)(value & 0xff));
+    ostr.put((char)((value>>8) & 0xff));
+}
+
+void GifEncoder::addFrame(std::vector<unsigned char> const& indexes) {
+    PLB_PRECONDITION( (plint)indexes.size() == width*height );
+    if (!ostr) {
+        return;
+    }
+    if (animated) {
+        // Graphic control extension, with the delay of the frame.
+        ostr.put((char)0x21);
+        ostr.put((char)0xf9);
+        ostr.put(4);
+        ostr.put(0);
+        writeShort(delay);
+        ostr.put(0);
+        ostr.put(0);
+    }
+    // Image descriptor: the frame covers the whole image.
+    ostr.put((char)0x2c);
+    writeShort(0);
+    writeShort(0);
+    writeShort(width);
+    writeShort(height);
+    ostr.put(0);
+    LzwEncoder(ostr, minCodeSize).encode(indexes);
+}
+
+
+////////// class AnimatedGif ////////////////////////////////////////
+
+AnimatedGif::AnimatedGif(std::string const& fName_, plint delay_, plint sizeX_, plint sizeY_)
+    : fName(fName_),
+      delay(delay_),
+      sizeX(sizeX_),
+      sizeY(sizeY_),
+      encoder(0)
+{ }
+
+AnimatedGif::~AnimatedGif() {
+    delete encoder;
+}
+
+void AnimatedGif::setEncoder(GifEncoder* encoder_) {
+    delete encoder;
+    encoder = encoder_;
+}
+
+}  // namespace plb
@@ -0,0 +1,104 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * In-memory encoders for PNG and GIF images -- header file.
+ */
+#ifndef IMAGE_ENCODERS_H
+#define IMAGE_ENCODERS_H
+
+#include "core/globalDefs.h"
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace plb {
+
+/// Write an RGB image with 8 bits per channel into a PNG file.
+/** The pixels are stored row by row, from the top row to the bottom row,
+ *  with three bytes (red, green, blue) per pixel. The image data is
+ *  compressed with zlib if Palabos is compiled with PLB_USE_ZLIB, and
+ *  written uncompressed (in stored deflate blocks) otherwise.
+ *  \return false if the file could not be written.
+ */
+bool writePngImage(std::string const& fName, plint width, plint height,
+                   std::vector<unsigned char> const& rgb);
+
+/// Encoder for GIF images, with one or several frames.
+/** All frames have the same size and share a global color table of at
+ *  most 256 colors. A frame is given by the index of the color of each
+ *  pixel, row by row from the top row to the bottom row. The frames are
+ *  written to the file as soon as they are added; the file is completed
+ *  by the destructor.
+ */
+class GifEncoder {
+public:
+    /// \param palette Red, green and blue component of each color.
+    /// \param animated Whether the frames are displayed as a looping animation.
+    /// \param delay Delay between frames of an animation, in hundredths of a second.
+    GifEncoder(std::string const& fName, plint width_, plint height_,
+               std::vector<unsigned char> const& palette, bool animated, plint delay_=10);
+    ~GifEncoder();
+    bool isOpen() const;
+    plint getWidth() const { return width; }
+    plint getHeight() const { return height; }
+    void addFrame(std::vector<unsigned char> const& indexes);
+private:
+    GifEncoder(GifEncoder const& rhs);
+    GifEncoder& operator=(GifEncoder const& rhs);
+    void writeShort(plint value);
+private:
+    std::ofstream ostr;
+    plint width, height;
+    plint minCodeSize;
+    bool animated;
+    plint delay;
+};
+
+/// An animated GIF file, to which frames are appended by an ImageWriter.
+/** The file is opened when the first frame is written, and completed
+ *  by the destructor. As for the other images of the ImageWriter, the
+ *  file name is given without extension and is relative to the image
+ *  output directory. If sizeX and sizeY are non-zero, the frames are
+ *  resized to fit into sizeX by sizeY pixels.
+ */
+class AnimatedGif {
+public:
+    AnimatedGif(std::string const& fName_, plint delay_=10, plint sizeX_=0, plint sizeY_=0);
+    ~AnimatedGif();
+    std::string const& getFileName() const { return fName; }
+    plint getDelay() const { return delay; }
+    plint getSizeX() const { return sizeX; }
+    plint getSizeY() const { return sizeY; }
+    /// The encoder, or 0 if no frame has been written yet.
+    GifEncoder* getEncoder() { return encoder; }
+    void setEncoder(GifEncoder* encoder_);
+private:
+    AnimatedGif(AnimatedGif const& rhs);
+    AnimatedGif& operator=(AnimatedGif const& rhs);
+private:
+    std::string fName;
+    plint delay, sizeX, sizeY;
+    GifEncoder* encoder;
+};
+
+}  // namespace plb
+
+#endif  // IMAGE_ENCODERS_H
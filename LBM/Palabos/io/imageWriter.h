@@ -25,6 +25,7 @@
 #include "core/dataFieldBase2D.h"
 #include "core/dataFieldBase3D.h"
 #include "io/colormaps.h"
+#include "io/imageEncoders.h"
 #include <sstream>
 #include <iomanip>
 #include <vector>
@@ -33,6 +34,15 @@ namespace plb {
 
 template<typename T> class ScalarField2D;
 
+/// Output of 2D fields, and of 3D fields which are one cell thick, as images.
+/** The values are mapped to colors through a color map. PPM images are
+ *  written as text, while PNG and GIF images are encoded in-process (see
+ *  imageEncoders.h). When sizeX and sizeY are given, the image is resized
+ *  to fit into sizeX by sizeY pixels, preserving its aspect ratio. GIF
+ *  images have a color table of at most 256 colors. The "scaled" methods
+ *  map the range between the minimum and the maximum of the field to the
+ *  whole color map.
+ */
 template<typename T>
 class ImageWriter {
 public:
@@ -56,6 +66,18 @@ public:
     void writeScaledGif(std::string const& fName,
                         ScalarFieldBase2D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  ScalarFieldBase2D<T>& field,
+                  T minVal, T maxVal, plint sizeX=0, plint sizeY=0) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarFieldBase2D<T>& field,
+                        plint sizeX=0, plint sizeY=0) const;
+    /// Append a frame to an animated GIF.
+    void writeGifFrame(AnimatedGif& animation,
+                       ScalarFieldBase2D<T>& field,
+                       T minVal, T maxVal) const;
+    void writeScaledGifFrame(AnimatedGif& animation,
+                             ScalarFieldBase2D<T>& field) const;
 
 
     void writePpm(std::string const& fName,
@@ -74,14 +96,48 @@ public:
     void writeScaledGif(std::string const& fName,
                         ScalarFieldBase3D<T>& field,
                         plint sizeX, plint sizeY) const;
+    void writePng(std::string const& fName,
+                  ScalarFieldBase3D<T>& field,
+                  T minVal, T maxVal, plint sizeX=0, plint sizeY=0) const;
+    void writeScaledPng(std::string const& fName,
+                        ScalarFieldBase3D<T>& field,
+                        plint sizeX=0, plint sizeY=0) const;
+    /// Append a frame to an animated GIF.
+    void writeGifFrame(AnimatedGif& animation,
+                       ScalarFieldBase3D<T>& field,
+                       T minVal, T maxVal) const;
+    void writeScaledGifFrame(AnimatedGif& animation,
+                             ScalarFieldBase3D<T>& field) const;
 
 private:
+    /// Copy a field into a new atomic field; collective.
+    ScalarField2D<T>* gatherField(ScalarFieldBase2D<T>& field) const;
+    /// Copy a 3D field which is one cell thick into a new 2D atomic field;
+    ///   collective. Returns 0 if the field is thicker.
+    ScalarField2D<T>* gatherField(ScalarFieldBase3D<T>& field) const;
     void writePpmImplementation (
         std::string const& fName,
         ScalarField2D<T>& localField, T minVal, T maxVal) const;
-    void imageMagickPpmToGif(std::string const& fName) const;
-    void imageMagickResize(std::string const& fName,
-                           plint sizeX, plint sizeY) const;
+    void writePngImplementation (
+        std::string const& fName, ScalarField2D<T>& localField,
+        T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeGifImplementation (
+        std::string const& fName, ScalarField2D<T>& localField,
+        T minVal, T maxVal, plint sizeX, plint sizeY) const;
+    void writeGifFrameImplementation (
+        AnimatedGif& animation, ScalarField2D<T>& localField,
+        T minVal, T maxVal) const;
+    /// Position of each pixel in the color map, in [0,1), from the top row of
+    ///   the image to the bottom row. The image is resized to fit into sizeX
+    ///   by sizeY pixels, unless they are zero.
+    void computeColorPositions (
+        ScalarField2D<T>& localField, T minVal, T maxVal, plint sizeX, plint sizeY,
+        plint& width, plint& height, std::vector<double>& positions ) const;
+    /// Color table of a GIF image, with at most 256 colors.
+    void computeGifPalette(std::vector<unsigned char>& palette) const;
+    /// Convert positions in the color map into indexes in the GIF color table.
+    void computeGifIndexes(std::vector<double> const& positions,
+                           std::vector<unsigned char>& indexes) const;
 private:
     plint colorRange, numColors;
     ColorMap colorMap;
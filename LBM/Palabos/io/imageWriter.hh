@@ -32,6 +32,7 @@
 #include <fstream>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -67,9 +68,16 @@ void ImageWriter<T>::writePpm (
         ScalarFieldBase2D<T>& field,
         T minVal, T maxVal) const
 {
-    ScalarField2D<T> localField(field.getNx(), field.getNy());
-    copySerializedBlock(field, localField);
-    writePpmImplementation(fName, localField, minVal, maxVal);
+    ScalarField2D<T>* localField = gatherField(field);
+    writePpmImplementation(fName, *localField, minVal, maxVal);
+    delete localField;
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    ScalarFieldBase2D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -77,8 +85,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               ScalarFieldBase2D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeGif(fName, field, minVal, maxVal, 0, 0);
 }
 
 template<typename T>
@@ -87,8 +94,9 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    ScalarField2D<T>* localField = gatherField(field);
+    writeGifImplementation(fName, *localField, minVal, maxVal, sizeX, sizeY);
+    delete localField;
 }
 
 template<typename T>
@@ -107,10 +115,39 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
-                                    ScalarFieldBase2D<T>& field) const
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarFieldBase2D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, T(), T());
+    ScalarField2D<T>* localField = gatherField(field);
+    writePngImplementation(fName, *localField, minVal, maxVal, sizeX, sizeY);
+    delete localField;
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    ScalarFieldBase2D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeGifFrame(AnimatedGif& animation,
+                                   ScalarFieldBase2D<T>& field,
+                                   T minVal, T maxVal) const
+{
+    ScalarField2D<T>* localField = gatherField(field);
+    writeGifFrameImplementation(animation, *localField, minVal, maxVal);
+    delete localField;
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledGifFrame(AnimatedGif& animation,
+                                         ScalarFieldBase2D<T>& field) const
+{
+    writeGifFrame(animation, field, T(), T());
 }
 
 
@@ -120,28 +157,18 @@ void ImageWriter<T>::writePpm (
         ScalarFieldBase3D<T>& field,
         T minVal, T maxVal) const
 {
-    plint nx=0, ny=0;
-    if (field.getNx()==1) {
-        nx = field.getNy();
-        ny = field.getNz();
-    }
-    else if (field.getNy()==1) {
-        nx = field.getNx();
-        ny = field.getNz();
-    }
-    else if (field.getNz()==1) {
-        nx = field.getNx();
-        ny = field.getNy();
-    }
-    else {
-        return;
+    ScalarField2D<T>* localField = gatherField(field);
+    if (localField) {
+        writePpmImplementation(fName, *localField, minVal, maxVal);
+        delete localField;
     }
+}
 
-    ScalarField2D<T> localField(nx,ny);
-    serializerToUnSerializer(
-            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
-            localField.getBlockUnSerializer(localField.getBoundingBox(), IndexOrdering::forward) );
-    writePpmImplementation(fName, localField, minVal, maxVal);
+template<typename T>
+void ImageWriter<T>::writeScaledPpm(std::string const& fName,
+                                    ScalarFieldBase3D<T>& field) const
+{
+    writePpm(fName, field, T(), T());
 }
 
 template<typename T>
@@ -149,8 +176,7 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               ScalarFieldBase3D<T>& field,
                               T minVal, T maxVal) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickPpmToGif(fName);
+    writeGif(fName, field, minVal, maxVal, 0, 0);
 }
 
 template<typename T>
@@ -159,8 +185,11 @@ void ImageWriter<T>::writeGif(std::string const& fName,
                               T minVal, T maxVal,
                               plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, minVal, maxVal);
-    imageMagickResize(fName, sizeX, sizeY);
+    ScalarField2D<T>* localField = gatherField(field);
+    if (localField) {
+        writeGifImplementation(fName, *localField, minVal, maxVal, sizeX, sizeY);
+        delete localField;
+    }
 }
 
 template<typename T>
@@ -179,12 +208,80 @@ void ImageWriter<T>::writeScaledGif(std::string const& fName,
 }
 
 template<typename T>
-void ImageWriter<T>::writeScaledPpm(std::string const& fName,
-                                    ScalarFieldBase3D<T>& field) const
+void ImageWriter<T>::writePng(std::string const& fName,
+                              ScalarFieldBase3D<T>& field,
+                              T minVal, T maxVal,
+                              plint sizeX, plint sizeY) const
 {
-    writePpm(fName, field, T(), T());
+    ScalarField2D<T>* localField = gatherField(field);
+    if (localField) {
+        writePngImplementation(fName, *localField, minVal, maxVal, sizeX, sizeY);
+        delete localField;
+    }
 }
 
+template<typename T>
+void ImageWriter<T>::writeScaledPng(std::string const& fName,
+                                    ScalarFieldBase3D<T>& field,
+                                    plint sizeX, plint sizeY) const
+{
+    writePng(fName, field, T(), T(), sizeX, sizeY);
+}
+
+template<typename T>
+void ImageWriter<T>::writeGifFrame(AnimatedGif& animation,
+                                   ScalarFieldBase3D<T>& field,
+                                   T minVal, T maxVal) const
+{
+    ScalarField2D<T>* localField = gatherField(field);
+    if (localField) {
+        writeGifFrameImplementation(animation, *localField, minVal, maxVal);
+        delete localField;
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::writeScaledGifFrame(AnimatedGif& animation,
+                                         ScalarFieldBase3D<T>& field) const
+{
+    writeGifFrame(animation, field, T(), T());
+}
+
+
+template<typename T>
+ScalarField2D<T>* ImageWriter<T>::gatherField(ScalarFieldBase2D<T>& field) const
+{
+    ScalarField2D<T>* localField = new ScalarField2D<T>(field.getNx(), field.getNy());
+    copySerializedBlock(field, *localField);
+    return localField;
+}
+
+template<typename T>
+ScalarField2D<T>* ImageWriter<T>::gatherField(ScalarFieldBase3D<T>& field) const
+{
+    plint nx=0, ny=0;
+    if (field.getNx()==1) {
+        nx = field.getNy();
+        ny = field.getNz();
+    }
+    else if (field.getNy()==1) {
+        nx = field.getNx();
+        ny = field.getNz();
+    }
+    else if (field.getNz()==1) {
+        nx = field.getNx();
+        ny = field.getNy();
+    }
+    else {
+        return 0;
+    }
+
+    ScalarField2D<T>* localField = new ScalarField2D<T>(nx,ny);
+    serializerToUnSerializer(
+            field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward),
+            localField->getBlockUnSerializer(localField->getBoundingBox(), IndexOrdering::forward) );
+    return localField;
+}
 
 template<typename T>
 void ImageWriter<T>::writePpmImplementation (
@@ -223,49 +320,147 @@ void ImageWriter<T>::writePpmImplementation (
 }
 
 template<typename T>
-void ImageWriter<T>::imageMagickPpmToGif(std::string const& fName) const {
+void ImageWriter<T>::writePngImplementation (
+        std::string const& fName, ScalarField2D<T>& localField,
+        T minVal, T maxVal, plint sizeX, plint sizeY) const
+{
+    if (global::mpi().isMainProcessor()) {
+        plint width, height;
+        std::vector<double> positions;
+        computeColorPositions(localField, minVal, maxVal, sizeX, sizeY, width, height, positions);
+        std::vector<unsigned char> pixels(3*positions.size());
+        for (pluint iPixel=0; iPixel<positions.size(); ++iPixel) {
+            rgb color = colorMap.get(positions[iPixel]);
+            pixels[3*iPixel]   = (unsigned char) (color.r*255.);
+            pixels[3*iPixel+1] = (unsigned char) (color.g*255.);
+            pixels[3*iPixel+2] = (unsigned char) (color.b*255.);
+        }
+        std::string fullName = global::directories().getImageOutDir() + fName+".png";
+        bool success = writePngImage(fullName, width, height, pixels);
+        plbMainProcWarning(!success, "Error in writing the PNG image "+fullName);
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::writeGifImplementation (
+        std::string const& fName, ScalarField2D<T>& localField,
+        T minVal, T maxVal, plint sizeX, plint sizeY) const
+{
     if (global::mpi().isMainProcessor()) {
-#ifdef PLB_USE_POSIX
-        std::string convCommand =
-            std::string("convert ") +
-            global::directories().getImageOutDir() + fName + ".ppm " +
-            global::directories().getImageOutDir() + fName + ".gif ";
-            
-        std::string rmCommand =
-            std::string("/bin/rm ") +
-            global::directories().getImageOutDir() + fName + ".ppm";
-
-        plint errorConv = system(convCommand.c_str());
-        plbMainProcWarning(errorConv!=0, "Error in using ImageMagick convert command.");
-        plint errorRm = system(rmCommand.c_str());
-        plbMainProcWarning(errorRm!=0, "Error in removing temporary ppm file.");
-#endif  // PLB_USE_POSIX
+        plint width, height;
+        std::vector<double> positions;
+        computeColorPositions(localField, minVal, maxVal, sizeX, sizeY, width, height, positions);
+        std::vector<unsigned char> palette, indexes;
+        computeGifPalette(palette);
+        computeGifIndexes(positions, indexes);
+        std::string fullName = global::directories().getImageOutDir() + fName+".gif";
+        GifEncoder encoder(fullName, width, height, palette, false);
+        plbMainProcWarning(!encoder.isOpen(), "Error in writing the GIF image "+fullName);
+        encoder.addFrame(indexes);
     }
 }
 
 template<typename T>
-void ImageWriter<T>::imageMagickResize( std::string const& fName,
-                                        plint sizeX, plint sizeY) const
+void ImageWriter<T>::writeGifFrameImplementation (
+        AnimatedGif& animation, ScalarField2D<T>& localField,
+        T minVal, T maxVal) const
 {
-#ifdef PLB_USE_POSIX
     if (global::mpi().isMainProcessor()) {
-        std::stringstream imStream;
-        imStream << "convert -resize "
-                 << sizeX << "x" << sizeY << " "
-                 << global::directories().getImageOutDir()
-                 << fName << ".ppm "
-                 << global::directories().getImageOutDir()
-                 << fName << ".gif";
-        plint errorConv = system(imStream.str().c_str());
-        plbMainProcWarning(errorConv!=0, "Error in using ImageMagick convert command.");
-
-        std::string rmCommand =
-            std::string("/bin/rm ") +
-            global::directories().getImageOutDir() + fName + ".ppm";
-        plint errorRm = system(rmCommand.c_str());
-        plbMainProcWarning(errorRm!=0, "Error in removing temporary ppm file.");
+        plint width, height;
+        std::vector<double> positions;
+        computeColorPositions( localField, minVal, maxVal,
+                               animation.getSizeX(), animation.getSizeY(),
+                               width, height, positions );
+        std::vector<unsigned char> indexes;
+        computeGifIndexes(positions, indexes);
+        if (!animation.getEncoder()) {
+            std::vector<unsigned char> palette;
+            computeGifPalette(palette);
+            std::string fullName = global::directories().getImageOutDir()
+                                 + animation.getFileName()+".gif";
+            animation.setEncoder (
+                    new GifEncoder(fullName, width, height, palette, true, animation.getDelay()) );
+            plbMainProcWarning(!animation.getEncoder()->isOpen(),
+                               "Error in writing the GIF image "+fullName);
+        }
+        GifEncoder& encoder = *animation.getEncoder();
+        PLB_PRECONDITION( encoder.getWidth()==width && encoder.getHeight()==height );
+        encoder.addFrame(indexes);
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::computeColorPositions (
+        ScalarField2D<T>& localField, T minVal, T maxVal, plint sizeX, plint sizeY,
+        plint& width, plint& height, std::vector<double>& positions ) const
+{
+    if (std::fabs(minVal-maxVal)<1.e-12) {
+        minVal = computeMin(localField);
+        maxVal = computeMax(localField);
+    }
+    plint nx = localField.getNx();
+    plint ny = localField.getNy();
+    width  = nx;
+    height = ny;
+    if (sizeX>0 && sizeY>0) {
+        // Fit the image into sizeX by sizeY pixels, preserving the aspect ratio.
+        double scale = std::min((double)sizeX/(double)nx, (double)sizeY/(double)ny);
+        width  = std::max((plint)1, (plint)(scale*(double)nx+0.5));
+        height = std::max((plint)1, (plint)(scale*(double)ny+0.5));
+    }
+    double maxPosition = (double) (numColors-1) / (double) numColors;
+    positions.resize(width*height);
+    plint iPixel = 0;
+    for (plint iRow=height-1; iRow>=0; --iRow) {
+        // Bilinear interpolation between the cell values, sampled at the
+        //   center of each pixel.
+        double y = std::min( std::max((iRow+0.5)*(double)ny/(double)height-0.5, 0.), (double)(ny-1) );
+        plint iY0 = std::min((plint)y, ny-1);
+        plint iY1 = std::min(iY0+1, ny-1);
+        double wy = y-(double)iY0;
+        for (plint iCol=0; iCol<width; ++iCol, ++iPixel) {
+            double x = std::min( std::max((iCol+0.5)*(double)nx/(double)width-0.5, 0.), (double)(nx-1) );
+            plint iX0 = std::min((plint)x, nx-1);
+            plint iX1 = std::min(iX0+1, nx-1);
+            double wx = x-(double)iX0;
+            double value = (1.-wx)*(1.-wy)*(double)localField.get(iX0,iY0)
+                         + wx*(1.-wy)*(double)localField.get(iX1,iY0)
+                         + (1.-wx)*wy*(double)localField.get(iX0,iY1)
+                         + wx*wy*(double)localField.get(iX1,iY1);
+            double position = 0.;
+            if (! (minVal==maxVal) ) {
+                position = ( (value-(double)minVal) / (double) (maxVal-minVal) * maxPosition );
+            }
+            if (position <  0.) position = 0.;
+            if (position >= 1.) position = maxPosition;
+            positions[iPixel] = position;
+        }
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::computeGifPalette(std::vector<unsigned char>& palette) const
+{
+    plint numGifColors = std::min(numColors, (plint)256);
+    palette.resize(3*numGifColors);
+    for (plint iColor=0; iColor<numGifColors; ++iColor) {
+        rgb color = colorMap.get((double)iColor/(double)numGifColors);
+        palette[3*iColor]   = (unsigned char) (color.r*255.);
+        palette[3*iColor+1] = (unsigned char) (color.g*255.);
+        palette[3*iColor+2] = (unsigned char) (color.b*255.);
+    }
+}
+
+template<typename T>
+void ImageWriter<T>::computeGifIndexes(std::vector<double> const& positions,
+                                       std::vector<unsigned char>& indexes) const
+{
+    plint numGifColors = std::min(numColors, (plint)256);
+    indexes.resize(positions.size());
+    for (pluint iPixel=0; iPixel<positions.size(); ++iPixel) {
+        plint index = (plint) (positions[iPixel]*(double)numGifColors);
+        indexes[iPixel] = (unsigned char) std::min(index, numGifColors-1);
     }
-#endif  // PLB_USE_POSIX
 }
 
 }  // namespace plb
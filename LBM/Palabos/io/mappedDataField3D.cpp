@@ -0,0 +1,115 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Memory-mapped, read-only access to 3D fields saved on disk -- implementation.
+ */
+
+#include "io/mappedDataField3D.h"
+#include <fstream>
+#include <vector>
+
+#ifdef PLB_USE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace plb {
+
+namespace {
+    /// The characters "PLBM", identifying a mappable field file.
+    const plint mappedFieldMagicNumber = 0x504c424d;
+    const plint mappedFieldVersion = 1;
+    const plint numHeaderEntries = 8;
+}
+
+MappedFieldFile3D::MappedFieldFile3D(std::string fName, plint sizeOfScalar, plint sizeOfCell)
+    : fieldSize(0, 0, 0),
+      mapping(0),
+      mappingSize(0),
+      data(0)
+{
+    plint headerSize = numHeaderEntries*sizeof(plint);
+    std::vector<plint> header(numHeaderEntries);
+    std::ifstream istr(fName.c_str(), std::ios::binary);
+    if ( !istr.read(reinterpret_cast<char*>(&header[0]), headerSize) ||
+         header[0] != mappedFieldMagicNumber || header[1] != mappedFieldVersion ||
+         header[2] != (plint)sizeof(plint) || header[3] != sizeOfScalar ||
+         header[4] != sizeOfCell || header[5] < 0 || header[6] < 0 || header[7] < 0 )
+    {
+        return;
+    }
+    plint dataSize = header[5]*header[6]*header[7]*sizeOfCell*sizeOfScalar;
+#ifdef PLB_USE_POSIX
+    istr.close();
+    int fd = open(fName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat fileStatus;
+    mappingSize = headerSize + dataSize;
+    if (fstat(fd, &fileStatus) != 0 || (plint)fileStatus.st_size < mappingSize) {
+        close(fd);
+        return;
+    }
+    // A private mapping: the pages are loaded when they are accessed, and
+    //   modifications are never written back to the file.
+    void* address = mmap(0, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return;
+    }
+    mapping = static_cast<char*>(address);
+    data = mapping + headerSize;
+#else
+    mappingSize = dataSize;
+    mapping = new char[dataSize > 0 ? dataSize : 1];
+    if (!istr.read(mapping, dataSize)) {
+        delete [] mapping;
+        mapping = 0;
+        return;
+    }
+    data = mapping;
+#endif
+    fieldSize = Array<plint,3>(header[5], header[6], header[7]);
+}
+
+MappedFieldFile3D::~MappedFieldFile3D() {
+    if (mapping) {
+#ifdef PLB_USE_POSIX
+        munmap(mapping, mappingSize);
+#else
+        delete [] mapping;
+#endif
+    }
+}
+
+void MappedFieldFile3D::writeHeader( std::ostream& ostr, plint sizeOfScalar, plint sizeOfCell,
+                                     plint nx, plint ny, plint nz )
+{
+    plint header[numHeaderEntries] = {
+        mappedFieldMagicNumber, mappedFieldVersion, (plint)sizeof(plint),
+        sizeOfScalar, sizeOfCell, nx, ny, nz };
+    ostr.write(reinterpret_cast<char const*>(header), numHeaderEntries*sizeof(plint));
+}
+
+}  // namespace plb
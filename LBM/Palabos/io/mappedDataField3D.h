@@ -0,0 +1,121 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Memory-mapped, read-only access to 3D fields saved on disk -- header file.
+ */
+
+#ifndef MAPPED_DATA_FIELD_3D_H
+#define MAPPED_DATA_FIELD_3D_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "core/dataFieldBase3D.h"
+#include "atomicBlock/dataField3D.h"
+#include <string>
+
+namespace plb {
+
+/// A file written with saveMappableField(), mapped into memory.
+/** The file starts with a header of entries of type plint: a magic number,
+ *  the format version, sizeof(plint), the size of a scalar in bytes, the
+ *  number of scalars per cell, and the size of the field (nx, ny, nz). It
+ *  is followed by the raw content of the field in the native binary format
+ *  of the machine, in the memory order of ScalarField3D and TensorField3D:
+ *  the cells are ordered with z running fastest, and then y and x.
+ *
+ *  If Palabos is compiled with PLB_USE_POSIX, the file is mapped with
+ *  mmap(): the operating system loads the pages which are accessed, and
+ *  nothing else. The mapping is private: modifications of the data are
+ *  visible to the process only, and are never written back to the file.
+ *  Otherwise, the whole file is read into memory.
+ */
+class MappedFieldFile3D {
+public:
+    /// Map a file, if its header matches the given scalar and cell size.
+    MappedFieldFile3D(std::string fName, plint sizeOfScalar, plint sizeOfCell);
+    ~MappedFieldFile3D();
+    /// Tells whether the file was opened, matches the field type, and was mapped.
+    bool isMapped() const { return data != 0; }
+    /// Size of the field (nx, ny, nz), or zero if the file was not mapped.
+    Array<plint,3> const& getFieldSize() const { return fieldSize; }
+    /// Content of the field, or 0 if the file was not mapped.
+    char* getFieldData() { return data; }
+    /// Write the header of a file.
+    static void writeHeader( std::ostream& ostr, plint sizeOfScalar, plint sizeOfCell,
+                             plint nx, plint ny, plint nz );
+private:
+    MappedFieldFile3D(MappedFieldFile3D const& rhs);
+    MappedFieldFile3D& operator=(MappedFieldFile3D const& rhs);
+private:
+    Array<plint,3> fieldSize;
+    char* mapping;
+    plint mappingSize;
+    char* data;
+};
+
+/// A scalar-field whose content is a file written with saveMappableField().
+/** The field is an ordinary ScalarField3D, on which all data-analysis
+ *  functions for atomic fields can be executed. As the file is mapped into
+ *  memory, only the parts of the file which are accessed are read from
+ *  disk: computing the average over a sub-domain, or extracting a slice
+ *  for an ImageWriter with extractSubDomain(), touches the pages of the
+ *  sub-domain only. If the file cannot be opened, or if it was written for
+ *  another type, the field is empty and isValid() returns false.
+ */
+template<typename T>
+class MappedScalarField3D : private MappedFieldFile3D, public ScalarField3D<T> {
+public:
+    explicit MappedScalarField3D(std::string fName);
+    bool isValid() const { return isMapped(); }
+private:
+    MappedScalarField3D(MappedScalarField3D<T> const& rhs);
+    MappedScalarField3D<T>& operator=(MappedScalarField3D<T> const& rhs);
+};
+
+/// A tensor-field whose content is a file written with saveMappableField().
+/** See MappedScalarField3D. */
+template<typename T, int nDim>
+class MappedTensorField3D : private MappedFieldFile3D, public TensorField3D<T,nDim> {
+public:
+    explicit MappedTensorField3D(std::string fName);
+    bool isValid() const { return isMapped(); }
+private:
+    MappedTensorField3D(MappedTensorField3D<T,nDim> const& rhs);
+    MappedTensorField3D<T,nDim>& operator=(MappedTensorField3D<T,nDim> const& rhs);
+};
+
+/// Save the content of a scalar-field into a file which can be opened as a MappedScalarField3D.
+/** The field can be an atomic field or a multi-block. All data is funneled
+ *  through the main processor, which writes the file.
+ */
+template<typename T>
+void saveMappableField(ScalarFieldBase3D<T> const& field, std::string fName);
+
+/// Save the content of a tensor-field into a file which can be opened as a MappedTensorField3D.
+/** The field can be an atomic field or a multi-block. All data is funneled
+ *  through the main processor, which writes the file.
+ */
+template<typename T, int nDim>
+void saveMappableField(TensorFieldBase3D<T,nDim> const& field, std::string fName);
+
+}  // namespace plb
+
+#endif  // MAPPED_DATA_FIELD_3D_H
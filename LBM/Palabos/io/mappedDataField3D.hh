@@ -0,0 +1,97 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Memory-mapped, read-only access to 3D fields saved on disk -- generic implementation.
+ */
+
+#ifndef MAPPED_DATA_FIELD_3D_HH
+#define MAPPED_DATA_FIELD_3D_HH
+
+#include "io/mappedDataField3D.h"
+#include "atomicBlock/dataField3D.hh"
+#include "core/serializer.h"
+#include "core/plbDebug.h"
+#include "parallelism/mpiManager.h"
+#include <fstream>
+
+namespace plb {
+
+template<typename T>
+MappedScalarField3D<T>::MappedScalarField3D(std::string fName)
+    : MappedFieldFile3D(fName, sizeof(T), 1),
+      ScalarField3D<T>( getFieldSize()[0], getFieldSize()[1], getFieldSize()[2],
+                        reinterpret_cast<T*>(getFieldData()) )
+{ }
+
+template<typename T, int nDim>
+MappedTensorField3D<T,nDim>::MappedTensorField3D(std::string fName)
+    : MappedFieldFile3D(fName, sizeof(T), nDim),
+      TensorField3D<T,nDim>( getFieldSize()[0], getFieldSize()[1], getFieldSize()[2],
+                             reinterpret_cast<Array<T,nDim>*>(getFieldData()) )
+{ }
+
+template<typename T>
+void saveMappableField(ScalarFieldBase3D<T> const& field, std::string fName) {
+    std::ofstream* ostr = 0;
+    if (global::mpi().isMainProcessor()) {
+        ostr = new std::ofstream(fName.c_str(), std::ios::binary);
+        PLB_PRECONDITION( *ostr );
+        MappedFieldFile3D::writeHeader( *ostr, sizeof(T), 1,
+                                        field.getNx(), field.getNy(), field.getNz() );
+    }
+    DataSerializer<T> const* serializer =
+        field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward);
+    while (!serializer->isEmpty()) {
+        pluint bufferSize;
+        T const* dataBuffer = serializer->getNextDataBuffer(bufferSize);
+        if (ostr) {
+            ostr->write((char const*)dataBuffer, bufferSize*sizeof(T));
+        }
+    }
+    delete serializer;
+    delete ostr;
+}
+
+template<typename T, int nDim>
+void saveMappableField(TensorFieldBase3D<T,nDim> const& field, std::string fName) {
+    std::ofstream* ostr = 0;
+    if (global::mpi().isMainProcessor()) {
+        ostr = new std::ofstream(fName.c_str(), std::ios::binary);
+        PLB_PRECONDITION( *ostr );
+        MappedFieldFile3D::writeHeader( *ostr, sizeof(T), nDim,
+                                        field.getNx(), field.getNy(), field.getNz() );
+    }
+    DataSerializer<T> const* serializer =
+        field.getBlockSerializer(field.getBoundingBox(), IndexOrdering::forward);
+    while (!serializer->isEmpty()) {
+        pluint bufferSize;
+        T const* dataBuffer = serializer->getNextDataBuffer(bufferSize);
+        if (ostr) {
+            ostr->write((char const*)dataBuffer, bufferSize*sizeof(T));
+        }
+    }
+    delete serializer;
+    delete ostr;
+}
+
+}  // namespace plb
+
+#endif  // MAPPED_DATA_FIELD_3D_HH
@@ -0,0 +1,186 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Parallel checkpointing of 3D multi-blocks into a single binary file -- implementation.
+ */
+
+#include "io/parallelCheckpoint3D.h"
+#include "parallelism/mpiManager.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+
+namespace plb {
+
+namespace {
+    /// The characters "PLBC", identifying a parallel checkpoint file.
+    const plint checkpointMagicNumber = 0x504c4243;
+    const plint checkpointVersion = 1;
+    /// Number of header entries which precede the list of blocks.
+    const plint numFixedHeaderEntries = 12;
+    /// Number of header entries per block: the bulk, and the data offset.
+    const plint numHeaderEntriesPerBlock = 7;
+
+    /// Broadcast a vector of plint from the main processor, whose size is already known.
+    void broadcastEntries(std::vector<plint>& entries) {
+        if (!entries.empty()) {
+            global::mpi().bCast( reinterpret_cast<char*>(&entries[0]),
+                                 (int)(entries.size()*sizeof(plint)) );
+        }
+    }
+}
+
+ParallelCheckpointIndex3D::ParallelCheckpointIndex3D (
+        MultiBlockDistribution3D const& distribution, plint sizeOfScalar_, plint sizeOfCell_ )
+    : valid(true),
+      sizeOfScalar(sizeOfScalar_),
+      sizeOfCell(sizeOfCell_),
+      boundingBox(distribution.getBoundingBox()),
+      bulks(distribution.getNumBlocks()),
+      offsets(distribution.getNumBlocks())
+{
+    plint offset = computeHeaderSize();
+    for (plint iBlock=0; iBlock<distribution.getNumBlocks(); ++iBlock) {
+        bulks[iBlock] = distribution.getBlockParameters(iBlock).getBulk();
+        offsets[iBlock] = offset;
+        offset += bulks[iBlock].nCells()*sizeOfCell*sizeOfScalar;
+    }
+}
+
+ParallelCheckpointIndex3D::ParallelCheckpointIndex3D(ParallelBinaryFile& file)
+    : valid(false),
+      sizeOfScalar(0),
+      sizeOfCell(0)
+{
+    std::vector<plint> entries(numFixedHeaderEntries);
+    if (global::mpi().isMainProcessor()) {
+        file.readAt(0, reinterpret_cast<char*>(&entries[0]), numFixedHeaderEntries*sizeof(plint));
+    }
+    broadcastEntries(entries);
+    if ( entries[0] != checkpointMagicNumber || entries[1] != checkpointVersion ||
+         entries[2] != (plint)sizeof(plint) || entries[11] < 0 )
+    {
+        return;
+    }
+    sizeOfScalar = entries[3];
+    sizeOfCell   = entries[4];
+    boundingBox  = Box3D(entries[5], entries[6], entries[7], entries[8], entries[9], entries[10]);
+    plint numBlocks = entries[11];
+
+    std::vector<plint> blockEntries(numBlocks*numHeaderEntriesPerBlock);
+    if (global::mpi().isMainProcessor() && numBlocks>0) {
+        file.readAt( numFixedHeaderEntries*sizeof(plint), reinterpret_cast<char*>(&blockEntries[0]),
+                     blockEntries.size()*sizeof(plint) );
+    }
+    broadcastEntries(blockEntries);
+    bulks.resize(numBlocks);
+    offsets.resize(numBlocks);
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        plint const* blockEntry = &blockEntries[iBlock*numHeaderEntriesPerBlock];
+        bulks[iBlock] = Box3D( blockEntry[0], blockEntry[1], blockEntry[2],
+                               blockEntry[3], blockEntry[4], blockEntry[5] );
+        offsets[iBlock] = blockEntry[6];
+    }
+    valid = true;
+}
+
+void ParallelCheckpointIndex3D::write(ParallelBinaryFile& file) const {
+    if (global::mpi().isMainProcessor()) {
+        std::vector<plint> header(toHeader());
+        file.writeAt(0, reinterpret_cast<char const*>(&header[0]), header.size()*sizeof(plint));
+    }
+}
+
+void ParallelCheckpointIndex3D::readRegion (
+        ParallelBinaryFile& file, plint iBlock, Box3D region, char* data ) const
+{
+    Box3D const& bulk = bulks[iBlock];
+    PLB_PRECONDITION( contained(region, bulk) );
+    plint cellSize = sizeOfCell*sizeOfScalar;
+    plint lineSize = bulk.getNz()*cellSize;
+    plint planeSize = bulk.getNy()*lineSize;
+    plint offset = offsets[iBlock] + (region.x0-bulk.x0)*planeSize;
+    // Contiguous pieces of the file are read at once: the full region if it
+    //   covers the y- and z-extent of the bulk, and else planes or lines.
+    if (region.getNy()==bulk.getNy() && region.getNz()==bulk.getNz()) {
+        file.readAt(offset, data, region.getNx()*planeSize);
+    }
+    else if (region.getNz()==bulk.getNz()) {
+        plint regionLineSize = region.getNy()*lineSize;
+        for (plint iX=region.x0; iX<=region.x1; ++iX) {
+            file.readAt(offset + (region.y0-bulk.y0)*lineSize, data, regionLineSize);
+            offset += planeSize;
+            data += regionLineSize;
+        }
+    }
+    else {
+        plint regionLineSize = region.getNz()*cellSize;
+        for (plint iX=region.x0; iX<=region.x1; ++iX) {
+            for (plint iY=region.y0; iY<=region.y1; ++iY) {
+                file.readAt( offset + (iY-bulk.y0)*lineSize + (region.z0-bulk.z0)*cellSize,
+                             data, regionLineSize );
+                data += regionLineSize;
+            }
+            offset += planeSize;
+        }
+    }
+}
+
+std::vector<plint> ParallelCheckpointIndex3D::toHeader() const {
+    std::vector<plint> header;
+    header.push_back(checkpointMagicNumber);
+    header.push_back(checkpointVersion);
+    header.push_back((plint)sizeof(plint));
+    header.push_back(sizeOfScalar);
+    header.push_back(sizeOfCell);
+    header.push_back(boundingBox.x0);
+    header.push_back(boundingBox.x1);
+    header.push_back(boundingBox.y0);
+    header.push_back(boundingBox.y1);
+    header.push_back(boundingBox.z0);
+    header.push_back(boundingBox.z1);
+    header.push_back(getNumBlocks());
+    for (plint iBlock=0; iBlock<getNumBlocks(); ++iBlock) {
+        header.push_back(bulks[iBlock].x0);
+        header.push_back(bulks[iBlock].x1);
+        header.push_back(bulks[iBlock].y0);
+        header.push_back(bulks[iBlock].y1);
+        header.push_back(bulks[iBlock].z0);
+        header.push_back(bulks[iBlock].z1);
+        header.push_back(offsets[iBlock]);
+    }
+    PLB_ASSERT( (plint)header.size()*(plint)sizeof(plint) == computeHeaderSize() );
+    return header;
+}
+
+plint ParallelCheckpointIndex3D::getFileSize() const {
+    plint fileSize = computeHeaderSize();
+    for (plint iBlock=0; iBlock<getNumBlocks(); ++iBlock) {
+        fileSize = std::max( fileSize,
+                             offsets[iBlock] + bulks[iBlock].nCells()*sizeOfCell*sizeOfScalar );
+    }
+    return fileSize;
+}
+
+plint ParallelCheckpointIndex3D::computeHeaderSize() const {
+    return (numFixedHeaderEntries + getNumBlocks()*numHeaderEntriesPerBlock) * (plint)sizeof(plint);
+}
+
+}  // namespace plb
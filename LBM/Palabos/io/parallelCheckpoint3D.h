@@ -0,0 +1,123 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Parallel checkpointing of 3D multi-blocks into a single binary file -- header file.
+ */
+
+#ifndef PARALLEL_CHECKPOINT_3D_H
+#define PARALLEL_CHECKPOINT_3D_H
+
+#include "core/globalDefs.h"
+#include "core/geometry3D.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "io/parallelIO.h"
+#include <string>
+#include <vector>
+
+namespace plb {
+
+/// Index of a parallel checkpoint file: the bulk of each saved block, and
+///   the position of its data in the file.
+/** The file starts with a header, which contains the index, followed by
+ *  the raw data of the blocks. All entries of the header are of type plint:
+ *    - a magic number, the format version, sizeof(plint), the size of a
+ *      scalar in bytes, and the number of scalars per cell;
+ *    - the bounding box of the multi-block (x0, x1, y0, y1, z0, z1);
+ *    - the number of blocks, and for each block its bulk and the byte
+ *      offset of its data.
+ *  The data of a block is the content of its bulk, as produced by
+ *  BlockDataTransfer3D::send(): the cells are ordered with z running
+ *  fastest, and then y and x.
+ */
+class ParallelCheckpointIndex3D {
+public:
+    /// Index of a file for the blocks of a distribution.
+    ParallelCheckpointIndex3D( MultiBlockDistribution3D const& distribution,
+                               plint sizeOfScalar_, plint sizeOfCell_ );
+    /// Read the index from the header of a file. The header is read by
+    ///   the main processor, and broadcast to all other processes.
+    ParallelCheckpointIndex3D(ParallelBinaryFile& file);
+    /// Write the header of a file; executed by the main processor only.
+    void write(ParallelBinaryFile& file) const;
+    /// Tells whether a valid header was read.
+    bool isValid() const { return valid; }
+    Box3D const& getBoundingBox() const { return boundingBox; }
+    plint getSizeOfScalar() const { return sizeOfScalar; }
+    plint getSizeOfCell() const { return sizeOfCell; }
+    plint getNumBlocks() const { return (plint)bulks.size(); }
+    Box3D const& getBulk(plint iBlock) const { return bulks[iBlock]; }
+    /// Byte offset of the data of a block in the file.
+    plint getOffset(plint iBlock) const { return offsets[iBlock]; }
+    /// Minimal size, in bytes, of a file which contains the header and the data of all blocks.
+    plint getFileSize() const;
+    /// Read the data of a region of the bulk of a saved block into a buffer.
+    /** The region must be contained in the bulk of block iBlock. The data
+     *  is stored in the buffer in the order of BlockDataTransfer3D::send().
+     */
+    void readRegion(ParallelBinaryFile& file, plint iBlock, Box3D region, char* data) const;
+private:
+    std::vector<plint> toHeader() const;
+    plint computeHeaderSize() const;
+private:
+    bool valid;
+    plint sizeOfScalar, sizeOfCell;
+    Box3D boundingBox;
+    std::vector<Box3D> bulks;
+    std::vector<plint> offsets;
+};
+
+/// Save the raw content of a MultiBlock3D into a binary checkpoint file, in parallel.
+/** Each process writes the bulk of its own blocks directly into a single
+ *  shared file, at an offset which is computed from the data distribution
+ *  (through MPI-IO in a parallel program). There is no communication
+ *  between processes, apart from opening and closing the file.
+ *
+ *  The content includes external scalars in the case of a BlockLattice3D,
+ *  but not the dynamics objects. The data is written in the native binary
+ *  format of the machine.
+ *
+ *  \return False, on all processes, if the file could not be opened or if
+ *          any process failed to write its data.
+ */
+template<typename T>
+bool saveParallelCheckpoint(MultiBlock3D<T> const& multiBlock, std::string fName);
+
+/// Load the raw content of a MultiBlock3D from a file written with saveParallelCheckpoint().
+/** The multi-block must have the same bounding box and cell type as the one
+ *  which was saved, but it can have a different data distribution, and the
+ *  program can be executed on a different number of processes. Each
+ *  process reads the parts of the saved blocks which intersect its own
+ *  blocks. Cells which are not covered by any saved block are left
+ *  unchanged. The envelopes are updated after the data has been read.
+ *
+ *  \return False if the file could not be opened, if it does not match
+ *          the multi-block or is too short for the index in its header; in
+ *          this case the multi-block is not modified. False is also returned,
+ *          on all processes, if a read error occurs while the data is loaded;
+ *          the content of the multi-block is then undefined.
+ */
+template<typename T>
+bool loadParallelCheckpoint(MultiBlock3D<T>& multiBlock, std::string fName);
+
+}  // namespace plb
+
+#endif  // PARALLEL_CHECKPOINT_3D_H
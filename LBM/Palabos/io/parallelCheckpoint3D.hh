@@ -0,0 +1,131 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Parallel checkpointing of 3D multi-blocks into a single binary file -- generic implementation.
+ */
+
+#ifndef PARALLEL_CHECKPOINT_3D_HH
+#define PARALLEL_CHECKPOINT_3D_HH
+
+#include "io/parallelCheckpoint3D.h"
+#include "atomicBlock/atomicBlock3D.h"
+#include "multiBlock/blockCommunicator3D.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+
+namespace plb {
+
+/// Number of scalars up to which a block is transferred between memory and
+///   file in a single piece; larger blocks are cut into slices along x.
+const plint checkpointChunkSize = (plint)1 << 22;
+
+template<typename T>
+bool saveParallelCheckpoint(MultiBlock3D<T> const& multiBlock, std::string fName) {
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    plint sizeOfCell = multiBlock.sizeOfCell();
+    ParallelCheckpointIndex3D index(distribution, sizeof(T), sizeOfCell);
+    ParallelBinaryFile file(fName, ParallelBinaryFile::write);
+    if (!file.is_open()) {
+        return false;
+    }
+    index.write(file);
+
+    std::vector<T> buffer;
+    std::vector<plint> const& relevantBlocks = multiBlock.getRelevantBlocks();
+    for (pluint rBlock=0; rBlock<relevantBlocks.size(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        BlockParameters3D const& params = distribution.getBlockParameters(iBlock);
+        Box3D bulk = params.getBulk();
+        plint planeSize = bulk.getNy()*bulk.getNz()*sizeOfCell;
+        plint numPlanes = std::max((plint)1, checkpointChunkSize/std::max((plint)1, planeSize));
+        AtomicBlock3D<T> const& block = multiBlock.getComponent(iBlock);
+        for (plint x0=bulk.x0; x0<=bulk.x1; x0+=numPlanes) {
+            Box3D slice(x0, std::min(x0+numPlanes-1, bulk.x1), bulk.y0, bulk.y1, bulk.z0, bulk.z1);
+            plint sliceSize = slice.nCells()*sizeOfCell;
+            // The +1 avoids having a buffer of size 0 which one cannot point to
+            buffer.resize(sliceSize+1);
+            block.getDataTransfer().send(params.toLocal(slice), &buffer[0]);
+            file.writeAt( index.getOffset(iBlock) + (x0-bulk.x0)*planeSize*(plint)sizeof(T),
+                          reinterpret_cast<char const*>(&buffer[0]), sliceSize*(plint)sizeof(T) );
+        }
+    }
+    return file.good();
+}
+
+template<typename T>
+bool loadParallelCheckpoint(MultiBlock3D<T>& multiBlock, std::string fName) {
+    ParallelBinaryFile file(fName, ParallelBinaryFile::read);
+    if (!file.is_open()) {
+        return false;
+    }
+    // The index is identical on all processes, and so is the outcome of the tests.
+    ParallelCheckpointIndex3D index(file);
+    if (!file.good()) {
+        return false;
+    }
+    Box3D boundingBox = multiBlock.getBoundingBox();
+    Box3D savedBoundingBox = index.getBoundingBox();
+    if ( !index.isValid() ||
+         index.getSizeOfScalar() != (plint)sizeof(T) ||
+         index.getSizeOfCell() != multiBlock.sizeOfCell() ||
+         savedBoundingBox.x0 != boundingBox.x0 || savedBoundingBox.x1 != boundingBox.x1 ||
+         savedBoundingBox.y0 != boundingBox.y0 || savedBoundingBox.y1 != boundingBox.y1 ||
+         savedBoundingBox.z0 != boundingBox.z0 || savedBoundingBox.z1 != boundingBox.z1 ||
+         file.size() < index.getFileSize() )
+    {
+        return false;
+    }
+
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    plint sizeOfCell = multiBlock.sizeOfCell();
+    std::vector<T> buffer;
+    std::vector<plint> const& relevantBlocks = multiBlock.getRelevantBlocks();
+    for (pluint rBlock=0; rBlock<relevantBlocks.size(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        BlockParameters3D const& params = distribution.getBlockParameters(iBlock);
+        AtomicBlock3D<T>& block = multiBlock.getComponent(iBlock);
+        for (plint iSaved=0; iSaved<index.getNumBlocks(); ++iSaved) {
+            Box3D inters;
+            if (!intersect(params.getBulk(), index.getBulk(iSaved), inters)) {
+                continue;
+            }
+            plint planeSize = inters.getNy()*inters.getNz()*sizeOfCell;
+            plint numPlanes = std::max((plint)1, checkpointChunkSize/std::max((plint)1, planeSize));
+            for (plint x0=inters.x0; x0<=inters.x1; x0+=numPlanes) {
+                Box3D slice(x0, std::min(x0+numPlanes-1, inters.x1),
+                            inters.y0, inters.y1, inters.z0, inters.z1);
+                buffer.resize(slice.nCells()*sizeOfCell+1);
+                index.readRegion(file, iSaved, slice, reinterpret_cast<char*>(&buffer[0]));
+                block.getDataTransfer().receive(params.toLocal(slice), &buffer[0]);
+            }
+        }
+    }
+    // The envelopes are updated in any case, because the outcome must be collective.
+    bool success = file.good();
+    multiBlock.getBlockCommunicator().duplicateOverlaps(multiBlock);
+    return success;
+}
+
+}  // namespace plb
+
+#endif  // PARALLEL_CHECKPOINT_3D_HH
@@ -21,6 +21,8 @@
 #include "core/globalDefs.h"
 #include "parallelism/mpiManager.h"
 #include "io/parallelIO.h"
+#include "core/plbDebug.h"
+#include <algorithm>
 
 namespace plb {
 
@@ -45,12 +47,12 @@ plb_ofstream::plb_ofstream(const char* filename, std::ostream::openmode mode)
             new std::ofstream(filename,mode) : 0 )
 { }
 
-plb_ofstream::plb_ofstream(plb_ofstream const& rhs)
+plb_ofstream::plb_ofstream(plb_ofstream const&)
     : devNullStream(&devNullBuffer),
       original(0)
 { }
 
-plb_ofstream& plb_ofstream::operator=(plb_ofstream const& rhs) {
+plb_ofstream& plb_ofstream::operator=(plb_ofstream const&) {
     return *this;
 }
 
@@ -113,12 +115,12 @@ plb_ifstream::plb_ifstream(const char * filename, std::istream::openmode mode)
             new std::ifstream(filename,mode) : 0 )
 { }
 
-plb_ifstream::plb_ifstream(plb_ifstream const& rhs)
+plb_ifstream::plb_ifstream(plb_ifstream const&)
     : devNullStream(&devNullBuffer),
       original(0)
 { }
 
-plb_ifstream& plb_ifstream::operator=(plb_ifstream const& rhs) {
+plb_ifstream& plb_ifstream::operator=(plb_ifstream const&) {
     return *this;
 }
 
@@ -162,4 +164,164 @@ void plb_ifstream::close() {
 }
 
 
+/* *************** Class ParallelBinaryFile ******************************** */
+
+#ifdef PLB_MPI_PARALLEL
+
+namespace {
+    /// Largest number of bytes transferred in a single MPI-IO call, whose count is an int.
+    const plint maxBytesPerCall = (plint)1 << 30;
+}
+
+ParallelBinaryFile::ParallelBinaryFile(std::string fName, Mode mode_)
+    : mode(mode_),
+      isOpen(false),
+      failed(false)
+{
+    int amode = mode==write ? (MPI_MODE_CREATE | MPI_MODE_WRONLY) : MPI_MODE_RDONLY;
+    isOpen = MPI_File_open( MPI_COMM_WORLD, const_cast<char*>(fName.c_str()), amode,
+                            MPI_INFO_NULL, &file ) == MPI_SUCCESS;
+    if (isOpen && mode==write) {
+        failed = MPI_File_set_size(file, 0) != MPI_SUCCESS;
+    }
+}
+
+ParallelBinaryFile::~ParallelBinaryFile() {
+    if (isOpen) {
+        MPI_File_close(&file);
+    }
+}
+
+plint ParallelBinaryFile::size() {
+    MPI_Offset fileSize = -1;
+    if (!isOpen || MPI_File_get_size(file, &fileSize) != MPI_SUCCESS) {
+        return -1;
+    }
+    return (plint)fileSize;
+}
+
+void ParallelBinaryFile::writeAt(plint offset, char const* data, plint numBytes) {
+    if (!isOpen || mode!=write) {
+        failed = true;
+    }
+    while (numBytes > 0 && !failed) {
+        plint numBytesInCall = std::min(numBytes, maxBytesPerCall);
+        MPI_Status status;
+        int count = 0;
+        if ( MPI_File_write_at( file, (MPI_Offset)offset, const_cast<char*>(data),
+                                (int)numBytesInCall, MPI_CHAR, &status ) != MPI_SUCCESS ||
+             MPI_Get_count(&status, MPI_CHAR, &count) != MPI_SUCCESS ||
+             count != numBytesInCall )
+        {
+            failed = true;
+        }
+        offset += numBytesInCall;
+        data += numBytesInCall;
+        numBytes -= numBytesInCall;
+    }
+}
+
+void ParallelBinaryFile::readAt(plint offset, char* data, plint numBytes) {
+    if (!isOpen || mode!=read) {
+        failed = true;
+    }
+    while (numBytes > 0 && !failed) {
+        plint numBytesInCall = std::min(numBytes, maxBytesPerCall);
+        MPI_Status status;
+        int count = 0;
+        // A read beyond the end of the file succeeds, but with a smaller count.
+        if ( MPI_File_read_at( file, (MPI_Offset)offset, data,
+                               (int)numBytesInCall, MPI_CHAR, &status ) != MPI_SUCCESS ||
+             MPI_Get_count(&status, MPI_CHAR, &count) != MPI_SUCCESS ||
+             count != numBytesInCall )
+        {
+            failed = true;
+        }
+        offset += numBytesInCall;
+        data += numBytesInCall;
+        numBytes -= numBytesInCall;
+    }
+}
+
+bool ParallelBinaryFile::is_open() const {
+    int open = isOpen;
+    int allOpen = false;
+    global::mpi().reduce(open, allOpen, MPI_LAND);
+    global::mpi().bCast(&allOpen, 1);
+    return allOpen;
+}
+
+bool ParallelBinaryFile::good() {
+    // MPI_File_sync is collective; the file is open either on all processes or on none.
+    if (isOpen && mode==write && MPI_File_sync(file) != MPI_SUCCESS) {
+        failed = true;
+    }
+    int ok = isOpen && !failed;
+    global::mpi().reduceAndBcast(ok, MPI_LAND);
+    return ok;
+}
+
+#else
+
+ParallelBinaryFile::ParallelBinaryFile(std::string fName, Mode mode_)
+    : mode(mode_),
+      isOpen(false),
+      failed(false),
+      file ( new std::fstream ( fName.c_str(),
+                 mode==write ? (std::ios::out | std::ios::trunc | std::ios::binary)
+                             : (std::ios::in | std::ios::binary) ) )
+{
+    isOpen = file->is_open();
+}
+
+ParallelBinaryFile::~ParallelBinaryFile() {
+    delete file;
+}
+
+plint ParallelBinaryFile::size() {
+    if (!isOpen || failed) {
+        return -1;
+    }
+    std::streampos position = file->tellg();
+    file->seekg(0, std::ios::end);
+    plint fileSize = (plint)file->tellg();
+    file->seekg(position);
+    return fileSize;
+}
+
+void ParallelBinaryFile::writeAt(plint offset, char const* data, plint numBytes) {
+    if (!isOpen || mode!=write) {
+        failed = true;
+    }
+    if (!failed) {
+        file->seekp(offset);
+        file->write(data, numBytes);
+        failed = !file->good();
+    }
+}
+
+void ParallelBinaryFile::readAt(plint offset, char* data, plint numBytes) {
+    if (!isOpen || mode!=read) {
+        failed = true;
+    }
+    if (!failed) {
+        file->seekg(offset);
+        file->read(data, numBytes);
+        failed = !file->good() || file->gcount() != numBytes;
+    }
+}
+
+bool ParallelBinaryFile::is_open() const {
+    return isOpen;
+}
+
+bool ParallelBinaryFile::good() {
+    if (isOpen && mode==write && !failed) {
+        failed = !file->flush();
+    }
+    return isOpen && !failed;
+}
+
+#endif  // PLB_MPI_PARALLEL
+
 }  // namespace plb
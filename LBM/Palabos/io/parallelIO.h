@@ -28,6 +28,7 @@
 #include <ostream>
 #include <fstream>
 #include <iostream>
+#include <string>
 
 namespace plb {
 
@@ -38,7 +39,7 @@ namespace plb {
  */
 class DevNullBuffer : public std::streambuf {
 protected:
-    virtual int_type overflow(int_type c) {
+    virtual int_type overflow(int_type) {
         return EOF;
     }
     virtual int_type underflow() {
@@ -159,6 +160,52 @@ private:
     std::ifstream *original;
 };
 
+// Parallel Binary Files.
+
+/// A binary file which is read and written concurrently by all processes.
+/** Each process accesses the file at explicit byte offsets, independently
+ *  of the other processes. Opening the file (construction) and closing it
+ *  (destruction) are collective operations. In a parallel program, the
+ *  file is accessed through MPI-IO; otherwise through a C++ file stream.
+ */
+class ParallelBinaryFile {
+public:
+    enum Mode { read, write };
+public:
+    /// Open the file; in write mode, the file is created or truncated.
+    ParallelBinaryFile(std::string fName, Mode mode_);
+    ~ParallelBinaryFile();
+    /// Tells whether the file is open on all processes.
+    bool is_open() const;
+    /// Size of the file, in bytes, or -1 if it is not open.
+    plint size();
+    /// Write numBytes bytes, starting at byte offset of the file.
+    /** A failure is recorded, and reported by good(). */
+    void writeAt(plint offset, char const* data, plint numBytes);
+    /// Read numBytes bytes, starting at byte offset of the file.
+    /** A failure, including a read beyond the end of the file, is recorded,
+     *  and reported by good().
+     */
+    void readAt(plint offset, char* data, plint numBytes);
+    /// Tells whether the file is open and all reads and writes have succeeded so far, on all processes.
+    /** In write mode, the data is flushed to the file first. This is a
+     *  collective operation.
+     */
+    bool good();
+private:
+    ParallelBinaryFile(ParallelBinaryFile const& rhs);
+    ParallelBinaryFile& operator=(ParallelBinaryFile const& rhs);
+private:
+    Mode mode;
+    bool isOpen;
+    bool failed;
+#ifdef PLB_MPI_PARALLEL
+    MPI_File file;
+#else
+    std::fstream* file;
+#endif
+};
+
 }  // namespace plb
 
 #endif
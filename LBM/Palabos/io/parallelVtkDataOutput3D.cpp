@@ -0,0 +1,68 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Partitioned output of 3D multi-blocks into parallel VTK image files -- implementation.
+ */
+
+#include "io/parallelVtkDataOutput3D.h"
+
+namespace plb {
+
+Box3D computeVtkPieceExtent(MultiBlockDistribution3D const& distribution, plint blockId)
+{
+    Box3D bulk = distribution.getBlockParameters(blockId).getBulk();
+    // The additional nodes are read from the envelope.
+    if (distribution.getBlockParameters(blockId).getEnvelopeWidth()<1) {
+        return bulk;
+    }
+    Box3D const& boundingBox = distribution.getBoundingBox();
+    bool canExtend[3] = { bulk.x1<boundingBox.x1, bulk.y1<boundingBox.y1, bulk.z1<boundingBox.z1 };
+    // Try the extensions along all three upper faces first, and then subsets of
+    //   them, until the additional nodes are fully covered by other blocks.
+    for (plint subset=7; subset>0; --subset) {
+        bool extend[3] = { (subset&4)!=0, (subset&2)!=0, (subset&1)!=0 };
+        if ( (extend[0] && !canExtend[0]) || (extend[1] && !canExtend[1]) ||
+             (extend[2] && !canExtend[2]) )
+        {
+            continue;
+        }
+        Box3D extent( bulk.x0, bulk.x1 + (extend[0] ? 1:0),
+                      bulk.y0, bulk.y1 + (extend[1] ? 1:0),
+                      bulk.z0, bulk.z1 + (extend[2] ? 1:0) );
+        // The bulks of the blocks don't overlap: the additional nodes are
+        //   covered if the intersections with the other blocks add up to them.
+        plint numCovered = 0;
+        for (plint otherId=0; otherId<distribution.getNumBlocks(); ++otherId) {
+            Box3D intersection;
+            if ( otherId!=blockId &&
+                 intersect(extent, distribution.getBlockParameters(otherId).getBulk(), intersection) )
+            {
+                numCovered += intersection.nCells();
+            }
+        }
+        if (numCovered == extent.nCells()-bulk.nCells()) {
+            return extent;
+        }
+    }
+    return bulk;
+}
+
+}  // namespace plb
@@ -0,0 +1,97 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Partitioned output of 3D multi-blocks into parallel VTK image files -- header file.
+ */
+
+#ifndef PARALLEL_VTK_DATA_OUTPUT_3D_H
+#define PARALLEL_VTK_DATA_OUTPUT_3D_H
+
+#include "core/globalDefs.h"
+#include "core/geometry3D.h"
+#include "core/array.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/multiDataField3D.h"
+#include "io/vtkDataOutput.h"
+#include <string>
+#include <vector>
+
+namespace plb {
+
+/// Extent of the VTK piece through which a block of a distribution is written.
+/** The piece consists of the bulk of the block, extended by one node on its
+ *  upper faces, so that the pieces of neighboring blocks share a layer of
+ *  nodes and the visualized domain has no gaps. A face is extended only if
+ *  the additional nodes are inside the bulk of other blocks.
+ */
+Box3D computeVtkPieceExtent(MultiBlockDistribution3D const& distribution, plint blockId);
+
+/// Output of multi-block data fields into a parallel VTK image file (.pvti).
+/** Every process writes the blocks it owns into separate .vti piece files,
+ *  named fName_<blockId>.vti, and the main processor writes the .pvti file
+ *  which refers to all pieces. No data is gathered on the main processor.
+ *
+ *  The pieces overlap by one node (see computeVtkPieceExtent()), which is
+ *  read from the envelope of the blocks. The envelopes must therefore be
+ *  up to date, as is the case for fields computed by data processors.
+ *  All fields written into the same file must have the same distribution.
+ *  The files are completed by the destructor, which must be called on all
+ *  processes.
+ */
+template<typename T>
+class ParallelVtkImageOutput3D {
+public:
+    ParallelVtkImageOutput3D(std::string fName_, T deltaX_=(T)1);
+    ParallelVtkImageOutput3D(std::string fName_, T deltaX_, Array<T,3> offset_);
+    ~ParallelVtkImageOutput3D();
+    template<typename TConv>
+    void writeData(MultiScalarField3D<T> const& scalarField,
+                   std::string scalarFieldName, TConv scalingFactor=(T)1);
+    template<int n, typename TConv>
+    void writeData(MultiTensorField3D<T,n> const& tensorField,
+                   std::string tensorFieldName, TConv scalingFactor=(T)1);
+private:
+    ParallelVtkImageOutput3D(ParallelVtkImageOutput3D<T> const& rhs);
+    ParallelVtkImageOutput3D<T>& operator=(ParallelVtkImageOutput3D<T> const& rhs);
+    template<typename TConv>
+    void writeField(MultiBlock3D<T> const& multiBlock, std::string const& name,
+                    TConv scalingFactor, plint nDim);
+    void openPieces(MultiBlock3D<T> const& multiBlock);
+    void writeMasterFile() const;
+    std::string getPieceName(plint blockId) const;
+private:
+    std::string fName;
+    T deltaX;
+    Array<T,3> offset;
+    bool piecesOpen;
+    Box3D boundingBox;
+    std::vector<Box3D> pieceExtents;
+    std::vector<plint> localBlocks;
+    std::vector<VtkDataWriter3D*> localWriters;
+    /// Type name, name and number of components of each field.
+    std::vector<std::string> typeNames, names;
+    std::vector<plint> numComponents;
+};
+
+} // namespace plb
+
+#endif
@@ -0,0 +1,191 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Partitioned output of 3D multi-blocks into parallel VTK image files -- generic implementation.
+ */
+
+#ifndef PARALLEL_VTK_DATA_OUTPUT_3D_HH
+#define PARALLEL_VTK_DATA_OUTPUT_3D_HH
+
+#include "io/parallelVtkDataOutput3D.h"
+#include "io/vtkDataOutput.hh"
+#include "parallelism/mpiManager.h"
+#include <fstream>
+#include <sstream>
+
+namespace plb {
+
+////////// class ParallelVtkImageOutput3D ////////////////////////////////////
+
+template<typename T>
+ParallelVtkImageOutput3D<T>::ParallelVtkImageOutput3D(std::string fName_, T deltaX_)
+    : fName(fName_),
+      deltaX(deltaX_),
+      offset(T(),T(),T()),
+      piecesOpen(false)
+{ }
+
+template<typename T>
+ParallelVtkImageOutput3D<T>::ParallelVtkImageOutput3D(std::string fName_, T deltaX_, Array<T,3> offset_)
+    : fName(fName_),
+      deltaX(deltaX_),
+      offset(offset_),
+      piecesOpen(false)
+{ }
+
+template<typename T>
+ParallelVtkImageOutput3D<T>::~ParallelVtkImageOutput3D() {
+    if (piecesOpen) {
+        for (pluint iWriter=0; iWriter<localWriters.size(); ++iWriter) {
+            localWriters[iWriter]->endPiece();
+            localWriters[iWriter]->writeFooter();
+            delete localWriters[iWriter];
+        }
+        writeMasterFile();
+    }
+}
+
+template<typename T>
+std::string ParallelVtkImageOutput3D<T>::getPieceName(plint blockId) const {
+    std::stringstream pieceName;
+    pieceName << fName << "_" << blockId << ".vti";
+    return pieceName.str();
+}
+
+template<typename T>
+void ParallelVtkImageOutput3D<T>::openPieces(MultiBlock3D<T> const& multiBlock) {
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    boundingBox = distribution.getBoundingBox();
+    pieceExtents.resize(distribution.getNumBlocks());
+    for (plint blockId=0; blockId<distribution.getNumBlocks(); ++blockId) {
+        pieceExtents[blockId] = computeVtkPieceExtent(distribution, blockId);
+    }
+    localBlocks = multiBlock.getRelevantBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        Box3D extent = pieceExtents[localBlocks[iBlock]];
+        VtkDataWriter3D* writer = new VtkDataWriter3D (
+                global::directories().getVtkOutDir() + getPieceName(localBlocks[iBlock]),
+                global::IOpolicy().getVtkEncoding(), false );
+        writer->writeHeader(extent, offset, deltaX);
+        writer->startPiece(extent);
+        localWriters.push_back(writer);
+    }
+    piecesOpen = true;
+}
+
+template<typename T>
+template<typename TConv>
+void ParallelVtkImageOutput3D<T>::writeField (
+        MultiBlock3D<T> const& multiBlock, std::string const& name, TConv scalingFactor, plint nDim )
+{
+    if (!piecesOpen) {
+        openPieces(multiBlock);
+    }
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    PLB_PRECONDITION( distribution.getNumBlocks() == (plint)pieceExtents.size() );
+    PLB_PRECONDITION( multiBlock.getRelevantBlocks().size() == localBlocks.size() );
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        BlockParameters3D const& params = distribution.getBlockParameters(blockId);
+        localWriters[iBlock]->writeConvertedDataField (
+                multiBlock.getComponent(blockId).getBlockSerializer (
+                    params.toLocal(pieceExtents[blockId]), IndexOrdering::backward ),
+                name, scalingFactor, nDim );
+    }
+    if (VtkDataWriter3D::convertsToSinglePrecision<TConv>()) {
+        typeNames.push_back(VtkTypeNames<float>::getName());
+    }
+    else {
+        typeNames.push_back(VtkTypeNames<TConv>::getName());
+    }
+    names.push_back(name);
+    numComponents.push_back(nDim);
+}
+
+template<typename T>
+template<typename TConv>
+void ParallelVtkImageOutput3D<T>::writeData( MultiScalarField3D<T> const& scalarField,
+                                             std::string scalarFieldName, TConv scalingFactor )
+{
+    writeField(scalarField, scalarFieldName, scalingFactor, 1);
+}
+
+template<typename T>
+template<int n, typename TConv>
+void ParallelVtkImageOutput3D<T>::writeData( MultiTensorField3D<T,n> const& tensorField,
+                                             std::string tensorFieldName, TConv scalingFactor )
+{
+    writeField(tensorField, tensorFieldName, scalingFactor, n);
+}
+
+template<typename T>
+void ParallelVtkImageOutput3D<T>::writeMasterFile() const {
+    if (!global::mpi().isMainProcessor()) {
+        return;
+    }
+    std::string fullName = global::directories().getVtkOutDir() + fName + ".pvti";
+    std::ofstream ostr(fullName.c_str());
+    if (!ostr) {
+        std::cerr << "could not open file " <<  fullName << "\n";
+        return;
+    }
+    // The pieces are referred to relative to the directory of the .pvti file.
+    std::string::size_type slash = fName.find_last_of("/\\");
+    plint pathLength = slash==std::string::npos ? 0 : (plint)slash+1;
+
+    ostr << "<?xml version=\"1.0\"?>\n";
+    ostr << "<VTKFile type=\"PImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    ostr << "<PImageData WholeExtent=\""
+         << boundingBox.x0 << " " << boundingBox.x1 << " "
+         << boundingBox.y0 << " " << boundingBox.y1 << " "
+         << boundingBox.z0 << " " << boundingBox.z1 << "\" "
+         << "GhostLevel=\"0\" "
+         << "Origin=\""
+         << offset[0] << " " << offset[1] << " " << offset[2] << "\" "
+         << "Spacing=\""
+         << deltaX << " " << deltaX << " " << deltaX << "\">\n";
+    ostr << "<PPointData>\n";
+    for (pluint iField=0; iField<names.size(); ++iField) {
+        ostr << "<PDataArray type=\"" << typeNames[iField]
+             << "\" Name=\"" << names[iField];
+        if (numComponents[iField]>1) {
+            ostr << "\" NumberOfComponents=\"" << numComponents[iField];
+        }
+        ostr << "\" />\n";
+    }
+    ostr << "</PPointData>\n";
+    for (pluint blockId=0; blockId<pieceExtents.size(); ++blockId) {
+        Box3D const& extent = pieceExtents[blockId];
+        ostr << "<Piece Extent=\""
+             << extent.x0 << " " << extent.x1 << " "
+             << extent.y0 << " " << extent.y1 << " "
+             << extent.z0 << " " << extent.z1 << "\" "
+             << "Source=\"" << getPieceName(blockId).substr(pathLength) << "\" />\n";
+    }
+    ostr << "</PImageData>\n";
+    ostr << "</VTKFile>\n";
+}
+
+}  // namespace plb
+
+#endif
@@ -0,0 +1,55 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Asynchronous output of 3D blocks -- template instantiation.
+ */
+#include "io/asyncIO_3D.h"
+#include "io/asyncIO_3D.hh"
+
+namespace plb {
+
+template class StagingWriter<double>;
+template class StagedDataSerializer<double>;
+
+template
+void asyncSaveBinaryBlock<double>(Block3D<double> const& block, std::string fName, bool enforceUint);
+
+template
+void asyncWritePpm<double>(ImageWriter<double> const& imageWriter, std::string const& fName,
+                           ScalarFieldBase3D<double>& field, double minVal, double maxVal);
+
+template
+void asyncWriteScaledPpm<double>(ImageWriter<double> const& imageWriter, std::string const& fName,
+                                 ScalarFieldBase3D<double>& field);
+
+template class AsyncVtkImageOutput3D<double>;
+
+template
+void AsyncVtkImageOutput3D<double>::writeData<double> (
+        ScalarFieldBase3D<double> const& scalarField,
+        std::string scalarFieldName, double scalingFactor );
+
+template
+void AsyncVtkImageOutput3D<double>::writeData<3,double> (
+        TensorFieldBase3D<double,3> const& tensorField,
+        std::string tensorFieldName, double scalingFactor );
+
+}
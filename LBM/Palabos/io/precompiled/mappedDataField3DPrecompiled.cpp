@@ -0,0 +1,38 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Memory-mapped, read-only access to 3D fields saved on disk -- template instantiation.
+ */
+#include "io/mappedDataField3D.h"
+#include "io/mappedDataField3D.hh"
+
+namespace plb {
+
+template class MappedScalarField3D<double>;
+template class MappedTensorField3D<double,3>;
+
+template
+void saveMappableField<double>(ScalarFieldBase3D<double> const& field, std::string fName);
+
+template
+void saveMappableField<double,3>(TensorFieldBase3D<double,3> const& field, std::string fName);
+
+}
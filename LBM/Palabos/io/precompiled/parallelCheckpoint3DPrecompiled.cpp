@@ -0,0 +1,35 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Parallel checkpointing of 3D multi-blocks into a single binary file -- template instantiation.
+ */
+#include "io/parallelCheckpoint3D.h"
+#include "io/parallelCheckpoint3D.hh"
+
+namespace plb {
+
+template
+bool saveParallelCheckpoint<double>(MultiBlock3D<double> const& multiBlock, std::string fName);
+
+template
+bool loadParallelCheckpoint<double>(MultiBlock3D<double>& multiBlock, std::string fName);
+
+}
@@ -0,0 +1,41 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Partitioned output of 3D multi-blocks into parallel VTK image files -- template instantiation.
+ */
+#include "io/parallelVtkDataOutput3D.h"
+#include "io/parallelVtkDataOutput3D.hh"
+
+namespace plb {
+
+template class ParallelVtkImageOutput3D<double>;
+
+template
+void ParallelVtkImageOutput3D<double>::writeData<double> (
+        MultiScalarField3D<double> const& scalarField,
+        std::string scalarFieldName, double scalingFactor );
+
+template
+void ParallelVtkImageOutput3D<double>::writeData<3,double> (
+        MultiTensorField3D<double,3> const& tensorField,
+        std::string tensorFieldName, double scalingFactor );
+
+}
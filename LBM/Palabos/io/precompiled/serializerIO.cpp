@@ -32,7 +32,8 @@ template class AsciiWriter<double>;
 template class AsciiReader<double>;
 
 template
-void serializerToBase64Stream<double>(DataSerializer<double> const* serializer, std::ostream& ostr, bool enforceUint);
+void serializerToBase64Stream<double>(DataSerializer<double> const* serializer, std::ostream& ostr, bool enforceUint,
+                                      bool mainProcOnly);
 
 template
 void base64StreamToUnSerializer<double>(std::istream& istr, DataUnSerializer<double>* unSerializer, bool enforceUint);
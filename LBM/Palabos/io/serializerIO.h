@@ -33,9 +33,12 @@ namespace plb {
  *  you can enforce that the type of this variable is converted to "unsigned int".
  *  Note that this may lead to errors on 64-bit platforms, if the total amount of
  *  data exceeds 2 GB.
+ *  By default, the stream is written by the main processor only; with
+ *  mainProcOnly=false, every process writes the data of its own serializer.
  */
 template<typename T>
-void serializerToBase64Stream(DataSerializer<T> const* serializer, std::ostream& ostr, bool enforceUint=false);
+void serializerToBase64Stream(DataSerializer<T> const* serializer, std::ostream& ostr, bool enforceUint=false,
+                              bool mainProcOnly=true);
 
 /// Take an input stream with Base64 encoded binary content, and stream into an unSerializer
 /** If the integer value which indicates the amount of data to be unSerialized is of type
@@ -299,12 +299,14 @@ void AsciiReader<T>::readData(T* dataBuffer, pluint bufferSize) const
 /* *************** Free functions ************************************ */
 
 template<typename T>
-    void serializerToBase64Stream(DataSerializer<T> const* serializer, std::ostream& ostr, bool enforceUint)
+    void serializerToBase64Stream(DataSerializer<T> const* serializer, std::ostream& ostr, bool enforceUint,
+                                  bool mainProcOnly)
 {
     serializerToSink (
             serializer,
             new Base64Writer<T>(ostr, enforceUint,
-                                global::IOpolicy().getEndianSwitchOnBase64out()) );
+                                global::IOpolicy().getEndianSwitchOnBase64out()),
+            mainProcOnly );
 }
 
 template<typename T>
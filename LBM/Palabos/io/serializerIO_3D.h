@@ -63,6 +63,10 @@ void loadBinaryBlock(Block3D<T>& block, std::string fName, bool enforceUint=fals
  *  dependent on the structure of the multi-block. If data is written with saveRawMultiBlock()
  *  in a parallel program, the program which loads the data with loadRawMultiBlock() must
  *  have exactly the same number of cores.
+ *
+ *  All data is funneled through the main processor. For large multi-blocks,
+ *  saveParallelCheckpoint() is faster, and its files can be loaded onto a
+ *  different number of cores.
  */
 template<typename T>
 void saveRawMultiBlock(MultiBlock3D<T> const& block, std::string fName, bool enforceUint=false);
@@ -27,33 +27,174 @@
 #include "io/serializerIO.hh"
 #include "io/base64.h"
 #include "io/base64.hh"
+#include <algorithm>
+
+#ifdef PLB_USE_ZLIB
+#include <zlib.h>
+#endif
 
 namespace plb {
     
+////////// class VtkAppendedDataEncoder ////////////////////////////////
+
+const pluint VtkAppendedDataEncoder::blockSize;
+
+VtkAppendedDataEncoder::VtkAppendedDataEncoder(std::vector<char>& buffer_, bool compress_)
+    : buffer(buffer_),
+      compress(compress_),
+      remainingBytes(0),
+      numCompressedBlocks(0)
+{ }
+
+void VtkAppendedDataEncoder::startArray(pluint numBytes) {
+    PLB_PRECONDITION( remainingBytes==0 );
+    remainingBytes = numBytes;
+    if (compress) {
+        pluint numBlocks = (numBytes+blockSize-1) / blockSize;
+        header.resize(3+numBlocks);
+        header[0] = numBlocks;
+        header[1] = blockSize;
+        header[2] = numBytes % blockSize;
+        std::fill(header.begin()+3, header.end(), 0);
+        numCompressedBlocks = 0;
+        // Placeholder, until the compressed sizes of the blocks are known.
+        headerPosition = buffer.size();
+        append((char const*)&header[0], header.size()*sizeof(unsigned long long));
+        block.clear();
+        block.reserve(blockSize);
+    }
+    else {
+        unsigned long long size = numBytes;
+        append((char const*)&size, sizeof(size));
+    }
+    if (numBytes==0) {
+        completeArray();
+    }
+}
+
+void VtkAppendedDataEncoder::write(char const* data, pluint numBytes) {
+    PLB_PRECONDITION( numBytes <= remainingBytes );
+    remainingBytes -= numBytes;
+    if (compress) {
+        while (numBytes>0) {
+            pluint chunk = std::min(numBytes, (pluint)blockSize-block.size());
+            block.insert(block.end(), data, data+chunk);
+            data += chunk;
+            numBytes -= chunk;
+            if (block.size()==blockSize) {
+                compressBlock();
+            }
+        }
+    }
+    else {
+        append(data, numBytes);
+    }
+    if (remainingBytes==0) {
+        completeArray();
+    }
+}
+
+void VtkAppendedDataEncoder::compressBlock() {
+#ifdef PLB_USE_ZLIB
+    uLongf compressedSize = compressBound(block.size());
+    compressedBlock.resize(compressedSize);
+    // The fastest compression level is used, as the output is bound by the
+    //   time spent on the main processor.
+    int status = compress2( &compressedBlock[0], &compressedSize,
+                            (Bytef const*)&block[0], block.size(), Z_BEST_SPEED );
+    PLB_ASSERT( status==Z_OK );
+    (void) status;
+    append((char const*)&compressedBlock[0], compressedSize);
+    PLB_ASSERT( 3+numCompressedBlocks < header.size() );
+    header[3+numCompressedBlocks] = compressedSize;
+#endif
+    ++numCompressedBlocks;
+    block.clear();
+}
+
+void VtkAppendedDataEncoder::completeArray() {
+    if (compress) {
+        if (!block.empty()) {
+            compressBlock();
+        }
+        std::copy( (char const*)&header[0], (char const*)&header[0]+header.size()*sizeof(unsigned long long),
+                   buffer.begin()+headerPosition );
+    }
+}
+
+void VtkAppendedDataEncoder::append(char const* data, pluint numBytes) {
+    buffer.insert(buffer.end(), data, data+numBytes);
+}
+
+
 ////////// class VtkDataWriter3D ////////////////////////////////////////
 
-VtkDataWriter3D::VtkDataWriter3D(std::string const& fileName_)
+VtkDataWriter3D::VtkDataWriter3D(std::string const& fileName_, VtkEncoding::EncodingT encoding_,
+                                 bool mainProcOnly_)
     : fileName(fileName_),
-      ostr(0)
+      encoding(encoding_),
+      mainProcOnly(mainProcOnly_),
+      ostr(0),
+      appendedEncoder(0)
 {
-    if (global::mpi().isMainProcessor()) {
-        ostr = new std::ofstream(fileName.c_str());
+#ifndef PLB_USE_ZLIB
+    if (encoding==VtkEncoding::zlibAppended) {
+        encoding = VtkEncoding::rawAppended;
+    }
+#endif
+    if (writesOnThisProcess()) {
+        std::ios::openmode mode = std::ios::out;
+        if (isAppended()) {
+            mode |= std::ios::binary;
+        }
+        ostr = new std::ofstream(fileName.c_str(), mode);
         if (!(*ostr)) {
             std::cerr << "could not open file " <<  fileName << "\n";
             return;
         }
+        if (isAppended()) {
+            appendedEncoder = new VtkAppendedDataEncoder (
+                    appendedData, encoding==VtkEncoding::zlibAppended );
+        }
     }
 }
 
 VtkDataWriter3D::~VtkDataWriter3D() {
+    delete appendedEncoder;
     delete ostr;
 }
 
+VtkEncoding::EncodingT VtkDataWriter3D::getEncoding() const {
+    return encoding;
+}
+
+bool VtkDataWriter3D::isAppended() const {
+    return encoding != VtkEncoding::base64;
+}
+
+bool VtkDataWriter3D::writesOnThisProcess() const {
+    return !mainProcOnly || global::mpi().isMainProcessor();
+}
+
 void VtkDataWriter3D::writeHeader(Box3D domain, Array<double,3> origin, double deltaX)
 {
-    if (global::mpi().isMainProcessor()) {
+    if (writesOnThisProcess()) {
         (*ostr) << "<?xml version=\"1.0\"?>\n";
-        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        if (isAppended()) {
+            // Raw data is written in the byte order of the machine.
+            unsigned short one = 1;
+            bool littleEndian = *((unsigned char*)&one) == 1;
+            (*ostr) << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\""
+                    << (littleEndian ? "LittleEndian" : "BigEndian")
+                    << "\" header_type=\"UInt64\"";
+            if (encoding==VtkEncoding::zlibAppended) {
+                (*ostr) << " compressor=\"vtkZLibDataCompressor\"";
+            }
+            (*ostr) << ">\n";
+        }
+        else {
+            (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        }
         (*ostr) << "<ImageData WholeExtent=\""
                 << domain.x0 << " " << domain.x1 << " "
                 << domain.y0 << " " << domain.y1 << " "
@@ -66,7 +207,7 @@ void VtkDataWriter3D::writeHeader(Box3D domain, Array<double,3> origin, double d
 }
 
 void VtkDataWriter3D::startPiece(Box3D domain) {
-    if (global::mpi().isMainProcessor()) {
+    if (writesOnThisProcess()) {
         (*ostr) << "<Piece Extent=\""
                 << domain.x0 << " " << domain.x1 << " "
                 << domain.y0 << " " << domain.y1 << " "
@@ -76,15 +217,25 @@ void VtkDataWriter3D::startPiece(Box3D domain) {
 }
 
 void VtkDataWriter3D::endPiece() {
-    if (global::mpi().isMainProcessor()) {
+    if (writesOnThisProcess()) {
         (*ostr) << "</PointData>\n";
         (*ostr) << "</Piece>\n";
     }
 }
 
 void VtkDataWriter3D::writeFooter() {
-    if (global::mpi().isMainProcessor()) {
+    if (writesOnThisProcess()) {
         (*ostr) << "</ImageData>\n";
+        if (isAppended()) {
+            // The offsets of the data arrays are counted from the first
+            //   byte after the underscore.
+            (*ostr) << "<AppendedData encoding=\"raw\">\n_";
+            if (!appendedData.empty()) {
+                ostr->write(&appendedData[0], appendedData.size());
+            }
+            (*ostr) << "\n</AppendedData>\n";
+            std::vector<char>().swap(appendedData);
+        }
         (*ostr) << "</VTKFile>\n";
     }
 }
@@ -34,9 +34,57 @@
 
 namespace plb {
 
+/// Encoder for the appended-data section of a VTK XML file.
+/** Each data array is preceded by a UInt64 header. In raw format, the
+ *  header holds the size of the array in bytes. In compressed format, the
+ *  array is cut into blocks of blockSize bytes which are compressed with
+ *  zlib, and the header holds the number of blocks, the uncompressed size
+ *  of a block, the uncompressed size of the last block (zero if it is
+ *  full) and the compressed size of each block, as defined by
+ *  vtkZLibDataCompressor. The encoded data is appended to a memory buffer,
+ *  in which the header is completed once the whole array is compressed.
+ */
+class VtkAppendedDataEncoder {
+public:
+    VtkAppendedDataEncoder(std::vector<char>& buffer_, bool compress_);
+    /// Start a data array of numBytes bytes.
+    void startArray(pluint numBytes);
+    /// Append data to the current array; the array is completed automatically
+    ///   once all of its bytes have been received.
+    void write(char const* data, pluint numBytes);
+    static const pluint blockSize = 1<<16;
+private:
+    void compressBlock();
+    void completeArray();
+    void append(char const* data, pluint numBytes);
+private:
+    std::vector<char>& buffer;
+    bool compress;
+    pluint remainingBytes;
+    pluint headerPosition;
+    std::vector<unsigned long long> header;
+    pluint numCompressedBlocks;
+    std::vector<char> block;
+    std::vector<unsigned char> compressedBlock;
+};
+
+/// Writes an ImageData VTK XML file.
+/** The encoding of the data arrays (inline base64, or raw or compressed
+ *  appended data) is set at construction. In appended format, the encoded
+ *  data is kept in memory, as the offsets of the data arrays must be known
+ *  when their description is written, and it is written at the end of the
+ *  VTK file by writeFooter().
+ *
+ *  By default, the file is written by the main processor, which receives
+ *  the data of all processes from the serializers. With mainProcOnly=false,
+ *  every process which constructs the writer writes its own file, with the
+ *  data of local serializers (for example the serializer of an atomic block).
+ */
 class VtkDataWriter3D {
 public:
-    VtkDataWriter3D(std::string const& fileName_);
+    VtkDataWriter3D(std::string const& fileName_,
+                    VtkEncoding::EncodingT encoding_ = global::IOpolicy().getVtkEncoding(),
+                    bool mainProcOnly_ = true);
     ~VtkDataWriter3D();
     void writeHeader(Box3D domain, Array<double,3> origin, double deltaX);
     void startPiece(Box3D domain);
@@ -45,12 +93,28 @@ public:
     template <typename T>
     void writeDataField( DataSerializer<T> const* serializer,
                          std::string const& name, T scalingFactor, plint nDim );
+    /// Write a data field after converting it to type TConv, or to float if
+    ///   TConv is a floating-point type and single-precision output is
+    ///   requested through global::IOpolicy().setVtkSinglePrecision().
+    template <typename T, typename TConv>
+    void writeConvertedDataField( DataSerializer<T> const* serializer,
+                                  std::string const& name, TConv scalingFactor, plint nDim );
+    /// Tells whether writeConvertedDataField() converts data of type TConv to float.
+    template <typename TConv>
+    static bool convertsToSinglePrecision();
+    VtkEncoding::EncodingT getEncoding() const;
 private:
     VtkDataWriter3D(VtkDataWriter3D const& rhs);
     VtkDataWriter3D operator=(VtkDataWriter3D const& rhs);
+    bool isAppended() const;
+    bool writesOnThisProcess() const;
 private:
     std::string fileName;
+    VtkEncoding::EncodingT encoding;
+    bool mainProcOnly;
     std::ofstream *ostr;
+    std::vector<char> appendedData;
+    VtkAppendedDataEncoder *appendedEncoder;
 };
 
 template<typename T>
@@ -30,6 +30,7 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <limits>
 
 namespace plb {
 
@@ -56,13 +57,51 @@ std::string VtkTypeNames<T>::getName() {
 }
 
 
+////////// class VtkAppendedWriter ////////////////////////////////////
+
+/// Sink which hands serialized data over to a VtkAppendedDataEncoder.
+template<typename T>
+class VtkAppendedWriter : public SerializedWriter<T> {
+public:
+    VtkAppendedWriter(VtkAppendedDataEncoder* encoder_)
+        : encoder(encoder_)
+    { }
+    virtual VtkAppendedWriter<T>* clone() const {
+        return new VtkAppendedWriter<T>(*this);
+    }
+    virtual void writeHeader(pluint dataSize) {
+        encoder->startArray(dataSize*sizeof(T));
+    }
+    virtual void writeData(T const* dataBuffer, pluint bufferSize) {
+        encoder->write((char const*)dataBuffer, bufferSize*sizeof(T));
+    }
+private:
+    VtkAppendedDataEncoder* encoder;
+};
+
+
 ////////// class VtkDataWriter3D ////////////////////////////////////////
 
 template<typename T>
 void VtkDataWriter3D::writeDataField(DataSerializer<T> const* serializer,
                                      std::string const& name, T scalingFactor, plint nDim)
 {
-    if (global::mpi().isMainProcessor()) {
+    if (isAppended()) {
+        if (writesOnThisProcess()) {
+            (*ostr) << "<DataArray type=\"" << VtkTypeNames<T>::getName()
+                    << "\" Name=\"" << name
+                    << "\" format=\"appended\" offset=\"" << appendedData.size();
+            if (nDim>1) {
+                (*ostr) << "\" NumberOfComponents=\"" << nDim;
+            }
+            (*ostr) << "\" />\n";
+        }
+        serializerToSink<T>( new ScalingSerializer<T>(serializer, scalingFactor),
+                             new VtkAppendedWriter<T>(appendedEncoder), mainProcOnly );
+        return;
+    }
+
+    if (writesOnThisProcess()) {
         (*ostr) << "<DataArray type=\"" << VtkTypeNames<T>::getName()
                 << "\" Name=\"" << name
                 << "\" format=\"binary\" encoding=\"base64";
@@ -82,13 +121,34 @@ void VtkDataWriter3D::writeDataField(DataSerializer<T> const* serializer,
     // equal to UInt32. If not, you are on your own.
 
     bool enforceUint=true; // VTK uses "unsigned" to indicate the size of data, even on a 64-bit machine.
-    serializerToBase64Stream<T>(new ScalingSerializer<T>(serializer, scalingFactor), *ostr, enforceUint);
+    serializerToBase64Stream<T>(new ScalingSerializer<T>(serializer, scalingFactor), *ostr, enforceUint, mainProcOnly);
 
-    if (global::mpi().isMainProcessor()) {
+    if (writesOnThisProcess()) {
         (*ostr) << "\n</DataArray>\n";
     }
 }
 
+template<typename TConv>
+bool VtkDataWriter3D::convertsToSinglePrecision() {
+    return global::IOpolicy().getVtkSinglePrecision() &&
+           !std::numeric_limits<TConv>::is_integer &&
+           sizeof(TConv) > sizeof(float);
+}
+
+template<typename T, typename TConv>
+void VtkDataWriter3D::writeConvertedDataField(DataSerializer<T> const* serializer,
+                                              std::string const& name, TConv scalingFactor, plint nDim)
+{
+    if (convertsToSinglePrecision<TConv>()) {
+        writeDataField ( new TypeConversionSerializer<T,float>(serializer),
+                         name, (float)scalingFactor, nDim );
+    }
+    else {
+        writeDataField ( new TypeConversionSerializer<T,TConv>(serializer),
+                         name, scalingFactor, nDim );
+    }
+}
+
 
 ////////// class VtkImageOutput2D ////////////////////////////////////
 
@@ -145,9 +205,8 @@ void VtkImageOutput2D<T>::writeData( ScalarFieldBase2D<T> const& scalarField,
                                      std::string scalarFieldName, TConv scalingFactor )
 {
     writeHeader(scalarField.getNx(), scalarField.getNy());
-    vtkOut.writeDataField (
-            new TypeConversionSerializer<T,TConv> (
-                scalarField.getBlockSerializer(scalarField.getBoundingBox(), IndexOrdering::backward) ),
+    vtkOut.writeConvertedDataField (
+            scalarField.getBlockSerializer(scalarField.getBoundingBox(), IndexOrdering::backward),
             scalarFieldName, scalingFactor, 1);
 }
 
@@ -157,9 +216,8 @@ void VtkImageOutput2D<T>::writeData( TensorFieldBase2D<T,n> const& tensorField,
                                      std::string tensorFieldName, TConv scalingFactor )
 {
     writeHeader(tensorField.getNx(), tensorField.getNy());
-    vtkOut.writeDataField (
-            new TypeConversionSerializer<T,TConv> (
-                tensorField.getBlockSerializer(tensorField.getBoundingBox(), IndexOrdering::backward) ),
+    vtkOut.writeConvertedDataField (
+            tensorField.getBlockSerializer(tensorField.getBoundingBox(), IndexOrdering::backward),
             tensorFieldName, scalingFactor, n);
 }
 
@@ -220,9 +278,8 @@ void VtkImageOutput3D<T>::writeData( ScalarFieldBase3D<T> const& scalarField,
                                      std::string scalarFieldName, TConv scalingFactor )
 {
     writeHeader(scalarField.getNx(), scalarField.getNy(), scalarField.getNz());
-    vtkOut.writeDataField (
-            new TypeConversionSerializer<T,TConv> (
-                scalarField.getBlockSerializer(scalarField.getBoundingBox(), IndexOrdering::backward) ),
+    vtkOut.writeConvertedDataField (
+            scalarField.getBlockSerializer(scalarField.getBoundingBox(), IndexOrdering::backward),
             scalarFieldName, scalingFactor, 1 );
 }
 
@@ -232,9 +289,8 @@ void VtkImageOutput3D<T>::writeData( TensorFieldBase3D<T,n> const& tensorField,
                                      std::string tensorFieldName, TConv scalingFactor )
 {
     writeHeader(tensorField.getNx(), tensorField.getNy(), tensorField.getNz());
-    vtkOut.writeDataField (
-            new TypeConversionSerializer<T,TConv> (
-                tensorField.getBlockSerializer(tensorField.getBoundingBox(), IndexOrdering::backward) ),
+    vtkOut.writeConvertedDataField (
+            tensorField.getBlockSerializer(tensorField.getBoundingBox(), IndexOrdering::backward),
             tensorFieldName, scalingFactor, n );
 }
 
@@ -0,0 +1,275 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Batched versions of the BGK and regularized collision templates, which
+ * process several cells at once in the lanes of a SIMD register. The
+ * populations are accessed in a structure-of-arrays layout: f[iPop] points
+ * to the values of population iPop for a set of contiguous cells.
+ *
+ * The results are identical, up to round-off, to the ones of
+ * dynamicsTemplates and momentTemplates. The templates are generic and
+ * are valid for any lattice; on D2Q9, D3Q19 and D3Q27, the loops over the
+ * populations are completely unrolled by the compiler.
+ */
+#ifndef BATCHED_DYNAMICS_TEMPLATES_H
+#define BATCHED_DYNAMICS_TEMPLATES_H
+
+#include "core/globalDefs.h"
+#include "core/simdPack.h"
+#include "latticeBoltzmann/geometricOperationTemplates.h"
+
+namespace plb {
+
+/// Collision of one pack of cells; Pack is one of the types of core/simdPack.h.
+template<typename T, class Descriptor, class Pack>
+struct batchedDynamicsTemplatesImpl {
+
+enum { q = Descriptor::q, d = Descriptor::d, n = SymmetricTensorImpl<T,Descriptor::d>::n };
+
+static void load(T* const* f, plint iCell, Pack* fPack) {
+    for (plint iPop=0; iPop<q; ++iPop) {
+        fPack[iPop] = Pack::load(f[iPop]+iCell);
+    }
+}
+
+static void store(Pack const* fPack, T* const* f, plint iCell) {
+    for (plint iPop=0; iPop<q; ++iPop) {
+        fPack[iPop].store(f[iPop]+iCell);
+    }
+}
+
+/// Lane-wise a += c*b, for a lattice constant c.
+static void addMultiple(Pack& a, int c, Pack b) {
+    if (c==1) {
+        a += b;
+    }
+    else if (c==-1) {
+        a -= b;
+    }
+    else if (c!=0) {
+        a += Pack((T)c)*b;
+    }
+}
+
+/// The round-off policy of the descriptor is applied lane by lane.
+static Pack invRho(Pack rhoBar) {
+    T lanes[Pack::width];
+    rhoBar.store(lanes);
+    for (plint iLane=0; iLane<Pack::width; ++iLane) {
+        lanes[iLane] = Descriptor::invRho(lanes[iLane]);
+    }
+    return Pack::load(lanes);
+}
+
+static Pack normSqr(Pack const* j) {
+    Pack jSqr = j[0]*j[0];
+    for (int iD=1; iD<d; ++iD) {
+        jSqr += j[iD]*j[iD];
+    }
+    return jSqr;
+}
+
+static void get_rhoBar_j(Pack const* f, Pack& rhoBar, Pack* j) {
+    rhoBar = f[0];
+    for (int iD=0; iD<d; ++iD) {
+        j[iD] = Pack((T)Descriptor::c[0][iD])*f[0];
+    }
+    for (plint iPop=1; iPop<q; ++iPop) {
+        rhoBar += f[iPop];
+        for (int iD=0; iD<d; ++iD) {
+            addMultiple(j[iD], Descriptor::c[iPop][iD], f[iPop]);
+        }
+    }
+}
+
+static void compute_PiNeq(Pack const* f, Pack rhoBar, Pack invRho_, Pack const* j, Pack* PiNeq) {
+    int iPi = 0;
+    for (int iAlpha=0; iAlpha<d; ++iAlpha) {
+        int iDiagonal = iPi;
+        for (int iBeta=iAlpha; iBeta<d; ++iBeta) {
+            PiNeq[iPi] = Pack((T)(Descriptor::c[0][iAlpha]*Descriptor::c[0][iBeta])) * f[0];
+            for (plint iPop=1; iPop<q; ++iPop) {
+                addMultiple(PiNeq[iPi], Descriptor::c[iPop][iAlpha]*Descriptor::c[iPop][iBeta], f[iPop]);
+            }
+            // Stripe off relative velocity
+            PiNeq[iPi] -= invRho_*j[iAlpha]*j[iBeta];
+            ++iPi;
+        }
+        // Stripe off diagonal term
+        PiNeq[iDiagonal] -= Pack(Descriptor::cs2)*rhoBar;
+    }
+}
+
+static Pack bgk_ma2_equilibrium(plint iPop, Pack rhoBar, Pack invRho_, Pack const* j, Pack jSqr) {
+    Pack c_j = Pack((T)Descriptor::c[iPop][0])*j[0];
+    for (int iD=1; iD<d; ++iD) {
+        addMultiple(c_j, Descriptor::c[iPop][iD], j[iD]);
+    }
+    return Pack(Descriptor::t[iPop]) * (
+               rhoBar + Pack(Descriptor::invCs2) * c_j +
+               Pack(Descriptor::invCs2/(T)2) * invRho_ * (
+                   Pack(Descriptor::invCs2) * c_j*c_j - jSqr ) );
+}
+
+static Pack fromPiToFneq(plint iPop, Pack const* PiNeq) {
+    Pack fNeq((T)0);
+    int iPi = 0;
+    for (int iAlpha=0; iAlpha<d; ++iAlpha) {
+        fNeq += PiNeq[iPi] * Pack( (T)(Descriptor::c[iPop][iAlpha]*Descriptor::c[iPop][iAlpha])
+                                   - Descriptor::cs2 );
+        ++iPi;
+        for (int iBeta=iAlpha+1; iBeta<d; ++iBeta) {
+            addMultiple(fNeq, 2*Descriptor::c[iPop][iAlpha]*Descriptor::c[iPop][iBeta], PiNeq[iPi]);
+            ++iPi;
+        }
+    }
+    return fNeq * Pack(Descriptor::t[iPop] * Descriptor::invCs2 * Descriptor::invCs2 / (T)2);
+}
+
+static Pack bgk_ma2_collision(Pack* f, Pack rhoBar, Pack const* j, T omega) {
+    Pack invRho_ = invRho(rhoBar);
+    Pack jSqr = normSqr(j);
+    Pack omegaPack(omega), oneMinusOmega((T)1-omega);
+    for (plint iPop=0; iPop<q; ++iPop) {
+        f[iPop] = f[iPop]*oneMinusOmega +
+                  omegaPack*bgk_ma2_equilibrium(iPop, rhoBar, invRho_, j, jSqr);
+    }
+    return jSqr*invRho_*invRho_;
+}
+
+static Pack bgk_inc_collision(Pack* f, Pack rhoBar, Pack const* j, T omega) {
+    // In incompressible BGK, the Ma^2 term is preceeded by 1 instead of 1/rho.
+    Pack invRho_((T)1);
+    Pack jSqr = normSqr(j);
+    Pack omegaPack(omega), oneMinusOmega((T)1-omega);
+    for (plint iPop=0; iPop<q; ++iPop) {
+        f[iPop] = f[iPop]*oneMinusOmega +
+                  omegaPack*bgk_ma2_equilibrium(iPop, rhoBar, invRho_, j, jSqr);
+    }
+    return jSqr;
+}
+
+static Pack rlb_collision(Pack* f, Pack rhoBar, Pack const* j, Pack const* PiNeq, T omega) {
+    Pack invRho_ = invRho(rhoBar);
+    Pack jSqr = normSqr(j);
+    Pack oneMinusOmega((T)1-omega);
+    f[0] = bgk_ma2_equilibrium(0, rhoBar, invRho_, j, jSqr) +
+           oneMinusOmega*fromPiToFneq(0, PiNeq);
+    for (plint iPop=1; iPop<=q/2; ++iPop) {
+        Pack fNeq = oneMinusOmega*fromPiToFneq(iPop, PiNeq);
+        f[iPop]     = bgk_ma2_equilibrium(iPop, rhoBar, invRho_, j, jSqr) + fNeq;
+        f[iPop+q/2] = bgk_ma2_equilibrium(iPop+q/2, rhoBar, invRho_, j, jSqr) + fNeq;
+    }
+    return jSqr*invRho_*invRho_;
+}
+
+/// Load, collide with BGK and store back one pack of cells.
+static void bgk_ma2_batch(T* const* f, plint iCell, T omega, T* rhoBarOut, T* uSqrOut) {
+    Pack fPack[q], rhoBar, j[d];
+    load(f, iCell, fPack);
+    get_rhoBar_j(fPack, rhoBar, j);
+    Pack uSqr = bgk_ma2_collision(fPack, rhoBar, j, omega);
+    store(fPack, f, iCell);
+    writeStatistics(rhoBar, uSqr, iCell, rhoBarOut, uSqrOut);
+}
+
+/// Load, collide with incompressible BGK and store back one pack of cells.
+static void bgk_inc_batch(T* const* f, plint iCell, T omega, T* rhoBarOut, T* uSqrOut) {
+    Pack fPack[q], rhoBar, j[d];
+    load(f, iCell, fPack);
+    get_rhoBar_j(fPack, rhoBar, j);
+    Pack uSqr = bgk_inc_collision(fPack, rhoBar, j, omega);
+    store(fPack, f, iCell);
+    writeStatistics(rhoBar, uSqr, iCell, rhoBarOut, uSqrOut);
+}
+
+/// Load, collide with regularized BGK and store back one pack of cells.
+static void rlb_batch(T* const* f, plint iCell, T omega, T* rhoBarOut, T* uSqrOut) {
+    Pack fPack[q], rhoBar, j[d], PiNeq[n];
+    load(f, iCell, fPack);
+    get_rhoBar_j(fPack, rhoBar, j);
+    compute_PiNeq(fPack, rhoBar, invRho(rhoBar), j, PiNeq);
+    Pack uSqr = rlb_collision(fPack, rhoBar, j, PiNeq, omega);
+    store(fPack, f, iCell);
+    writeStatistics(rhoBar, uSqr, iCell, rhoBarOut, uSqrOut);
+}
+
+static void writeStatistics(Pack rhoBar, Pack uSqr, plint iCell, T* rhoBarOut, T* uSqrOut) {
+    if (rhoBarOut) {
+        rhoBar.store(rhoBarOut+iCell);
+    }
+    if (uSqrOut) {
+        uSqr.store(uSqrOut+iCell);
+    }
+}
+
+};  // struct batchedDynamicsTemplatesImpl
+
+
+/// Batched collision on contiguous cells, using the widest SIMD type available.
+/** Cells are processed by packs of simd::NativePack<T>::Pack::width; the
+ *  remainder is handled by the scalar fallback. If they are non-null, the
+ *  arrays rhoBar and uSqr receive the value of rhoBar and of the squared
+ *  velocity of each cell, for use in the statistics.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct batchedDynamicsTemplates {
+
+typedef typename Descriptor<T>::BaseDescriptor BaseDescriptor;
+typedef typename simd::NativePack<T>::Pack VectorPack;
+typedef batchedDynamicsTemplatesImpl<T, BaseDescriptor, VectorPack> VectorImpl;
+typedef batchedDynamicsTemplatesImpl<T, BaseDescriptor, simd::ScalarPack<T> > ScalarImpl;
+
+static void bgk_ma2_collision(T* const* f, plint numCells, T omega, T* rhoBar=0, T* uSqr=0) {
+    plint iCell=0;
+    for (; iCell+(plint)VectorPack::width<=numCells; iCell+=VectorPack::width) {
+        VectorImpl::bgk_ma2_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+    for (; iCell<numCells; ++iCell) {
+        ScalarImpl::bgk_ma2_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+}
+
+static void bgk_inc_collision(T* const* f, plint numCells, T omega, T* rhoBar=0, T* uSqr=0) {
+    plint iCell=0;
+    for (; iCell+(plint)VectorPack::width<=numCells; iCell+=VectorPack::width) {
+        VectorImpl::bgk_inc_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+    for (; iCell<numCells; ++iCell) {
+        ScalarImpl::bgk_inc_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+}
+
+static void rlb_collision(T* const* f, plint numCells, T omega, T* rhoBar=0, T* uSqr=0) {
+    plint iCell=0;
+    for (; iCell+(plint)VectorPack::width<=numCells; iCell+=VectorPack::width) {
+        VectorImpl::rlb_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+    for (; iCell<numCells; ++iCell) {
+        ScalarImpl::rlb_batch(f, iCell, omega, rhoBar, uSqr);
+    }
+}
+
+};  // struct batchedDynamicsTemplates
+
+}  // namespace plb
+
+#endif  // BATCHED_DYNAMICS_TEMPLATES_H
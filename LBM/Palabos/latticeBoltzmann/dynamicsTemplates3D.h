@@ -179,7 +179,7 @@ static T bgk_ma2_collision_base(Array<T,Descriptor::q>& f, T rhoBar, Array<T,3>
     C2 = -ky;
     C3 = -kxSqr_ - kzSqr_;
     f[2]  *= one_m_omega; f[2]  += t1_omega * (C1+C2+C3);
-    f[14] *= one_m_omega; f[14] += t1_omega * (C1-C2+C3);
+    f[15] *= one_m_omega; f[15] += t1_omega * (C1-C2+C3);
 
     // i=3 and i=16
     C2 = -kz;
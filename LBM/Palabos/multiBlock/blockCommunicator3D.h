@@ -38,6 +38,31 @@ struct BlockCommunicator3D {
     virtual void broadCastScalar(T& scalar, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const =0;
     virtual void broadCastVector(T* data, plint length, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const =0;
     virtual void duplicateOverlaps(MultiBlock3D<T>& multiBlock) const =0;
+    /// First half of a split duplicateOverlaps(): start the transfer of the overlaps.
+    /** Until finishDuplicateOverlaps() is invoked, the content of the blocks can
+     *  be modified outside the overlaps only. The default does nothing.
+     */
+    virtual void startDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const { }
+    /// Second half of a split duplicateOverlaps(): complete the transfer of the overlaps.
+    virtual void finishDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const {
+        duplicateOverlaps(multiBlock);
+    }
+    /// Send the data streamed into the envelope of each block back to the blocks which own these cells.
+    /** Only the data streamed from the bulk of the sending block is
+     *  transferred (see BlockDataTransfer3D::sendStreamed()). The envelopes
+     *  themselves are left unchanged.
+     */
+    virtual void returnStreamedData(MultiBlock3D<T>& multiBlock) const =0;
+    /// First half of a split returnStreamedData(): start the transfer of the streamed data.
+    /** Until finishReturnStreamedData() is invoked, the envelopes must be left
+     *  untouched, and the bulk can be modified outside the cells which receive
+     *  streamed data. The default does nothing.
+     */
+    virtual void startReturnStreamedData(MultiBlock3D<T>& multiBlock) const { }
+    /// Second half of a split returnStreamedData(): complete the transfer of the streamed data.
+    virtual void finishReturnStreamedData(MultiBlock3D<T>& multiBlock) const {
+        returnStreamedData(multiBlock);
+    }
     virtual void signalPeriodicity() const =0;
 };
 
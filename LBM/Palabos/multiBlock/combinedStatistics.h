@@ -38,6 +38,15 @@ public:
     void combine (
             std::vector<BlockStatistics<T> const*>& individualStatistics,
             BlockStatistics<T>& result ) const;
+    /// Like combine(), but the cross-process reduction may complete during the next call.
+    /** The result then contains the statistics which were combined in the
+     *  previous call, and the reduction of the present statistics overlaps
+     *  with the computations which precede the next call. The first call
+     *  produces the present statistics.
+     */
+    void combineAsynchronously (
+            std::vector<BlockStatistics<T> const*>& individualStatistics,
+            BlockStatistics<T>& result ) const;
 protected:
     virtual void reduceStatistics (
             std::vector<T>& averageObservables,
@@ -45,6 +54,22 @@ protected:
             std::vector<T>& sumObservables,
             std::vector<T>& maxObservables,
             std::vector<plint>& intSumObservables ) const =0;
+    /// Start the reduction of the present statistics, and replace them by
+    ///   the result of the previous reduction; by default, a blocking reduction.
+    virtual void reduceStatisticsAsynchronously (
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const;
+private:
+    void computeLocalStatistics (
+            std::vector<BlockStatistics<T> const*> const& individualStatistics,
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const;
 private:
     void computeLocalAverage (
             std::vector<BlockStatistics<T> const*> const& individualStatistics,
@@ -109,27 +109,35 @@ void CombinedStatistics<T>::computeLocalIntSum (
 }
 
 
+template<typename T>
+void CombinedStatistics<T>::computeLocalStatistics (
+            std::vector<BlockStatistics<T> const*> const& individualStatistics,
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const
+{
+    computeLocalAverage(individualStatistics, averageObservables, sumWeights);
+    computeLocalSum(individualStatistics, sumObservables);
+    computeLocalMax(individualStatistics, maxObservables);
+    computeLocalIntSum(individualStatistics, intSumObservables);
+}
+
 template<typename T>
 void CombinedStatistics<T>::combine (
             std::vector<BlockStatistics<T> const*>& individualStatistics,
             BlockStatistics<T>& result ) const
 {
-    // Local averages
+    // Local statistics
     std::vector<T> averageObservables(result.getAverageVect().size());
     std::vector<T> sumWeights(result.getAverageVect().size());
-    computeLocalAverage(individualStatistics, averageObservables, sumWeights);
-
-    // Local sums
     std::vector<T> sumObservables(result.getSumVect().size());
-    computeLocalSum(individualStatistics, sumObservables);
-
-    // Local maxima
     std::vector<T> maxObservables(result.getMaxVect().size());
-    computeLocalMax(individualStatistics, maxObservables);
-
-    // Local integer sums
     std::vector<plint> intSumObservables(result.getIntSumVect().size());
-    computeLocalIntSum(individualStatistics, intSumObservables);
+    computeLocalStatistics (
+            individualStatistics, averageObservables, sumWeights,
+            sumObservables, maxObservables, intSumObservables );
 
     // Compute global, cross-core statistics
     this->reduceStatistics (
@@ -143,6 +151,45 @@ void CombinedStatistics<T>::combine (
         averageObservables, sumObservables, maxObservables, intSumObservables, 0 );
 }
 
+template<typename T>
+void CombinedStatistics<T>::combineAsynchronously (
+            std::vector<BlockStatistics<T> const*>& individualStatistics,
+            BlockStatistics<T>& result ) const
+{
+    std::vector<T> averageObservables(result.getAverageVect().size());
+    std::vector<T> sumWeights(result.getAverageVect().size());
+    std::vector<T> sumObservables(result.getSumVect().size());
+    std::vector<T> maxObservables(result.getMaxVect().size());
+    std::vector<plint> intSumObservables(result.getIntSumVect().size());
+    computeLocalStatistics (
+            individualStatistics, averageObservables, sumWeights,
+            sumObservables, maxObservables, intSumObservables );
+
+    this->reduceStatisticsAsynchronously (
+            averageObservables, sumWeights,
+            sumObservables,
+            maxObservables,
+            intSumObservables );
+
+    result.evaluate (
+        averageObservables, sumObservables, maxObservables, intSumObservables, 0 );
+}
+
+template<typename T>
+void CombinedStatistics<T>::reduceStatisticsAsynchronously (
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const
+{
+    this->reduceStatistics (
+            averageObservables, sumWeights,
+            sumObservables,
+            maxObservables,
+            intSumObservables );
+}
+
 
 template<typename T>
 SerialCombinedStatistics<T>* SerialCombinedStatistics<T>::clone() const {
@@ -25,6 +25,7 @@
 #define DEFAULT_MULTI_BLOCK_POLICY_3D_H
 
 #include "core/globalDefs.h"
+#include "core/plbDebug.h"
 #include "multiBlock/serialBlockCommunicator3D.h"
 #include "parallelism/parallelBlockCommunicator3D.h"
 #include "multiBlock/combinedStatistics.h"
@@ -95,11 +96,24 @@ public:
     }
 
     MultiBlockManagement3D getMultiBlockManagement(plint nx, plint ny, plint nz) {
-        plint envelopeWidth = 1;
         return MultiBlockManagement3D( createRegularMultiBlockDistribution3D(nx,ny,nz, envelopeWidth, numProcesses),
                                        getThreadAttribution() );
     }
 
+    /// Width of the envelope of newly created multi-blocks.
+    /** A width of k times the vicinity of the lattice descriptor lets
+     *  MultiBlockLattice3D::multiStepCollideAndStream() execute k time steps
+     *  between two exchanges of the envelopes.
+     */
+    void setEnvelopeWidth(plint envelopeWidth_) {
+        PLB_PRECONDITION( envelopeWidth_ >= 1 );
+        envelopeWidth = envelopeWidth_;
+    }
+
+    plint getEnvelopeWidth() const {
+        return envelopeWidth;
+    }
+
     void setNumProcesses(int numProcesses_) {
         numProcesses = numProcesses_;
     }
@@ -109,11 +123,13 @@ public:
     }
 private:
     DefaultMultiBlockPolicy3D()
-        : numProcesses(global::mpi().getSize())
+        : numProcesses(global::mpi().getSize()),
+          envelopeWidth(1)
     { }
     friend DefaultMultiBlockPolicy3D& defaultMultiBlockPolicy3D();
 private:
     int numProcesses;
+    plint envelopeWidth;
 };
 
 inline DefaultMultiBlockPolicy3D& defaultMultiBlockPolicy3D() {
@@ -36,3 +36,4 @@
 #include "multiBlock/multiBlockSerializer3D.hh"
 #include "multiBlock/multiLatticeInitializer3D.hh"
 #include "multiBlock/combinedStatistics.hh"
+#include "multiBlock/staticRepartitions3D.hh"
@@ -29,6 +29,7 @@
 #include "multiBlock/blockCommunicator3D.h"
 #include "multiBlock/combinedStatistics.h"
 #include "core/block3D.h"
+#include "parallelism/smpManager.h"
 
 namespace plb {
 
@@ -85,9 +86,24 @@ public:
 public:
     void toggleInternalStatistics(bool statisticsOn_);
     bool isInternalStatisticsOn() const;
+    /// Reduce the internal statistics over processes asynchronously (see
+    ///   CombinedStatistics::combineAsynchronously()): the values of the
+    ///   internal statistics then lag behind by one evaluation.
+    void toggleAsynchronousStatistics(bool asynchronousStatistics_);
+    bool isAsynchronousStatisticsOn() const;
     BlockParameters3D const& getParameters(plint iBlock) const {
         return getMultiBlockManagement().getMultiBlockDistribution().getBlockParameters(iBlock);
     }
+    /// Execute a task on each relevant block, concurrently if threads are enabled.
+    /** If block timing is on, the time spent on each block is accumulated. */
+    void executeOnRelevantBlocks(BlockTask& task);
+    /// Measure the time spent on each local block in executeOnRelevantBlocks() (default: false).
+    void toggleBlockTiming(bool blockTimingOn_);
+    bool isBlockTimingOn() const { return blockTimingOn; }
+    /// Time accumulated on each block since the last reset, indexed by block id.
+    /** The entries of non-local blocks are zero. */
+    std::vector<double> const& getBlockTimes() const { return blockTimes; }
+    void resetBlockTimes();
 public:
     virtual void executeDataProcessor(DataProcessorGenerator3D<T> const& generator);
     virtual void executeDataProcessor(ReductiveDataProcessorGenerator3D<T>& generator);
@@ -96,15 +112,62 @@ public:
     virtual void executeInternalProcessors(plint level);
     void subscribeProcessor(plint level, std::vector<MultiBlock3D<T>*> modifiedBlocks,
                             bool includesEnvelope);
+    /// Keep a copy of the generator of an internal processor which involves this multi-block.
+    void recordInternalProcessor(DataProcessorGenerator3D<T> const& generator,
+                                 std::vector<MultiBlock3D<T>*> multiBlocks, plint level);
+    /// Tells whether an internal processor couples this multi-block to another one.
+    bool hasCoupledProcessors() const;
+    /// Replace the internal processors of the local components by new instances of the recorded ones.
+    /** This is used after the components have been redistributed over the
+     *  processes. Processors which have been added directly to a component,
+     *  without going through the multi-block, are removed. The processors are
+     *  re-created by their generators: their internal state, if any, is reset.
+     */
+    void reinstantiateInternalProcessors();
+    /// Tells whether internal processors are executed after each iteration.
+    bool hasInternalProcessors() const { return maxProcessorLevel >= 0; }
+    /// Declare that the cells of the envelopes are accessed after each iteration.
+    /** Unless this is declared, a multi-block lattice updates only the
+     *  populations which are streamed across the boundaries of its
+     *  components, and leaves the rest of the envelopes incomplete (see
+     *  MultiBlockLattice3D::collideAndStream()). Data processors, internal or
+     *  executed through executeDataProcessor(), complete the envelopes of the
+     *  multi-blocks they access beforehand; this declaration is only needed
+     *  if the envelopes of the components are accessed directly after each
+     *  iteration.
+     */
+    void signalEnvelopeAccess() { envelopeAccessed = true; }
+    /// Tells whether the envelopes must hold complete copies of the neighboring cells after each iteration.
+    bool requiresFullEnvelope() const { return envelopeAccessed; }
+    /// Bring the envelopes up to date, if the last iteration has left them incomplete.
+    /** This is called before a data processor is executed on the multi-block,
+     *  and does nothing by default (see MultiBlockLattice3D::collideAndStream()).
+     */
+    virtual void completeEnvelopes() { }
+    /// Bring the envelopes in agreement with the bulk, after the bulk has been modified by internal processors.
+    /** By default, the overlaps are duplicated immediately. A multi-block
+     *  which keeps track of incomplete envelopes can defer this to the next
+     *  call to completeEnvelopes().
+     */
+    virtual void refreshEnvelopes();
 public:
     virtual void signalPeriodicity();
+protected:
+    /// Replace the distribution of the components, e.g. after they were migrated between processes.
+    /** The components themselves are handled by the derived class. */
+    void swapMultiBlockManagement(MultiBlockManagement3D& newManagement);
+    /// Copy the records of the internal processors from another multi-block.
+    /** References to rhs in the records are replaced by references to this multi-block. */
+    void copyProcessorRecords(MultiBlock3D<T> const& rhs);
 private:
+    void clearProcessorRecords();
     void reduceStatistics();
     void addModifiedBlocks(plint level, std::vector<MultiBlock3D<T>*> modifiedBlocks,
                            std::vector<std::vector<MultiBlock3D<T>*> >& multiBlockCollection,
                            bool includesEnvelope);
     void duplicateOverlapsInModifiedMultiBlocks(plint level);
     void duplicateOverlapsInModifiedMultiBlocks(std::vector<MultiBlock3D<T>*>& multiBlocks);
+    void completeEnvelopesOfProcessors(plint level);
 private:
     MultiBlockManagement3D multiBlockManagement;
     BlockCommunicator3D<T>* blockCommunicator;
@@ -114,8 +177,16 @@ private:
     std::vector<std::vector<MultiBlock3D<T>*> > multiBlocksChangedByManualProcessors;
     /// List of MultiBlocks which are modified by the automatic processors and require an update of their envelope.
     std::vector<std::vector<MultiBlock3D<T>*> > multiBlocksChangedByAutomaticProcessors;
+    /// Generators, multi-blocks and levels of the internal processors which involve this multi-block.
+    std::vector<DataProcessorGenerator3D<T>*> recordedGenerators;
+    std::vector<std::vector<MultiBlock3D<T>*> > recordedMultiBlocks;
+    std::vector<plint> recordedLevels;
     plint maxProcessorLevel;
+    bool envelopeAccessed;
     bool statisticsOn;
+    bool asynchronousStatistics;
+    bool blockTimingOn;
+    std::vector<double> blockTimes;
 };
 
 } // namespace plb
@@ -99,7 +99,10 @@ MultiBlock3D<T>::MultiBlock3D( MultiBlockManagement3D const& multiBlockManagemen
       combinedStatistics(combinedStatistics_),
       statSubscriber(*this),
       maxProcessorLevel(-1),
-      statisticsOn(true)
+      envelopeAccessed(false),
+      statisticsOn(true),
+      asynchronousStatistics(false),
+      blockTimingOn(false)
 { }
 
 template<typename T>
@@ -109,7 +112,10 @@ MultiBlock3D<T>::MultiBlock3D(plint nx, plint ny, plint nz)
       combinedStatistics( defaultMultiBlockPolicy3D().getCombinedStatistics<T>() ),
       statSubscriber(*this),
       maxProcessorLevel(-1),
-      statisticsOn(true)
+      envelopeAccessed(false),
+      statisticsOn(true),
+      asynchronousStatistics(false),
+      blockTimingOn(false)
 { }
 
 template<typename T>
@@ -120,7 +126,11 @@ MultiBlock3D<T>::MultiBlock3D(MultiBlock3D<T> const& rhs)
     combinedStatistics(rhs.combinedStatistics -> clone()),
     statSubscriber(*this),
     maxProcessorLevel(rhs.maxProcessorLevel),
-    statisticsOn(rhs.statisticsOn)
+    envelopeAccessed(rhs.envelopeAccessed),
+    statisticsOn(rhs.statisticsOn),
+    asynchronousStatistics(rhs.asynchronousStatistics),
+    blockTimingOn(rhs.blockTimingOn),
+    blockTimes(rhs.blockTimes)
 { }
 
 template<typename T>
@@ -131,7 +141,10 @@ MultiBlock3D<T>::MultiBlock3D(MultiBlock3D<T> const& rhs, Box3D subDomain, bool
     combinedStatistics(rhs.combinedStatistics -> clone()),
     statSubscriber(*this),
     maxProcessorLevel(rhs.maxProcessorLevel),
-    statisticsOn(rhs.statisticsOn)
+    envelopeAccessed(rhs.envelopeAccessed),
+    statisticsOn(rhs.statisticsOn),
+    asynchronousStatistics(rhs.asynchronousStatistics),
+    blockTimingOn(false)
 { }
 
 template<typename T>
@@ -141,11 +154,34 @@ void MultiBlock3D<T>::swap(MultiBlock3D<T>& rhs) {
     std::swap(blockCommunicator, rhs.blockCommunicator);
     std::swap(combinedStatistics, rhs.combinedStatistics);
     std::swap(maxProcessorLevel, rhs.maxProcessorLevel);
+    std::swap(envelopeAccessed, rhs.envelopeAccessed);
     std::swap(statisticsOn, rhs.statisticsOn);
+    std::swap(asynchronousStatistics, rhs.asynchronousStatistics);
+    std::swap(blockTimingOn, rhs.blockTimingOn);
+    blockTimes.swap(rhs.blockTimes);
+    // The records follow the components, which have been swapped as well.
+    recordedGenerators.swap(rhs.recordedGenerators);
+    recordedMultiBlocks.swap(rhs.recordedMultiBlocks);
+    recordedLevels.swap(rhs.recordedLevels);
+    for (int iSide=0; iSide<2; ++iSide) {
+        std::vector<std::vector<MultiBlock3D<T>*> >& records =
+            iSide==0 ? recordedMultiBlocks : rhs.recordedMultiBlocks;
+        for (pluint iRecord=0; iRecord<records.size(); ++iRecord) {
+            for (pluint iBlock=0; iBlock<records[iRecord].size(); ++iBlock) {
+                if (records[iRecord][iBlock]==this) {
+                    records[iRecord][iBlock] = &rhs;
+                }
+                else if (records[iRecord][iBlock]==&rhs) {
+                    records[iRecord][iBlock] = this;
+                }
+            }
+        }
+    }
 }
 
 template<typename T>
 MultiBlock3D<T>::~MultiBlock3D() {
+    clearProcessorRecords();
     delete blockCommunicator;
     delete combinedStatistics;
 }
@@ -195,6 +231,9 @@ template<typename T>
 DataSerializer<T>* MultiBlock3D<T>::getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const
 {
+    if (global::IOpolicy().getBlockwiseSerialization()) {
+        return new BlockwiseMultiBlockSerializer3D<T>(*this, domain, ordering);
+    }
     return new MultiBlockSerializer3D<T>(*this, domain, ordering);
 }
 
@@ -202,6 +241,9 @@ template<typename T>
 DataUnSerializer<T>* MultiBlock3D<T>::getBlockUnSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering )
 {
+    if (global::IOpolicy().getBlockwiseSerialization()) {
+        return new BlockwiseMultiBlockUnSerializer3D<T>(*this, domain, ordering);
+    }
     return new MultiBlockUnSerializer3D<T>(*this, domain, ordering);
 }
 
@@ -213,7 +255,10 @@ void MultiBlock3D<T>::evaluateStatistics() {
         plint iBlock = relevantBlocks[rBlock];
         getComponent(iBlock).evaluateStatistics();
     }
-    if (isInternalStatisticsOn()) reduceStatistics();
+    // No reduction in iterations during which no statistics have been gathered.
+    if (isInternalStatisticsOn() && this->getInternalStatistics().isGatheringOn()) {
+        reduceStatistics();
+    }
 }
 
 
@@ -232,6 +277,16 @@ bool MultiBlock3D<T>::isInternalStatisticsOn() const {
     return statisticsOn;
 }
 
+template<typename T>
+void MultiBlock3D<T>::toggleAsynchronousStatistics(bool asynchronousStatistics_) {
+    asynchronousStatistics = asynchronousStatistics_;
+}
+
+template<typename T>
+bool MultiBlock3D<T>::isAsynchronousStatisticsOn() const {
+    return asynchronousStatistics;
+}
+
 template<typename T>
 void MultiBlock3D<T>::executeDataProcessor(DataProcessorGenerator3D<T> const& generator) {
     std::vector<MultiBlock3D<T>*> objects;
@@ -267,17 +322,75 @@ void MultiBlock3D<T>::executeInternalProcessors() {
     }
 }
 
+/// Executes a task on one block, and accumulates the time it takes.
+/** Each block writes only to its own entry of the times. */
+class TimedBlockTask : public BlockTask {
+public:
+    TimedBlockTask(BlockTask& task_, std::vector<double>& times_)
+        : task(task_), times(times_)
+    { }
+    virtual void execute(plint iBlock) {
+        double startTime = global::smp().getTime();
+        task.execute(iBlock);
+        times[iBlock] += global::smp().getTime() - startTime;
+    }
+private:
+    BlockTask& task;
+    std::vector<double>& times;
+};
+
 template<typename T>
-void MultiBlock3D<T>::executeInternalProcessors(plint level) {
-    std::vector<plint> const& relevantBlocks
-        = this -> getMultiBlockManagement().getRelevantIndexes().getBlocks();
+void MultiBlock3D<T>::executeOnRelevantBlocks(BlockTask& task) {
+    std::vector<plint> const& relevantBlocks = getRelevantBlocks();
+    std::vector<plint> costs(relevantBlocks.size());
     for (pluint rBlock=0; rBlock < relevantBlocks.size(); ++rBlock) {
-        plint iBlock = relevantBlocks[rBlock];
-        this -> getComponent(iBlock).executeInternalProcessors(level);
+        costs[rBlock] = getParameters(relevantBlocks[rBlock]).getBulk().nCells();
+    }
+    if (blockTimingOn) {
+        TimedBlockTask timedTask(task, blockTimes);
+        executeBlockTasks(relevantBlocks, costs, timedTask);
+    }
+    else {
+        executeBlockTasks(relevantBlocks, costs, task);
     }
+}
+
+template<typename T>
+void MultiBlock3D<T>::toggleBlockTiming(bool blockTimingOn_) {
+    blockTimingOn = blockTimingOn_;
+    if (blockTimingOn) {
+        resetBlockTimes();
+    }
+}
+
+template<typename T>
+void MultiBlock3D<T>::resetBlockTimes() {
+    blockTimes.assign(getMultiBlockManagement().getMultiBlockDistribution().getNumBlocks(), 0.);
+}
+
+/// Executes the internal processors of a given level on one component of a multi-block.
+template<typename T>
+class InternalProcessorsTask3D : public BlockTask {
+public:
+    InternalProcessorsTask3D(MultiBlock3D<T>& multiBlock_, plint level_)
+        : multiBlock(multiBlock_), level(level_)
+    { }
+    virtual void execute(plint iBlock) {
+        multiBlock.getComponent(iBlock).executeInternalProcessors(level);
+    }
+private:
+    MultiBlock3D<T>& multiBlock;
+    plint level;
+};
+
+template<typename T>
+void MultiBlock3D<T>::executeInternalProcessors(plint level) {
+    completeEnvelopesOfProcessors(level);
+    InternalProcessorsTask3D<T> task(*this, level);
+    executeOnRelevantBlocks(task);
     // At level 0, the expected behavior is to update overlaps in current MultiBlock only.
     if (level==0) {
-        this->getBlockCommunicator().duplicateOverlaps(*this);
+        refreshEnvelopes();
     }
     // At the other levels, all affected MultiBlocks get their overlaps updated.
     else {
@@ -302,6 +415,69 @@ void MultiBlock3D<T>::subscribeProcessor(plint level, std::vector<MultiBlock3D<T
     }
 }
 
+template<typename T>
+void MultiBlock3D<T>::recordInternalProcessor (
+        DataProcessorGenerator3D<T> const& generator,
+        std::vector<MultiBlock3D<T>*> multiBlocks, plint level )
+{
+    recordedGenerators.push_back(generator.clone());
+    recordedMultiBlocks.push_back(multiBlocks);
+    recordedLevels.push_back(level);
+}
+
+template<typename T>
+bool MultiBlock3D<T>::hasCoupledProcessors() const {
+    for (pluint iRecord=0; iRecord<recordedMultiBlocks.size(); ++iRecord) {
+        for (pluint iBlock=0; iBlock<recordedMultiBlocks[iRecord].size(); ++iBlock) {
+            if (recordedMultiBlocks[iRecord][iBlock] != this) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<typename T>
+void MultiBlock3D<T>::reinstantiateInternalProcessors() {
+    std::vector<plint> const& relevantBlocks = getRelevantBlocks();
+    for (pluint rBlock=0; rBlock<relevantBlocks.size(); ++rBlock) {
+        getComponent(relevantBlocks[rBlock]).clearInternalProcessors();
+    }
+    for (pluint iRecord=0; iRecord<recordedGenerators.size(); ++iRecord) {
+        instantiateInternalProcessor (
+                *recordedGenerators[iRecord], recordedMultiBlocks[iRecord], recordedLevels[iRecord] );
+    }
+}
+
+template<typename T>
+void MultiBlock3D<T>::swapMultiBlockManagement(MultiBlockManagement3D& newManagement) {
+    multiBlockManagement.swap(newManagement);
+}
+
+template<typename T>
+void MultiBlock3D<T>::copyProcessorRecords(MultiBlock3D<T> const& rhs) {
+    clearProcessorRecords();
+    for (pluint iRecord=0; iRecord<rhs.recordedGenerators.size(); ++iRecord) {
+        std::vector<MultiBlock3D<T>*> multiBlocks(rhs.recordedMultiBlocks[iRecord]);
+        for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+            if (multiBlocks[iBlock]==&rhs) {
+                multiBlocks[iBlock] = this;
+            }
+        }
+        recordInternalProcessor(*rhs.recordedGenerators[iRecord], multiBlocks, rhs.recordedLevels[iRecord]);
+    }
+}
+
+template<typename T>
+void MultiBlock3D<T>::clearProcessorRecords() {
+    for (pluint iRecord=0; iRecord<recordedGenerators.size(); ++iRecord) {
+        delete recordedGenerators[iRecord];
+    }
+    recordedGenerators.clear();
+    recordedMultiBlocks.clear();
+    recordedLevels.clear();
+}
+
 template<typename T>
 void MultiBlock3D<T>::reduceStatistics() {
     std::vector<plint> const& relevantBlocks
@@ -314,7 +490,12 @@ void MultiBlock3D<T>::reduceStatistics() {
     }
     // Execute reduction operation on all individual statistics and store result into
     //   statistics of current MultiBlock.
-    combinedStatistics -> combine(individualStatistics, this->getInternalStatistics());
+    if (asynchronousStatistics) {
+        combinedStatistics -> combineAsynchronously(individualStatistics, this->getInternalStatistics());
+    }
+    else {
+        combinedStatistics -> combine(individualStatistics, this->getInternalStatistics());
+    }
     // Copy result to each individual statistics
     for (pluint rBlock=0; rBlock<relevantBlocks.size(); ++rBlock) {
         plint iBlock = relevantBlocks[rBlock];
@@ -363,11 +544,32 @@ template<typename T>
 void MultiBlock3D<T>::duplicateOverlapsInModifiedMultiBlocks(std::vector<MultiBlock3D<T>*>& multiBlocks)
 {
     for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
-        multiBlocks[iBlock]->getBlockCommunicator().
-            duplicateOverlaps(*multiBlocks[iBlock]);
+        multiBlocks[iBlock]->refreshEnvelopes();
     }
 }
 
+/** The decision is taken for each processor executed by this multi-block
+ *  at the given level: all multi-blocks it accesses, read or written,
+ *  must have complete envelopes. Multi-blocks which are accessed by no
+ *  processor keep their envelopes as they are.
+ */
+template<typename T>
+void MultiBlock3D<T>::completeEnvelopesOfProcessors(plint level) {
+    for (pluint iRecord=0; iRecord<recordedMultiBlocks.size(); ++iRecord) {
+        std::vector<MultiBlock3D<T>*> const& multiBlocks = recordedMultiBlocks[iRecord];
+        if (recordedLevels[iRecord]==level && !multiBlocks.empty() && multiBlocks[0]==this) {
+            for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+                multiBlocks[iBlock]->completeEnvelopes();
+            }
+        }
+    }
+}
+
+template<typename T>
+void MultiBlock3D<T>::refreshEnvelopes() {
+    getBlockCommunicator().duplicateOverlaps(*this);
+}
+
 template<typename T>
 void MultiBlock3D<T>::signalPeriodicity() {
     getBlockCommunicator().signalPeriodicity();
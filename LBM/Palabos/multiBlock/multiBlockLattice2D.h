@@ -102,6 +102,7 @@ private:
     void allocateBlocks(Dynamics<T,Descriptor>* backgroundDynamics);
     void eliminateStatisticsInEnvelope();
     Box2D extendPeriodic(Box2D const& box, plint envelopeWidth) const;
+    void checkStreamingScheme() const;
 private:
     BlockParameters2D const& getParameters(plint iParam) const;
     Overlap2D const& getNormalOverlap(plint iOverlap) const;
@@ -27,6 +27,7 @@
 #include "multiBlock/multiBlockLattice2D.h"
 #include "atomicBlock/blockLattice2D.h"
 #include "multiBlock/defaultMultiBlockPolicy2D.h"
+#include "core/runTimeDiagnostics.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -215,6 +216,7 @@ void MultiBlockLattice2D<T,Descriptor>::stream() {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice2D<T,Descriptor>::collideAndStream(Box2D domain) {
+    checkStreamingScheme();
     Box2D inters;
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
     for (plint rBlock=0; rBlock <  this->getNumRelevantBlocks(); ++rBlock) {
@@ -229,6 +231,7 @@ void MultiBlockLattice2D<T,Descriptor>::collideAndStream(Box2D domain) {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice2D<T,Descriptor>::collideAndStream() {
+    checkStreamingScheme();
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
     for (plint rBlock=0; rBlock <  this->getNumRelevantBlocks(); ++rBlock) {
         plint iBlock = relevantBlocks[rBlock];
@@ -253,6 +256,21 @@ void MultiBlockLattice2D<T,Descriptor>::incrementTime() {
     this->getTimeCounter().incrementTime();
 }
 
+/** The components are collided and streamed over partial domains, for
+ *  which the aaPattern streaming scheme is not implemented. The check
+ *  involves the local components only, and no communication.
+ */
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice2D<T,Descriptor>::checkStreamingScheme() const {
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        if (blockLattices[relevantBlocks[rBlock]]->getStreamingScheme() != StreamingScheme::inPlaceSwap) {
+            throw XflLogicException (
+                    "the aaPattern streaming scheme cannot be used by the components of a multi-block lattice" );
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice2D<T,Descriptor>::allocateBlocks(Dynamics<T,Descriptor>* backgroundDynamics )
 {
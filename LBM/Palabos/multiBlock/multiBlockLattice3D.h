@@ -30,6 +30,8 @@
 #include "core/blockStatistics.h"
 #include "core/cell.h"
 #include "core/dynamics.h"
+#include "multiBlock/staticRepartitions3D.h"
+#include "parallelism/blockMigration3D.h"
 #include <vector>
 
 namespace plb {
@@ -95,11 +97,50 @@ public:
     MultiBlockDistribution3D const& getMultiBlockDistribution() const;
     std::vector<BlockLattice3D<T,Descriptor>*>& getBlockLattices();
     std::vector<BlockLattice3D<T,Descriptor>*> const& getBlockLattices() const;
+    /// Convert the memory layout of the populations in all local blocks.
+    void setPopulationLayout(PopulationLayout::LayoutT layout);
+    /// Execute numTimeSteps iterations, exchanging the envelopes only every few steps.
+    void multiStepCollideAndStream(plint numTimeSteps);
+    /// Number of iterations which multiStepCollideAndStream() executes between two envelope exchanges.
+    plint getTemporalBlockingDepth() const;
+    /// Redistribute the blocks between the processes, according to their measured execution time.
+    /** The time of each block is measured while block timing is on (see
+     *  MultiBlock3D::toggleBlockTiming()). If the slowest process is slower
+     *  than the average by more than the relative tolerance, the blocks are
+     *  attributed anew (see createRebalancedMultiBlockDistribution3D()), and
+     *  the blocks which change process are migrated, together with the
+     *  dynamics of their cells and their external fields. The internal
+     *  processors are then re-created from their generators, and the block
+     *  times are reset. The report of each call is appended to the log.
+     *
+     *  The dynamics are re-created from their prototypes (see
+     *  DynamicsPrototypes). Lattices whose internal processors involve
+     *  another multi-block are not rebalanced, as the other multi-block
+     *  would need to be redistributed in the same way.
+     *
+     *  This method must be called by all processes collectively. With a
+     *  single process, no block is ever moved.
+     */
+    RebalanceReport3D rebalance( double tolerance=0.1,
+                                 SpaceFillingCurve::CurveT curve=SpaceFillingCurve::hilbert );
+    /// Reports of all previous calls to rebalance().
+    std::vector<RebalanceReport3D> const& getRebalanceLog() const { return rebalanceLog; }
+    /// Refresh the envelopes if they have been left incomplete by the last iteration.
+    virtual void completeEnvelopes();
+    /// Refresh the envelopes after a modification of the bulk, or defer it to completeEnvelopes().
+    /** The refresh is deferred, unless the envelopes are accessed after each
+     *  iteration (see MultiBlock3D::requiresFullEnvelope()).
+     */
+    virtual void refreshEnvelopes();
+protected:
+    /// Switch the gathering of the statistics on or off, in the multi-block and all its components.
+    virtual void toggleStatisticsGathering(bool gatheringOn);
 private:
     MultiBlockLattice3D<T,Descriptor>& operator=(MultiBlockLattice3D<T,Descriptor> const& rhs);
     void allocateBlocks(Dynamics<T,Descriptor>* backgroundDynamics);
     void eliminateStatisticsInEnvelope();
     Box3D extendPeriodic(Box3D const& box, plint envelopeWidth) const;
+    void checkStreamingScheme() const;
 private:
     BlockParameters3D const& getParameters(plint iParam) const;
     Overlap3D const& getNormalOverlap(plint iOverlap) const;
@@ -107,6 +148,8 @@ private:
 private:
     MultiCellAccess3D<T,Descriptor>* multiCellAccess;
     std::vector<BlockLattice3D<T,Descriptor>*> blockLattices;
+    bool incompleteEnvelopes;
+    std::vector<RebalanceReport3D> rebalanceLog;
 };
 
 }  // namespace plb
@@ -26,7 +26,10 @@
 
 #include "multiBlock/multiBlockLattice3D.h"
 #include "atomicBlock/blockLattice3D.h"
+#include "core/collisionKernels.h"
+#include "core/dynamicsPrototypes.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
+#include "core/runTimeDiagnostics.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -44,7 +47,8 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         MultiCellAccess3D<T,Descriptor>* multiCellAccess_,
         Dynamics<T,Descriptor>* backgroundDynamics )
     : MultiBlock3D<T>(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
-      multiCellAccess(multiCellAccess_)
+      multiCellAccess(multiCellAccess_),
+      incompleteEnvelopes(false)
 {
     allocateBlocks(backgroundDynamics);
     eliminateStatisticsInEnvelope();
@@ -56,7 +60,8 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         plint nx, plint ny, plint nz,
         Dynamics<T,Descriptor>* backgroundDynamics )
     : MultiBlock3D<T>(nx,ny,nz),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      incompleteEnvelopes(false)
 {
     allocateBlocks(backgroundDynamics);
     eliminateStatisticsInEnvelope();
@@ -77,7 +82,8 @@ template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Descriptor> const& rhs)
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       MultiBlock3D<T>(rhs),
-      multiCellAccess(rhs.multiCellAccess->clone())
+      multiCellAccess(rhs.multiCellAccess->clone()),
+      incompleteEnvelopes(rhs.incompleteEnvelopes)
 {
     for (plint iBlock=0; iBlock<getMultiBlockDistribution().getNumBlocks(); ++iBlock) {
         if ( this->getMultiBlockManagement().getThreadAttribution().isLocal (
@@ -90,12 +96,14 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Des
             blockLattices.push_back( 0 );
         }
     }
+    this->copyProcessorRecords(rhs);
 }
 
 template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D<T> const& rhs)
     : MultiBlock3D<T>(rhs),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      incompleteEnvelopes(false)
 {
     allocateBlocks(new NoDynamics<T,Descriptor>());
     eliminateStatisticsInEnvelope();
@@ -104,7 +112,8 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D<T> const& rh
 template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D<T> const& rhs, Box3D subDomain, bool crop)
     : MultiBlock3D<T>(rhs, subDomain, crop),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      incompleteEnvelopes(false)
 {
     allocateBlocks(new NoDynamics<T,Descriptor>());
     eliminateStatisticsInEnvelope();
@@ -136,6 +145,7 @@ void MultiBlockLattice3D<T,Descriptor>::specifyStatisticsStatus (Box3D domain, b
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collide(Box3D domain) {
+    completeEnvelopes();
     Box3D inters;
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
     for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
@@ -150,6 +160,7 @@ void MultiBlockLattice3D<T,Descriptor>::collide(Box3D domain) {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collide() {
+    completeEnvelopes();
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
     for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
         plint iBlock = relevantBlocks[rBlock];
@@ -221,23 +232,130 @@ void MultiBlockLattice3D<T,Descriptor>::stream() {
     this->incrementTime();
 }
 
+/// Executes collideAndStream on a given domain of components of a multi-block lattice.
+template<typename T, template<typename U> class Descriptor>
+class CollideAndStreamTask3D : public BlockTask {
+public:
+    CollideAndStreamTask3D( std::vector<BlockLattice3D<T,Descriptor>*>& lattices_,
+                            std::vector<Box3D> const& localDomains_ )
+        : lattices(lattices_), localDomains(localDomains_)
+    { }
+    virtual void execute(plint iBlock) {
+        lattices[iBlock] -> collideAndStream(localDomains[iBlock]);
+    }
+private:
+    std::vector<BlockLattice3D<T,Descriptor>*>& lattices;
+    std::vector<Box3D> const& localDomains;
+};
+
+/** The blocks are executed concurrently if threads are enabled. */
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
+    checkStreamingScheme();
+    completeEnvelopes();
     Box3D inters;
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    std::vector<plint> blocks, costs;
+    std::vector<Box3D> localDomains(blockLattices.size());
     for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
         plint iBlock = relevantBlocks[rBlock];
         BlockParameters3D const& params = getParameters(iBlock);
         if (intersect(domain, params.getNonPeriodicEnvelope(), inters ) ) {
-            inters = params.toLocal(inters);
-            blockLattices[iBlock] -> collideAndStream(inters);
+            localDomains[iBlock] = params.toLocal(inters);
+            blocks.push_back(iBlock);
+            costs.push_back(inters.nCells());
         }
     }
+    CollideAndStreamTask3D<T,Descriptor> task(blockLattices, localDomains);
+    executeBlockTasks(blocks, costs, task);
 }
 
+/// Executes one phase of a split collideAndStream on components of a multi-block lattice.
+/** The domain is streamed into the envelope, as in collideAndStreamIntoEnvelope(),
+ *  or into itself if both are the same.
+ */
+template<typename T, template<typename U> class Descriptor>
+class SplitCollideAndStreamTask3D : public BlockTask {
+public:
+    SplitCollideAndStreamTask3D( std::vector<BlockLattice3D<T,Descriptor>*>& lattices_,
+                                 std::vector<Box3D> const& localDomains_,
+                                 std::vector<Box3D> const& localEnvelopes_,
+                                 plint shellWidth_, bool shellPhase_ )
+        : lattices(lattices_), localDomains(localDomains_), localEnvelopes(localEnvelopes_),
+          shellWidth(shellWidth_), shellPhase(shellPhase_)
+    { }
+    virtual void execute(plint iBlock) {
+        if (shellPhase) {
+            lattices[iBlock] -> collideAndStreamShell(localDomains[iBlock], localEnvelopes[iBlock], shellWidth);
+        }
+        else {
+            lattices[iBlock] -> collideAndStreamCore(localDomains[iBlock], shellWidth);
+        }
+    }
+private:
+    std::vector<BlockLattice3D<T,Descriptor>*>& lattices;
+    std::vector<Box3D> const& localDomains;
+    std::vector<Box3D> const& localEnvelopes;
+    plint shellWidth;
+    bool shellPhase;
+};
+
+/// Executes collideAndStreamIntoEnvelope on components of a multi-block lattice.
+template<typename T, template<typename U> class Descriptor>
+class CollideAndStreamIntoEnvelopeTask3D : public BlockTask {
+public:
+    CollideAndStreamIntoEnvelopeTask3D( std::vector<BlockLattice3D<T,Descriptor>*>& lattices_,
+                                        std::vector<Box3D> const& localBulks_,
+                                        std::vector<Box3D> const& localDomains_ )
+        : lattices(lattices_), localBulks(localBulks_), localDomains(localDomains_)
+    { }
+    virtual void execute(plint iBlock) {
+        lattices[iBlock] -> collideAndStreamIntoEnvelope(localBulks[iBlock], localDomains[iBlock]);
+    }
+private:
+    std::vector<BlockLattice3D<T,Descriptor>*>& lattices;
+    std::vector<Box3D> const& localBulks;
+    std::vector<Box3D> const& localDomains;
+};
+
+/** The blocks are executed concurrently if threads are enabled. Which
+ *  populations are exchanged between the components depends on the
+ *  configuration:
+ *
+ *  - By default, the envelopes are not required to hold complete cells
+ *    after the iteration (see MultiBlock3D::requiresFullEnvelope()). Only the
+ *    bulk of each component is collided, and the populations streamed out of
+ *    the bulk into the envelope are returned to the neighboring components.
+ *    In parallel, the cells which stream into the envelope are computed
+ *    first, and their populations are sent with non-blocking messages while
+ *    the rest of the bulk is being computed. The envelopes remain incomplete
+ *    until an operation needs them (see completeEnvelopes()).
+ *  - Internal processors are executed after this exchange. Before each of
+ *    them, the envelopes of the multi-blocks it accesses are completed; its
+ *    modifications are propagated to the envelopes by refreshEnvelopes(),
+ *    which defers the refresh of this lattice to the next completion. A
+ *    lattice with boundary conditions therefore exchanges the streamed
+ *    populations, overlapped with computation, and complete cells once
+ *    before its processors.
+ *  - If the envelopes are accessed directly after each iteration
+ *    (MultiBlock3D::signalEnvelopeAccess()), the envelopes are collided like
+ *    the bulk and then refreshed by duplicateOverlaps(). Without internal
+ *    processors, the shell of each block, which contains the cells sent to
+ *    other blocks, is computed first and sent while the core is being
+ *    computed. With internal processors, the envelopes are refreshed after
+ *    the processors, and the communication is not overlapped.
+ *
+ *  The overlap requires the arrayOfStructures layout and blocks which are
+ *  large enough (see BlockLattice3D::isSplittable()); otherwise, the same
+ *  exchanges take place after the computation of the blocks.
+ */
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
+    checkStreamingScheme();
+    static const plint vicinity = Descriptor<T>::vicinity;
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    std::vector<Box3D> localDomains(blockLattices.size());
+    plint shellWidth = 0;
     plint rBlock;
     for (rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
         plint iBlock = relevantBlocks[rBlock];
@@ -245,13 +363,265 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
         // CollideAndStream must be applied to full domain,
         //   including currently active envelopes.
         Box3D domain = extendPeriodic(params.getNonPeriodicEnvelope(), params.getEnvelopeWidth());
-        blockLattices[iBlock] -> collideAndStream( params.toLocal(domain) );
+        localDomains[iBlock] = params.toLocal(domain);
+        shellWidth = std::max(shellWidth, 2*params.getEnvelopeWidth());
+    }
+    if (!this->requiresFullEnvelope()) {
+        std::vector<Box3D> localBulks(blockLattices.size());
+        bool overlapCommunication = global::mpi().getSize()>1;
+        for (rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+            plint iBlock = relevantBlocks[rBlock];
+            BlockParameters3D const& params = getParameters(iBlock);
+            localBulks[iBlock] = params.toLocal(params.getBulk());
+            overlapCommunication = overlapCommunication &&
+                                   blockLattices[iBlock]->isSplittable(localBulks[iBlock], vicinity);
+        }
+        BlockCommunicator3D<T> const& communicator = this->getBlockCommunicator();
+        if (overlapCommunication) {
+            // Only the cells at a distance smaller than the vicinity from the
+            //   boundary of the bulk stream into the envelope.
+            SplitCollideAndStreamTask3D<T,Descriptor>
+                shellTask(blockLattices, localBulks, localDomains, vicinity, true);
+            this->executeOnRelevantBlocks(shellTask);
+            communicator.startReturnStreamedData(*this);
+            SplitCollideAndStreamTask3D<T,Descriptor>
+                coreTask(blockLattices, localBulks, localDomains, vicinity, false);
+            this->executeOnRelevantBlocks(coreTask);
+            communicator.finishReturnStreamedData(*this);
+        }
+        else {
+            CollideAndStreamIntoEnvelopeTask3D<T,Descriptor> task(blockLattices, localBulks, localDomains);
+            this->executeOnRelevantBlocks(task);
+            communicator.returnStreamedData(*this);
+        }
+        incompleteEnvelopes = true;
+        if (this->hasInternalProcessors()) {
+            this->executeInternalProcessors();
+        }
+        this->evaluateStatistics();
+        this->incrementTime();
+        return;
+    }
+    completeEnvelopes();
+    bool overlapCommunication = global::mpi().getSize()>1 && !this->hasInternalProcessors();
+    for (rBlock=0; overlapCommunication && rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        overlapCommunication = blockLattices[iBlock]->isSplittable(localDomains[iBlock], shellWidth);
+    }
+    if (overlapCommunication) {
+        SplitCollideAndStreamTask3D<T,Descriptor>
+            shellTask(blockLattices, localDomains, localDomains, shellWidth, true);
+        this->executeOnRelevantBlocks(shellTask);
+        this->getBlockCommunicator().startDuplicateOverlaps(*this);
+        SplitCollideAndStreamTask3D<T,Descriptor>
+            coreTask(blockLattices, localDomains, localDomains, shellWidth, false);
+        this->executeOnRelevantBlocks(coreTask);
+        this->getBlockCommunicator().finishDuplicateOverlaps(*this);
+    }
+    else {
+        CollideAndStreamTask3D<T,Descriptor> task(blockLattices, localDomains);
+        this->executeOnRelevantBlocks(task);
+        this->executeInternalProcessors();
     }
-    this->executeInternalProcessors();
     this->evaluateStatistics();
     this->incrementTime();
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::completeEnvelopes() {
+    if (incompleteEnvelopes) {
+        this->getBlockCommunicator().duplicateOverlaps(*this);
+        incompleteEnvelopes = false;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::refreshEnvelopes() {
+    if (this->requiresFullEnvelope()) {
+        this->getBlockCommunicator().duplicateOverlaps(*this);
+        incompleteEnvelopes = false;
+    }
+    else {
+        incompleteEnvelopes = true;
+    }
+}
+
+/// Executes several iterations of collideAndStream on one component of a multi-block lattice.
+template<typename T, template<typename U> class Descriptor>
+class MultiStepCollideAndStreamTask3D : public BlockTask {
+public:
+    MultiStepCollideAndStreamTask3D( std::vector<BlockLattice3D<T,Descriptor>*>& lattices_,
+                                     std::vector<Box3D> const& localDomains_, plint numTimeSteps_ )
+        : lattices(lattices_), localDomains(localDomains_), numTimeSteps(numTimeSteps_)
+    { }
+    virtual void execute(plint iBlock) {
+        for (plint iStep=0; iStep<numTimeSteps; ++iStep) {
+            // Only the statistics of the last iteration are kept, as they
+            //   would be after numTimeSteps calls to collideAndStream().
+            if (iStep>0) {
+                lattices[iBlock]->getInternalStatistics().resetRunning();
+            }
+            lattices[iBlock] -> collideAndStream(localDomains[iBlock]);
+        }
+    }
+private:
+    std::vector<BlockLattice3D<T,Descriptor>*>& lattices;
+    std::vector<Box3D> const& localDomains;
+    plint numTimeSteps;
+};
+
+/** Each iteration invalidates the populations in an outer layer of the
+ *  envelope of each component, of a thickness equal to the vicinity of the
+ *  descriptor. An envelope which is k times wider than the vicinity can
+ *  therefore absorb k iterations, after which the bulk is still valid and
+ *  the envelopes are refreshed. Each component is advanced by k iterations
+ *  before the next one is processed, which keeps small components in cache,
+ *  and the envelopes are exchanged once instead of k times.
+ *
+ *  Internal processors (non-local boundary conditions, couplings) require
+ *  valid envelopes after each iteration. In their presence, and with the
+ *  default envelope width of 1, this method is equivalent to a sequence of
+ *  calls to collideAndStream().
+ *  \sa DefaultMultiBlockPolicy3D::setEnvelopeWidth()
+ */
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::multiStepCollideAndStream(plint numTimeSteps) {
+    checkStreamingScheme();
+    plint depth = getTemporalBlockingDepth();
+    if (depth<=1) {
+        for (plint iStep=0; iStep<numTimeSteps; ++iStep) {
+            collideAndStream();
+        }
+        return;
+    }
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    std::vector<Box3D> localDomains(blockLattices.size());
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        BlockParameters3D const& params = getParameters(iBlock);
+        Box3D domain = extendPeriodic(params.getNonPeriodicEnvelope(), params.getEnvelopeWidth());
+        localDomains[iBlock] = params.toLocal(domain);
+    }
+    for (plint iStep=0; iStep<numTimeSteps; iStep+=depth) {
+        // The internal processors may have deferred the refresh of the envelopes.
+        completeEnvelopes();
+        plint numSubSteps = std::min(depth, numTimeSteps-iStep);
+        MultiStepCollideAndStreamTask3D<T,Descriptor> task(blockLattices, localDomains, numSubSteps);
+        this->executeOnRelevantBlocks(task);
+        this->executeInternalProcessors();
+        this->evaluateStatistics();
+        for (plint iSubStep=0; iSubStep<numSubSteps; ++iSubStep) {
+            this->incrementTime();
+        }
+    }
+}
+
+/** The measured time of all blocks is first made available on all
+ *  processes. As the new distribution is computed from the same data on
+ *  all of them, no further agreement is needed before the migration.
+ */
+template<typename T, template<typename U> class Descriptor>
+RebalanceReport3D MultiBlockLattice3D<T,Descriptor>::rebalance (
+        double tolerance, SpaceFillingCurve::CurveT curve )
+{
+    RebalanceReport3D report;
+    int numProc = global::mpi().getSize();
+    MultiBlockDistribution3D const& distribution = getMultiBlockDistribution();
+    plint numBlocks = distribution.getNumBlocks();
+    std::vector<double> blockTimes(this->getBlockTimes());
+    blockTimes.resize(numBlocks, 0.);
+#ifdef PLB_MPI_PARALLEL
+    std::vector<double> globalBlockTimes;
+    global::mpi().allReduceVect(blockTimes, globalBlockTimes, MPI_SUM);
+    blockTimes.swap(globalBlockTimes);
+#endif
+    LoadBalanceReport3D measured = predictLoadBalance3D(distribution, blockTimes, numProc);
+    report.measuredImbalance = measured.imbalance;
+    report.predictedImbalance = measured.imbalance;
+    if ( measured.totalCost <= 0. || measured.imbalance <= 1.+tolerance ||
+         this->hasCoupledProcessors() )
+    {
+        rebalanceLog.push_back(report);
+        return report;
+    }
+
+    LoadBalanceReport3D predicted;
+    MultiBlockDistribution3D newDistribution =
+        createRebalancedMultiBlockDistribution3D(distribution, blockTimes, numProc, curve, &predicted);
+    report.predictedImbalance = predicted.imbalance;
+    if (predicted.imbalance >= measured.imbalance) {
+        rebalanceLog.push_back(report);
+        return report;
+    }
+
+    double startTime = global::smp().getTime();
+    completeEnvelopes();
+    std::vector<plint> oldProcIds(numBlocks), newProcIds(numBlocks);
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        oldProcIds[iBlock] = distribution.getBlockParameters(iBlock).getProcId();
+        newProcIds[iBlock] = newDistribution.getBlockParameters(iBlock).getProcId();
+    }
+    BlockMigrationStatistics3D migrated;
+    if (!migrateBlockLattices3D(blockLattices, oldProcIds, newProcIds, migrated)) {
+        rebalanceLog.push_back(report);
+        return report;
+    }
+    MultiBlockManagement3D newManagement (
+            newDistribution, this->getMultiBlockManagement().getThreadAttribution().clone(),
+            this->getMultiBlockManagement().getRefinementLevel() );
+    this->swapMultiBlockManagement(newManagement);
+    // The communication patterns depend on the attribution of the blocks.
+    this->signalPeriodicity();
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        if (oldProcIds[iBlock] != newProcIds[iBlock]) {
+            blockLattices[iBlock]->getInternalStatistics() = this->getInternalStatistics();
+        }
+    }
+    this->reinstantiateInternalProcessors();
+    this->resetBlockTimes();
+
+    std::vector<double> localTotals(4), globalTotals(4);
+    localTotals[0] = (double)migrated.numSentBlocks;
+    localTotals[1] = (double)migrated.numSentCells;
+    localTotals[2] = (double)migrated.numSentBytes;
+    localTotals[3] = global::smp().getTime() - startTime;
+    globalTotals = localTotals;
+#ifdef PLB_MPI_PARALLEL
+    std::vector<double> globalMax;
+    global::mpi().allReduceVect(localTotals, globalTotals, MPI_SUM);
+    global::mpi().allReduceVect(localTotals, globalMax, MPI_MAX);
+    globalTotals[3] = globalMax[3];
+#endif
+    report.executed = true;
+    report.numMigratedBlocks = (plint)(globalTotals[0]+0.5);
+    report.numMigratedCells = (plint)(globalTotals[1]+0.5);
+    report.numMigratedBytes = (plint)(globalTotals[2]+0.5);
+    report.migrationTime = globalTotals[3];
+    rebalanceLog.push_back(report);
+    return report;
+}
+
+/** The depth is the number of iterations which the narrowest envelope can
+ *  absorb, or 1 if internal processors must be executed after each iteration.
+ */
+template<typename T, template<typename U> class Descriptor>
+plint MultiBlockLattice3D<T,Descriptor>::getTemporalBlockingDepth() const {
+    if (this->hasInternalProcessors()) {
+        return 1;
+    }
+    MultiBlockDistribution3D const& distribution = getMultiBlockDistribution();
+    if (distribution.getNumBlocks()==0) {
+        return 1;
+    }
+    plint envelopeWidth = distribution.getBlockParameters(0).getEnvelopeWidth();
+    for (plint iBlock=1; iBlock<distribution.getNumBlocks(); ++iBlock) {
+        envelopeWidth = std::min(envelopeWidth, distribution.getBlockParameters(iBlock).getEnvelopeWidth());
+    }
+    return std::max(envelopeWidth/Descriptor<T>::vicinity, (plint)1);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
     std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
@@ -260,6 +630,33 @@ void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
         blockLattices[iBlock] -> incrementTime();
     }
     this->getTimeCounter().incrementTime();
+    // The components follow the statistics period of the multi-block.
+    toggleStatisticsGathering(this->isStatisticsStep());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleStatisticsGathering(bool gatheringOn) {
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        blockLattices[iBlock] -> getInternalStatistics().toggleGathering(gatheringOn);
+    }
+    this->getInternalStatistics().toggleGathering(gatheringOn);
+}
+
+/** The components are collided and streamed over partial domains, for
+ *  which the aaPattern streaming scheme is not implemented. The check
+ *  involves the local components only, and no communication.
+ */
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::checkStreamingScheme() const {
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        if (blockLattices[relevantBlocks[rBlock]]->getStreamingScheme() != StreamingScheme::inPlaceSwap) {
+            throw XflLogicException (
+                    "the aaPattern streaming scheme cannot be used by the components of a multi-block lattice" );
+        }
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -281,7 +678,14 @@ void MultiBlockLattice3D<T,Descriptor>::allocateBlocks(Dynamics<T,Descriptor>* b
             blockLattices.push_back( 0 );
         }
     }
+    // The background dynamics is needed to re-create blocks which are
+    //   migrated to another process (see rebalance()).
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*backgroundDynamics);
     delete backgroundDynamics;
+    // Construct the singletons used during collision before the blocks are
+    //   possibly executed concurrently.
+    BlockLattice3D<T,Descriptor>::cachePolicy();
+    collisionKernelRegistry<T,Descriptor>();
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -314,6 +718,15 @@ std::vector<BlockLattice3D<T,Descriptor>*> const& MultiBlockLattice3D<T,Descript
     return blockLattices;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::setPopulationLayout(PopulationLayout::LayoutT layout) {
+    std::vector<plint> const& relevantBlocks = this->getRelevantBlocks();
+    for (plint rBlock=0; rBlock < this->getNumRelevantBlocks(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        blockLattices[iBlock] -> setPopulationLayout(layout);
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 MultiBlockDistribution3D const& MultiBlockLattice3D<T,Descriptor>::getMultiBlockDistribution() const {
     return this->getMultiBlockManagement().getMultiBlockDistribution();
@@ -73,6 +73,15 @@ template<typename T>
 void addInternalProcessor( DataProcessorGenerator3D<T> const& generator,
                            std::vector<MultiBlock3D<T>*> multiBlocks, plint level=0 );
 
+/// Add the instances of an internal processor to the local components, without subscribing it.
+/** This is the part of addInternalProcessor() which depends on the
+ *  distribution of the components over the processes. It is used to
+ *  re-create the processors after the components have been redistributed.
+ */
+template<typename T>
+void instantiateInternalProcessor( DataProcessorGenerator3D<T> const& generator,
+                                   std::vector<MultiBlock3D<T>*> multiBlocks, plint level );
+
 } // namespace plb
 
 #endif
@@ -32,6 +32,7 @@
 #include "atomicBlock/atomicBlockOperations3D.h"
 #include "multiGrid/multiScale.h"
 #include "core/plbDebug.h"
+#include <algorithm>
 
 
 namespace plb {
@@ -283,6 +284,10 @@ template<typename T>
 void executeDataProcessor( DataProcessorGenerator3D<T> const& generator,
                            std::vector<MultiBlock3D<T>*> multiBlocks )
 {
+    // The processor may read the envelopes, which must therefore be complete.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->completeEnvelopes();
+    }
     MultiProcessing3D<T, DataProcessorGenerator3D<T> const, DataProcessorGenerator3D<T> >
         multiProcessing(generator, multiBlocks);
     std::vector<DataProcessorGenerator3D<T>*> const& retainedGenerators = multiProcessing.getRetainedGenerators();
@@ -306,6 +311,10 @@ template<typename T>
 void executeDataProcessor( ReductiveDataProcessorGenerator3D<T>& generator,
                            std::vector<MultiBlock3D<T>*> multiBlocks )
 {
+    // The processor may read the envelopes, which must therefore be complete.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->completeEnvelopes();
+    }
     MultiProcessing3D<T, ReductiveDataProcessorGenerator3D<T>, ReductiveDataProcessorGenerator3D<T> >
         multiProcessing(generator, multiBlocks);
     std::vector<ReductiveDataProcessorGenerator3D<T>*> const& retainedGenerators = multiProcessing.getRetainedGenerators();
@@ -328,12 +337,12 @@ void executeDataProcessor( ReductiveDataProcessorGenerator3D<T>& generator,
     multiProcessing.updateEnvelopesWhereRequired();
 }
 
+/// Add the processors of the retained generators to the corresponding atomic-blocks.
 template<typename T>
-void addInternalProcessor( DataProcessorGenerator3D<T> const& generator,
-                           std::vector<MultiBlock3D<T>*> multiBlocks, plint level )
+void integrateRetainedProcessors (
+        MultiProcessing3D<T, DataProcessorGenerator3D<T> const, DataProcessorGenerator3D<T> > const& multiProcessing,
+        std::vector<MultiBlock3D<T>*> const& multiBlocks, plint level )
 {
-    MultiProcessing3D<T, DataProcessorGenerator3D<T> const, DataProcessorGenerator3D<T> >
-        multiProcessing(generator, multiBlocks);
     std::vector<DataProcessorGenerator3D<T>*> const& retainedGenerators = multiProcessing.getRetainedGenerators();
     std::vector<std::vector<plint> > const& atomicBlockNumbers = multiProcessing.getAtomicBlockNumbers();
 
@@ -345,6 +354,24 @@ void addInternalProcessor( DataProcessorGenerator3D<T> const& generator,
         // Delegate to the "AtomicBlock version" of addInternal.
         plb::addInternalProcessor(*retainedGenerators[iGenerator], extractedAtomicBlocks, level);
     }
+}
+
+template<typename T>
+void instantiateInternalProcessor( DataProcessorGenerator3D<T> const& generator,
+                                   std::vector<MultiBlock3D<T>*> multiBlocks, plint level )
+{
+    MultiProcessing3D<T, DataProcessorGenerator3D<T> const, DataProcessorGenerator3D<T> >
+        multiProcessing(generator, multiBlocks);
+    integrateRetainedProcessors(multiProcessing, multiBlocks, level);
+}
+
+template<typename T>
+void addInternalProcessor( DataProcessorGenerator3D<T> const& generator,
+                           std::vector<MultiBlock3D<T>*> multiBlocks, plint level )
+{
+    MultiProcessing3D<T, DataProcessorGenerator3D<T> const, DataProcessorGenerator3D<T> >
+        multiProcessing(generator, multiBlocks);
+    integrateRetainedProcessors(multiProcessing, multiBlocks, level);
     // Subscribe the processor in the multi-block. This guarantees that the multi-block is aware
     //   of the maximal current processor level, and it instantiates the communication pattern
     //   for an update of envelopes after processor execution.
@@ -352,6 +379,14 @@ void addInternalProcessor( DataProcessorGenerator3D<T> const& generator,
             level,
             multiProcessing.multiBlocksWhichRequireUpdate(),
             BlockDomain::usesEnvelope(generator.appliesTo()) );
+    // Each multi-block keeps a record of the processor, by which the
+    //   processor can be re-instantiated when the components are redistributed.
+    std::vector<MultiBlock3D<T>*> partners(multiBlocks);
+    std::sort(partners.begin(), partners.end());
+    partners.erase(std::unique(partners.begin(), partners.end()), partners.end());
+    for (pluint iPartner=0; iPartner<partners.size(); ++iPartner) {
+        partners[iPartner]->recordInternalProcessor(generator, multiBlocks, level);
+    }
 }
 
 }  // namespace plb
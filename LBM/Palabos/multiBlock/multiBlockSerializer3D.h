@@ -27,6 +27,7 @@
 #include "core/globalDefs.h"
 #include "multiBlock/multiBlock3D.h"
 #include "core/serializer.h"
+#include <vector>
 
 namespace plb {
 
@@ -125,6 +126,138 @@ private:
     mutable std::vector<T> buffer;
 };
 
+/// Geometry shared by the blockwise serializer and unserializer.
+/** The domain is cut into slabs, perpendicular to the slowest-varying
+ *  index of the ordering (x for forward and memorySaving, z for backward).
+ *  Each slab is cut into pieces, the intersections of the slab with the
+ *  bulk of the blocks. The pieces are grouped by process, so that the data
+ *  which a process contributes to a slab is contiguous, and is exchanged
+ *  with the main processor in a single message.
+ */
+template<typename T>
+class BlockwiseSerializationPlan3D {
+public:
+    struct Piece {
+        plint blockId, procId;
+        Box3D box;
+        /// Position of the data of the piece in the buffer of the slab.
+        plint offset;
+    };
+public:
+    BlockwiseSerializationPlan3D(MultiBlock3D<T> const& multiBlock_, Box3D domain_,
+                                 IndexOrdering::OrderingT ordering_);
+    plint getNumSlabs() const { return numSlabs; }
+    Box3D getSlab(plint iSlab) const;
+    /// Compute the pieces of a slab; returns the size of the buffer of the slab.
+    plint computePieces(Box3D const& slab, std::vector<Piece>& pieces) const;
+    /// Size of the serialized data of a slab.
+    plint getSerializedSize(Box3D const& slab, std::vector<Piece> const& pieces) const;
+    /// Convert the data of the pieces into serialized data, in the index ordering.
+    void assemble(Box3D const& slab, std::vector<Piece> const& pieces,
+                  T* pieceData, T* serialized) const;
+    /// Convert serialized data into the data of the pieces.
+    void disassemble(Box3D const& slab, std::vector<Piece> const& pieces,
+                     T* pieceData, T* serialized) const;
+    bool isLocal(plint procId) const;
+private:
+    /// Orders pieces by their first cell along the lines of the serialized data.
+    struct LineStartOrder {
+        LineStartOrder(bool alongZ_) : alongZ(alongZ_) { }
+        bool operator()(Piece const* piece1, Piece const* piece2) const {
+            return alongZ ? piece1->box.z0 < piece2->box.z0 : piece1->box.x0 < piece2->box.x0;
+        }
+        bool alongZ;
+    };
+    void copyLines(Box3D const& slab, std::vector<Piece> const& pieces,
+                   T* pieceData, T* serialized, bool toSerialized) const;
+private:
+    MultiBlock3D<T> const& multiBlock;
+    Box3D domain;
+    IndexOrdering::OrderingT ordering;
+    plint slabWidth, numSlabs;
+};
+
+/// Serializer which transfers data between the processes in large chunks.
+/** Produces the same data as MultiBlockSerializer3D, but instead of
+ *  exchanging one message per line of cells, each process packs its
+ *  contribution to a slab of the domain (see BlockwiseSerializationPlan3D)
+ *  into a single message. The transfer of the next slab is started before
+ *  the current one is handed out, so that communication is overlapped with
+ *  the processing of the data on the main processor.
+ *
+ *  A clone starts again from the beginning of the domain.
+ */
+template<typename T>
+class BlockwiseMultiBlockSerializer3D : public DataSerializer<T> {
+public:
+    BlockwiseMultiBlockSerializer3D(MultiBlock3D<T> const& multiBlock_,
+                                    Box3D domain_,
+                                    IndexOrdering::OrderingT ordering_);
+    ~BlockwiseMultiBlockSerializer3D();
+    virtual BlockwiseMultiBlockSerializer3D<T>* clone() const;
+    virtual pluint getSize() const;
+    virtual const T* getNextDataBuffer(pluint& bufferSize) const;
+    virtual bool isEmpty() const;
+private:
+    /// Start the transfer of a slab, into or out of one of two alternating buffers.
+    void startSlab(plint iSlab) const;
+    /// Wait for the completion of the transfers of a slab.
+    void completeSlab(plint iSlab) const;
+    /// Pack the local pieces, at their slab offsets or else contiguously.
+    void packPieces(std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> const& slabPieces,
+                    T* data, bool atSlabOffsets) const;
+private:
+    MultiBlock3D<T> const& multiBlock;
+    IndexOrdering::OrderingT ordering;
+    Box3D domain;
+    BlockwiseSerializationPlan3D<T> plan;
+    mutable plint currentSlab;
+    mutable std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> pieces[2];
+    mutable std::vector<T> pieceData[2];
+#ifdef PLB_MPI_PARALLEL
+    mutable std::vector<MPI_Request> requests[2];
+#endif
+    mutable std::vector<T> buffer;
+};
+
+/// Unserializer which transfers data between the processes in large chunks.
+/** Counterpart of BlockwiseMultiBlockSerializer3D. After a slab has been
+ *  read, the main processor sends each process its data in a single
+ *  non-blocking message, and proceeds with the next slab.
+ *
+ *  A clone starts again from the beginning of the domain.
+ */
+template<typename T>
+class BlockwiseMultiBlockUnSerializer3D : public DataUnSerializer<T> {
+public:
+    BlockwiseMultiBlockUnSerializer3D(MultiBlock3D<T>& multiBlock_,
+                                      Box3D domain_,
+                                      IndexOrdering::OrderingT ordering_);
+    ~BlockwiseMultiBlockUnSerializer3D();
+    virtual BlockwiseMultiBlockUnSerializer3D<T>* clone() const;
+    virtual pluint getSize() const;
+    virtual T* getNextDataBuffer(pluint& bufferSize);
+    virtual void commitData();
+    virtual bool isFull() const;
+private:
+    void waitForSends(plint iBuffer);
+    /// Unpack the local pieces, from their slab offsets or else from contiguous data.
+    void unpackPieces(std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> const& slabPieces,
+                      T* data, bool atSlabOffsets);
+private:
+    MultiBlock3D<T>& multiBlock;
+    IndexOrdering::OrderingT ordering;
+    Box3D domain;
+    BlockwiseSerializationPlan3D<T> plan;
+    plint currentSlab;
+    std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> pieces;
+    std::vector<T> pieceData[2];
+#ifdef PLB_MPI_PARALLEL
+    std::vector<MPI_Request> requests[2];
+#endif
+    std::vector<T> buffer;
+};
+
 }  //  namespace plb
 
 #endif  // MULTI_BLOCK_SERIALIZER_3D_H
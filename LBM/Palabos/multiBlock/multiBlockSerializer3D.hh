@@ -28,6 +28,7 @@
 #include "multiBlock/multiBlockSerializer3D.h"
 #include "atomicBlock/atomicBlock3D.h"
 #include "core/plbDebug.h"
+#include <algorithm>
 
 namespace plb {
 
@@ -658,6 +659,490 @@ void RawMultiBlockUnSerializer3D<T>::communicateBuffer (
 #endif
 }
 
+////////// class BlockwiseSerializationPlan3D ////////////////////////////
+
+/// Number of scalars up to which the data of a slab is transferred in a single
+///   chunk by the blockwise serializers; a slab is at least one cell wide.
+const plint blockwiseSerializationChunkSize = (plint)1 << 21;
+
+template<typename T>
+BlockwiseSerializationPlan3D<T>::BlockwiseSerializationPlan3D (
+        MultiBlock3D<T> const& multiBlock_, Box3D domain_,
+        IndexOrdering::OrderingT ordering_ )
+    : multiBlock(multiBlock_),
+      domain(domain_),
+      ordering(ordering_)
+{
+    plint extent, planeSize;
+    if (ordering==IndexOrdering::backward) {
+        extent = domain.getNz();
+        planeSize = domain.getNx()*domain.getNy();
+    }
+    else {
+        extent = domain.getNx();
+        planeSize = domain.getNy()*domain.getNz();
+    }
+    planeSize *= multiBlock.sizeOfCell();
+    slabWidth = std::max((plint)1, blockwiseSerializationChunkSize/std::max((plint)1, planeSize));
+    numSlabs = (extent+slabWidth-1) / slabWidth;
+}
+
+template<typename T>
+Box3D BlockwiseSerializationPlan3D<T>::getSlab(plint iSlab) const {
+    PLB_PRECONDITION( iSlab < numSlabs );
+    Box3D slab(domain);
+    if (ordering==IndexOrdering::backward) {
+        slab.z0 = domain.z0 + iSlab*slabWidth;
+        slab.z1 = std::min(slab.z0+slabWidth-1, domain.z1);
+    }
+    else {
+        slab.x0 = domain.x0 + iSlab*slabWidth;
+        slab.x1 = std::min(slab.x0+slabWidth-1, domain.x1);
+    }
+    return slab;
+}
+
+template<typename T>
+plint BlockwiseSerializationPlan3D<T>::computePieces (
+        Box3D const& slab, std::vector<Piece>& pieces ) const
+{
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    pieces.clear();
+    for (plint iBlock=0; iBlock<distribution.getNumBlocks(); ++iBlock) {
+        Piece piece;
+        if (intersect(distribution.getBlockParameters(iBlock).getBulk(), slab, piece.box)) {
+            piece.blockId = iBlock;
+            piece.procId = distribution.getBlockParameters(iBlock).getProcId();
+            pieces.push_back(piece);
+        }
+    }
+    // Group the pieces by process, in a stable order.
+    std::vector<Piece> sortedPieces;
+    sortedPieces.reserve(pieces.size());
+    std::vector<bool> isSorted(pieces.size(), false);
+    for (pluint iPiece=0; iPiece<pieces.size(); ++iPiece) {
+        if (isSorted[iPiece]) continue;
+        for (pluint jPiece=iPiece; jPiece<pieces.size(); ++jPiece) {
+            if (!isSorted[jPiece] && pieces[jPiece].procId==pieces[iPiece].procId) {
+                sortedPieces.push_back(pieces[jPiece]);
+                isSorted[jPiece] = true;
+            }
+        }
+    }
+    pieces.swap(sortedPieces);
+    plint offset = 0;
+    for (pluint iPiece=0; iPiece<pieces.size(); ++iPiece) {
+        pieces[iPiece].offset = offset;
+        offset += pieces[iPiece].box.nCells()*multiBlock.sizeOfCell();
+    }
+    return offset;
+}
+
+template<typename T>
+plint BlockwiseSerializationPlan3D<T>::getSerializedSize (
+        Box3D const& slab, std::vector<Piece> const& pieces ) const
+{
+    if (ordering==IndexOrdering::memorySaving) {
+        plint numCells = 0;
+        for (pluint iPiece=0; iPiece<pieces.size(); ++iPiece) {
+            numCells += pieces[iPiece].box.nCells();
+        }
+        return numCells*multiBlock.sizeOfCell();
+    }
+    else {
+        return slab.nCells()*multiBlock.sizeOfCell();
+    }
+}
+
+template<typename T>
+void BlockwiseSerializationPlan3D<T>::assemble (
+        Box3D const& slab, std::vector<Piece> const& pieces,
+        T* pieceData, T* serialized ) const
+{
+    copyLines(slab, pieces, pieceData, serialized, true);
+}
+
+template<typename T>
+void BlockwiseSerializationPlan3D<T>::disassemble (
+        Box3D const& slab, std::vector<Piece> const& pieces,
+        T* pieceData, T* serialized ) const
+{
+    copyLines(slab, pieces, pieceData, serialized, false);
+}
+
+template<typename T>
+bool BlockwiseSerializationPlan3D<T>::isLocal(plint procId) const {
+    return multiBlock.getMultiBlockManagement().getThreadAttribution().isLocal(procId);
+}
+
+template<typename T>
+void BlockwiseSerializationPlan3D<T>::copyLines (
+        Box3D const& slab, std::vector<Piece> const& pieces,
+        T* pieceData, T* serialized, bool toSerialized ) const
+{
+    plint sizeOfCell = multiBlock.sizeOfCell();
+    // The serialized data is a sequence of lines along z (forward and
+    //   memorySaving ordering) or along x (backward ordering).
+    bool alongZ = ordering!=IndexOrdering::backward;
+    plint outer0 = alongZ ? slab.x0 : slab.z0;
+    plint outer1 = alongZ ? slab.x1 : slab.z1;
+    plint lineEnd = alongZ ? slab.z1 : slab.x1;
+    plint lineStart = alongZ ? slab.z0 : slab.x0;
+
+    std::vector<Piece const*> sortedPieces(pieces.size());
+    for (pluint iPiece=0; iPiece<pieces.size(); ++iPiece) {
+        sortedPieces[iPiece] = &pieces[iPiece];
+    }
+    std::sort(sortedPieces.begin(), sortedPieces.end(), LineStartOrder(alongZ));
+
+    for (plint iOuter=outer0; iOuter<=outer1; ++iOuter) {
+        for (plint iY=slab.y0; iY<=slab.y1; ++iY) {
+            plint pos = lineStart;
+            for (pluint iPiece=0; iPiece<=sortedPieces.size(); ++iPiece) {
+                Piece const* piece = iPiece<sortedPieces.size() ? sortedPieces[iPiece] : 0;
+                plint start = lineEnd+1;
+                plint end = lineEnd;
+                if (piece) {
+                    Box3D const& box = piece->box;
+                    bool onLine = iY>=box.y0 && iY<=box.y1 &&
+                                  ( alongZ ? (iOuter>=box.x0 && iOuter<=box.x1)
+                                           : (iOuter>=box.z0 && iOuter<=box.z1) );
+                    if (!onLine) continue;
+                    start = alongZ ? box.z0 : box.x0;
+                    end = alongZ ? box.z1 : box.x1;
+                }
+                // Cells which are not covered by any block.
+                if (ordering!=IndexOrdering::memorySaving) {
+                    plint gapSize = (start-pos)*sizeOfCell;
+                    if (toSerialized) {
+                        std::fill(serialized, serialized+gapSize, T());
+                    }
+                    serialized += gapSize;
+                }
+                if (!piece) break;
+                Box3D const& box = piece->box;
+                plint iX = alongZ ? iOuter : start;
+                plint iZ = alongZ ? start : iOuter;
+                T* cell = pieceData + piece->offset +
+                          ( ((iX-box.x0)*box.getNy() + (iY-box.y0))*box.getNz() + (iZ-box.z0) )*sizeOfCell;
+                plint cellStride = alongZ ? sizeOfCell : box.getNy()*box.getNz()*sizeOfCell;
+                if (cellStride==sizeOfCell) {
+                    plint runSize = (end-start+1)*sizeOfCell;
+                    if (toSerialized) {
+                        std::copy(cell, cell+runSize, serialized);
+                    }
+                    else {
+                        std::copy(serialized, serialized+runSize, cell);
+                    }
+                    serialized += runSize;
+                }
+                else {
+                    for (plint iCell=start; iCell<=end; ++iCell) {
+                        if (toSerialized) {
+                            std::copy(cell, cell+sizeOfCell, serialized);
+                        }
+                        else {
+                            std::copy(serialized, serialized+sizeOfCell, cell);
+                        }
+                        cell += cellStride;
+                        serialized += sizeOfCell;
+                    }
+                }
+                pos = end+1;
+            }
+        }
+    }
+}
+
+
+////////// class BlockwiseMultiBlockSerializer3D ////////////////////////////
+
+template<typename T>
+BlockwiseMultiBlockSerializer3D<T>::BlockwiseMultiBlockSerializer3D (
+        MultiBlock3D<T> const& multiBlock_,
+        Box3D domain_,
+        IndexOrdering::OrderingT ordering_ )
+    : multiBlock(multiBlock_),
+      ordering(ordering_),
+      domain(domain_),
+      plan(multiBlock, domain, ordering),
+      currentSlab(0),
+      buffer(1) // this avoids buffer of size 0 which one cannot point to
+{ }
+
+template<typename T>
+BlockwiseMultiBlockSerializer3D<T>::~BlockwiseMultiBlockSerializer3D() {
+    // Complete the transfers if the serializer was not emptied.
+    completeSlab(0);
+    completeSlab(1);
+}
+
+template<typename T>
+BlockwiseMultiBlockSerializer3D<T>* BlockwiseMultiBlockSerializer3D<T>::clone() const {
+    return new BlockwiseMultiBlockSerializer3D<T>(multiBlock, domain, ordering);
+}
+
+template<typename T>
+pluint BlockwiseMultiBlockSerializer3D<T>::getSize() const {
+    if (ordering==IndexOrdering::memorySaving) {
+        return multiBlock.getMultiBlockManagement().getMultiBlockDistribution().getNumAllocatedBulkCells()
+                   * multiBlock.sizeOfCell();
+    }
+    else {
+        return domain.nCells() * multiBlock.sizeOfCell();
+    }
+}
+
+template<typename T>
+const T* BlockwiseMultiBlockSerializer3D<T>::getNextDataBuffer(pluint& bufferSize) const {
+    PLB_PRECONDITION( !isEmpty() );
+    if (currentSlab==0) {
+        startSlab(0);
+    }
+    // Double buffering: the next slab is in transit while the current one is processed.
+    if (currentSlab+1 < plan.getNumSlabs()) {
+        startSlab(currentSlab+1);
+    }
+    completeSlab(currentSlab);
+    plint iBuffer = currentSlab%2;
+    Box3D slab = plan.getSlab(currentSlab);
+    bufferSize = plan.getSerializedSize(slab, pieces[iBuffer]);
+    // The buffer is allocated on all processes, because filters like the
+    //   TypeConversionSerializer read bufferSize elements everywhere.
+    //   The +1 avoids having a buffer of size 0 which one cannot point to
+    buffer.resize(bufferSize+1);
+    if (global::mpi().isMainProcessor()) {
+        plan.assemble(slab, pieces[iBuffer], &pieceData[iBuffer][0], &buffer[0]);
+    }
+    ++currentSlab;
+    return &buffer[0];
+}
+
+template<typename T>
+bool BlockwiseMultiBlockSerializer3D<T>::isEmpty() const {
+    return currentSlab >= plan.getNumSlabs();
+}
+
+template<typename T>
+void BlockwiseMultiBlockSerializer3D<T>::startSlab(plint iSlab) const {
+    plint iBuffer = iSlab%2;
+    plint slabSize = plan.computePieces(plan.getSlab(iSlab), pieces[iBuffer]);
+    std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> const& slabPieces = pieces[iBuffer];
+    if (global::mpi().isMainProcessor()) {
+        // The +1 avoids having a buffer of size 0 which one cannot point to
+        pieceData[iBuffer].resize(slabSize+1);
+        packPieces(slabPieces, &pieceData[iBuffer][0], true);
+#ifdef PLB_MPI_PARALLEL
+        // One message per remote process, whose pieces are contiguous.
+        pluint iPiece=0;
+        while (iPiece<slabPieces.size()) {
+            plint procId = slabPieces[iPiece].procId;
+            plint offset = slabPieces[iPiece].offset;
+            plint size = 0;
+            for (; iPiece<slabPieces.size() && slabPieces[iPiece].procId==procId; ++iPiece) {
+                size += slabPieces[iPiece].box.nCells()*multiBlock.sizeOfCell();
+            }
+            if (!plan.isLocal(procId)) {
+                requests[iBuffer].push_back(MPI_Request());
+                global::mpi().iRecv(&pieceData[iBuffer][offset], size, procId, &requests[iBuffer].back());
+            }
+        }
+#endif
+    }
+#ifdef PLB_MPI_PARALLEL
+    else {
+        plint size = 0;
+        for (pluint iPiece=0; iPiece<slabPieces.size(); ++iPiece) {
+            if (plan.isLocal(slabPieces[iPiece].procId)) {
+                size += slabPieces[iPiece].box.nCells()*multiBlock.sizeOfCell();
+            }
+        }
+        if (size>0) {
+            pieceData[iBuffer].resize(size);
+            packPieces(slabPieces, &pieceData[iBuffer][0], false);
+            requests[iBuffer].push_back(MPI_Request());
+            global::mpi().iSend(&pieceData[iBuffer][0], size, 0, &requests[iBuffer].back());
+        }
+    }
+#endif
+}
+
+template<typename T>
+void BlockwiseMultiBlockSerializer3D<T>::completeSlab(plint iSlab) const {
+#ifdef PLB_MPI_PARALLEL
+    std::vector<MPI_Request>& slabRequests = requests[iSlab%2];
+    if (!slabRequests.empty()) {
+        std::vector<MPI_Status> statuses(slabRequests.size());
+        global::mpi().waitAll((int)slabRequests.size(), &slabRequests[0], &statuses[0]);
+        slabRequests.clear();
+    }
+#endif
+}
+
+template<typename T>
+void BlockwiseMultiBlockSerializer3D<T>::packPieces (
+        std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> const& slabPieces,
+        T* data, bool atSlabOffsets ) const
+{
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    for (pluint iPiece=0; iPiece<slabPieces.size(); ++iPiece) {
+        typename BlockwiseSerializationPlan3D<T>::Piece const& piece = slabPieces[iPiece];
+        if (plan.isLocal(piece.procId)) {
+            BlockParameters3D const& params = distribution.getBlockParameters(piece.blockId);
+            T* pieceBegin = atSlabOffsets ? data+piece.offset : data;
+            multiBlock.getComponent(piece.blockId).getDataTransfer().send (
+                    params.toLocal(piece.box), pieceBegin );
+            if (!atSlabOffsets) {
+                data += piece.box.nCells()*multiBlock.sizeOfCell();
+            }
+        }
+    }
+}
+
+
+////////// class BlockwiseMultiBlockUnSerializer3D ////////////////////////////
+
+template<typename T>
+BlockwiseMultiBlockUnSerializer3D<T>::BlockwiseMultiBlockUnSerializer3D (
+        MultiBlock3D<T>& multiBlock_,
+        Box3D domain_,
+        IndexOrdering::OrderingT ordering_ )
+    : multiBlock(multiBlock_),
+      ordering(ordering_),
+      domain(domain_),
+      plan(multiBlock, domain, ordering),
+      currentSlab(0),
+      buffer(1) // this avoids buffer of size 0 which one cannot point to
+{ }
+
+template<typename T>
+BlockwiseMultiBlockUnSerializer3D<T>::~BlockwiseMultiBlockUnSerializer3D() {
+    waitForSends(0);
+    waitForSends(1);
+}
+
+template<typename T>
+BlockwiseMultiBlockUnSerializer3D<T>* BlockwiseMultiBlockUnSerializer3D<T>::clone() const {
+    return new BlockwiseMultiBlockUnSerializer3D<T>(multiBlock, domain, ordering);
+}
+
+template<typename T>
+pluint BlockwiseMultiBlockUnSerializer3D<T>::getSize() const {
+    if (ordering==IndexOrdering::memorySaving) {
+        return multiBlock.getMultiBlockManagement().getMultiBlockDistribution().getNumAllocatedBulkCells()
+                   * multiBlock.sizeOfCell();
+    }
+    else {
+        return domain.nCells() * multiBlock.sizeOfCell();
+    }
+}
+
+template<typename T>
+T* BlockwiseMultiBlockUnSerializer3D<T>::getNextDataBuffer(pluint& bufferSize) {
+    PLB_PRECONDITION( !isFull() );
+    Box3D slab = plan.getSlab(currentSlab);
+    plan.computePieces(slab, pieces);
+    bufferSize = plan.getSerializedSize(slab, pieces);
+    if (global::mpi().isMainProcessor()) {
+        // The +1 avoids having a buffer of size 0 which one cannot point to
+        buffer.resize(bufferSize+1);
+    }
+    return &buffer[0];
+}
+
+template<typename T>
+void BlockwiseMultiBlockUnSerializer3D<T>::commitData() {
+    PLB_PRECONDITION( !isFull() );
+    plint iBuffer = currentSlab%2;
+    Box3D slab = plan.getSlab(currentSlab);
+    plint slabSize = plan.computePieces(slab, pieces);
+    if (global::mpi().isMainProcessor()) {
+        // The buffer is reused only after the messages of the slab before
+        //   last have been delivered.
+        waitForSends(iBuffer);
+        pieceData[iBuffer].resize(slabSize+1);
+        plan.disassemble(slab, pieces, &pieceData[iBuffer][0], &buffer[0]);
+        unpackPieces(pieces, &pieceData[iBuffer][0], true);
+#ifdef PLB_MPI_PARALLEL
+        pluint iPiece=0;
+        while (iPiece<pieces.size()) {
+            plint procId = pieces[iPiece].procId;
+            plint offset = pieces[iPiece].offset;
+            plint size = 0;
+            for (; iPiece<pieces.size() && pieces[iPiece].procId==procId; ++iPiece) {
+                size += pieces[iPiece].box.nCells()*multiBlock.sizeOfCell();
+            }
+            if (!plan.isLocal(procId)) {
+                requests[iBuffer].push_back(MPI_Request());
+                global::mpi().iSend(&pieceData[iBuffer][offset], size, procId, &requests[iBuffer].back());
+            }
+        }
+#endif
+    }
+#ifdef PLB_MPI_PARALLEL
+    else {
+        plint size = 0;
+        for (pluint iPiece=0; iPiece<pieces.size(); ++iPiece) {
+            if (plan.isLocal(pieces[iPiece].procId)) {
+                size += pieces[iPiece].box.nCells()*multiBlock.sizeOfCell();
+            }
+        }
+        if (size>0) {
+            pieceData[iBuffer].resize(size);
+            global::mpi().receive(&pieceData[iBuffer][0], size, 0);
+            unpackPieces(pieces, &pieceData[iBuffer][0], false);
+        }
+    }
+#endif
+    ++currentSlab;
+    // At the end of unserialization, duplicate overlaps.
+    if (isFull()) {
+        waitForSends(0);
+        waitForSends(1);
+        multiBlock.getBlockCommunicator().duplicateOverlaps(multiBlock);
+    }
+}
+
+template<typename T>
+bool BlockwiseMultiBlockUnSerializer3D<T>::isFull() const {
+    return currentSlab >= plan.getNumSlabs();
+}
+
+template<typename T>
+void BlockwiseMultiBlockUnSerializer3D<T>::waitForSends(plint iBuffer) {
+#ifdef PLB_MPI_PARALLEL
+    if (!requests[iBuffer].empty()) {
+        std::vector<MPI_Status> statuses(requests[iBuffer].size());
+        global::mpi().waitAll((int)requests[iBuffer].size(), &requests[iBuffer][0], &statuses[0]);
+        requests[iBuffer].clear();
+    }
+#endif
+}
+
+template<typename T>
+void BlockwiseMultiBlockUnSerializer3D<T>::unpackPieces (
+        std::vector<typename BlockwiseSerializationPlan3D<T>::Piece> const& slabPieces,
+        T* data, bool atSlabOffsets )
+{
+    MultiBlockDistribution3D const& distribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    for (pluint iPiece=0; iPiece<slabPieces.size(); ++iPiece) {
+        typename BlockwiseSerializationPlan3D<T>::Piece const& piece = slabPieces[iPiece];
+        if (plan.isLocal(piece.procId)) {
+            BlockParameters3D const& params = distribution.getBlockParameters(piece.blockId);
+            T* pieceBegin = atSlabOffsets ? data+piece.offset : data;
+            multiBlock.getComponent(piece.blockId).getDataTransfer().receive (
+                    params.toLocal(piece.box), pieceBegin );
+            if (!atSlabOffsets) {
+                data += piece.box.nCells()*multiBlock.sizeOfCell();
+            }
+        }
+    }
+}
+
+
 }  //  namespace plb
 
 #endif  // MULTI_BLOCK_SERIALIZER_3D_HH
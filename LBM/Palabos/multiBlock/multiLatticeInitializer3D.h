@@ -48,6 +48,24 @@ template<typename T, template<typename U> class Descriptor>
 void defineDynamics( MultiBlockLattice3D<T,Descriptor>& lattice, MultiScalarField3D<T>& intMask,
                      Dynamics<T,Descriptor>* dynamics, int whichFlag );
 
+/// Like defineDynamics(), but all cells refer to a single instance of the dynamics per atomic block.
+/** See defineSharedDynamics() in latticeInitializer3D.h. */
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( MultiBlockLattice3D<T,Descriptor>& lattice, MultiScalarField3D<T>& boolMask,
+                           Box3D domain, Dynamics<T,Descriptor>* dynamics, bool whichFlag );
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( MultiBlockLattice3D<T,Descriptor>& lattice, MultiScalarField3D<T>& boolMask,
+                           Dynamics<T,Descriptor>* dynamics, bool whichFlag );
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( MultiBlockLattice3D<T,Descriptor>& lattice, MultiScalarField3D<T>& intMask,
+                           Box3D domain, Dynamics<T,Descriptor>* dynamics, int whichFlag );
+
+template<typename T, template<typename U> class Descriptor>
+void defineSharedDynamics( MultiBlockLattice3D<T,Descriptor>& lattice, MultiScalarField3D<T>& intMask,
+                           Dynamics<T,Descriptor>* dynamics, int whichFlag );
+
 }  // namespace plb
 
 #endif  // MULTI_LATTICE_INITIALIZER_3D_H
@@ -29,5 +29,8 @@ namespace plb {
 
     template class MultiBlockSerializer3D<double>;
     template class MultiBlockUnSerializer3D<double>;
+    template class BlockwiseSerializationPlan3D<double>;
+    template class BlockwiseMultiBlockSerializer3D<double>;
+    template class BlockwiseMultiBlockUnSerializer3D<double>;
 
 }
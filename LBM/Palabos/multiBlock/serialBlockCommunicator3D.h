@@ -27,22 +27,53 @@
 #include "core/globalDefs.h"
 #include "multiBlock/blockCommunicator3D.h"
 #include "multiBlock/multiBlockManagement3D.h"
+#include "parallelism/communicationPackage3D.h"
+#include <vector>
 
 namespace plb {
 
 class MultiBlockManagement3D;
+template<typename T> class CopyOverlapsTask3D;
 
+/// Communicator for multi-blocks whose blocks are all local.
+/** The overlaps are copied from block to block. The copy plans, which group
+ *  the overlaps by destination block, are computed at the first
+ *  communication and reused afterwards; they are recomputed only when the
+ *  periodicity of the multi-block changes.
+ */
 template<typename T>
 class SerialBlockCommunicator3D : public BlockCommunicator3D<T> {
 public:
     SerialBlockCommunicator3D();
+    SerialBlockCommunicator3D(SerialBlockCommunicator3D<T> const& rhs);
     virtual SerialBlockCommunicator3D<T>* clone() const;
     virtual void broadCastScalar(T& scalar, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const;
     virtual void broadCastVector(T* data, plint length, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const;
     virtual void duplicateOverlaps(MultiBlock3D<T>& multiBlock) const;
+    virtual void returnStreamedData(MultiBlock3D<T>& multiBlock) const;
     virtual void signalPeriodicity() const;
 private:
-    void copyOverlap(Overlap3D const& overlap, MultiBlock3D<T>& multiBlock) const;
+    SerialBlockCommunicator3D<T>& operator= (
+            SerialBlockCommunicator3D<T> const& rhs ) { return *this; }
+    void setupCopyPlan(MultiBlock3D<T> const& multiBlock) const;
+    void subscribeOverlap(Overlap3D const& overlap, MultiBlockDistribution3D const& distribution) const;
+    void copyOverlap(CommunicationInfo3D const& info, MultiBlock3D<T>& multiBlock, bool streamedData) const;
+private:
+    /// Overlaps to be copied, grouped by destination block.
+    struct CopyPlan {
+        std::vector<CommunicationPackage3D> copiesPerBlock;
+        /// Blocks with a non-empty list of copies, and the number of cells they receive.
+        std::vector<plint> blocks, costs;
+        void clear(plint numBlocks);
+        void computeCosts();
+    };
+    void executeCopyPlan(CopyPlan const& plan, MultiBlock3D<T>& multiBlock, bool streamedData) const;
+private:
+    mutable bool needsUpdate;
+    mutable CopyPlan copyPlan;
+    /// Plan for the return of the data streamed into the envelopes.
+    mutable CopyPlan streamedCopyPlan;
+friend class CopyOverlapsTask3D<T>;
 };
 
 }  // namespace plb
@@ -28,6 +28,8 @@
 #include "atomicBlock/atomicBlock3D.h"
 #include "multiBlock/multiBlock3D.h"
 #include "core/plbDebug.h"
+#include "parallelism/smpManager.h"
+#include <vector>
 
 namespace plb {
 
@@ -35,6 +37,13 @@ namespace plb {
 
 template<typename T>
 SerialBlockCommunicator3D<T>::SerialBlockCommunicator3D()
+    : needsUpdate(true)
+{ }
+
+template<typename T>
+SerialBlockCommunicator3D<T>::SerialBlockCommunicator3D (
+        SerialBlockCommunicator3D<T> const& rhs )
+    : needsUpdate(true)
 { }
 
 template<typename T>
@@ -53,40 +62,70 @@ void SerialBlockCommunicator3D<T>::broadCastVector(T* vect, plint length, plint
 }
 
 template<typename T>
-void SerialBlockCommunicator3D<T>::copyOverlap(Overlap3D const& overlap, MultiBlock3D<T>& multiBlock) const
+void SerialBlockCommunicator3D<T>::subscribeOverlap (
+        Overlap3D const& overlap, MultiBlockDistribution3D const& distribution ) const
 {
-    MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
-    MultiBlockDistribution3D const& multiBlockDistribution = multiBlockManagement.getMultiBlockDistribution();
-    plint originalId = overlap.getOriginalId();
-    plint overlapId  = overlap.getOverlapId();
-    BlockParameters3D const& originalParameters = multiBlockDistribution.getBlockParameters(originalId);
-    BlockParameters3D const& overlapParameters  = multiBlockDistribution.getBlockParameters(overlapId);
-
-    Box3D originalCoords(originalParameters.toLocal(overlap.getOriginalCoordinates()));
-    Box3D overlapCoords(overlapParameters.toLocal(overlap.getOverlapCoordinates()));
-
-    PLB_PRECONDITION(originalCoords.x1-originalCoords.x0 == overlapCoords.x1-overlapCoords.x0);
-    PLB_PRECONDITION(originalCoords.y1-originalCoords.y0 == overlapCoords.y1-overlapCoords.y0);
-    PLB_PRECONDITION(originalCoords.z1-originalCoords.z0 == overlapCoords.z1-overlapCoords.z0);
-
-    AtomicBlock3D<T>* originalBlock = &multiBlock.getComponent(originalId);
-    AtomicBlock3D<T>* overlapBlock = &multiBlock.getComponent(overlapId);
-    plint deltaX = originalCoords.x0 - overlapCoords.x0;
-    plint deltaY = originalCoords.y0 - overlapCoords.y0;
-    plint deltaZ = originalCoords.z0 - overlapCoords.z0;
-
-    overlapBlock -> getDataTransfer().attribute(overlapCoords, deltaX, deltaY, deltaZ, *originalBlock);
+    CommunicationInfo3D info;
+    info.fromBlockId = overlap.getOriginalId();
+    info.toBlockId   = overlap.getOverlapId();
+    BlockParameters3D const& originalParameters = distribution.getBlockParameters(info.fromBlockId);
+    BlockParameters3D const& overlapParameters  = distribution.getBlockParameters(info.toBlockId);
+    info.fromProcessId = originalParameters.getProcId();
+    info.toProcessId   = overlapParameters.getProcId();
+    info.fromDomain = originalParameters.toLocal(overlap.getOriginalCoordinates());
+    info.toDomain   = overlapParameters.toLocal(overlap.getOverlapCoordinates());
+
+    PLB_PRECONDITION(info.fromDomain.x1-info.fromDomain.x0 == info.toDomain.x1-info.toDomain.x0);
+    PLB_PRECONDITION(info.fromDomain.y1-info.fromDomain.y0 == info.toDomain.y1-info.toDomain.y0);
+    PLB_PRECONDITION(info.fromDomain.z1-info.fromDomain.z0 == info.toDomain.z1-info.toDomain.z0);
+
+    copyPlan.copiesPerBlock[info.toBlockId].push_back(info);
+
+    Box3D overlapBulk(overlapParameters.toLocal(overlapParameters.getBulk()));
+    streamedCopyPlan.copiesPerBlock[info.fromBlockId].push_back (
+            reverseForStreamedData(info, overlapBulk) );
 }
 
 template<typename T>
-void SerialBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlock) const
+void SerialBlockCommunicator3D<T>::CopyPlan::clear(plint numBlocks)
+{
+    copiesPerBlock.clear();
+    copiesPerBlock.resize(numBlocks);
+    blocks.clear();
+    costs.clear();
+}
+
+template<typename T>
+void SerialBlockCommunicator3D<T>::CopyPlan::computeCosts()
 {
-    MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
+    for (pluint iBlock=0; iBlock<copiesPerBlock.size(); ++iBlock) {
+        if (!copiesPerBlock[iBlock].empty()) {
+            plint cost = 0;
+            for (pluint iCopy=0; iCopy<copiesPerBlock[iBlock].size(); ++iCopy) {
+                cost += copiesPerBlock[iBlock][iCopy].toDomain.nCells();
+            }
+            blocks.push_back(iBlock);
+            costs.push_back(cost);
+        }
+    }
+}
+
+template<typename T>
+void SerialBlockCommunicator3D<T>::setupCopyPlan(MultiBlock3D<T> const& multiBlock) const
+{
+    if (!needsUpdate) {
+        return;
+    }
+    needsUpdate = false;
+
+    MultiBlockDistribution3D const& multiBlockDistribution =
+        multiBlock.getMultiBlockManagement().getMultiBlockDistribution();
+    copyPlan.clear(multiBlockDistribution.getNumBlocks());
+    streamedCopyPlan.clear(multiBlockDistribution.getNumBlocks());
 
     // Non-periodic communication
-    MultiBlockDistribution3D const& multiBlockDistribution = multiBlockManagement.getMultiBlockDistribution();
     for (plint iOverlap=0; iOverlap<multiBlockDistribution.getNumNormalOverlaps(); ++iOverlap) {
-        copyOverlap(multiBlockDistribution.getNormalOverlap(iOverlap), multiBlock);
+        subscribeOverlap(multiBlockDistribution.getNormalOverlap(iOverlap), multiBlockDistribution);
     }
 
     // Periodic communication
@@ -94,14 +133,96 @@ void SerialBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlock
     for (plint iOverlap=0; iOverlap<multiBlockDistribution.getNumPeriodicOverlaps(); ++iOverlap) {
         PeriodicOverlap3D const& pOverlap = multiBlockDistribution.getPeriodicOverlap(iOverlap);
         if (periodicity.get(pOverlap.normalX, pOverlap.normalY, pOverlap.normalZ)) {
-            copyOverlap(pOverlap.overlap, multiBlock);
+            subscribeOverlap(pOverlap.overlap, multiBlockDistribution);
         }
     }
+
+    copyPlan.computeCosts();
+    streamedCopyPlan.computeCosts();
+}
+
+template<typename T>
+void SerialBlockCommunicator3D<T>::copyOverlap (
+        CommunicationInfo3D const& info, MultiBlock3D<T>& multiBlock, bool streamedData ) const
+{
+    AtomicBlock3D<T>& fromBlock = multiBlock.getComponent(info.fromBlockId);
+    AtomicBlock3D<T>& toBlock   = multiBlock.getComponent(info.toBlockId);
+    plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+    plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+    plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+
+    if (streamedData) {
+        toBlock.getDataTransfer().attributeStreamed (
+                info.toDomain, info.streamSource, deltaX, deltaY, deltaZ, fromBlock );
+    }
+    else {
+        toBlock.getDataTransfer().attribute(info.toDomain, deltaX, deltaY, deltaZ, fromBlock);
+    }
+}
+
+/// Copies all overlaps which have a given block as destination.
+template<typename T>
+class CopyOverlapsTask3D : public BlockTask {
+public:
+    CopyOverlapsTask3D( SerialBlockCommunicator3D<T> const& communicator_,
+                        MultiBlock3D<T>& multiBlock_,
+                        std::vector<CommunicationPackage3D> const& copiesPerBlock_,
+                        bool streamedData_ )
+        : communicator(communicator_),
+          multiBlock(multiBlock_),
+          copiesPerBlock(copiesPerBlock_),
+          streamedData(streamedData_)
+    { }
+    virtual void execute(plint iBlock) {
+        CommunicationPackage3D const& copies = copiesPerBlock[iBlock];
+        for (pluint iCopy=0; iCopy<copies.size(); ++iCopy) {
+            communicator.copyOverlap(copies[iCopy], multiBlock, streamedData);
+        }
+    }
+private:
+    SerialBlockCommunicator3D<T> const& communicator;
+    MultiBlock3D<T>& multiBlock;
+    std::vector<CommunicationPackage3D> const& copiesPerBlock;
+    bool streamedData;
+};
+
+/** The groups of copies write into distinct blocks, and read only from
+ *  regions of other blocks which are not written: they are executed
+ *  concurrently if threads are enabled.
+ */
+template<typename T>
+void SerialBlockCommunicator3D<T>::executeCopyPlan (
+        CopyPlan const& plan, MultiBlock3D<T>& multiBlock, bool streamedData ) const
+{
+    CopyOverlapsTask3D<T> task(*this, multiBlock, plan.copiesPerBlock, streamedData);
+    executeBlockTasks(plan.blocks, plan.costs, task);
+}
+
+/** The overlaps are copied from the bulk of each block into the envelopes
+ *  of its neighbors.
+ */
+template<typename T>
+void SerialBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlock) const
+{
+    setupCopyPlan(multiBlock);
+    executeCopyPlan(copyPlan, multiBlock, false);
+}
+
+/** The overlaps are copied from the envelope of each block into the bulk
+ *  of its neighbors.
+ */
+template<typename T>
+void SerialBlockCommunicator3D<T>::returnStreamedData(MultiBlock3D<T>& multiBlock) const
+{
+    setupCopyPlan(multiBlock);
+    executeCopyPlan(streamedCopyPlan, multiBlock, true);
 }
 
 template<typename T>
 void SerialBlockCommunicator3D<T>::signalPeriodicity() const
-{ }
+{
+    needsUpdate = true;
+}
 
 
 }  // namespace plb
@@ -26,6 +26,8 @@
 #include "atomicBlock/dataField3D.hh"
 #include "core/blockStatistics.hh"
 #include "algorithm/basicAlgorithms.h"
+#include <algorithm>
+#include <utility>
 
 namespace plb {
 
@@ -200,4 +202,393 @@ MultiBlockDistribution3D createZSlicedMultiBlockDistribution3D (
     return createZSlicedMultiBlockDistribution3D(cellTypeField, global::mpi().getSize(), envelopeWidth);
 }
 
+////////////////////// Weighted data distributions /////////////////////
+
+DynamicsCostTable::DynamicsCostTable(double defaultCost_)
+    : defaultCost(defaultCost_)
+{ }
+
+void addCellCost(CellCostField3D& costField, Box3D domain, double cost) {
+    Box3D inters;
+    if (intersect(domain, costField.getBoundingBox(), inters)) {
+        for (plint iX=inters.x0; iX<=inters.x1; ++iX) {
+            for (plint iY=inters.y0; iY<=inters.y1; ++iY) {
+                for (plint iZ=inters.z0; iZ<=inters.z1; ++iZ) {
+                    costField.get(iX,iY,iZ) += cost;
+                }
+            }
+        }
+    }
+}
+
+LoadBalanceReport3D::LoadBalanceReport3D()
+    : totalCost(0.), maxCost(0.), meanCost(0.), imbalance(1.),
+      numCommunicatedCells(0), numOmittedBlocks(0)
+{ }
+
+namespace {
+
+double computeBoxCost(CellCostField3D const& costField, Box3D const& box) {
+    double cost = 0.;
+    for (plint iX=box.x0; iX<=box.x1; ++iX) {
+        for (plint iY=box.y0; iY<=box.y1; ++iY) {
+            for (plint iZ=box.z0; iZ<=box.z1; ++iZ) {
+                cost += costField.get(iX,iY,iZ);
+            }
+        }
+    }
+    return cost;
+}
+
+/// Position on a Morton (Z-order) curve: the bits of the coordinates are interleaved.
+pluint mortonIndex(plint iX, plint iY, plint iZ, plint numBits) {
+    pluint coord[3] = { (pluint)iX, (pluint)iY, (pluint)iZ };
+    pluint index = 0;
+    for (plint iBit=numBits-1; iBit>=0; --iBit) {
+        for (plint iDim=0; iDim<3; ++iDim) {
+            index = (index<<1) | ((coord[iDim]>>iBit) & 1);
+        }
+    }
+    return index;
+}
+
+/// Position on a Hilbert curve, following J. Skilling, "Programming the
+///   Hilbert curve", AIP Conf. Proc. 707 (2004): the coordinates are
+///   transformed into the "transposed" Hilbert index, whose bits are
+///   then interleaved like in the Morton index.
+pluint hilbertIndex(plint iX, plint iY, plint iZ, plint numBits) {
+    pluint coord[3] = { (pluint)iX, (pluint)iY, (pluint)iZ };
+    pluint highestBit = (pluint)1 << (numBits-1);
+    // Inverse undo.
+    for (pluint bit=highestBit; bit>1; bit>>=1) {
+        pluint lowerBits = bit-1;
+        for (plint iDim=0; iDim<3; ++iDim) {
+            if (coord[iDim] & bit) {
+                coord[0] ^= lowerBits;
+            }
+            else {
+                pluint swapped = (coord[0]^coord[iDim]) & lowerBits;
+                coord[0] ^= swapped;
+                coord[iDim] ^= swapped;
+            }
+        }
+    }
+    // Gray encode.
+    for (plint iDim=1; iDim<3; ++iDim) {
+        coord[iDim] ^= coord[iDim-1];
+    }
+    pluint flip = 0;
+    for (pluint bit=highestBit; bit>1; bit>>=1) {
+        if (coord[2] & bit) {
+            flip ^= bit-1;
+        }
+    }
+    for (plint iDim=0; iDim<3; ++iDim) {
+        coord[iDim] ^= flip;
+    }
+    return mortonIndex((plint)coord[0], (plint)coord[1], (plint)coord[2], numBits);
+}
+
+/// A block of the regular grid, with its position on the space-filling curve.
+struct CurveBlock {
+    pluint curveIndex;
+    Box3D bulk;
+    double cost;
+    bool operator<(CurveBlock const& rhs) const {
+        return curveIndex < rhs.curveIndex;
+    }
+};
+
+/// Start of block iBlock out of numBlocks along an axis of n cells.
+plint regularBlockBegin(plint n, plint numBlocks, plint iBlock) {
+    return iBlock*(n/numBlocks) + std::min(iBlock, n%numBlocks);
+}
+
+/// Cut a sequence of blocks into numProc contiguous pieces of approximately equal cost.
+/** The piece of each block is written into pieces. */
+void cutCurve(std::vector<double> const& costs, int numProc, std::vector<plint>& pieces) {
+    double totalCost = 0.;
+    for (pluint iBlock=0; iBlock<costs.size(); ++iBlock) {
+        totalCost += costs[iBlock];
+    }
+
+    // The curve is cut into numProc contiguous pieces, such as to minimize
+    //   the cost of the most expensive piece. This bottleneck is found by
+    //   bisection: for a given bound, the pieces are filled greedily, and
+    //   the bound is feasible if no more than numProc pieces are needed.
+    double lowerBound = totalCost / (double)numProc;
+    double upperBound = totalCost;
+    for (pluint iBlock=0; iBlock<costs.size(); ++iBlock) {
+        lowerBound = std::max(lowerBound, costs[iBlock]);
+    }
+    for (plint iBisection=0; iBisection<64 && lowerBound<upperBound; ++iBisection) {
+        double bound = 0.5*(lowerBound+upperBound);
+        plint numPieces = 1;
+        double pieceCost = 0.;
+        for (pluint iBlock=0; iBlock<costs.size(); ++iBlock) {
+            if (pieceCost+costs[iBlock] > bound) {
+                ++numPieces;
+                pieceCost = 0.;
+            }
+            pieceCost += costs[iBlock];
+        }
+        if (numPieces <= numProc) {
+            upperBound = bound;
+        }
+        else {
+            lowerBound = bound;
+        }
+    }
+
+    // A new piece is also started when just enough blocks are left to give
+    //   one to each of the remaining processes.
+    plint numBlocks = (plint)costs.size();
+    pieces.resize(numBlocks);
+    plint procId = 0;
+    double pieceCost = 0.;
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        if ( iBlock>0 && procId<numProc-1 &&
+             ( pieceCost+costs[iBlock] > upperBound ||
+               numBlocks-iBlock == numProc-1-procId ) )
+        {
+            ++procId;
+            pieceCost = 0.;
+        }
+        pieces[iBlock] = procId;
+        pieceCost += costs[iBlock];
+    }
+}
+
+/// Overlap between a piece of the curve and the blocks which a process already owns.
+struct PieceOwnership {
+    double cost;
+    plint piece, procId;
+    bool operator<(PieceOwnership const& rhs) const {
+        if (cost != rhs.cost) {
+            return cost > rhs.cost;
+        }
+        if (piece != rhs.piece) {
+            return piece < rhs.piece;
+        }
+        return procId < rhs.procId;
+    }
+};
+
+}  // namespace
+
+LoadBalanceReport3D predictLoadBalance3D (
+        MultiBlockDistribution3D const& distribution, CellCostField3D const& costField,
+        int numProc )
+{
+    std::vector<double> blockCosts(distribution.getNumBlocks());
+    for (plint iBlock=0; iBlock<distribution.getNumBlocks(); ++iBlock) {
+        blockCosts[iBlock] = computeBoxCost(costField, distribution.getBlockParameters(iBlock).getBulk());
+    }
+    return predictLoadBalance3D(distribution, blockCosts, numProc);
+}
+
+LoadBalanceReport3D predictLoadBalance3D (
+        MultiBlockDistribution3D const& distribution, std::vector<double> const& blockCosts,
+        int numProc )
+{
+    PLB_PRECONDITION( numProc >= 1 );
+    PLB_PRECONDITION( (plint)blockCosts.size() == distribution.getNumBlocks() );
+    LoadBalanceReport3D report;
+    report.processCosts.resize(numProc, 0.);
+    for (plint iBlock=0; iBlock<distribution.getNumBlocks(); ++iBlock) {
+        BlockParameters3D const& params = distribution.getBlockParameters(iBlock);
+        PLB_ASSERT( params.getProcId() < numProc );
+        report.processCosts[params.getProcId()] += blockCosts[iBlock];
+        report.totalCost += blockCosts[iBlock];
+    }
+    for (plint iOverlap=0; iOverlap<distribution.getNumNormalOverlaps(); ++iOverlap) {
+        Overlap3D const& overlap = distribution.getNormalOverlap(iOverlap);
+        if ( distribution.getBlockParameters(overlap.getOriginalId()).getProcId() !=
+             distribution.getBlockParameters(overlap.getOverlapId()).getProcId() )
+        {
+            report.numCommunicatedCells += overlap.getOriginalCoordinates().nCells();
+        }
+    }
+    report.maxCost = *std::max_element(report.processCosts.begin(), report.processCosts.end());
+    report.meanCost = report.totalCost / (double)numProc;
+    if (report.meanCost > 0.) {
+        report.imbalance = report.maxCost / report.meanCost;
+    }
+    return report;
+}
+
+MultiBlockDistribution3D createWeightedMultiBlockDistribution3D (
+        CellCostField3D const& costField,
+        plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        plint envelopeWidth, int numProc,
+        SpaceFillingCurve::CurveT curve,
+        LoadBalanceReport3D* report )
+{
+    PLB_PRECONDITION( numProc >= 1 );
+    plint nX = costField.getNx();
+    plint nY = costField.getNy();
+    plint nZ = costField.getNz();
+    numBlocksX = std::max((plint)1, std::min(numBlocksX, nX));
+    numBlocksY = std::max((plint)1, std::min(numBlocksY, nY));
+    numBlocksZ = std::max((plint)1, std::min(numBlocksZ, nZ));
+
+    plint numBits = 1;
+    while ( ((plint)1<<numBits) < std::max(numBlocksX, std::max(numBlocksY, numBlocksZ)) ) {
+        ++numBits;
+    }
+    PLB_ASSERT( 3*numBits <= (plint)(8*sizeof(pluint)) );
+
+    std::vector<CurveBlock> blocks;
+    plint numOmittedBlocks = 0;
+    for (plint iBlockX=0; iBlockX<numBlocksX; ++iBlockX) {
+        for (plint iBlockY=0; iBlockY<numBlocksY; ++iBlockY) {
+            for (plint iBlockZ=0; iBlockZ<numBlocksZ; ++iBlockZ) {
+                CurveBlock block;
+                block.bulk = Box3D (
+                        regularBlockBegin(nX, numBlocksX, iBlockX),
+                        regularBlockBegin(nX, numBlocksX, iBlockX+1)-1,
+                        regularBlockBegin(nY, numBlocksY, iBlockY),
+                        regularBlockBegin(nY, numBlocksY, iBlockY+1)-1,
+                        regularBlockBegin(nZ, numBlocksZ, iBlockZ),
+                        regularBlockBegin(nZ, numBlocksZ, iBlockZ+1)-1 );
+                block.cost = computeBoxCost(costField, block.bulk);
+                if (block.cost <= 0.) {
+                    ++numOmittedBlocks;
+                    continue;
+                }
+                if (curve == SpaceFillingCurve::hilbert) {
+                    block.curveIndex = hilbertIndex(iBlockX, iBlockY, iBlockZ, numBits);
+                }
+                else {
+                    block.curveIndex = mortonIndex(iBlockX, iBlockY, iBlockZ, numBits);
+                }
+                blocks.push_back(block);
+            }
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    std::vector<double> curveCosts(blocks.size());
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        curveCosts[iBlock] = blocks[iBlock].cost;
+    }
+    std::vector<plint> pieces;
+    cutCurve(curveCosts, numProc, pieces);
+    MultiBlockDistribution3D dataGeometry(nX, nY, nZ);
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        dataGeometry.addBlock(blocks[iBlock].bulk, envelopeWidth, pieces[iBlock]);
+    }
+
+    if (report) {
+        *report = predictLoadBalance3D(dataGeometry, costField, numProc);
+        report->numOmittedBlocks = numOmittedBlocks;
+    }
+    return dataGeometry;
+}
+
+MultiBlockDistribution3D createRebalancedMultiBlockDistribution3D (
+        MultiBlockDistribution3D const& distribution, std::vector<double> const& blockCosts,
+        int numProc, SpaceFillingCurve::CurveT curve,
+        LoadBalanceReport3D* report )
+{
+    PLB_PRECONDITION( numProc >= 1 );
+    PLB_PRECONDITION( (plint)blockCosts.size() == distribution.getNumBlocks() );
+    plint numBlocks = distribution.getNumBlocks();
+    Box3D const& boundingBox = distribution.getBoundingBox();
+
+    // The blocks are not necessarily on a regular grid. They are ordered by
+    //   the position of their center, on a grid of 2^numBits cells per axis.
+    //   Blocks in the same cell of this grid are ordered by their id.
+    static const plint numBits = 10;
+    static const plint gridSize = (plint)1 << numBits;
+    std::vector<std::pair<pluint,plint> > curveOrder(numBlocks);
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        Box3D const& bulk = distribution.getBlockParameters(iBlock).getBulk();
+        plint iX = (bulk.x0+bulk.x1+1-2*boundingBox.x0) * gridSize / (2*boundingBox.getNx());
+        plint iY = (bulk.y0+bulk.y1+1-2*boundingBox.y0) * gridSize / (2*boundingBox.getNy());
+        plint iZ = (bulk.z0+bulk.z1+1-2*boundingBox.z0) * gridSize / (2*boundingBox.getNz());
+        pluint curveIndex = curve == SpaceFillingCurve::hilbert ?
+                                hilbertIndex(iX, iY, iZ, numBits) :
+                                mortonIndex(iX, iY, iZ, numBits);
+        curveOrder[iBlock] = std::make_pair(curveIndex, iBlock);
+    }
+    std::sort(curveOrder.begin(), curveOrder.end());
+
+    std::vector<double> curveCosts(numBlocks);
+    for (plint iCurve=0; iCurve<numBlocks; ++iCurve) {
+        curveCosts[iCurve] = blockCosts[curveOrder[iCurve].second];
+    }
+    std::vector<plint> pieces;
+    cutCurve(curveCosts, numProc, pieces);
+    std::vector<plint> blockPieces(numBlocks);
+    for (plint iCurve=0; iCurve<numBlocks; ++iCurve) {
+        blockPieces[curveOrder[iCurve].second] = pieces[iCurve];
+    }
+
+    // The pieces are attributed to processes such as to move as little
+    //   work as possible: each piece preferably goes to the process which
+    //   already owns the largest part of its cost.
+    std::map<std::pair<plint,plint>, double> ownedCosts;
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        plint oldProcId = distribution.getBlockParameters(iBlock).getProcId();
+        if (oldProcId < numProc) {
+            ownedCosts[std::make_pair(blockPieces[iBlock], oldProcId)] += blockCosts[iBlock];
+        }
+    }
+    std::vector<PieceOwnership> ownerships;
+    std::map<std::pair<plint,plint>, double>::const_iterator it = ownedCosts.begin();
+    for (; it != ownedCosts.end(); ++it) {
+        PieceOwnership ownership;
+        ownership.piece = it->first.first;
+        ownership.procId = it->first.second;
+        ownership.cost = it->second;
+        ownerships.push_back(ownership);
+    }
+    std::sort(ownerships.begin(), ownerships.end());
+    std::vector<plint> pieceProcs(numProc, -1);
+    std::vector<bool> procIsTaken(numProc, false);
+    for (pluint iOwnership=0; iOwnership<ownerships.size(); ++iOwnership) {
+        PieceOwnership const& ownership = ownerships[iOwnership];
+        if (pieceProcs[ownership.piece]==-1 && !procIsTaken[ownership.procId]) {
+            pieceProcs[ownership.piece] = ownership.procId;
+            procIsTaken[ownership.procId] = true;
+        }
+    }
+    plint freeProcId = 0;
+    for (plint iPiece=0; iPiece<numProc; ++iPiece) {
+        if (pieceProcs[iPiece]==-1) {
+            while (procIsTaken[freeProcId]) {
+                ++freeProcId;
+            }
+            pieceProcs[iPiece] = freeProcId;
+            procIsTaken[freeProcId] = true;
+        }
+    }
+
+    // The blocks are kept in their original order, so that block ids remain valid.
+    MultiBlockDistribution3D dataGeometry(boundingBox);
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        BlockParameters3D const& params = distribution.getBlockParameters(iBlock);
+        dataGeometry.addBlock(params.getBulk(), params.getEnvelopeWidth(), pieceProcs[blockPieces[iBlock]]);
+    }
+
+    if (report) {
+        *report = predictLoadBalance3D(dataGeometry, blockCosts, numProc);
+    }
+    return dataGeometry;
+}
+
+MultiBlockDistribution3D createWeightedMultiBlockDistribution3D (
+        CellCostField3D const& costField, plint envelopeWidth,
+        int numProc, plint blocksPerProc,
+        SpaceFillingCurve::CurveT curve,
+        LoadBalanceReport3D* report )
+{
+    PLB_PRECONDITION( blocksPerProc >= 1 );
+    std::vector<int> repartition = algorithm::evenRepartition(numProc*blocksPerProc, 3);
+    return createWeightedMultiBlockDistribution3D (
+            costField, repartition[0], repartition[1], repartition[2],
+            envelopeWidth, numProc, curve, report );
+}
+
 }  // namespace plb
@@ -29,9 +29,16 @@
 #include "core/globalDefs.h"
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/multiBlockManagement3D.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <typeinfo>
 
 namespace plb {
 
+template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+template<typename T, template<typename U> class Descriptor> class MultiBlockLattice3D;
+
 /// A 3D field of scalar values used to indicate the type of the cells.
 /// Any positive value indicates an active (bulk, boundary) cell, 
 /// while zero indicates a non-active (no-dynamics) cell
@@ -80,6 +87,136 @@ MultiBlockDistribution3D createYSlicedMultiBlockDistribution3D (
 MultiBlockDistribution3D createZSlicedMultiBlockDistribution3D (
         CellTypeField3D const& cellTypeField, plint envelopeWidth=1);
 
+/// A 3D field of scalar values used to indicate the computational cost of
+/// the cells, in arbitrary units (for example 1 for a bulk BGK cell). Cells
+/// with a zero cost are considered non-active.
+typedef ScalarField3D<double> CellCostField3D;
+
+/// Computational cost of each type of dynamics, used to build a CellCostField3D.
+/** The dynamics are identified by their dynamic type: a boundary condition
+ *  which wraps a BGK dynamics is distinct from the BGK dynamics.
+ */
+class DynamicsCostTable {
+public:
+    /// Unless specified otherwise, NoDynamics cells have cost 0, and all other cells the defaultCost.
+    DynamicsCostTable(double defaultCost_=1.);
+    /// Assign a cost to all cells with the dynamics type of the argument.
+    template<class DynamicsT>
+    void setCost(DynamicsT const& dynamics, double cost) {
+        costs[typeid(dynamics).name()] = cost;
+    }
+    /// Tells whether a cost was assigned to the dynamics type of the argument.
+    template<class DynamicsT>
+    bool hasCost(DynamicsT const& dynamics) const {
+        return costs.find(typeid(dynamics).name()) != costs.end();
+    }
+    /// Cost of a cell, given its dynamics; the default cost if none was assigned.
+    template<class DynamicsT>
+    double getCost(DynamicsT const& dynamics) const {
+        std::map<std::string,double>::const_iterator it = costs.find(typeid(dynamics).name());
+        if (it == costs.end()) {
+            return defaultCost;
+        }
+        return it->second;
+    }
+    void setDefaultCost(double defaultCost_) { defaultCost = defaultCost_; }
+    double getDefaultCost() const { return defaultCost; }
+private:
+    double defaultCost;
+    std::map<std::string,double> costs;
+};
+
+/// Compute the cost of the cells of a lattice, according to their dynamics.
+template<typename T, template<typename U> class Descriptor>
+void computeCellCostField3D (
+        BlockLattice3D<T,Descriptor> const& lattice, DynamicsCostTable const& costTable,
+        CellCostField3D& costField );
+
+/// Compute the cost of the cells of a multi-block lattice, according to their dynamics.
+/** The cost field must have the size of the bounding box of the lattice.
+ *  In parallel, the costs of all cells are available on all processes after
+ *  the call.
+ */
+template<typename T, template<typename U> class Descriptor>
+void computeCellCostField3D (
+        MultiBlockLattice3D<T,Descriptor> const& lattice, DynamicsCostTable const& costTable,
+        CellCostField3D& costField );
+
+/// Add an extra cost to the cells of a domain, for example the cost of a data processor.
+void addCellCost(CellCostField3D& costField, Box3D domain, double cost);
+
+/// Space-filling curves by which blocks are ordered before being attributed to processes.
+namespace SpaceFillingCurve {
+    enum CurveT {morton, hilbert};
+}
+
+/// Predicted distribution of the computational load of a multi-block over the processes.
+struct LoadBalanceReport3D {
+    LoadBalanceReport3D();
+    /// Sum of the cost of the cells of all blocks attributed to each process.
+    std::vector<double> processCosts;
+    double totalCost, maxCost, meanCost;
+    /// Ratio between the largest and the average process cost; 1 is a perfect balance.
+    double imbalance;
+    /// Number of envelope cells which are filled with data from another process.
+    plint numCommunicatedCells;
+    /// Number of blocks which were omitted, because all their cells are non-active.
+    plint numOmittedBlocks;
+};
+
+/// Predict the load balance of a data distribution, given the cost of each cell.
+LoadBalanceReport3D predictLoadBalance3D (
+        MultiBlockDistribution3D const& distribution, CellCostField3D const& costField,
+        int numProc = global::mpi().getSize() );
+
+/// Predict the load balance of a data distribution, given the cost of each block.
+LoadBalanceReport3D predictLoadBalance3D (
+        MultiBlockDistribution3D const& distribution, std::vector<double> const& blockCosts,
+        int numProc = global::mpi().getSize() );
+
+/// Create a data distribution which balances the cost of the cells between processes.
+/** The domain (as defined by costField) is cut into a regular grid of
+ *  numBlocksX*numBlocksY*numBlocksZ blocks. Blocks which contain only
+ *  non-active cells are omitted. The remaining blocks are ordered along a
+ *  space-filling curve, and the curve is cut into numProc contiguous
+ *  pieces of approximately equal cost, one per process. Because neighboring
+ *  blocks on the curve are neighbors in space, the blocks of a process form
+ *  a compact region, which limits the amount of communication.
+ *
+ *  The balance improves with the number of blocks per process, at the price
+ *  of more envelope cells. If report is non-null, it receives the predicted
+ *  load balance of the new distribution.
+ */
+MultiBlockDistribution3D createWeightedMultiBlockDistribution3D (
+        CellCostField3D const& costField,
+        plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        plint envelopeWidth, int numProc,
+        SpaceFillingCurve::CurveT curve = SpaceFillingCurve::hilbert,
+        LoadBalanceReport3D* report = 0 );
+
+/// Create a weighted data distribution with approximately blocksPerProc blocks per process.
+MultiBlockDistribution3D createWeightedMultiBlockDistribution3D (
+        CellCostField3D const& costField, plint envelopeWidth=1,
+        int numProc = global::mpi().getSize(), plint blocksPerProc=8,
+        SpaceFillingCurve::CurveT curve = SpaceFillingCurve::hilbert,
+        LoadBalanceReport3D* report = 0 );
+
+/// Attribute the blocks of an existing data distribution anew to the processes, given the cost of each block.
+/** The blocks are the same as in the original distribution, with the same
+ *  ids, but their processes change. They are ordered along a space-filling
+ *  curve through their centers, and the curve is cut into numProc pieces of
+ *  approximately equal cost. Each piece is attributed preferably to the
+ *  process which already owns the largest part of its cost, such as to
+ *  limit the number of blocks to be moved. The costs are typically measured
+ *  (see MultiBlock3D::getBlockTimes()), and are used for the report.
+ *  \sa MultiBlockLattice3D::rebalance()
+ */
+MultiBlockDistribution3D createRebalancedMultiBlockDistribution3D (
+        MultiBlockDistribution3D const& distribution, std::vector<double> const& blockCosts,
+        int numProc = global::mpi().getSize(),
+        SpaceFillingCurve::CurveT curve = SpaceFillingCurve::hilbert,
+        LoadBalanceReport3D* report = 0 );
+
 }  // namespace plb
 
 
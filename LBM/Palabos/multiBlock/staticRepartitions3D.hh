@@ -0,0 +1,107 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Utilities for 3D multi data distributions -- generic implementation.
+ */
+
+#ifndef STATIC_REPARTITIONS_3D_HH
+#define STATIC_REPARTITIONS_3D_HH
+
+#include "multiBlock/staticRepartitions3D.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include "core/dynamics.h"
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+void computeCellCostField3D (
+        BlockLattice3D<T,Descriptor> const& lattice, DynamicsCostTable const& costTable,
+        CellCostField3D& costField )
+{
+    PLB_PRECONDITION( costField.getNx()==lattice.getNx() &&
+                      costField.getNy()==lattice.getNy() &&
+                      costField.getNz()==lattice.getNz() );
+    for (plint iX=0; iX<lattice.getNx(); ++iX) {
+        for (plint iY=0; iY<lattice.getNy(); ++iY) {
+            for (plint iZ=0; iZ<lattice.getNz(); ++iZ) {
+                Dynamics<T,Descriptor> const& dynamics = lattice.get(iX,iY,iZ).getDynamics();
+                if (!costTable.hasCost(dynamics) &&
+                    typeid(dynamics)==typeid(NoDynamics<T,Descriptor>))
+                {
+                    costField.get(iX,iY,iZ) = 0.;
+                }
+                else {
+                    costField.get(iX,iY,iZ) = costTable.getCost(dynamics);
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void computeCellCostField3D (
+        MultiBlockLattice3D<T,Descriptor> const& lattice, DynamicsCostTable const& costTable,
+        CellCostField3D& costField )
+{
+    PLB_PRECONDITION( costField.getNx()==lattice.getNx() &&
+                      costField.getNy()==lattice.getNy() &&
+                      costField.getNz()==lattice.getNz() );
+    // Every cell is located in the bulk of at most one block. The costs
+    //   are written by the process which owns the block, and summed over
+    //   all processes.
+    costField.reset();
+    std::vector<plint> const& relevantBlocks = lattice.getRelevantBlocks();
+    for (pluint rBlock=0; rBlock<relevantBlocks.size(); ++rBlock) {
+        plint iBlock = relevantBlocks[rBlock];
+        BlockParameters3D const& params =
+            lattice.getMultiBlockManagement().getMultiBlockDistribution().getBlockParameters(iBlock);
+        BlockLattice3D<T,Descriptor> const& block = *lattice.getBlockLattices()[iBlock];
+        CellCostField3D blockCosts(block.getNx(), block.getNy(), block.getNz());
+        computeCellCostField3D(block, costTable, blockCosts);
+        Box3D bulk = params.getBulk();
+        for (plint iX=bulk.x0; iX<=bulk.x1; ++iX) {
+            for (plint iY=bulk.y0; iY<=bulk.y1; ++iY) {
+                for (plint iZ=bulk.z0; iZ<=bulk.z1; ++iZ) {
+                    costField.get(iX,iY,iZ) = blockCosts.get( params.toLocalX(iX),
+                                                              params.toLocalY(iY),
+                                                              params.toLocalZ(iZ) );
+                }
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    plint numCells = (plint)costField.getSize();
+    std::vector<double> localCosts(numCells), globalCosts(numCells);
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        localCosts[iCell] = costField[iCell];
+    }
+    global::mpi().reduceVect(localCosts, globalCosts, MPI_SUM);
+    global::mpi().bCast(&globalCosts[0], numCells);
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        costField[iCell] = globalCosts[iCell];
+    }
+#endif
+}
+
+}  // namespace plb
+
+#endif  // STATIC_REPARTITIONS_3D_HH
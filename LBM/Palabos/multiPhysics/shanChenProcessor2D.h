@@ -33,6 +33,10 @@
 namespace plb {
 
 /// Shan-Chen coupling for multi-component flow with or without external force
+/** The moments of all species are computed in a single sweep, and the
+ *  interaction term is evaluated for all species at once, on a local
+ *  copy of the densities in which the species index runs fastest.
+ */
 template<typename T, template<typename U> class Descriptor>
 class ShanChenMultiComponentProcessor2D : public LatticeBoxProcessingFunctional2D<T,Descriptor> {
 public:
@@ -29,6 +29,8 @@
 #include "core/util.h"
 #include "finiteDifference/finiteDifference2D.h"
 #include "latticeBoltzmann/momentTemplates.h"
+#include <algorithm>
+#include <vector>
 
 namespace plb {
 
@@ -83,21 +85,33 @@ void ShanChenMultiComponentProcessor2D<T,Descriptor>::process (
         densityOffset  = D::ExternalField::densityBeginsAt,
         momentumOffset = D::ExternalField::momentumBeginsAt,
     };
-    
-    // Compute per-lattice density  and momentum on every site and on each
-    //   lattice, and store result in external scalars;  envelope cells are included,
-    //   because they are needed to compute the interaction potential in the following.
+
+    plint nx = domain.getNx() + 2;  // Include a one-cell boundary
+    plint ny = domain.getNy() + 2;  // Include a one-cell boundary
+    plint offsetX = domain.x0-1;
+    plint offsetY = domain.y0-1;
+    // Densities of all species, with the species index running fastest, so that
+    //   the interaction stencil reads the values of all species at a given
+    //   neighbor from a single, contiguous location.
+    std::vector<T> rhoField(nx*ny*numSpecies);
+
+    // Compute per-lattice density and momentum on every site and on each
+    //   lattice in a single sweep, and store result in external scalars, and
+    //   the density in rhoField. Envelope cells are included, because they are
+    //   needed to compute the interaction potential in the following.
     //   Note that the per-lattice value of the momentum is stored temporarily only, as
     //   it is corrected later on, based on the common fluid velocity.
-    for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
-        for (plint iX=domain.x0-1; iX<=domain.x1+1; ++iX) {
-            for (plint iY=domain.y0-1; iY<=domain.y1+1; ++iY) {
+    for (plint iX=domain.x0-1; iX<=domain.x1+1; ++iX) {
+        for (plint iY=domain.y0-1; iY<=domain.y1+1; ++iY) {
+            T* rho = &rhoField[ ((iX-offsetX)*ny+iY-offsetY)*numSpecies ];
+            for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
                 // Get "intelligent" value of density through cell object, to account
                 //   for the fact that the density value can be user-defined, for example
                 //   on boundaries.
                 Cell<T,Descriptor>& cell = lattices[iSpecies]->get(iX,iY);
+                rho[iSpecies] = cell.computeDensity();
                 // And store the result into the corresponding external scalar.
-                *cell.getExternal(densityOffset) = cell.computeDensity();
+                *cell.getExternal(densityOffset) = rho[iSpecies];
                 // Compute momentum through direct access to particle populations, and store
                 //   result in corresponding external scalars. Note that Cell::computeVelocity
                 //   cannot be used, because it returns the velocity of the external scalars,
@@ -114,19 +128,22 @@ void ShanChenMultiComponentProcessor2D<T,Descriptor>::process (
     // Temporary the relaxation parameters omega at a place where they are less
     //   verbous to access.
     std::vector<T> omega(numSpecies);
+    // Term \sum_i ( t_i rho(x+c_i,t) c_i ) for each species, with the species
+    //   index running fastest.
+    std::vector<T> rhoContribution(D::d*numSpecies);
 
     // Compute the interaction force between the species, and store it by
     //   means of a velocity correction in the external velocity field.
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            T const* rho = &rhoField[ ((iX-offsetX)*ny+iY-offsetY)*numSpecies ];
             // Computation of the common density over all populations, weighted by
             //   the relaxation parameters omega.
             T weightedDensity = T();
             for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
-                Cell<T,Descriptor> const& cell = lattices[iSpecies]->get(iX,iY);
                 // Take this opportunity to store relaxation parameters in vector omega.
-                omega[iSpecies] = cell.getDynamics().getOmega();
-                weightedDensity += omega[iSpecies] * (*cell.getExternal(densityOffset));
+                omega[iSpecies] = lattices[iSpecies]->get(iX,iY).getDynamics().getOmega();
+                weightedDensity += omega[iSpecies] * rho[iSpecies];
             }
             // Computation of the common velocity, shared among all populations.
             Array<T,Descriptor<T>::d> uTot;
@@ -139,21 +156,17 @@ void ShanChenMultiComponentProcessor2D<T,Descriptor>::process (
                 uTot[iD] /= weightedDensity;
             }
 
-            // Computation of the interaction potential.
-            // 1. Allocate memory and initialize to zero.
-            std::vector<Array<T,D::d> > rhoContribution(numSpecies);
-            for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
-                rhoContribution[iSpecies].resetToZero();
-            }
-            // 2. Compute the term \sum_i ( t_i rho(x+c_i,t) c_i )
+            // Computation of the interaction potential, for all species at once.
+            std::fill(rhoContribution.begin(), rhoContribution.end(), T());
             for (plint iPop = 0; iPop < D::q; ++iPop) {
                 plint nextX = iX + D::c[iPop][0];
                 plint nextY = iY + D::c[iPop][1];
-                for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
-                    Cell<T,Descriptor> const& cell = lattices[iSpecies]->get(nextX,nextY);
-                    T rho = *cell.getExternal(densityOffset);
-                    for (int iD = 0; iD < D::d; ++iD) {
-                        rhoContribution[iSpecies][iD] += D::t[iPop] * rho * D::c[iPop][iD];
+                T const* nextRho = &rhoField[ ((nextX-offsetX)*ny+nextY-offsetY)*numSpecies ];
+                for (int iD = 0; iD < D::d; ++iD) {
+                    T weight = D::t[iPop] * D::c[iPop][iD];
+                    T* contribution = &rhoContribution[iD*numSpecies];
+                    for (plint iSpecies=0; iSpecies<numSpecies; ++iSpecies) {
+                        contribution[iSpecies] += weight * nextRho[iSpecies];
                     }
                 }
             }
@@ -172,12 +185,12 @@ void ShanChenMultiComponentProcessor2D<T,Descriptor>::process (
                     // Then, add a contribution from the potential of all other species.
                     for (plint iPartnerSpecies=0; iPartnerSpecies<numSpecies; ++iPartnerSpecies) {
                         if (iPartnerSpecies != iSpecies) {
-                            forceContribution -= G * rhoContribution[iPartnerSpecies][iD];
+                            forceContribution -= G * rhoContribution[iD*numSpecies+iPartnerSpecies];
                         }
                     }
                     momentum[iD] += (T)1/omega[iSpecies]*forceContribution;
                     // Multiply by rho to covnert from velocity to momentum.
-                    momentum[iD] *= *cell.getExternal(densityOffset);
+                    momentum[iD] *= rho[iSpecies];
                 }
             }
         }
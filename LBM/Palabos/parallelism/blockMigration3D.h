@@ -0,0 +1,142 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Migration of the components of a multi-block lattice between processes -- header file.
+ */
+#ifndef BLOCK_MIGRATION_3D_H
+#define BLOCK_MIGRATION_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+
+/// A buffer of bytes, into which the content of a block is packed to be sent to another process.
+class MigrationBuffer {
+public:
+    MigrationBuffer() : readPos(0) { }
+    template<typename U>
+    void pack(U const& value) {
+        pack(&value, 1);
+    }
+    template<typename U>
+    void pack(U const* values, pluint numValues) {
+        char const* bytes = reinterpret_cast<char const*>(values);
+        data.insert(data.end(), bytes, bytes+numValues*sizeof(U));
+    }
+    void pack(std::string const& word) {
+        pack((plint)word.size());
+        pack(word.c_str(), word.size());
+    }
+    template<typename U>
+    void unpack(U& value) {
+        unpack(&value, 1);
+    }
+    template<typename U>
+    void unpack(U* values, pluint numValues) {
+        PLB_PRECONDITION( readPos+numValues*sizeof(U) <= data.size() );
+        if (numValues>0) {
+            std::memcpy(values, &data[readPos], numValues*sizeof(U));
+        }
+        readPos += numValues*sizeof(U);
+    }
+    void unpack(std::string& word) {
+        plint size;
+        unpack(size);
+        std::vector<char> characters(size+1, '\0');
+        unpack(&characters[0], size);
+        word = std::string(&characters[0], size);
+    }
+    std::vector<char>& getData() { return data; }
+    std::vector<char> const& getData() const { return data; }
+private:
+    std::vector<char> data;
+    pluint readPos;
+};
+
+/// Pack the full content of a block lattice, so that it can be re-created on another process.
+/** This includes the populations and external fields of all cells, the
+ *  dynamics of the cells with their state (see Dynamics::serialize()), the
+ *  statistics status of the cells, the memory layout, the streaming scheme
+ *  and the time counter. The data processors and statistics are not
+ *  packed.
+ *  \return false if the type of one of the dynamics has no registered
+ *          prototype (see DynamicsPrototypes), in which case the content of
+ *          the buffer is meaningless.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool packBlockLattice3D(BlockLattice3D<T,Descriptor> const& lattice, MigrationBuffer& buffer);
+
+/// Create a block lattice from the content of a buffer filled by packBlockLattice3D().
+template<typename T, template<typename U> class Descriptor>
+BlockLattice3D<T,Descriptor>* unpackBlockLattice3D(MigrationBuffer& buffer);
+
+/// Number of blocks, cells and bytes moved by the local process in a migration.
+struct BlockMigrationStatistics3D {
+    BlockMigrationStatistics3D()
+        : numSentBlocks(0), numSentCells(0), numSentBytes(0)
+    { }
+    plint numSentBlocks, numSentCells, numSentBytes;
+};
+
+/// Outcome of a dynamic load rebalancing of a multi-block lattice (see MultiBlockLattice3D::rebalance()).
+struct RebalanceReport3D {
+    RebalanceReport3D()
+        : executed(false), measuredImbalance(1.), predictedImbalance(1.),
+          numMigratedBlocks(0), numMigratedCells(0), numMigratedBytes(0),
+          migrationTime(0.)
+    { }
+    /// Tells whether the blocks have been redistributed.
+    bool executed;
+    /// Ratio between the largest and the average measured process time, before the rebalancing.
+    double measuredImbalance;
+    /// The same ratio, predicted for the new distribution from the measured block times.
+    double predictedImbalance;
+    /// Total number of blocks, cells and bytes moved between processes.
+    plint numMigratedBlocks, numMigratedCells, numMigratedBytes;
+    /// Wall-clock time of the migration, in seconds, on the slowest process.
+    double migrationTime;
+};
+
+/// Move the components of a multi-block lattice to the processes to which they are newly attributed.
+/** The components are indexed by block id, and are non-null on the
+ *  processes which own them according to oldProcIds. After the call, the
+ *  components which have moved are deleted on their former process, and
+ *  re-created on their new one (see packBlockLattice3D()). All processes
+ *  must call this function collectively.
+ *
+ *  Nothing is moved if a dynamics cannot be re-created on any of the
+ *  processes, in which case the function returns false on all processes.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool migrateBlockLattices3D (
+        std::vector<BlockLattice3D<T,Descriptor>*>& lattices,
+        std::vector<plint> const& oldProcIds, std::vector<plint> const& newProcIds,
+        BlockMigrationStatistics3D& statistics );
+
+}  // namespace plb
+
+#endif  // BLOCK_MIGRATION_3D_H
@@ -0,0 +1,288 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Migration of the components of a multi-block lattice between processes -- generic implementation.
+ */
+#ifndef BLOCK_MIGRATION_3D_HH
+#define BLOCK_MIGRATION_3D_HH
+
+#include "parallelism/blockMigration3D.h"
+#include "parallelism/mpiManager.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "core/dynamics.h"
+#include "core/dynamicsPrototypes.h"
+#include <map>
+
+namespace plb {
+
+/** The dynamics objects of the lattice are numbered, the background
+ *  dynamics being number 0. Each of them is packed once, by its type chain
+ *  and its state, and each cell refers to its dynamics by number.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool packBlockLattice3D(BlockLattice3D<T,Descriptor> const& lattice, MigrationBuffer& buffer)
+{
+    plint nx = lattice.getNx();
+    plint ny = lattice.getNy();
+    plint nz = lattice.getNz();
+    plint numCells = nx*ny*nz;
+    buffer.pack(nx);
+    buffer.pack(ny);
+    buffer.pack(nz);
+    Dot3D location = lattice.getLocation();
+    buffer.pack(location.x);
+    buffer.pack(location.y);
+    buffer.pack(location.z);
+    buffer.pack((int)lattice.getPopulationLayout());
+    buffer.pack((int)lattice.getStreamingScheme());
+    buffer.pack((plint)lattice.getTimeCounter().getTime());
+
+    typedef std::map<Dynamics<T,Descriptor> const*, int> DynamicsIds;
+    DynamicsIds dynamicsIds;
+    std::vector<Dynamics<T,Descriptor> const*> dynamicsList;
+    dynamicsIds[&lattice.getBackgroundDynamics()] = 0;
+    dynamicsList.push_back(&lattice.getBackgroundDynamics());
+    std::vector<int> cellDynamics(numCells);
+    std::vector<char> cellStatistics(numCells);
+    plint iCell = 0;
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                Cell<T,Descriptor> const& cell = lattice.get(iX,iY,iZ);
+                Dynamics<T,Descriptor> const* dynamics = &cell.getDynamics();
+                typename DynamicsIds::const_iterator it = dynamicsIds.find(dynamics);
+                if (it == dynamicsIds.end()) {
+                    it = dynamicsIds.insert(std::make_pair(dynamics, (int)dynamicsList.size())).first;
+                    dynamicsList.push_back(dynamics);
+                }
+                cellDynamics[iCell] = it->second;
+                cellStatistics[iCell] = cell.takesStatistics() ? 1 : 0;
+                ++iCell;
+            }
+        }
+    }
+
+    bool allKnown = true;
+    buffer.pack((plint)dynamicsList.size());
+    for (pluint iDynamics=0; iDynamics<dynamicsList.size(); ++iDynamics) {
+        std::vector<std::string> chain;
+        DynamicsPrototypes<T,Descriptor>::getTypeChain(*dynamicsList[iDynamics], chain);
+        allKnown = allKnown && dynamicsPrototypes<T,Descriptor>().isKnown(chain);
+        buffer.pack((plint)chain.size());
+        for (pluint iType=0; iType<chain.size(); ++iType) {
+            buffer.pack(chain[iType]);
+        }
+        buffer.pack((char)(lattice.getDynamicsRegistry().isShared(dynamicsList[iDynamics]) ? 1 : 0));
+        std::vector<T> state;
+        dynamicsList[iDynamics]->serialize(state);
+        buffer.pack((plint)state.size());
+        if (!state.empty()) {
+            buffer.pack(&state[0], state.size());
+        }
+    }
+    buffer.pack(&cellDynamics[0], numCells);
+    buffer.pack(&cellStatistics[0], numCells);
+
+    plint sizeOfCell = lattice.getDataTransfer().sizeOfCell();
+    std::vector<T> cellData(numCells*sizeOfCell);
+    lattice.getDataTransfer().send(lattice.getBoundingBox(), &cellData[0]);
+    buffer.pack(&cellData[0], cellData.size());
+    return allKnown;
+}
+
+/** The lattice is re-created in the arrayOfStructures layout, and converted
+ *  to its original layout once its cells are complete.
+ */
+template<typename T, template<typename U> class Descriptor>
+BlockLattice3D<T,Descriptor>* unpackBlockLattice3D(MigrationBuffer& buffer)
+{
+    plint nx, ny, nz;
+    buffer.unpack(nx);
+    buffer.unpack(ny);
+    buffer.unpack(nz);
+    plint numCells = nx*ny*nz;
+    Dot3D location;
+    buffer.unpack(location.x);
+    buffer.unpack(location.y);
+    buffer.unpack(location.z);
+    int layout, scheme;
+    buffer.unpack(layout);
+    buffer.unpack(scheme);
+    plint time;
+    buffer.unpack(time);
+
+    plint numDynamics;
+    buffer.unpack(numDynamics);
+    std::vector<Dynamics<T,Descriptor>*> dynamicsList(numDynamics);
+    std::vector<bool> isShared(numDynamics);
+    for (plint iDynamics=0; iDynamics<numDynamics; ++iDynamics) {
+        plint chainLength;
+        buffer.unpack(chainLength);
+        std::vector<std::string> chain(chainLength);
+        for (plint iType=0; iType<chainLength; ++iType) {
+            buffer.unpack(chain[iType]);
+        }
+        char shared;
+        buffer.unpack(shared);
+        isShared[iDynamics] = shared != 0;
+        plint stateSize;
+        buffer.unpack(stateSize);
+        std::vector<T> state(stateSize);
+        if (stateSize>0) {
+            buffer.unpack(&state[0], stateSize);
+        }
+        dynamicsList[iDynamics] = dynamicsPrototypes<T,Descriptor>().create(chain);
+        PLB_ASSERT( dynamicsList[iDynamics] );
+        pluint pos = 0;
+        dynamicsList[iDynamics]->unserialize(state, pos);
+    }
+    std::vector<int> cellDynamics(numCells);
+    std::vector<char> cellStatistics(numCells);
+    buffer.unpack(&cellDynamics[0], numCells);
+    buffer.unpack(&cellStatistics[0], numCells);
+
+    BlockLattice3D<T,Descriptor>* lattice = new BlockLattice3D<T,Descriptor>(nx, ny, nz, dynamicsList[0]);
+    lattice->setLocation(location);
+    lattice->getTimeCounter().resetTime(time);
+    for (plint iDynamics=1; iDynamics<numDynamics; ++iDynamics) {
+        if (isShared[iDynamics]) {
+            dynamicsList[iDynamics] = lattice->shareDynamics(dynamicsList[iDynamics]);
+        }
+    }
+    // A dynamics which is not shared, but which was nevertheless referred to
+    //   by several cells, is cloned for all cells but the first one.
+    std::vector<bool> isAttributed(numDynamics, false);
+    plint iCell = 0;
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                int iDynamics = cellDynamics[iCell];
+                PLB_ASSERT( iDynamics>=0 && iDynamics<numDynamics );
+                if (iDynamics>0) {
+                    if (isShared[iDynamics] || !isAttributed[iDynamics]) {
+                        lattice->attributeDynamics(iX,iY,iZ, dynamicsList[iDynamics]);
+                        isAttributed[iDynamics] = true;
+                    }
+                    else {
+                        lattice->attributeDynamics(iX,iY,iZ, dynamicsList[iDynamics]->clone());
+                    }
+                }
+                if (!cellStatistics[iCell]) {
+                    lattice->get(iX,iY,iZ).specifyStatisticsStatus(false);
+                }
+                ++iCell;
+            }
+        }
+    }
+
+    plint sizeOfCell = lattice->getDataTransfer().sizeOfCell();
+    std::vector<T> cellData(numCells*sizeOfCell);
+    buffer.unpack(&cellData[0], cellData.size());
+    lattice->getDataTransfer().receive(lattice->getBoundingBox(), &cellData[0]);
+    lattice->setPopulationLayout((PopulationLayout::LayoutT)layout);
+    lattice->setStreamingScheme((StreamingScheme::SchemeT)scheme);
+    return lattice;
+}
+
+/** The outgoing blocks are packed first. Their size and content are then
+ *  sent with non-blocking messages, while the incoming blocks are received
+ *  in the order of their ids. As messages between two processes with the
+ *  same tag are received in the order in which they were sent, no further
+ *  identification of the blocks is needed.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool migrateBlockLattices3D (
+        std::vector<BlockLattice3D<T,Descriptor>*>& lattices,
+        std::vector<plint> const& oldProcIds, std::vector<plint> const& newProcIds,
+        BlockMigrationStatistics3D& statistics )
+{
+    PLB_PRECONDITION( lattices.size()==oldProcIds.size() && lattices.size()==newProcIds.size() );
+    statistics = BlockMigrationStatistics3D();
+    plint rank = global::mpi().getRank();
+    plint numBlocks = (plint)lattices.size();
+
+    std::vector<plint> outgoingBlocks;
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        if (oldProcIds[iBlock]==rank && newProcIds[iBlock]!=rank) {
+            outgoingBlocks.push_back(iBlock);
+        }
+    }
+    std::vector<MigrationBuffer> outgoingBuffers(outgoingBlocks.size());
+    int numUnknown = 0;
+    for (pluint iOut=0; iOut<outgoingBlocks.size(); ++iOut) {
+        BlockLattice3D<T,Descriptor> const& lattice = *lattices[outgoingBlocks[iOut]];
+        if (!packBlockLattice3D(lattice, outgoingBuffers[iOut])) {
+            ++numUnknown;
+        }
+        statistics.numSentCells += lattice.getNx()*lattice.getNy()*lattice.getNz();
+        statistics.numSentBytes += (plint)outgoingBuffers[iOut].getData().size();
+    }
+    statistics.numSentBlocks = (plint)outgoingBlocks.size();
+
+#ifdef PLB_MPI_PARALLEL
+    std::vector<int> localUnknown(1, numUnknown), globalUnknown(1);
+    global::mpi().allReduceVect(localUnknown, globalUnknown, MPI_SUM);
+    numUnknown = globalUnknown[0];
+#endif
+    if (numUnknown>0) {
+        statistics = BlockMigrationStatistics3D();
+        return false;
+    }
+
+#ifdef PLB_MPI_PARALLEL
+    static const int sizeTag = 0;
+    static const int dataTag = 1;
+    std::vector<int> sizes(outgoingBlocks.size());
+    std::vector<MPI_Request> requests(2*outgoingBlocks.size());
+    for (pluint iOut=0; iOut<outgoingBlocks.size(); ++iOut) {
+        std::vector<char>& data = outgoingBuffers[iOut].getData();
+        int dest = (int)newProcIds[outgoingBlocks[iOut]];
+        sizes[iOut] = (int)data.size();
+        global::mpi().iSend(&sizes[iOut], 1, dest, &requests[2*iOut], sizeTag);
+        global::mpi().iSend(&data[0], sizes[iOut], dest, &requests[2*iOut+1], dataTag);
+    }
+    for (plint iBlock=0; iBlock<numBlocks; ++iBlock) {
+        if (newProcIds[iBlock]==rank && oldProcIds[iBlock]!=rank) {
+            int source = (int)oldProcIds[iBlock];
+            int size;
+            global::mpi().receive(&size, 1, source, sizeTag);
+            MigrationBuffer buffer;
+            buffer.getData().resize(size);
+            global::mpi().receive(&buffer.getData()[0], size, source, dataTag);
+            lattices[iBlock] = unpackBlockLattice3D<T,Descriptor>(buffer);
+        }
+    }
+    if (!requests.empty()) {
+        std::vector<MPI_Status> statuses(requests.size());
+        global::mpi().waitAll((int)requests.size(), &requests[0], &statuses[0]);
+    }
+#endif
+
+    for (pluint iOut=0; iOut<outgoingBlocks.size(); ++iOut) {
+        delete lattices[outgoingBlocks[iOut]];
+        lattices[outgoingBlocks[iOut]] = 0;
+    }
+    return true;
+}
+
+}  // namespace plb
+
+#endif  // BLOCK_MIGRATION_3D_HH
@@ -37,10 +37,41 @@ struct CommunicationInfo3D {
     plint toBlockId;
     plint toProcessId;
     Box3D toDomain;
+    /// For a transfer of streamed data only: domain, in the local
+    ///   coordinates of the receiving block, from which the data was streamed.
+    Box3D streamSource;
 };
 
 typedef std::vector<CommunicationInfo3D> CommunicationPackage3D;
 
+/// Communication which returns the data streamed into the overlap of info
+///   to the block which owns these cells.
+/** \param toBulk Bulk of the block info.toBlockId, in its local coordinates.
+ *                The data streamed from this domain is returned.
+ */
+inline CommunicationInfo3D reverseForStreamedData(CommunicationInfo3D const& info, Box3D const& toBulk)
+{
+    CommunicationInfo3D reverse;
+    reverse.fromBlockId   = info.toBlockId;
+    reverse.fromProcessId = info.toProcessId;
+    reverse.fromDomain    = info.toDomain;
+    reverse.toBlockId     = info.fromBlockId;
+    reverse.toProcessId   = info.fromProcessId;
+    reverse.toDomain      = info.fromDomain;
+    reverse.streamSource  = toBulk.shift( info.fromDomain.x0-info.toDomain.x0,
+                                          info.fromDomain.y0-info.toDomain.y0,
+                                          info.fromDomain.z0-info.toDomain.z0 );
+    return reverse;
+}
+
+/// Domain from which the data of a transfer of streamed data was streamed,
+///   in the local coordinates of the sending block.
+inline Box3D streamSourceOfSender(CommunicationInfo3D const& info) {
+    return info.streamSource.shift( info.fromDomain.x0-info.toDomain.x0,
+                                    info.fromDomain.y0-info.toDomain.y0,
+                                    info.fromDomain.z0-info.toDomain.z0 );
+}
+
 }  // namespace plb
 
 #endif  // COMMUNICATION_PACKAGE_3D_H
@@ -23,9 +23,11 @@
  * Groups all the include files for 3D parallelism.
  */
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "parallelism/parallelDynamics.h"
 #include "parallelism/parallelBlockCommunicator3D.h"
 #include "parallelism/parallelMultiBlockLattice3D.h"
 #include "parallelism/parallelMultiDataField3D.h"
 #include "parallelism/parallelStatistics.h"
 #include "parallelism/sendRecvPool.h"
+#include "parallelism/blockMigration3D.h"
@@ -27,3 +27,4 @@
 #include "parallelism/parallelMultiDataField3D.hh"
 #include "parallelism/parallelStatistics.hh"
 #include "parallelism/sendRecvPool.hh"
+#include "parallelism/blockMigration3D.hh"
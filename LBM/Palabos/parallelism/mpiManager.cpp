@@ -45,7 +45,17 @@ void MpiManager::init(int *argc, char ***argv, bool verbous) {
     if (verbous) {
         std::cerr << "Constructing an MPI thread" << std::endl;
     }
+#ifdef PLB_SMP_PARALLEL
+    // Hybrid mode: MPI is only called by the main thread, outside of the
+    //   regions in which blocks are executed concurrently.
+    int threadSupport;
+    int ok1 = MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &threadSupport);
+    if (threadSupport < MPI_THREAD_FUNNELED) {
+        std::cerr << "Warning: the MPI library does not support multi-threaded processes" << std::endl;
+    }
+#else
     int ok1 = MPI_Init(argc, argv);
+#endif
     int ok2 = MPI_Comm_rank(MPI_COMM_WORLD,&taskId);
     int ok3 = MPI_Comm_size(MPI_COMM_WORLD,&numTasks);
     ok = (ok1==0 && ok2==0 && ok3==0);
@@ -143,6 +153,78 @@ void MpiManager::iSend<double>
     }
 }
 
+template <>
+void MpiManager::sendInit<char>
+    (char *buf, int count, int dest, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Send_init(static_cast<void*>(buf), count, MPI_CHAR, dest, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::sendInit<int>
+    (int *buf, int count, int dest, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Send_init(static_cast<void*>(buf), count, MPI_INT, dest, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::sendInit<float>
+    (float *buf, int count, int dest, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Send_init(static_cast<void*>(buf), count, MPI_FLOAT, dest, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::sendInit<double>
+    (double *buf, int count, int dest, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Send_init(static_cast<void*>(buf), count, MPI_DOUBLE, dest, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::recvInit<char>
+    (char *buf, int count, int source, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Recv_init(static_cast<void*>(buf), count, MPI_CHAR, source, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::recvInit<int>
+    (int *buf, int count, int source, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Recv_init(static_cast<void*>(buf), count, MPI_INT, source, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::recvInit<float>
+    (float *buf, int count, int source, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Recv_init(static_cast<void*>(buf), count, MPI_FLOAT, source, tag, comm, request);
+    }
+}
+
+template <>
+void MpiManager::recvInit<double>
+    (double *buf, int count, int source, MPI_Request* request, int tag, MPI_Comm comm)
+{
+    if (ok) {
+        MPI_Recv_init(static_cast<void*>(buf), count, MPI_DOUBLE, source, tag, comm, request);
+    }
+}
+
 template <>
 void MpiManager::iSendRequestFree<char>
     (char *buf, int count, int dest, int tag, MPI_Comm comm)
@@ -744,12 +826,154 @@ void MpiManager::reduceAndBcast<double>(double& reductVal, MPI_Op op, int root,
 
 }
 
+template <>
+void MpiManager::allReduceVect<int>(std::vector<int> const& sendVal, std::vector<int>& recvVal,
+                                 MPI_Op op, MPI_Comm comm)
+{
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+    MPI_Allreduce(const_cast<int*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_INT, op, comm);
+}
+
+template <>
+void MpiManager::allReduceVect<long>(std::vector<long> const& sendVal, std::vector<long>& recvVal,
+                                 MPI_Op op, MPI_Comm comm)
+{
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+    MPI_Allreduce(const_cast<long*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_LONG, op, comm);
+}
+
+template <>
+void MpiManager::allReduceVect<float>(std::vector<float> const& sendVal, std::vector<float>& recvVal,
+                                 MPI_Op op, MPI_Comm comm)
+{
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+    MPI_Allreduce(const_cast<float*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_FLOAT, op, comm);
+}
+
+template <>
+void MpiManager::allReduceVect<double>(std::vector<double> const& sendVal, std::vector<double>& recvVal,
+                                 MPI_Op op, MPI_Comm comm)
+{
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+    MPI_Allreduce(const_cast<double*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_DOUBLE, op, comm);
+}
+
+template <>
+void MpiManager::iAllReduceVect<int>(std::vector<int> const& sendVal, std::vector<int>& recvVal,
+                                  MPI_Op op, MPI_Request* request, MPI_Comm comm)
+{
+    *request = MPI_REQUEST_NULL;
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(const_cast<int*>(&(sendVal[0])),
+                   static_cast<void*>(&(recvVal[0])),
+                   sendVal.size(), MPI_INT, op, comm, request);
+#else
+    MPI_Allreduce(const_cast<int*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_INT, op, comm);
+#endif
+}
+
+template <>
+void MpiManager::iAllReduceVect<long>(std::vector<long> const& sendVal, std::vector<long>& recvVal,
+                                  MPI_Op op, MPI_Request* request, MPI_Comm comm)
+{
+    *request = MPI_REQUEST_NULL;
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(const_cast<long*>(&(sendVal[0])),
+                   static_cast<void*>(&(recvVal[0])),
+                   sendVal.size(), MPI_LONG, op, comm, request);
+#else
+    MPI_Allreduce(const_cast<long*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_LONG, op, comm);
+#endif
+}
+
+template <>
+void MpiManager::iAllReduceVect<float>(std::vector<float> const& sendVal, std::vector<float>& recvVal,
+                                  MPI_Op op, MPI_Request* request, MPI_Comm comm)
+{
+    *request = MPI_REQUEST_NULL;
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(const_cast<float*>(&(sendVal[0])),
+                   static_cast<void*>(&(recvVal[0])),
+                   sendVal.size(), MPI_FLOAT, op, comm, request);
+#else
+    MPI_Allreduce(const_cast<float*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_FLOAT, op, comm);
+#endif
+}
+
+template <>
+void MpiManager::iAllReduceVect<double>(std::vector<double> const& sendVal, std::vector<double>& recvVal,
+                                  MPI_Op op, MPI_Request* request, MPI_Comm comm)
+{
+    *request = MPI_REQUEST_NULL;
+    recvVal.resize(sendVal.size());
+    if (!ok || sendVal.empty()) return;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(const_cast<double*>(&(sendVal[0])),
+                   static_cast<void*>(&(recvVal[0])),
+                   sendVal.size(), MPI_DOUBLE, op, comm, request);
+#else
+    MPI_Allreduce(const_cast<double*>(&(sendVal[0])),
+                  static_cast<void*>(&(recvVal[0])),
+                  sendVal.size(), MPI_DOUBLE, op, comm);
+#endif
+}
+
 void MpiManager::wait(MPI_Request* request, MPI_Status* status)
 {
     if (!ok) return;
     MPI_Wait(request, status);
 }
 
+void MpiManager::waitAll(int count, MPI_Request* requests, MPI_Status* statuses)
+{
+    if (!ok || count==0) return;
+    MPI_Waitall(count, requests, statuses);
+}
+
+void MpiManager::startAll(int count, MPI_Request* requests)
+{
+    if (!ok || count==0) return;
+    MPI_Startall(count, requests);
+}
+
+void MpiManager::start(MPI_Request* request)
+{
+    if (!ok) return;
+    MPI_Start(request);
+}
+
+void MpiManager::freeRequest(MPI_Request* request)
+{
+    if (!ok) return;
+    if (*request != MPI_REQUEST_NULL) {
+        MPI_Request_free(request);
+    }
+}
+
 }  // namespace global
 
 
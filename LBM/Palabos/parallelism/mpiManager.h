@@ -78,6 +78,14 @@ public:
     template <typename T>
     void iRecv(T *buf, int count, int source, MPI_Request* request, int tag = 0, MPI_Comm comm = MPI_COMM_WORLD);
 
+    /// Creates a persistent request for sending data at *buf; started with start()
+    template <typename T>
+    void sendInit(T *buf, int count, int dest, MPI_Request* request, int tag = 0, MPI_Comm comm = MPI_COMM_WORLD);
+
+    /// Creates a persistent request for receiving data at *buf; started with start()
+    template <typename T>
+    void recvInit(T *buf, int count, int source, MPI_Request* request, int tag = 0, MPI_Comm comm = MPI_COMM_WORLD);
+
     /// Send and receive data between two partners
     template <typename T>
     void sendRecv(T *sendBuf, T *recvBuf, int count, int dest, int source, int tag = 0,
@@ -117,9 +125,36 @@ public:
     template <typename T>
     void reduceAndBcast(T& reductVal, MPI_Op op, int root = 0, MPI_Comm comm = MPI_COMM_WORLD);
 
+    /// Element-per-element reduction of a vector of data, with the result on all processors
+    /** recvVal is resized to the size of sendVal. */
+    template <typename T>
+    void allReduceVect(std::vector<T> const& sendVal, std::vector<T>& recvVal,
+                       MPI_Op op, MPI_Comm comm = MPI_COMM_WORLD);
+
+    /// Element-per-element reduction of a vector of data, with the result on all processors, non blocking
+    /** The buffers must remain valid until the request is completed with wait().
+     *  With an MPI library older than MPI-3, the reduction is blocking, and the
+     *  request is set to MPI_REQUEST_NULL.
+     */
+    template <typename T>
+    void iAllReduceVect(std::vector<T> const& sendVal, std::vector<T>& recvVal,
+                        MPI_Op op, MPI_Request* request, MPI_Comm comm = MPI_COMM_WORLD);
+
     /// Complete a non-blocking MPI operation
     void wait(MPI_Request* request, MPI_Status* status);
 
+    /// Complete a list of non-blocking MPI operations
+    void waitAll(int count, MPI_Request* requests, MPI_Status* statuses);
+
+    /// Start a list of persistent requests
+    void startAll(int count, MPI_Request* requests);
+
+    /// Start a persistent request
+    void start(MPI_Request* request);
+
+    /// Release a persistent request
+    void freeRequest(MPI_Request* request);
+
 private:
     /// Implementation code for Scatter
     template <typename T>
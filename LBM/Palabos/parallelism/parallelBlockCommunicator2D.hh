@@ -79,6 +79,8 @@ void ParallelBlockCommunicator2D<T>::setupCommunicationStructure (
     recvPackage.clear();
     sendRecvPackage.clear();
 
+    // The messages of the pools are numbered in the order of subscription,
+    //   which is also their order in sendPackage and recvPackage.
     SendRecvPool sendPool, recvPool;
 
     RelevantIndexes2D const& relevantIndexes = multiBlockManagement.getRelevantIndexes();
@@ -98,8 +100,8 @@ void ParallelBlockCommunicator2D<T>::setupCommunicationStructure (
                 sendPool, recvPool, sizeOfCell );
         }
     }
-    sendComm = SendPoolCommunicator<T>(sendPool);
-    recvComm = RecvPoolCommunicator<T>(recvPool);
+    sendComm.compile(sendPool);
+    recvComm.compile(recvPool);
 }
 
 template<typename T>
@@ -159,8 +161,8 @@ void ParallelBlockCommunicator2D<T>::duplicateOverlaps(MultiBlock2D<T>& multiBlo
         CommunicationInfo2D const& info = sendPackage[iSend];
         AtomicBlock2D<T>& fromBlock = multiBlock.getComponent(info.fromBlockId);
         fromBlock.getDataTransfer().send (
-                info.fromDomain, sendComm.getSendBuffer(info.toProcessId) );
-        sendComm.acceptMessage(info.toProcessId);
+                info.fromDomain, sendComm.getSendBuffer(iSend) );
+        sendComm.acceptMessage(iSend);
     }
 
     // 3. Local copies which require no communication.
@@ -179,7 +181,7 @@ void ParallelBlockCommunicator2D<T>::duplicateOverlaps(MultiBlock2D<T>& multiBlo
         CommunicationInfo2D const& info = recvPackage[iRecv];
         AtomicBlock2D<T>& toBlock = multiBlock.getComponent(info.toBlockId);
         toBlock.getDataTransfer().receive (
-                info.toDomain, recvComm.receiveMessage(info.fromProcessId) );
+                info.toDomain, recvComm.receiveMessage(iRecv) );
     }
 
     // 5. Finalize the sends.
@@ -48,6 +48,11 @@ public:
     virtual void broadCastScalar(T& scalar, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const;
     virtual void broadCastVector(T* data, plint length, plint fromBlock, MultiBlockManagement3D const& multiBlockManagement) const;
     virtual void duplicateOverlaps(MultiBlock3D<T>& multiBlock) const;
+    virtual void startDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const;
+    virtual void finishDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const;
+    virtual void returnStreamedData(MultiBlock3D<T>& multiBlock) const;
+    virtual void startReturnStreamedData(MultiBlock3D<T>& multiBlock) const;
+    virtual void finishReturnStreamedData(MultiBlock3D<T>& multiBlock) const;
     virtual void signalPeriodicity() const;
 private:
     ParallelBlockCommunicator3D<T>& operator= (
@@ -58,13 +63,20 @@ private:
     void subscribeOverlap (
         Overlap3D const& overlap, MultiBlockManagement3D const& multiBlockManagement,
         SendRecvPool& sendPool, SendRecvPool& recvPool, plint sizeOfCell ) const;
-private:
+    void setupStreamedCommunication(MultiBlock3D<T>& multiBlock) const;
     mutable bool needsUpdate;
     mutable CommunicationPackage3D sendPackage;
     mutable CommunicationPackage3D recvPackage;
     mutable CommunicationPackage3D sendRecvPackage;
     mutable SendPoolCommunicator<T> sendComm;
     mutable RecvPoolCommunicator<T> recvComm;
+    /// Communication structure of returnStreamedData(), the reverse of the one above.
+    mutable bool needsStreamedUpdate;
+    mutable CommunicationPackage3D streamedSendPackage;
+    mutable CommunicationPackage3D streamedRecvPackage;
+    mutable CommunicationPackage3D streamedSendRecvPackage;
+    mutable SendPoolCommunicator<T> streamedSendComm;
+    mutable RecvPoolCommunicator<T> streamedRecvComm;
 };
 
 #endif  // PLB_MPI_PARALLEL
@@ -39,13 +39,15 @@ namespace plb {
 
 template<typename T>
 ParallelBlockCommunicator3D<T>::ParallelBlockCommunicator3D()
-    : needsUpdate(true)
+    : needsUpdate(true),
+      needsStreamedUpdate(true)
 { }
 
 template<typename T>
 ParallelBlockCommunicator3D<T>::ParallelBlockCommunicator3D (
         ParallelBlockCommunicator3D<T> const& rhs )
-  : needsUpdate(true)
+  : needsUpdate(true),
+    needsStreamedUpdate(true)
 { }
 
 template<typename T>
@@ -79,6 +81,8 @@ void ParallelBlockCommunicator3D<T>::setupCommunicationStructure (
     recvPackage.clear();
     sendRecvPackage.clear();
 
+    // The messages of the pools are numbered in the order of subscription,
+    //   which is also their order in sendPackage and recvPackage.
     SendRecvPool sendPool, recvPool;
 
     RelevantIndexes3D const& relevantIndexes = multiBlockManagement.getRelevantIndexes();
@@ -98,8 +102,8 @@ void ParallelBlockCommunicator3D<T>::setupCommunicationStructure (
                 sendPool, recvPool, sizeOfCell );
         }
     }
-    sendComm = SendPoolCommunicator<T>(sendPool);
-    recvComm = RecvPoolCommunicator<T>(recvPool);
+    sendComm.compile(sendPool);
+    recvComm.compile(recvPool);
 }
 
 template<typename T>
@@ -147,6 +151,17 @@ void ParallelBlockCommunicator3D<T>::subscribeOverlap (
 
 template<typename T>
 void ParallelBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlock) const
+{
+    startDuplicateOverlaps(multiBlock);
+    finishDuplicateOverlaps(multiBlock);
+}
+
+/** The receives are posted and the data of the local blocks is sent. The
+ *  caller is free to work on the interior of the blocks while the messages
+ *  are in flight.
+ */
+template<typename T>
+void ParallelBlockCommunicator3D<T>::startDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const
 {
     MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
     PeriodicitySwitch3D<T> const& periodicity          = multiBlock.periodicity();
@@ -161,10 +176,14 @@ void ParallelBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlo
         CommunicationInfo3D const& info = sendPackage[iSend];
         AtomicBlock3D<T>& fromBlock = multiBlock.getComponent(info.fromBlockId);
         fromBlock.getDataTransfer().send (
-                info.fromDomain, sendComm.getSendBuffer(info.toProcessId) );
-        sendComm.acceptMessage(info.toProcessId);
+                info.fromDomain, sendComm.getSendBuffer(iSend) );
+        sendComm.acceptMessage(iSend);
     }
+}
 
+template<typename T>
+void ParallelBlockCommunicator3D<T>::finishDuplicateOverlaps(MultiBlock3D<T>& multiBlock) const
+{
     // 3. Local copies which require no communication.
     for (unsigned iSendRecv=0; iSendRecv<sendRecvPackage.size(); ++iSendRecv) {
         CommunicationInfo3D const& info = sendRecvPackage[iSendRecv];
@@ -182,16 +201,126 @@ void ParallelBlockCommunicator3D<T>::duplicateOverlaps(MultiBlock3D<T>& multiBlo
         CommunicationInfo3D const& info = recvPackage[iRecv];
         AtomicBlock3D<T>& toBlock = multiBlock.getComponent(info.toBlockId);
         toBlock.getDataTransfer().receive (
-                info.toDomain, recvComm.receiveMessage(info.fromProcessId) );
+                info.toDomain, recvComm.receiveMessage(iRecv) );
     }
 
     // 5. Finalize the sends.
     sendComm.finalize();
 }
 
+/** The communication is the reverse of the one of duplicateOverlaps(). The
+ *  message lengths depend on the shape of the overlaps and are computed by
+ *  the local blocks, on both the sending and the receiving side.
+ */
+template<typename T>
+void ParallelBlockCommunicator3D<T>::setupStreamedCommunication(MultiBlock3D<T>& multiBlock) const
+{
+    MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
+    setupCommunicationStructure(multiBlockManagement, multiBlock.sizeOfCell(), multiBlock.periodicity());
+    if (!needsStreamedUpdate) {
+        return;
+    }
+    needsStreamedUpdate = false;
+
+    streamedSendPackage.clear();
+    streamedRecvPackage.clear();
+    streamedSendRecvPackage.clear();
+
+    SendRecvPool sendPool, recvPool;
+    MultiBlockDistribution3D const& dataDistribution = multiBlockManagement.getMultiBlockDistribution();
+
+    // Overlaps received during duplicateOverlaps() are returned to their sender.
+    for (pluint iRecv=0; iRecv<recvPackage.size(); ++iRecv) {
+        CommunicationInfo3D const& info = recvPackage[iRecv];
+        BlockParameters3D const& parameters = dataDistribution.getBlockParameters(info.toBlockId);
+        CommunicationInfo3D reverse =
+            reverseForStreamedData(info, parameters.toLocal(parameters.getBulk()));
+        plint length = multiBlock.getComponent(reverse.fromBlockId).getDataTransfer().
+                           sizeOfStreamedData(reverse.fromDomain, streamSourceOfSender(reverse));
+        streamedSendPackage.push_back(reverse);
+        sendPool.subscribeMessage(reverse.toProcessId, length);
+    }
+    // Overlaps sent during duplicateOverlaps() are received back.
+    for (pluint iSend=0; iSend<sendPackage.size(); ++iSend) {
+        CommunicationInfo3D const& info = sendPackage[iSend];
+        BlockParameters3D const& parameters = dataDistribution.getBlockParameters(info.toBlockId);
+        CommunicationInfo3D reverse =
+            reverseForStreamedData(info, parameters.toLocal(parameters.getBulk()));
+        plint length = multiBlock.getComponent(reverse.toBlockId).getDataTransfer().
+                           sizeOfStreamedData(reverse.toDomain, reverse.streamSource);
+        streamedRecvPackage.push_back(reverse);
+        recvPool.subscribeMessage(reverse.fromProcessId, length);
+    }
+    for (pluint iSendRecv=0; iSendRecv<sendRecvPackage.size(); ++iSendRecv) {
+        CommunicationInfo3D const& info = sendRecvPackage[iSendRecv];
+        BlockParameters3D const& parameters = dataDistribution.getBlockParameters(info.toBlockId);
+        streamedSendRecvPackage.push_back (
+                reverseForStreamedData(info, parameters.toLocal(parameters.getBulk())) );
+    }
+    streamedSendComm.compile(sendPool);
+    streamedRecvComm.compile(recvPool);
+}
+
+template<typename T>
+void ParallelBlockCommunicator3D<T>::returnStreamedData(MultiBlock3D<T>& multiBlock) const
+{
+    startReturnStreamedData(multiBlock);
+    finishReturnStreamedData(multiBlock);
+}
+
+/** As in startDuplicateOverlaps(), the receives are posted and the data of
+ *  the local blocks is sent, after which the caller is free to work on the
+ *  cells which do not take part in the communication.
+ */
+template<typename T>
+void ParallelBlockCommunicator3D<T>::startReturnStreamedData(MultiBlock3D<T>& multiBlock) const
+{
+    setupStreamedCommunication(multiBlock);
+
+    // 1. Non-blocking receives.
+    streamedRecvComm.startBeingReceptive();
+
+    // 2. Non-blocking sends.
+    for (unsigned iSend=0; iSend<streamedSendPackage.size(); ++iSend) {
+        CommunicationInfo3D const& info = streamedSendPackage[iSend];
+        AtomicBlock3D<T>& fromBlock = multiBlock.getComponent(info.fromBlockId);
+        fromBlock.getDataTransfer().sendStreamed (
+                info.fromDomain, streamSourceOfSender(info), streamedSendComm.getSendBuffer(iSend) );
+        streamedSendComm.acceptMessage(iSend);
+    }
+}
+
+template<typename T>
+void ParallelBlockCommunicator3D<T>::finishReturnStreamedData(MultiBlock3D<T>& multiBlock) const
+{
+    // 3. Local copies which require no communication.
+    for (unsigned iSendRecv=0; iSendRecv<streamedSendRecvPackage.size(); ++iSendRecv) {
+        CommunicationInfo3D const& info = streamedSendRecvPackage[iSendRecv];
+        AtomicBlock3D<T>& fromBlock = multiBlock.getComponent(info.fromBlockId);
+        AtomicBlock3D<T>& toBlock = multiBlock.getComponent(info.toBlockId);
+        plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+        plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+        plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+        toBlock.getDataTransfer().attributeStreamed (
+                info.toDomain, info.streamSource, deltaX, deltaY, deltaZ, fromBlock );
+    }
+
+    // 4. Finalize the receives.
+    for (unsigned iRecv=0; iRecv<streamedRecvPackage.size(); ++iRecv) {
+        CommunicationInfo3D const& info = streamedRecvPackage[iRecv];
+        AtomicBlock3D<T>& toBlock = multiBlock.getComponent(info.toBlockId);
+        toBlock.getDataTransfer().receiveStreamed (
+                info.toDomain, info.streamSource, streamedRecvComm.receiveMessage(iRecv) );
+    }
+
+    // 5. Finalize the sends.
+    streamedSendComm.finalize();
+}
+
 template<typename T>
 void ParallelBlockCommunicator3D<T>::signalPeriodicity() const {
     needsUpdate = true;
+    needsStreamedUpdate = true;
 }
 
 #endif  // PLB_MPI_PARALLEL
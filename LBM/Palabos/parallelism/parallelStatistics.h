@@ -26,15 +26,26 @@
 
 #include "core/globalDefs.h"
 #include "multiBlock/combinedStatistics.h"
+#include "parallelism/mpiManager.h"
 #include <vector>
 
 namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
+/// Reduction of the statistics over all MPI processes.
+/** All observables which are reduced with the same operation are packed
+ *  into a single buffer, and reduced by a single collective call. In the
+ *  asynchronous version, the collective is non-blocking: it is completed
+ *  in the next call, and the statistics which are returned are the ones
+ *  of the previous call.
+ */
 template<typename T>
 class ParallelCombinedStatistics : public CombinedStatistics<T> {
 public:
+    ParallelCombinedStatistics();
+    ParallelCombinedStatistics(ParallelCombinedStatistics<T> const& rhs);
+    ~ParallelCombinedStatistics();
     virtual ParallelCombinedStatistics<T>* clone() const;
 protected:
     virtual void reduceStatistics (
@@ -43,6 +54,39 @@ protected:
             std::vector<T>& sumObservables,
             std::vector<T>& maxObservables,
             std::vector<plint>& intSumObservables ) const;
+    virtual void reduceStatisticsAsynchronously (
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const;
+private:
+    ParallelCombinedStatistics<T>& operator=(ParallelCombinedStatistics<T> const& rhs);
+    /// Pack averages, weights and sums into one buffer.
+    static void pack( std::vector<T> const& averageObservables,
+                      std::vector<T> const& sumWeights,
+                      std::vector<T> const& sumObservables,
+                      std::vector<T>& buffer );
+    /// Unpack the reduced buffer, and compute the global averages.
+    static void unpack( std::vector<T> const& buffer,
+                        std::vector<T>& averageObservables,
+                        std::vector<T>& sumObservables );
+    /// Copy the result of the completed non-blocking reduction.
+    void copyResults( std::vector<T>& averageObservables,
+                      std::vector<T>& sumObservables,
+                      std::vector<T>& maxObservables,
+                      std::vector<plint>& intSumObservables ) const;
+    /// Complete the pending non-blocking reduction, if any.
+    void waitForPending() const;
+private:
+    /// Tells whether a reduction has been started, of which the result
+    ///   is available in the receive buffers after waitForPending().
+    mutable bool pending;
+    mutable pluint pendingNumAverages;
+    mutable std::vector<T> sendSums, recvSums;
+    mutable std::vector<T> sendMaxes, recvMaxes;
+    mutable std::vector<plint> sendIntSums, recvIntSums;
+    mutable MPI_Request requests[3];
 };
 
 #endif
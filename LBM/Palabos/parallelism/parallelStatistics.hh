@@ -31,12 +31,78 @@ namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
+template<typename T>
+ParallelCombinedStatistics<T>::ParallelCombinedStatistics()
+    : pending(false),
+      pendingNumAverages(0)
+{
+    for (plint iRequest=0; iRequest<3; ++iRequest) {
+        requests[iRequest] = MPI_REQUEST_NULL;
+    }
+}
+
+/// The copy starts with no pending reduction.
+template<typename T>
+ParallelCombinedStatistics<T>::ParallelCombinedStatistics(ParallelCombinedStatistics<T> const& rhs)
+    : CombinedStatistics<T>(rhs),
+      pending(false),
+      pendingNumAverages(0)
+{
+    for (plint iRequest=0; iRequest<3; ++iRequest) {
+        requests[iRequest] = MPI_REQUEST_NULL;
+    }
+}
+
+template<typename T>
+ParallelCombinedStatistics<T>::~ParallelCombinedStatistics()
+{
+    waitForPending();
+}
+
 template<typename T>
 ParallelCombinedStatistics<T>* ParallelCombinedStatistics<T>::clone() const
 {
     return new ParallelCombinedStatistics<T>(*this);
 }
 
+template<typename T>
+void ParallelCombinedStatistics<T>::pack (
+        std::vector<T> const& averageObservables,
+        std::vector<T> const& sumWeights,
+        std::vector<T> const& sumObservables,
+        std::vector<T>& buffer )
+{
+    pluint numAverages = averageObservables.size();
+    buffer.resize(2*numAverages + sumObservables.size());
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        buffer[iAverage] = averageObservables[iAverage]*sumWeights[iAverage];
+        buffer[numAverages+iAverage] = sumWeights[iAverage];
+    }
+    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
+        buffer[2*numAverages+iSum] = sumObservables[iSum];
+    }
+}
+
+template<typename T>
+void ParallelCombinedStatistics<T>::unpack (
+        std::vector<T> const& buffer,
+        std::vector<T>& averageObservables,
+        std::vector<T>& sumObservables )
+{
+    pluint numAverages = averageObservables.size();
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        T globalAverage = buffer[iAverage];
+        T globalWeight  = buffer[numAverages+iAverage];
+        if (fabs(globalWeight) > (T)0.5) {
+            globalAverage /= globalWeight;
+        }
+        averageObservables[iAverage] = globalAverage;
+    }
+    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
+        sumObservables[iSum] = buffer[2*numAverages+iSum];
+    }
+}
+
 template<typename T>
 void ParallelCombinedStatistics<T>::reduceStatistics (
             std::vector<T>& averageObservables,
@@ -45,43 +111,100 @@ void ParallelCombinedStatistics<T>::reduceStatistics (
             std::vector<T>& maxObservables,
             std::vector<plint>& intSumObservables ) const
 {
-    // Averages
-    for (pluint iAverage=0; iAverage<averageObservables.size(); ++iAverage) {
-        T globalAverage, globalWeight;
-        global::mpi().reduce(averageObservables[iAverage]*sumWeights[iAverage], globalAverage, MPI_SUM);
-        global::mpi().reduce(sumWeights[iAverage], globalWeight, MPI_SUM);
-        if (global::mpi().isMainProcessor() && fabs(globalWeight) > (T)0.5) {
-            globalAverage /= globalWeight;
-        }
-        global::mpi().bCast(&globalAverage, 1);
-        averageObservables[iAverage] = globalAverage;
-    }
+    // A pending asynchronous reduction is outdated by the present one.
+    waitForPending();
+    pending = false;
 
-    // Sum
-    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
-        T globalSum;
-        global::mpi().reduce(sumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        sumObservables[iSum] = globalSum;
+    // Averages (together with their weights) and sums
+    std::vector<T> localSums, globalSums;
+    pack(averageObservables, sumWeights, sumObservables, localSums);
+    global::mpi().allReduceVect(localSums, globalSums, MPI_SUM);
+    if (!globalSums.empty()) {
+        unpack(globalSums, averageObservables, sumObservables);
     }
 
     // Max
-    for (pluint iMax=0; iMax<maxObservables.size(); ++iMax) {
-        T globalMax;
-        global::mpi().reduce(maxObservables[iMax], globalMax, MPI_MAX);
-        global::mpi().bCast(&globalMax, 1);
-        maxObservables[iMax] = globalMax;
+    std::vector<T> globalMaxes;
+    global::mpi().allReduceVect(maxObservables, globalMaxes, MPI_MAX);
+    if (!globalMaxes.empty()) {
+        maxObservables.swap(globalMaxes);
     }
 
     // Integer sum
-    for (pluint iSum=0; iSum<intSumObservables.size(); ++iSum) {
-        plint globalSum;
-        global::mpi().reduce(intSumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        intSumObservables[iSum] = globalSum;
+    std::vector<plint> globalIntSums;
+    global::mpi().allReduceVect(intSumObservables, globalIntSums, MPI_SUM);
+    if (!globalIntSums.empty()) {
+        intSumObservables.swap(globalIntSums);
     }
 }
 
+template<typename T>
+void ParallelCombinedStatistics<T>::reduceStatisticsAsynchronously (
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumWeights,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const
+{
+    // Results of the previous reduction, if they match the present observables.
+    bool hasPrevious = pending &&
+                       pendingNumAverages == averageObservables.size() &&
+                       sendSums.size() == 2*averageObservables.size()+sumObservables.size() &&
+                       sendMaxes.size() == maxObservables.size() &&
+                       sendIntSums.size() == intSumObservables.size();
+    waitForPending();
+
+    std::vector<T> localSums;
+    pack(averageObservables, sumWeights, sumObservables, localSums);
+    std::vector<T> localMaxes(maxObservables);
+    std::vector<plint> localIntSums(intSumObservables);
+
+    if (hasPrevious) {
+        copyResults(averageObservables, sumObservables, maxObservables, intSumObservables);
+    }
+
+    // Start the reduction of the present statistics.
+    sendSums.swap(localSums);
+    sendMaxes.swap(localMaxes);
+    sendIntSums.swap(localIntSums);
+    pendingNumAverages = averageObservables.size();
+    global::mpi().iAllReduceVect(sendSums, recvSums, MPI_SUM, &requests[0]);
+    global::mpi().iAllReduceVect(sendMaxes, recvMaxes, MPI_MAX, &requests[1]);
+    global::mpi().iAllReduceVect(sendIntSums, recvIntSums, MPI_SUM, &requests[2]);
+    pending = true;
+
+    // Nothing is available from a previous call: complete the present reduction.
+    if (!hasPrevious) {
+        waitForPending();
+        copyResults(averageObservables, sumObservables, maxObservables, intSumObservables);
+    }
+}
+
+template<typename T>
+void ParallelCombinedStatistics<T>::copyResults (
+            std::vector<T>& averageObservables,
+            std::vector<T>& sumObservables,
+            std::vector<T>& maxObservables,
+            std::vector<plint>& intSumObservables ) const
+{
+    if (!recvSums.empty()) {
+        unpack(recvSums, averageObservables, sumObservables);
+    }
+    if (!recvMaxes.empty()) {
+        maxObservables = recvMaxes;
+    }
+    if (!recvIntSums.empty()) {
+        intSumObservables = recvIntSums;
+    }
+}
+
+template<typename T>
+void ParallelCombinedStatistics<T>::waitForPending() const
+{
+    // Completed requests are set to MPI_REQUEST_NULL, and are ignored.
+    global::mpi().waitAll(3, requests, MPI_STATUSES_IGNORE);
+}
+
 #endif
 
 }  // namespace plb
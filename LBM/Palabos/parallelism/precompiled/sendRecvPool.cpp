@@ -29,8 +29,9 @@ namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
     template struct CommunicatorEntry<double>;
-    template struct SendPoolCommunicator<double>;
-    template struct RecvPoolCommunicator<double>;
+    template class PoolCommunicationPlan<double>;
+    template class SendPoolCommunicator<double>;
+    template class RecvPoolCommunicator<double>;
 #endif
 
 }
@@ -42,6 +42,10 @@ struct PoolEntry {
     std::vector<int> lengths;
 };
 
+/// Collects the messages exchanged with other processes during a communication.
+/** Messages are identified by the order of their subscription: the first
+ *  message has id 0, the next one id 1, and so on.
+ */
 class SendRecvPool {
 public:
     typedef std::map<int, PoolEntry> SubsT;
@@ -50,62 +54,100 @@ public:
         PoolEntry& entry = subscriptions[proc];
         entry.lengths.push_back(numData);
         entry.cumDataLength += numData;
+        messageProcs.push_back(proc);
     }
     void clear() {
         subscriptions.clear();
+        messageProcs.clear();
     }
     SubsT::const_iterator begin() const { return subscriptions.begin(); }
     SubsT::const_iterator end() const { return subscriptions.end(); }
+    int getNumMessages() const { return (int)messageProcs.size(); }
+    int getMessageProc(int iMessage) const { return messageProcs[iMessage]; }
 private:
     SubsT subscriptions;
+    std::vector<int> messageProcs;
 };
 
+/// All messages exchanged with one process, packed into a single buffer.
 template <typename T>
 struct CommunicatorEntry {
-    CommunicatorEntry() { } 
-    CommunicatorEntry(PoolEntry const& poolEntry)
-        : lengths(poolEntry.lengths),
-          data(poolEntry.cumDataLength),
-          currentMessage(0),
-          currentPos(0)
+    CommunicatorEntry()
+        : proc(0), numMessages(0), numPending(0)
     { }
-    void reset() {
-        currentMessage=0;
-        currentPos=0;
-    }
-    std::vector<int> lengths;
+    CommunicatorEntry(int proc_, PoolEntry const& poolEntry)
+        : proc(proc_),
+          numMessages((int)poolEntry.lengths.size()),
+          numPending(0),
+          data(poolEntry.cumDataLength)
+    { }
+    T* getData() { return data.empty() ? 0 : &data[0]; }
+    int proc;
+    int numMessages;
+    int numPending;
     std::vector<T> data;
-    int currentMessage;
-    int currentPos;
-    MPI_Request request;
-    MPI_Status  status;
 };
 
+/// Position of a message within the buffers of a PoolCommunicationPlan.
+struct MessageSlot {
+    int entry;
+    int offset;
+};
+
+/// Communication structure which is compiled once from a SendRecvPool.
+/** The buffers and the persistent MPI requests are allocated during
+ *  compilation. Every message has a precomputed position in the buffers,
+ *  so that a communication step neither allocates memory nor searches
+ *  for the partner process of a message.
+ */
 template <typename T>
-class SendPoolCommunicator {
+class PoolCommunicationPlan {
 public:
-    SendPoolCommunicator() { }
-    SendPoolCommunicator(SendRecvPool const& pool);
-    T* getSendBuffer(int toProc);
-    void acceptMessage(int toProc);
-    void finalize();
-private:
-    void startCommunication(int toProc);
+    PoolCommunicationPlan();
+    ~PoolCommunicationPlan();
+    /// Release the buffers and the persistent requests.
+    void clear();
+    int getNumMessages() const { return (int)messages.size(); }
+protected:
+    void compileBuffers(SendRecvPool const& pool);
+    T* getMessage(int iMessage) {
+        MessageSlot const& slot = messages[iMessage];
+        return entries[slot.entry].getData() + slot.offset;
+    }
 private:
-    std::map<int, CommunicatorEntry<T> > subscriptions;
+    PoolCommunicationPlan(PoolCommunicationPlan<T> const& rhs) { }
+    PoolCommunicationPlan<T>& operator=(PoolCommunicationPlan<T> const& rhs) { return *this; }
+protected:
+    std::vector<CommunicatorEntry<T> > entries;
+    std::vector<MessageSlot> messages;
+    std::vector<MPI_Request> requests;
+    std::vector<MPI_Status> statuses;
 };
 
+/// Packs messages and sends them to other processes.
+/** All messages to a given process are sent together, as soon as the
+ *  last one of them has been packed.
+ */
 template <typename T>
-class RecvPoolCommunicator {
+class SendPoolCommunicator : public PoolCommunicationPlan<T> {
 public:
-    RecvPoolCommunicator() { }
-    RecvPoolCommunicator(SendRecvPool const& pool);
+    void compile(SendRecvPool const& pool);
+    /// Location at which the message with id iMessage is to be packed.
+    T* getSendBuffer(int iMessage);
+    /// Signal that the message with id iMessage is packed.
+    void acceptMessage(int iMessage);
+    /// Wait for the completion of all sends.
+    void finalize();
+};
+
+/// Receives messages from other processes.
+template <typename T>
+class RecvPoolCommunicator : public PoolCommunicationPlan<T> {
+public:
+    void compile(SendRecvPool const& pool);
     void startBeingReceptive();
-    T const* receiveMessage(int fromProc);
-private:
-    void finalize(int fromProc);
-private:
-    std::map<int, CommunicatorEntry<T> > subscriptions;
+    /// Wait until the message with id iMessage is available, and access it.
+    T const* receiveMessage(int iMessage);
 };
 
 #endif  // PLB_MPI_PARALLEL
@@ -28,89 +28,129 @@
 #include "parallelism/mpiManager.h"
 #include "parallelism/sendRecvPool.h"
 #include "core/plbDebug.h"
+#include <map>
 
 namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
+////////////////////// Class PoolCommunicationPlan /////////////////////
+
 template <typename T>
-SendPoolCommunicator<T>::SendPoolCommunicator(SendRecvPool const& pool)
-    : subscriptions(pool.begin(), pool.end())
+PoolCommunicationPlan<T>::PoolCommunicationPlan()
 { }
 
 template <typename T>
-T* SendPoolCommunicator<T>::getSendBuffer(int toProc) {
-    CommunicatorEntry<T>& entry = subscriptions[toProc];
-    PLB_PRECONDITION( entry.currentMessage < (int)entry.lengths.size() );
-    return &entry.data[entry.currentPos];
+PoolCommunicationPlan<T>::~PoolCommunicationPlan() {
+    clear();
 }
 
 template <typename T>
-void SendPoolCommunicator<T>::acceptMessage(int toProc) {
-    CommunicatorEntry<T>& entry = subscriptions[toProc];
-    PLB_PRECONDITION( entry.currentMessage < (int)entry.lengths.size() );
-    int length = entry.lengths[entry.currentMessage];
-    entry.currentMessage++;
-    entry.currentPos += length;
-
-    if (entry.currentMessage==(int)entry.lengths.size()) {
-        startCommunication(toProc);
-        entry.reset();
+void PoolCommunicationPlan<T>::clear() {
+    for (pluint iEntry=0; iEntry<requests.size(); ++iEntry) {
+        global::mpi().freeRequest(&requests[iEntry]);
     }
+    entries.clear();
+    messages.clear();
+    requests.clear();
+    statuses.clear();
 }
 
 template <typename T>
-void SendPoolCommunicator<T>::finalize() {
-    typename std::map<int, CommunicatorEntry<T> >::iterator iter = subscriptions.begin();
-    for (; iter != subscriptions.end(); ++iter) {
-        CommunicatorEntry<T>& entry = iter->second;
-        global::mpi().wait(&entry.request, &entry.status);
+void PoolCommunicationPlan<T>::compileBuffers(SendRecvPool const& pool) {
+    clear();
+    std::map<int,int> entryOfProc;
+    std::vector<std::vector<int> const*> lengths;
+    for (SendRecvPool::SubsT::const_iterator iter = pool.begin(); iter != pool.end(); ++iter) {
+        entryOfProc[iter->first] = (int)entries.size();
+        entries.push_back(CommunicatorEntry<T>(iter->first, iter->second));
+        lengths.push_back(&iter->second.lengths);
+    }
+    // The messages to a given process are laid out contiguously, in the
+    //   order of their subscription.
+    std::vector<int> numPlaced(entries.size()), position(entries.size());
+    messages.resize(pool.getNumMessages());
+    for (int iMessage=0; iMessage<pool.getNumMessages(); ++iMessage) {
+        int iEntry = entryOfProc[pool.getMessageProc(iMessage)];
+        messages[iMessage].entry  = iEntry;
+        messages[iMessage].offset = position[iEntry];
+        position[iEntry] += (*lengths[iEntry])[numPlaced[iEntry]++];
     }
+    requests.resize(entries.size(), MPI_REQUEST_NULL);
+    statuses.resize(entries.size());
 }
 
+////////////////////// Class SendPoolCommunicator /////////////////////
+
 template <typename T>
-void SendPoolCommunicator<T>::startCommunication(int toProc)
-{
-    CommunicatorEntry<T>& entry = subscriptions[toProc];
-    global::mpi().iSend(&entry.data[0], entry.data.size(), toProc, &entry.request);
+void SendPoolCommunicator<T>::compile(SendRecvPool const& pool) {
+    this->compileBuffers(pool);
+    for (pluint iEntry=0; iEntry<this->entries.size(); ++iEntry) {
+        CommunicatorEntry<T>& entry = this->entries[iEntry];
+        entry.numPending = entry.numMessages;
+        global::mpi().sendInit(entry.getData(), (int)entry.data.size(), entry.proc,
+                               &this->requests[iEntry]);
+    }
 }
 
 template <typename T>
-RecvPoolCommunicator<T>::RecvPoolCommunicator(SendRecvPool const& pool)
-    : subscriptions(pool.begin(), pool.end())
-{ }
+T* SendPoolCommunicator<T>::getSendBuffer(int iMessage) {
+    PLB_PRECONDITION( iMessage < this->getNumMessages() );
+    return this->getMessage(iMessage);
+}
 
 template <typename T>
-void RecvPoolCommunicator<T>::startBeingReceptive() {
-    typename std::map<int, CommunicatorEntry<T> >::iterator iter = subscriptions.begin();
-    for (; iter != subscriptions.end(); ++iter) {
-        int fromProc = iter->first;
-        CommunicatorEntry<T>& entry = iter->second;
-        global::mpi().iRecv(&entry.data[0], entry.data.size(), fromProc, &entry.request);
+void SendPoolCommunicator<T>::acceptMessage(int iMessage) {
+    PLB_PRECONDITION( iMessage < this->getNumMessages() );
+    int iEntry = this->messages[iMessage].entry;
+    CommunicatorEntry<T>& entry = this->entries[iEntry];
+    PLB_PRECONDITION( entry.numPending > 0 );
+    --entry.numPending;
+    if (entry.numPending==0) {
+        global::mpi().start(&this->requests[iEntry]);
+        entry.numPending = entry.numMessages;
+    }
+}
+
+template <typename T>
+void SendPoolCommunicator<T>::finalize() {
+    if (!this->requests.empty()) {
+        global::mpi().waitAll((int)this->requests.size(), &this->requests[0], &this->statuses[0]);
+    }
+}
+
+////////////////////// Class RecvPoolCommunicator /////////////////////
+
+template <typename T>
+void RecvPoolCommunicator<T>::compile(SendRecvPool const& pool) {
+    this->compileBuffers(pool);
+    for (pluint iEntry=0; iEntry<this->entries.size(); ++iEntry) {
+        CommunicatorEntry<T>& entry = this->entries[iEntry];
+        global::mpi().recvInit(entry.getData(), (int)entry.data.size(), entry.proc,
+                               &this->requests[iEntry]);
     }
 }
 
 template <typename T>
-T const* RecvPoolCommunicator<T>::receiveMessage(int fromProc) {
-    CommunicatorEntry<T>& entry = subscriptions[fromProc];
-    PLB_PRECONDITION( entry.currentMessage < (int)entry.lengths.size() );
-    if (entry.currentMessage==0) {
-        finalize(fromProc);
+void RecvPoolCommunicator<T>::startBeingReceptive() {
+    for (pluint iEntry=0; iEntry<this->entries.size(); ++iEntry) {
+        this->entries[iEntry].numPending = 1;
     }
-    T const* message = &entry.data[entry.currentPos];
-    int length = entry.lengths[entry.currentMessage];
-    entry.currentMessage++;
-    entry.currentPos += length;
-    if (entry.currentMessage==(int)entry.lengths.size()) {
-        entry.reset();
+    if (!this->requests.empty()) {
+        global::mpi().startAll((int)this->requests.size(), &this->requests[0]);
     }
-    return message;
 }
 
 template <typename T>
-void RecvPoolCommunicator<T>::finalize(int fromProc) {
-    CommunicatorEntry<T>& entry = subscriptions[fromProc];
-    global::mpi().wait(&entry.request, &entry.status);
+T const* RecvPoolCommunicator<T>::receiveMessage(int iMessage) {
+    PLB_PRECONDITION( iMessage < this->getNumMessages() );
+    int iEntry = this->messages[iMessage].entry;
+    CommunicatorEntry<T>& entry = this->entries[iEntry];
+    if (entry.numPending>0) {
+        global::mpi().wait(&this->requests[iEntry], &this->statuses[iEntry]);
+        entry.numPending = 0;
+    }
+    return this->getMessage(iMessage);
 }
 
 #endif // PLB_MPI_PARALLEL
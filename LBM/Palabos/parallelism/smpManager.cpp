@@ -0,0 +1,154 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Shared-memory parallelism: concurrent execution of the blocks of a
+ * multi-block within one process -- implementation.
+ */
+
+#include "parallelism/smpManager.h"
+#include "core/plbDebug.h"
+#include "parallelism/mpiManager.h"
+#include <algorithm>
+#include <iostream>
+#include <ctime>
+
+#ifdef PLB_SMP_PARALLEL
+#include <omp.h>
+#endif
+
+namespace plb {
+
+namespace {
+
+/// Orders block positions by decreasing cost, and by position for equal costs.
+struct DecreasingCost {
+    DecreasingCost(std::vector<plint> const& costs_) : costs(costs_) { }
+    bool operator()(plint i1, plint i2) const {
+        if (costs[i1] != costs[i2]) {
+            return costs[i1] > costs[i2];
+        }
+        return i1 < i2;
+    }
+    std::vector<plint> const& costs;
+};
+
+}  // namespace
+
+#ifdef PLB_SMP_PARALLEL
+
+void executeBlockTasks(std::vector<plint> const& blocks, std::vector<plint> const& costs,
+                       BlockTask& task)
+{
+    PLB_PRECONDITION( blocks.size() == costs.size() );
+    plint numThreads = global::smp().getNumThreads();
+    if (numThreads<=1 || blocks.size()<=1 || global::smp().inParallelRegion()) {
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            task.execute(blocks[iBlock]);
+        }
+        return;
+    }
+    std::vector<plint> queue(blocks.size());
+    for (pluint iBlock=0; iBlock<queue.size(); ++iBlock) {
+        queue[iBlock] = iBlock;
+    }
+    std::sort(queue.begin(), queue.end(), DecreasingCost(costs));
+    int numTasks = (int)queue.size();
+    // Dynamic scheduling with chunks of size 1: each thread fetches the
+    //   next pending block as soon as it is done with the previous one.
+    #pragma omp parallel for schedule(dynamic,1) num_threads((int)numThreads)
+    for (int iTask=0; iTask<numTasks; ++iTask) {
+        task.execute(blocks[queue[iTask]]);
+    }
+}
+
+#else  // PLB_SMP_PARALLEL
+
+void executeBlockTasks(std::vector<plint> const& blocks, std::vector<plint> const&,
+                       BlockTask& task)
+{
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        task.execute(blocks[iBlock]);
+    }
+}
+
+#endif  // PLB_SMP_PARALLEL
+
+namespace global {
+
+SmpManager::SmpManager()
+    : numThreads(1)
+{
+#ifdef PLB_SMP_PARALLEL
+    numThreads = omp_get_max_threads();
+#endif
+}
+
+void SmpManager::init(bool verbous) {
+#ifdef PLB_SMP_PARALLEL
+    numThreads = omp_get_max_threads();
+#endif
+    if (verbous) {
+        std::cerr << "Executing blocks with " << numThreads << " thread(s)" << std::endl;
+    }
+}
+
+plint SmpManager::getNumThreads() const {
+    return numThreads;
+}
+
+#ifdef PLB_SMP_PARALLEL
+void SmpManager::setNumThreads(plint numThreads_) {
+    PLB_PRECONDITION( numThreads_ >= 1 );
+    numThreads = numThreads_;
+}
+#else
+void SmpManager::setNumThreads(plint) { }
+#endif
+
+plint SmpManager::getThreadNum() const {
+#ifdef PLB_SMP_PARALLEL
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+bool SmpManager::inParallelRegion() const {
+#ifdef PLB_SMP_PARALLEL
+    return omp_in_parallel() != 0;
+#else
+    return false;
+#endif
+}
+
+double SmpManager::getTime() const {
+#if defined(PLB_SMP_PARALLEL)
+    return omp_get_wtime();
+#elif defined(PLB_MPI_PARALLEL)
+    return mpi().getTime();
+#else
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+}  // namespace global
+
+}  // namespace plb
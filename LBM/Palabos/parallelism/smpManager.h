@@ -0,0 +1,105 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Shared-memory parallelism: concurrent execution of the blocks of a
+ * multi-block within one process -- header file.
+ *
+ * Threads are enabled by compiling with PLB_SMP_PARALLEL and OpenMP
+ * support (-fopenmp, or /openmp for Visual C++). Together with
+ * PLB_MPI_PARALLEL, this yields a hybrid mode in which each MPI process
+ * executes its local blocks with a team of threads. All MPI communication
+ * takes place outside of the threaded regions.
+ *
+ * A block lattice which is executed outside of a threaded region (an
+ * atomic block, or a multi-block with a single local block) cuts its own
+ * domain into slabs, which are executed by the threads (see
+ * LatticeSlabTask3D). Within a threaded region, blocks and slabs are
+ * executed sequentially.
+ */
+#ifndef SMP_MANAGER_H
+#define SMP_MANAGER_H
+
+#include "core/globalDefs.h"
+#include <vector>
+
+#if defined(PLB_SMP_PARALLEL) && !defined(_OPENMP)
+    #error "PLB_SMP_PARALLEL requires a compiler with OpenMP support enabled."
+#endif
+
+namespace plb {
+
+/// A unit of work, executed on one block of a multi-block.
+/** Tasks for different blocks may be executed concurrently. The
+ *  implementation of execute() must therefore write only to data which
+ *  belongs to the block iBlock.
+ */
+struct BlockTask {
+    virtual ~BlockTask() { }
+    virtual void execute(plint iBlock) =0;
+};
+
+/// Execute a task on each of a list of blocks.
+/** With shared-memory parallelism, the blocks are handed out one by one
+ *  from a shared queue to the threads, by decreasing cost. An idle thread
+ *  picks up the next pending block, so that blocks of unequal size are
+ *  balanced between threads. Without threads, or within a region which is
+ *  already executed concurrently, the blocks are executed sequentially, in
+ *  the order of the list.
+ *  \param costs Estimated amount of work for each of the blocks.
+ */
+void executeBlockTasks(std::vector<plint> const& blocks, std::vector<plint> const& costs,
+                       BlockTask& task);
+
+namespace global {
+
+/// Configuration of the threads used for shared-memory parallelism.
+class SmpManager {
+public:
+    /// Initializes the thread team, as configured by the environment (OMP_NUM_THREADS).
+    void init(bool verbous=false);
+    /// Number of threads used to execute blocks concurrently.
+    plint getNumThreads() const;
+    /// Change the number of threads; 1 means sequential execution.
+    void setNumThreads(plint numThreads_);
+    /// Id of the calling thread, between 0 and getNumThreads()-1.
+    plint getThreadNum() const;
+    /// Tells whether the calling code is executed by a team of threads.
+    bool inParallelRegion() const;
+    /// Wall-clock time in seconds, from an arbitrary origin.
+    /** Unlike clock(), this measures elapsed time also when threads are used. */
+    double getTime() const;
+private:
+    SmpManager();
+private:
+    plint numThreads;
+friend SmpManager& smp();
+};
+
+inline SmpManager& smp() {
+    static SmpManager instance;
+    return instance;
+}
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // SMP_MANAGER_H
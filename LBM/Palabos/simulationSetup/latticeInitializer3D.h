@@ -53,6 +53,23 @@ template<typename T, template<class U> class Descriptor>
 void defineDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, plint iX, plint iY, plint iZ,
                     Dynamics<T,Descriptor>* dynamics);
 
+/// Like defineDynamics(), but all cells refer to a single instance of the dynamics per atomic block.
+/** This saves memory on large domains. Changing a parameter of one of these
+ *  cells, for example through lattice.get(iX,iY,iZ).getDynamics().setOmega(),
+ *  changes it on all of them. Dynamics which are not shareable (see
+ *  Dynamics::isShareable()) are cloned for each cell as usual.
+ */
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D domain, Dynamics<T,Descriptor>* dynamics);
+
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D boundingBox,
+                          DomainFunctional3D* domain, Dynamics<T,Descriptor>* dynamics);
+
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, DotList3D const& dotList,
+                          Dynamics<T,Descriptor>* dynamics);
+
 template<typename T, template<class U> class Descriptor>
 void setBoundaryVelocity(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D domain, Array<T,3> velocity);
 
@@ -73,6 +73,28 @@ void defineDynamics(BlockLatticeBase3D<T,Descriptor>& lattice,
     defineDynamics(lattice, pos, dynamics);
 }
 
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D domain, Dynamics<T,Descriptor>* dynamics) {
+    applyProcessingFunctional (
+        new InstantiateDynamicsFunctional3D<T,Descriptor>(dynamics, true), domain, lattice );
+}
+
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D boundingBox,
+                          DomainFunctional3D* domain, Dynamics<T,Descriptor>* dynamics) {
+    applyProcessingFunctional (
+        new InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>(dynamics, domain, true),
+        boundingBox, lattice );
+}
+
+template<typename T, template<class U> class Descriptor>
+void defineSharedDynamics(BlockLatticeBase3D<T,Descriptor>& lattice,
+                          DotList3D const& dotList, Dynamics<T,Descriptor>* dynamics)
+{
+    applyProcessingFunctional (
+        new InstantiateDotDynamicsFunctional3D<T,Descriptor>(dynamics, true), dotList, lattice );
+}
+
 template<typename T, template<class U> class Descriptor>
 void setBoundaryVelocity(BlockLatticeBase3D<T,Descriptor>& lattice, Box3D domain, Array<T,3> velocity) {
     applyProcessingFunctional(new SetConstBoundaryVelocityFunctional3D<T,Descriptor>(velocity), domain, lattice);
@@ -95,10 +95,17 @@ private:
 
 /* *************** Class InstantiateDynamicsFunctional3D ************* */
 
+/// Attribute a clone of a dynamics to each cell of a domain.
+/** With shareDynamics_=true, a shareable dynamics is instead instantiated
+ *  once per atomic block, and shared by all cells of the domain (see
+ *  BlockLattice3D::shareDynamics()). A later change of the parameters of
+ *  one of these cells, for example through setOmega(), then applies to all
+ *  of them.
+ */
 template<typename T, template<typename U> class Descriptor>
 class InstantiateDynamicsFunctional3D : public BoxProcessingFunctional3D_L<T,Descriptor> {
 public:
-    InstantiateDynamicsFunctional3D(Dynamics<T,Descriptor>* dynamics_);
+    InstantiateDynamicsFunctional3D(Dynamics<T,Descriptor>* dynamics_, bool shareDynamics_=false);
     InstantiateDynamicsFunctional3D(InstantiateDynamicsFunctional3D<T,Descriptor> const& rhs);
     InstantiateDynamicsFunctional3D<T,Descriptor>& operator= (
             InstantiateDynamicsFunctional3D<T,Descriptor> const& rhs );
@@ -109,6 +116,7 @@ public:
     virtual InstantiateDynamicsFunctional3D<T,Descriptor>* clone() const ;
 private:
     Dynamics<T,Descriptor>* dynamics;
+    bool shareDynamics;
 };
 
 
@@ -120,7 +128,8 @@ class InstantiateComplexDomainDynamicsFunctional3D
 {
 public:
     InstantiateComplexDomainDynamicsFunctional3D( Dynamics<T,Descriptor>* dynamics_,
-                                                  DomainFunctional3D* domain_ );
+                                                  DomainFunctional3D* domain_,
+                                                  bool shareDynamics_=false );
     InstantiateComplexDomainDynamicsFunctional3D (
             InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor> const& rhs );
     InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>& operator= (
@@ -133,6 +142,7 @@ public:
 private:
     Dynamics<T,Descriptor>* dynamics;
     DomainFunctional3D* domain;
+    bool shareDynamics;
 };
 
 
@@ -141,7 +151,7 @@ private:
 template<typename T, template<typename U> class Descriptor>
 class InstantiateDotDynamicsFunctional3D : public DotProcessingFunctional3D_L<T,Descriptor> {
 public:
-    InstantiateDotDynamicsFunctional3D(Dynamics<T,Descriptor>* dynamics_);
+    InstantiateDotDynamicsFunctional3D(Dynamics<T,Descriptor>* dynamics_, bool shareDynamics_=false);
     InstantiateDotDynamicsFunctional3D(InstantiateDotDynamicsFunctional3D<T,Descriptor> const& rhs);
     InstantiateDotDynamicsFunctional3D<T,Descriptor>& operator= (
             InstantiateDotDynamicsFunctional3D<T,Descriptor> const& rhs );
@@ -152,6 +162,7 @@ public:
     virtual InstantiateDotDynamicsFunctional3D<T,Descriptor>* clone() const;
 private:
     Dynamics<T,Descriptor>* dynamics;
+    bool shareDynamics;
 };
 
 
@@ -164,7 +175,8 @@ private:
 template<typename T, template<typename U> class Descriptor>
 class DynamicsFromMaskFunctional3D : public BoxProcessingFunctional3D_LS<T,Descriptor> {
 public:
-    DynamicsFromMaskFunctional3D(Dynamics<T,Descriptor>* dynamics_, bool whichFlag_);
+    DynamicsFromMaskFunctional3D( Dynamics<T,Descriptor>* dynamics_, bool whichFlag_,
+                                  bool shareDynamics_=false );
     DynamicsFromMaskFunctional3D(DynamicsFromMaskFunctional3D<T,Descriptor> const& rhs);
     DynamicsFromMaskFunctional3D<T,Descriptor>& operator= (
             DynamicsFromMaskFunctional3D<T,Descriptor> const& rhs );
@@ -178,6 +190,7 @@ public:
 private:
     Dynamics<T,Descriptor>* dynamics;
     bool whichFlag;
+    bool shareDynamics;
 };
 
 
@@ -190,7 +203,8 @@ private:
 template<typename T, template<typename U> class Descriptor>
 class DynamicsFromIntMaskFunctional3D : public BoxProcessingFunctional3D_LS<T,Descriptor> {
 public:
-    DynamicsFromIntMaskFunctional3D(Dynamics<T,Descriptor>* dynamics_, int whichFlag_);
+    DynamicsFromIntMaskFunctional3D( Dynamics<T,Descriptor>* dynamics_, int whichFlag_,
+                                     bool shareDynamics_=false );
     DynamicsFromIntMaskFunctional3D(DynamicsFromIntMaskFunctional3D<T,Descriptor> const& rhs);
     DynamicsFromIntMaskFunctional3D<T,Descriptor>& operator= (
             DynamicsFromIntMaskFunctional3D<T,Descriptor> const& rhs );
@@ -204,6 +218,7 @@ public:
 private:
     Dynamics<T,Descriptor>* dynamics;
     int whichFlag;
+    bool shareDynamics;
 };
 
 
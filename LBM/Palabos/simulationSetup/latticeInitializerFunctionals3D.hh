@@ -27,6 +27,7 @@
 #include "simulationSetup/latticeInitializer3D.h"
 #include "atomicBlock/blockLattice3D.h"
 #include "core/cell.h"
+#include "core/dynamicsPrototypes.h"
 #include "atomicBlock/dataProcessorWrapper3D.h"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
 
@@ -213,14 +214,18 @@ void GenericIndexedLatticeFunctional3D<T,Descriptor>::rescale(T dxScale, T dtSca
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateDynamicsFunctional3D<T,Descriptor>::InstantiateDynamicsFunctional3D (
-        Dynamics<T,Descriptor>* dynamics_ )
-    : dynamics(dynamics_)
-{ }
+        Dynamics<T,Descriptor>* dynamics_, bool shareDynamics_ )
+    : dynamics(dynamics_),
+      shareDynamics(shareDynamics_)
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*dynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateDynamicsFunctional3D<T,Descriptor>::InstantiateDynamicsFunctional3D (
         InstantiateDynamicsFunctional3D<T,Descriptor> const& rhs )
-    : dynamics(rhs.dynamics->clone())
+    : dynamics(rhs.dynamics->clone()),
+      shareDynamics(rhs.shareDynamics)
 { }
 
 template<typename T, template<typename U> class Descriptor>
@@ -229,6 +234,7 @@ InstantiateDynamicsFunctional3D<T,Descriptor>&
         InstantiateDynamicsFunctional3D<T,Descriptor> const& rhs )
 {
     delete dynamics; dynamics = rhs.dynamics->clone();
+    shareDynamics = rhs.shareDynamics;
     return *this;
 }
 
@@ -242,10 +248,13 @@ template<typename T, template<typename U> class Descriptor>
 void InstantiateDynamicsFunctional3D<T,Descriptor>::process (
         Box3D domain, BlockLattice3D<T,Descriptor>& lattice )
 {
+    // On request, a shareable dynamics is instantiated once, and shared by all cells.
+    Dynamics<T,Descriptor>* shared = shareDynamics && dynamics->isShareable() ?
+                                         lattice.shareDynamics(dynamics->clone()) : 0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                lattice.attributeDynamics(iX,iY,iZ, dynamics->clone());
+                lattice.attributeDynamics(iX,iY,iZ, shared ? shared : dynamics->clone());
             }
         }
     }
@@ -276,16 +285,20 @@ InstantiateDynamicsFunctional3D<T,Descriptor>*
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>::InstantiateComplexDomainDynamicsFunctional3D (
-        Dynamics<T,Descriptor>* dynamics_, DomainFunctional3D* domain_ )
+        Dynamics<T,Descriptor>* dynamics_, DomainFunctional3D* domain_, bool shareDynamics_ )
     : dynamics(dynamics_),
-      domain(domain_)
-{ }
+      domain(domain_),
+      shareDynamics(shareDynamics_)
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*dynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>::InstantiateComplexDomainDynamicsFunctional3D (
         InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor> const& rhs )
     : dynamics(rhs.dynamics->clone()),
-      domain(rhs.domain->clone())
+      domain(rhs.domain->clone()),
+      shareDynamics(rhs.shareDynamics)
 { }
 
 template<typename T, template<typename U> class Descriptor>
@@ -295,6 +308,7 @@ InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>&
 {
     delete dynamics; dynamics = rhs.dynamics->clone();
     delete domain; domain = rhs.domain->clone();
+    shareDynamics = rhs.shareDynamics;
     return *this;
 }
 
@@ -311,11 +325,13 @@ void InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>::process (
 {
 
     Dot3D relativeOffset = lattice.getLocation();
+    Dynamics<T,Descriptor>* shared = shareDynamics && dynamics->isShareable() ?
+                                         lattice.shareDynamics(dynamics->clone()) : 0;
     for (plint iX=boundingBox.x0; iX<=boundingBox.x1; ++iX) {
         for (plint iY=boundingBox.y0; iY<=boundingBox.y1; ++iY) {
             for (plint iZ=boundingBox.z0; iZ<=boundingBox.z1; ++iZ) {
                 if ((*domain)(iX+relativeOffset.x,iY+relativeOffset.y,iZ+relativeOffset.z)) {
-                    lattice.attributeDynamics(iX,iY,iZ, dynamics->clone());
+                    lattice.attributeDynamics(iX,iY,iZ, shared ? shared : dynamics->clone());
                 }
             }
         }
@@ -348,14 +364,18 @@ InstantiateComplexDomainDynamicsFunctional3D<T,Descriptor>*
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateDotDynamicsFunctional3D<T,Descriptor>::InstantiateDotDynamicsFunctional3D (
-        Dynamics<T,Descriptor>* dynamics_ )
-    : dynamics(dynamics_)
-{ }
+        Dynamics<T,Descriptor>* dynamics_, bool shareDynamics_ )
+    : dynamics(dynamics_),
+      shareDynamics(shareDynamics_)
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*dynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateDotDynamicsFunctional3D<T,Descriptor>::InstantiateDotDynamicsFunctional3D (
         InstantiateDotDynamicsFunctional3D<T,Descriptor> const& rhs )
-    : dynamics(rhs.dynamics->clone())
+    : dynamics(rhs.dynamics->clone()),
+      shareDynamics(rhs.shareDynamics)
 { }
 
 template<typename T, template<typename U> class Descriptor>
@@ -364,6 +384,7 @@ InstantiateDotDynamicsFunctional3D<T,Descriptor>&
         InstantiateDotDynamicsFunctional3D<T,Descriptor> const& rhs )
 {
     delete dynamics; dynamics = rhs.dynamics->clone();
+    shareDynamics = rhs.shareDynamics;
     return *this;
 }
 
@@ -377,9 +398,11 @@ template<typename T, template<typename U> class Descriptor>
 void InstantiateDotDynamicsFunctional3D<T,Descriptor>::process (
         DotList3D const& dotList, BlockLattice3D<T,Descriptor>& lattice )
 {
+    Dynamics<T,Descriptor>* shared = shareDynamics && dynamics->isShareable() ?
+                                         lattice.shareDynamics(dynamics->clone()) : 0;
     for (plint iDot=0; iDot<dotList.getN(); ++iDot) {
         Dot3D const& dot = dotList.getDot(iDot);
-        lattice.attributeDynamics(dot.x,dot.y,dot.z, dynamics->clone());
+        lattice.attributeDynamics(dot.x,dot.y,dot.z, shared ? shared : dynamics->clone());
     }
 }
 
@@ -409,15 +432,18 @@ InstantiateDotDynamicsFunctional3D<T,Descriptor>*
 
 template<typename T, template<typename U> class Descriptor>
 DynamicsFromMaskFunctional3D<T,Descriptor>::DynamicsFromMaskFunctional3D (
-        Dynamics<T,Descriptor>* dynamics_, bool whichFlag_ )
-    : dynamics(dynamics_), whichFlag(whichFlag_)
-{ }
+        Dynamics<T,Descriptor>* dynamics_, bool whichFlag_, bool shareDynamics_ )
+    : dynamics(dynamics_), whichFlag(whichFlag_), shareDynamics(shareDynamics_)
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*dynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 DynamicsFromMaskFunctional3D<T,Descriptor>::DynamicsFromMaskFunctional3D (
         DynamicsFromMaskFunctional3D<T,Descriptor> const& rhs )
     : dynamics(rhs.dynamics->clone()),
-      whichFlag(rhs.whichFlag)
+      whichFlag(rhs.whichFlag),
+      shareDynamics(rhs.shareDynamics)
 { }
 
 template<typename T, template<typename U> class Descriptor>
@@ -427,6 +453,8 @@ DynamicsFromMaskFunctional3D<T,Descriptor>&
 {
     delete dynamics; dynamics = rhs.dynamics->clone();
     whichFlag = rhs.whichFlag;
+    shareDynamics = rhs.shareDynamics;
+    return *this;
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -440,6 +468,8 @@ void DynamicsFromMaskFunctional3D<T,Descriptor>::process (
                       ScalarField3D<T>& mask )
 {
     Dot3D offset = computeRelativeDisplacement(lattice, mask);
+    Dynamics<T,Descriptor>* shared = shareDynamics && dynamics->isShareable() ?
+                                         lattice.shareDynamics(dynamics->clone()) : 0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ)
@@ -447,7 +477,7 @@ void DynamicsFromMaskFunctional3D<T,Descriptor>::process (
                 bool flag = (bool) util::roundToInt (
                                mask.get(iX+offset.x, iY+offset.y, iZ+offset.z) );
                 if ( util::boolIsEqual(flag, whichFlag) ) {
-                    lattice.attributeDynamics(iX,iY,iZ, dynamics->clone());
+                    lattice.attributeDynamics(iX,iY,iZ, shared ? shared : dynamics->clone());
                 }
             }
         }
@@ -480,15 +510,18 @@ DynamicsFromMaskFunctional3D<T,Descriptor>*
 
 template<typename T, template<typename U> class Descriptor>
 DynamicsFromIntMaskFunctional3D<T,Descriptor>::DynamicsFromIntMaskFunctional3D (
-        Dynamics<T,Descriptor>* dynamics_, int whichFlag_ )
-    : dynamics(dynamics_), whichFlag(whichFlag_)
-{ }
+        Dynamics<T,Descriptor>* dynamics_, int whichFlag_, bool shareDynamics_ )
+    : dynamics(dynamics_), whichFlag(whichFlag_), shareDynamics(shareDynamics_)
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*dynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 DynamicsFromIntMaskFunctional3D<T,Descriptor>::DynamicsFromIntMaskFunctional3D (
         DynamicsFromIntMaskFunctional3D<T,Descriptor> const& rhs )
     : dynamics(rhs.dynamics->clone()),
-      whichFlag(rhs.whichFlag)
+      whichFlag(rhs.whichFlag),
+      shareDynamics(rhs.shareDynamics)
 { }
 
 template<typename T, template<typename U> class Descriptor>
@@ -498,6 +531,8 @@ DynamicsFromIntMaskFunctional3D<T,Descriptor>&
 {
     delete dynamics; dynamics = rhs.dynamics->clone();
     whichFlag = rhs.whichFlag;
+    shareDynamics = rhs.shareDynamics;
+    return *this;
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -511,6 +546,8 @@ void DynamicsFromIntMaskFunctional3D<T,Descriptor>::process (
                       ScalarField3D<T>& mask )
 {
     Dot3D offset = computeRelativeDisplacement(lattice, mask);
+    Dynamics<T,Descriptor>* shared = shareDynamics && dynamics->isShareable() ?
+                                         lattice.shareDynamics(dynamics->clone()) : 0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ)
@@ -518,7 +555,7 @@ void DynamicsFromIntMaskFunctional3D<T,Descriptor>::process (
                 bool flag = (bool) util::roundToInt (
                                mask.get(iX+offset.x, iY+offset.y, iZ+offset.z) );
                 if ( flag == whichFlag ) {
-                    lattice.attributeDynamics(iX,iY,iZ, dynamics->clone());
+                    lattice.attributeDynamics(iX,iY,iZ, shared ? shared : dynamics->clone());
                 }
             }
         }
@@ -766,7 +803,9 @@ template<typename T, template<typename U> class Descriptor>
 InstantiateCompositeDynamicsFunctional3D<T,Descriptor>::InstantiateCompositeDynamicsFunctional3D (
         CompositeDynamics<T,Descriptor>* compositeDynamics_ )
     : compositeDynamics(compositeDynamics_)
-{ }
+{
+    dynamicsPrototypes<T,Descriptor>().registerPrototype(*compositeDynamics);
+}
 
 template<typename T, template<typename U> class Descriptor>
 InstantiateCompositeDynamicsFunctional3D<T,Descriptor>::InstantiateCompositeDynamicsFunctional3D (
@@ -0,0 +1,211 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Comparison of the batched collision templates (batchedDynamicsTemplates.h)
+ * with the scalar ones (dynamicsTemplates.h), on D2Q9, D3Q19 and D3Q27.
+ * The scalar BGK template is furthermore compared with a direct evaluation
+ * of the BGK collision, which covers the hand-unrolled specializations of
+ * dynamicsTemplates2D.h and dynamicsTemplates3D.h (in D3Q27, population 15
+ * used to be left uncollided).
+ *
+ * The program is self-contained. Compile it once without and once with
+ * SIMD instructions, for example:
+ *     g++ -O2 -I../Palabos batchedDynamicsTemplatesTest.cpp
+ *     g++ -O2 -mavx -I../Palabos batchedDynamicsTemplatesTest.cpp
+ * It returns a non-zero exit code if one of the comparisons fails.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "core/globalDefs.h"
+#include "latticeBoltzmann/nearestNeighborLattices2D.h"
+#include "latticeBoltzmann/nearestNeighborLattices3D.h"
+#include "latticeBoltzmann/nearestNeighborLattices2D.hh"
+#include "latticeBoltzmann/nearestNeighborLattices3D.hh"
+#include "latticeBoltzmann/momentTemplates.h"
+#include "latticeBoltzmann/dynamicsTemplates.h"
+#include "latticeBoltzmann/batchedDynamicsTemplates.h"
+
+using namespace plb;
+
+typedef double T;
+
+/// Tolerance on the difference between two post-collision populations.
+const T tolerance = 1.e-14;
+
+/// Number of cells; it is not a multiple of the SIMD width, so that the scalar remainder is tested as well.
+const plint numCells = 37;
+
+enum CollisionModel { bgk_ma2, bgk_inc, rlb };
+
+char const* modelName(CollisionModel model) {
+    switch(model) {
+        case bgk_ma2: return "bgk_ma2";
+        case bgk_inc: return "bgk_inc";
+        default:      return "rlb";
+    }
+}
+
+/// Populations close to equilibrium, in the rhoBar representation (f_i - t_i).
+template<class Descriptor>
+void randomPopulations(Array<T,Descriptor::q>& f) {
+    for (plint iPop=0; iPop<Descriptor::q; ++iPop) {
+        T noise = (T)std::rand()/(T)RAND_MAX - (T)0.5;
+        f[iPop] = Descriptor::t[iPop]*(T)0.2*noise;
+    }
+}
+
+/// Collision of one cell with the scalar templates.
+template<class Descriptor>
+T scalarCollision(CollisionModel model, Array<T,Descriptor::q>& f, T omega) {
+    typedef momentTemplatesImpl<T,Descriptor> moments;
+    typedef dynamicsTemplatesImpl<T,Descriptor> dynamics;
+    T rhoBar;
+    Array<T,Descriptor::d> j;
+    moments::get_rhoBar_j(f, rhoBar, j);
+    switch(model) {
+        case bgk_ma2: return dynamics::bgk_ma2_collision(f, rhoBar, j, omega);
+        case bgk_inc: return dynamics::bgk_inc_collision(f, rhoBar, j, omega);
+        default: {
+            Array<T,SymmetricTensorImpl<T,Descriptor::d>::n> PiNeq;
+            moments::compute_PiNeq(f, rhoBar, j, PiNeq);
+            return dynamics::rlb_collision(f, rhoBar, j, PiNeq, omega);
+        }
+    }
+}
+
+/// BGK collision of one cell, evaluated population by population from the lattice constants.
+template<class Descriptor>
+void referenceBgkCollision(Array<T,Descriptor::q>& f, T omega) {
+    T rhoBar = T();
+    Array<T,Descriptor::d> j;
+    j.resetToZero();
+    for (plint iPop=0; iPop<Descriptor::q; ++iPop) {
+        rhoBar += f[iPop];
+        for (int iD=0; iD<Descriptor::d; ++iD) {
+            j[iD] += Descriptor::c[iPop][iD]*f[iPop];
+        }
+    }
+    T invRho = (T)1/(rhoBar+(T)1);
+    T jSqr = T();
+    for (int iD=0; iD<Descriptor::d; ++iD) {
+        jSqr += j[iD]*j[iD];
+    }
+    for (plint iPop=0; iPop<Descriptor::q; ++iPop) {
+        T c_j = T();
+        for (int iD=0; iD<Descriptor::d; ++iD) {
+            c_j += Descriptor::c[iPop][iD]*j[iD];
+        }
+        T fEq = Descriptor::t[iPop] * ( rhoBar + Descriptor::invCs2*c_j +
+                    Descriptor::invCs2/(T)2*invRho*(Descriptor::invCs2*c_j*c_j - jSqr) );
+        f[iPop] = ((T)1-omega)*f[iPop] + omega*fEq;
+    }
+}
+
+/// Compare the batched and the scalar collision on numCells random cells; return the number of failures.
+template<template<typename U> class Descriptor>
+int testBatched(char const* latticeName, CollisionModel model) {
+    typedef typename Descriptor<T>::BaseDescriptor D;
+    const T omega = (T)1.7;
+    std::vector<Array<T,D::q> > cells(numCells);
+    std::vector<std::vector<T> > soa(D::q, std::vector<T>(numCells));
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        randomPopulations<D>(cells[iCell]);
+        for (plint iPop=0; iPop<D::q; ++iPop) {
+            soa[iPop][iCell] = cells[iCell][iPop];
+        }
+    }
+    std::vector<T*> f(D::q);
+    for (plint iPop=0; iPop<D::q; ++iPop) {
+        f[iPop] = &soa[iPop][0];
+    }
+    std::vector<T> rhoBar(numCells), uSqr(numCells);
+    switch(model) {
+        case bgk_ma2:
+            batchedDynamicsTemplates<T,Descriptor>::bgk_ma2_collision(&f[0], numCells, omega, &rhoBar[0], &uSqr[0]);
+            break;
+        case bgk_inc:
+            batchedDynamicsTemplates<T,Descriptor>::bgk_inc_collision(&f[0], numCells, omega, &rhoBar[0], &uSqr[0]);
+            break;
+        default:
+            batchedDynamicsTemplates<T,Descriptor>::rlb_collision(&f[0], numCells, omega, &rhoBar[0], &uSqr[0]);
+    }
+    T maxDiff = T();
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        T scalarUSqr = scalarCollision<D>(model, cells[iCell], omega);
+        maxDiff = std::max(maxDiff, std::fabs(scalarUSqr-uSqr[iCell]));
+        for (plint iPop=0; iPop<D::q; ++iPop) {
+            maxDiff = std::max(maxDiff, std::fabs(cells[iCell][iPop]-soa[iPop][iCell]));
+        }
+    }
+    bool ok = maxDiff <= tolerance;
+    std::cout << latticeName << " " << modelName(model) << " batched vs. scalar: max. difference "
+              << maxDiff << (ok ? "" : "  FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+/// Compare the scalar BGK collision with referenceBgkCollision(), population by population.
+template<template<typename U> class Descriptor>
+int testScalarBgk(char const* latticeName) {
+    typedef typename Descriptor<T>::BaseDescriptor D;
+    const T omega = (T)1.7;
+    int numFailures = 0;
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        Array<T,D::q> f, fRef;
+        randomPopulations<D>(f);
+        fRef = f;
+        scalarCollision<D>(bgk_ma2, f, omega);
+        referenceBgkCollision<D>(fRef, omega);
+        for (plint iPop=0; iPop<D::q; ++iPop) {
+            if (std::fabs(f[iPop]-fRef[iPop]) > tolerance) {
+                if (iCell==0) {
+                    std::cout << latticeName << " bgk_ma2 scalar: population " << iPop
+                              << " is wrong  FAILED" << std::endl;
+                }
+                ++numFailures;
+            }
+        }
+    }
+    if (numFailures==0) {
+        std::cout << latticeName << " bgk_ma2 scalar vs. reference: ok" << std::endl;
+    }
+    return numFailures==0 ? 0 : 1;
+}
+
+int main() {
+    std::srand(1);
+    int numFailures = 0;
+    CollisionModel models[] = { bgk_ma2, bgk_inc, rlb };
+    for (int iModel=0; iModel<3; ++iModel) {
+        numFailures += testBatched<descriptors::D2Q9Descriptor>("D2Q9", models[iModel]);
+        numFailures += testBatched<descriptors::D3Q19Descriptor>("D3Q19", models[iModel]);
+        numFailures += testBatched<descriptors::D3Q27Descriptor>("D3Q27", models[iModel]);
+    }
+    numFailures += testScalarBgk<descriptors::D2Q9Descriptor>("D2Q9");
+    numFailures += testScalarBgk<descriptors::D3Q19Descriptor>("D3Q19");
+    numFailures += testScalarBgk<descriptors::D3Q27Descriptor>("D3Q27");
+    std::cout << (numFailures==0 ? "All tests passed." : "Some tests FAILED.") << std::endl;
+    return numFailures==0 ? 0 : 1;
+}
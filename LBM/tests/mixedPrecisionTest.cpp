@@ -0,0 +1,221 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Accuracy of the single precision storage of the populations
+ * (PLB_MIXED_PRECISION, see PopulationStorage in populationArrays3D.h).
+ * Two force-driven D3Q19 flows are computed until they are steady: a
+ * Poiseuille channel, and a channel with a cylindrical obstacle made of
+ * BounceBack cells around a core of NoDynamics cells. The reference is
+ * computed in the arrayOfStructures layout, which stores the populations in
+ * double precision. In the structureOfArrays and sparse layouts, they are
+ * stored in single precision. The largest difference of the velocity in the
+ * fluid cells, relative to the peak velocity, is required to be below
+ * tolerance. For the Poiseuille channel, the discretization error of the
+ * reference with respect to the analytical profile is printed for
+ * comparison.
+ *
+ * The program uses the library. Compile it, in a serial build and with
+ * PLB_MIXED_PRECISION, together with the source files of Palabos, for example:
+ *     g++ -O2 -DPLB_MIXED_PRECISION -I../Palabos mixedPrecisionTest.cpp <Palabos .cpp files>
+ * It returns a non-zero exit code if one of the comparisons fails.
+ */
+
+#ifndef PLB_MIXED_PRECISION
+#error "This test is meaningful with PLB_MIXED_PRECISION only."
+#endif
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+using namespace plb;
+using namespace plb::descriptors;
+
+typedef double T;
+#define DESCRIPTOR ForcedD3Q19Descriptor
+
+static const plint ny = 23;
+static const plint nz = 4;
+static const T omega = (T)1.;
+static const T force = (T)6.e-5;
+/// Admitted difference of the velocity with the double precision storage, relative to the peak velocity.
+static const T tolerance = (T)1.e-4;
+
+/// Tells whether the velocity of a cell is meaningful.
+bool isFluid(Cell<T,DESCRIPTOR> const& cell) {
+    return !dynamic_cast<NoDynamics<T,DESCRIPTOR> const*>(&cell.getDynamics()) &&
+           !dynamic_cast<BounceBack<T,DESCRIPTOR> const*>(&cell.getDynamics());
+}
+
+/// Run a channel of length nx, periodic along x and z, with or without the cylinder.
+MultiBlockLattice3D<T,DESCRIPTOR>* runChannel (
+        plint nx, bool withCylinder, PopulationLayout::LayoutT layout, plint numIter )
+{
+    MultiBlockLattice3D<T,DESCRIPTOR>* lattice =
+        new MultiBlockLattice3D<T,DESCRIPTOR> (
+                nx, ny, nz, new GuoExternalForceBGKdynamics<T,DESCRIPTOR>(omega) );
+    lattice->setPopulationLayout(layout);
+    lattice->periodicity().toggle(0, true);
+    lattice->periodicity().toggle(2, true);
+
+    defineDynamics(*lattice, Box3D(0,nx-1, 0,0, 0,nz-1), new BounceBack<T,DESCRIPTOR>((T)1.));
+    defineDynamics(*lattice, Box3D(0,nx-1, ny-1,ny-1, 0,nz-1), new BounceBack<T,DESCRIPTOR>((T)1.));
+    if (withCylinder) {
+        T centerX = (T)12., centerY = (T)(ny-1)/(T)2., radius = (T)4.5;
+        for (plint iX=0; iX<nx; ++iX) {
+            for (plint iY=1; iY<ny-1; ++iY) {
+                T distance = std::sqrt( ((T)iX-centerX)*((T)iX-centerX) +
+                                        ((T)iY-centerY)*((T)iY-centerY) );
+                if (distance < radius-(T)2.) {
+                    defineDynamics(*lattice, Box3D(iX,iX, iY,iY, 0,nz-1),
+                                   new NoDynamics<T,DESCRIPTOR>);
+                }
+                else if (distance < radius) {
+                    defineDynamics(*lattice, Box3D(iX,iX, iY,iY, 0,nz-1),
+                                   new BounceBack<T,DESCRIPTOR>((T)1.));
+                }
+            }
+        }
+    }
+
+    initializeAtEquilibrium(*lattice, lattice->getBoundingBox(), (T)1., Array<T,3>((T)0.,(T)0.,(T)0.));
+    T forceVector[] = { force, (T)0., (T)0. };
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                lattice->get(iX,iY,iZ).setExternalField (
+                        DESCRIPTOR<T>::ExternalField::forceBeginsAt,
+                        DESCRIPTOR<T>::ExternalField::sizeOfForce, forceVector );
+            }
+        }
+    }
+    lattice->initialize();
+
+    for (plint iT=0; iT<numIter; ++iT) {
+        lattice->collideAndStream();
+    }
+    return lattice;
+}
+
+/// Largest velocity in the fluid cells.
+T maxVelocity(MultiBlockLattice3D<T,DESCRIPTOR>& lattice) {
+    T maximum = (T)0;
+    Box3D domain(lattice.getBoundingBox());
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,DESCRIPTOR> const& cell = lattice.get(iX,iY,iZ);
+                if (!isFluid(cell)) continue;
+                Array<T,3> u;
+                cell.computeVelocity(u);
+                maximum = std::max(maximum, std::sqrt(VectorTemplate<T,DESCRIPTOR>::normSqr(u)));
+            }
+        }
+    }
+    return maximum;
+}
+
+/// Largest difference of the velocity in the fluid cells of two lattices.
+T maxDifference( MultiBlockLattice3D<T,DESCRIPTOR>& lattice1,
+                 MultiBlockLattice3D<T,DESCRIPTOR>& lattice2 )
+{
+    T difference = (T)0;
+    Box3D domain(lattice1.getBoundingBox());
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,DESCRIPTOR> const& cell1 = lattice1.get(iX,iY,iZ);
+                Array<T,3> u1, u2;
+                if (!isFluid(cell1)) continue;
+                cell1.computeVelocity(u1);
+                lattice2.get(iX,iY,iZ).computeVelocity(u2);
+                for (int iD=0; iD<3; ++iD) {
+                    difference = std::max(difference, std::fabs(u1[iD]-u2[iD]));
+                }
+            }
+        }
+    }
+    return difference;
+}
+
+/// Largest difference with the analytical profile of the Poiseuille channel.
+T poiseuilleError(MultiBlockLattice3D<T,DESCRIPTOR>& lattice) {
+    // With the bounce-back rule, the walls are located half-way between
+    //   the wall cells and the first fluid cells.
+    T nu = DESCRIPTOR<T>::cs2 * ((T)1./omega - (T)0.5);
+    T y0 = (T)0.5, y1 = (T)ny-(T)1.5;
+    T error = (T)0;
+    for (plint iY=1; iY<ny-1; ++iY) {
+        T y = (T)iY;
+        T analytical = force / ((T)2.*nu) * (y-y0)*(y1-y);
+        Array<T,3> u;
+        lattice.get(0,iY,0).computeVelocity(u);
+        error = std::max(error, std::fabs(u[0]-analytical));
+    }
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    PopulationLayout::LayoutT layouts[] = { PopulationLayout::structureOfArrays,
+                                            PopulationLayout::sparse };
+    char const* layoutNames[] = { "structure-of-arrays", "sparse" };
+    char const* flowNames[] = { "Poiseuille channel", "cylinder" };
+    plint lengths[] = { 4, 48 };
+    plint numIters[] = { 8000, 4000 };
+
+    int numFailures = 0;
+    for (int iFlow=0; iFlow<2; ++iFlow) {
+        bool withCylinder = iFlow==1;
+        std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> > reference (
+            runChannel(lengths[iFlow], withCylinder, PopulationLayout::arrayOfStructures, numIters[iFlow]) );
+        T peakVelocity = maxVelocity(*reference);
+        if (!withCylinder) {
+            std::cout << flowNames[iFlow] << ": discretization error (relative) "
+                      << poiseuilleError(*reference)/peakVelocity << std::endl;
+        }
+        for (int iLayout=0; iLayout<2; ++iLayout) {
+            std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> > lattice (
+                runChannel(lengths[iFlow], withCylinder, layouts[iLayout], numIters[iFlow]) );
+            T difference = maxDifference(*reference, *lattice)/peakVelocity;
+            bool ok = difference <= tolerance;
+            std::cout << flowNames[iFlow] << ", " << layoutNames[iLayout] << ": "
+                      << (ok ? "ok" : "FAILED") << " (max. relative difference " << difference << ")"
+                      << std::endl;
+            if (!ok) ++numFailures;
+        }
+    }
+
+    if (numFailures>0) {
+        std::cout << numFailures << " comparison(s) failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All comparisons passed." << std::endl;
+    return 0;
+}
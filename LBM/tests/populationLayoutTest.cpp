@@ -0,0 +1,163 @@
+/* This file is part of the Palabos library.
+ * Copyright (C) 2009 Jonas Latt
+ * E-mail contact: jonas@lbmethod.org
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.lbmethod.org/palabos/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Comparison of the population layouts (PopulationLayout in globalDefs.h)
+ * on a D3Q19 channel with two obstacles. The channel walls, the inlet and
+ * the outlet are implemented with createInterpBoundaryCondition3D(), whose
+ * data processors access several neighboring cells through references
+ * which are all alive at the same time. The first obstacle is made of
+ * NoDynamics cells wrapped in a layer of BounceBack cells, and the second
+ * one of NoDynamics cells only, which the sparse layout must not remove
+ * from the storage. The populations of the fluid and boundary cells
+ * obtained with the structure-of-arrays and the sparse layout, on one and
+ * on several blocks, are required to be identical to the ones obtained with
+ * the array-of-structures layout, up to round-off: in these layouts, the
+ * BGK cells are collided with the batched templates.
+ *
+ * The program uses the library. Compile it, in a serial build and without
+ * PLB_MIXED_PRECISION, together with the source files of Palabos, for example:
+ *     g++ -O2 -I../Palabos populationLayoutTest.cpp <Palabos .cpp files>
+ * It returns a non-zero exit code if one of the comparisons fails.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+using namespace plb;
+using namespace plb::descriptors;
+
+typedef double T;
+#define DESCRIPTOR D3Q19Descriptor
+
+static const plint nx = 32;
+static const plint ny = 13;
+static const plint nz = 11;
+static const plint numIter = 60;
+/// Admitted difference with the array-of-structures layout, for each layout.
+static const T tolerance[] = { (T)0, (T)1.e-12, (T)1.e-12 };
+
+/// Run the channel with the given layout on numBlocks blocks.
+MultiBlockLattice3D<T,DESCRIPTOR>* runChannel (
+        PopulationLayout::LayoutT layout, int numBlocks )
+{
+    defaultMultiBlockPolicy3D().setNumProcesses(numBlocks);
+    MultiBlockLattice3D<T,DESCRIPTOR>* lattice =
+        new MultiBlockLattice3D<T,DESCRIPTOR> (
+                nx, ny, nz, new BGKdynamics<T,DESCRIPTOR>((T)1.6) );
+    lattice->setPopulationLayout(layout);
+
+    std::auto_ptr<OnLatticeBoundaryCondition3D<T,DESCRIPTOR> >
+        boundaryCondition( createInterpBoundaryCondition3D<T,DESCRIPTOR>() );
+    boundaryCondition->setVelocityConditionOnBlockBoundaries(*lattice);
+
+    Box3D everything(lattice->getBoundingBox());
+    Box3D inlet(0,0, 1,ny-2, 1,nz-2);
+    Box3D outlet(nx-1,nx-1, 1,ny-2, 1,nz-2);
+    Array<T,3> zeroVelocity((T)0.,(T)0.,(T)0.);
+    Array<T,3> plugVelocity((T)0.04,(T)0.,(T)0.);
+
+    setBoundaryVelocity(*lattice, everything, zeroVelocity);
+    setBoundaryVelocity(*lattice, inlet, plugVelocity);
+    setBoundaryVelocity(*lattice, outlet, plugVelocity);
+    defineDynamics(*lattice, Box3D(8,12, 3,7, 2,nz-3),
+                   new BounceBack<T,DESCRIPTOR>((T)1.));
+    defineDynamics(*lattice, Box3D(9,11, 4,6, 3,nz-4),
+                   new NoDynamics<T,DESCRIPTOR>);
+    defineDynamics(*lattice, Box3D(20,22, 6,9, 3,6),
+                   new NoDynamics<T,DESCRIPTOR>);
+    initializeAtEquilibrium(*lattice, everything, (T)1., zeroVelocity);
+    initializeAtEquilibrium(*lattice, inlet, (T)1., plugVelocity);
+    initializeAtEquilibrium(*lattice, outlet, (T)1., plugVelocity);
+    lattice->initialize();
+
+    for (plint iT=0; iT<numIter; ++iT) {
+        lattice->collideAndStream();
+    }
+    return lattice;
+}
+
+/// Tells whether the content of a cell is meaningful in all layouts.
+bool isFluidOrBoundary(Cell<T,DESCRIPTOR> const& cell) {
+    return !dynamic_cast<NoDynamics<T,DESCRIPTOR> const*>(&cell.getDynamics()) &&
+           !dynamic_cast<BounceBack<T,DESCRIPTOR> const*>(&cell.getDynamics());
+}
+
+/// Largest difference between the populations of the fluid and boundary cells of two lattices.
+T maxDifference( MultiBlockLattice3D<T,DESCRIPTOR>& lattice1,
+                 MultiBlockLattice3D<T,DESCRIPTOR>& lattice2 )
+{
+    T difference = (T)0;
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                Cell<T,DESCRIPTOR> const& cell1 = lattice1.get(iX,iY,iZ);
+                Cell<T,DESCRIPTOR> const& cell2 = lattice2.get(iX,iY,iZ);
+                if (!isFluidOrBoundary(cell1)) continue;
+                for (plint iPop=0; iPop<DESCRIPTOR<T>::q; ++iPop) {
+                    difference = std::max(difference, std::fabs(cell1[iPop]-cell2[iPop]));
+                }
+            }
+        }
+    }
+    return difference;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> >
+        reference( runChannel(PopulationLayout::arrayOfStructures, 1) );
+
+    PopulationLayout::LayoutT layouts[] = { PopulationLayout::arrayOfStructures,
+                                            PopulationLayout::structureOfArrays,
+                                            PopulationLayout::sparse };
+    char const* layoutNames[] = { "array-of-structures", "structure-of-arrays", "sparse" };
+    int numBlocks[] = { 1, 4 };
+
+    int numFailures = 0;
+    for (int iLayout=0; iLayout<3; ++iLayout) {
+        for (int iBlocks=0; iBlocks<2; ++iBlocks) {
+            std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> >
+                lattice( runChannel(layouts[iLayout], numBlocks[iBlocks]) );
+            T difference = maxDifference(*reference, *lattice);
+            bool ok = difference <= tolerance[iLayout];
+            std::cout << layoutNames[iLayout] << " on " << numBlocks[iBlocks] << " block(s): "
+                      << (ok ? "ok" : "FAILED") << " (max. difference " << difference << ")"
+                      << std::endl;
+            if (!ok) ++numFailures;
+        }
+    }
+
+    if (numFailures>0) {
+        std::cout << numFailures << " comparison(s) failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All comparisons passed." << std::endl;
+    return 0;
+}